@@ -0,0 +1,154 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/StandardMapParser.h"
+#include "IO/TokenizerScan.h"
+
+#include <algorithm>
+#include <optional>
+#include <string>
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+namespace TrenchBroom
+{
+namespace IO
+{
+static constexpr size_t NumEntities = 2'000;
+static constexpr size_t NumBrushesPerEntity = 50;
+
+static std::string makeMap()
+{
+  auto result = std::string{};
+  for (size_t i = 0; i < NumEntities; ++i)
+  {
+    result += "// entity " + std::to_string(i)
+              + " - a comment that is long enough to be skipped in bulk\n";
+    result += "{\n\"classname\" \"func_detail\"\n\"_tb_name\" \"a fairly long group name "
+              + std::to_string(i) + "\"\n";
+    for (size_t j = 0; j < NumBrushesPerEntity; ++j)
+    {
+      result += "    {\n";
+      for (size_t k = 0; k < 6; ++k)
+      {
+        result += "        ( -1024 512 64 ) ( 1024 -512 64 ) ( 1024 512 -64.5 ) "
+                  "some/long/texture/name_"
+                  + std::to_string(k) + " 0 0 0 1 1\n";
+      }
+      result += "    }\n";
+    }
+    result += "}\n";
+  }
+  return result;
+}
+
+static size_t countTokens(const std::string& str, const bool skipRunsInBulk)
+{
+  auto tokenizer = QuakeMapTokenizer{str};
+  tokenizer.setSkipRunsInBulk(skipRunsInBulk);
+
+  auto tokenCount = size_t(0);
+  while (tokenizer.nextToken().type() != QuakeMapToken::Eof)
+  {
+    ++tokenCount;
+  }
+  return tokenCount;
+}
+
+TEST_CASE("TokenizerBenchmark.tokenizeMap", "[TokenizerBenchmark]")
+{
+  const auto str = makeMap();
+  const auto size = std::to_string(str.size());
+
+  auto scalarTokenCount = size_t(0);
+  timeLambda(
+    [&]() { scalarTokenCount = countTokens(str, false); },
+    "tokenize " + size + " bytes one character at a time");
+
+  auto bulkTokenCount = size_t(0);
+  timeLambda(
+    [&]() { bulkTokenCount = countTokens(str, true); },
+    "tokenize " + size + " bytes skipping runs in bulk");
+
+  CHECK(bulkTokenCount > 0u);
+  CHECK(bulkTokenCount == scalarTokenCount);
+
+  // both methods must yield the same tokens at the same positions
+  auto scalarTokenizer = QuakeMapTokenizer{str};
+  scalarTokenizer.setSkipRunsInBulk(false);
+  auto bulkTokenizer = QuakeMapTokenizer{str};
+  auto firstMismatch = std::optional<size_t>{};
+  for (size_t i = 0; i < bulkTokenCount && !firstMismatch; ++i)
+  {
+    const auto scalarToken = scalarTokenizer.nextToken();
+    const auto bulkToken = bulkTokenizer.nextToken();
+    if (
+      bulkToken.type() != scalarToken.type() || bulkToken.view() != scalarToken.view()
+      || bulkToken.line() != scalarToken.line()
+      || bulkToken.column() != scalarToken.column())
+    {
+      firstMismatch = i;
+    }
+  }
+  CHECK(firstMismatch == std::nullopt);
+}
+
+TEST_CASE("TokenizerBenchmark.scan", "[TokenizerBenchmark]")
+{
+  const auto str = makeMap();
+  const auto* begin = str.data();
+  const auto* end = str.data() + str.size();
+
+  auto scalarCount = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto* cur = begin; cur != end; ++cur)
+      {
+        if (*cur == '\n' || *cur == '"')
+        {
+          ++scalarCount;
+        }
+      }
+    },
+    "find line feeds and quotes one character at a time");
+
+  auto scanCount = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto* cur = Scan::findFirstOf(begin, end, "\n\""); cur != end;
+           cur = Scan::findFirstOf(cur + 1, end, "\n\""))
+      {
+        ++scanCount;
+      }
+    },
+    "find line feeds and quotes using Scan::findFirstOf");
+
+  CHECK(scanCount == scalarCount);
+
+  auto lineCount = size_t(0);
+  timeLambda(
+    [&]() { lineCount = Scan::countLineBreaks(begin, end, end); },
+    "count line breaks using Scan::countLineBreaks");
+
+  // the generated map doesn't contain any carriage returns
+  CHECK(lineCount == static_cast<size_t>(std::count(begin, end, '\n')));
+}
+} // namespace IO
+} // namespace TrenchBroom
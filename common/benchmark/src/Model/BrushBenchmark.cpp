@@ -0,0 +1,121 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushError.h"
+#include "Model/BrushFace.h"
+#include "Model/MapFormat.h"
+
+#include <kdl/result.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/constants.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+namespace TrenchBroom
+{
+namespace Model
+{
+static constexpr size_t NumBrushes = 50'000;
+
+/**
+ * Returns the vertices of a prism whose number of sides, size and position vary with the
+ * given index so that the brushes of a benchmark run are not all alike.
+ */
+static std::vector<vm::vec3> makePrismPoints(const size_t index)
+{
+  const auto sides = 3u + index % 10u;
+  const auto radius = 16.0 + double(index % 7u) * 8.0;
+  const auto height = 32.0 + double(index % 5u) * 16.0;
+  const auto center = vm::vec3{
+    -3072.0 + double(index % 64u) * 96.0,
+    -3072.0 + double((index / 64u) % 64u) * 96.0,
+    -2048.0 + double(index / 4096u) * 128.0};
+
+  auto result = std::vector<vm::vec3>{};
+  for (size_t i = 0; i < sides; ++i)
+  {
+    const auto angle = vm::C::two_pi() * double(i) / double(sides) + double(index);
+    const auto offset = vm::vec3{radius * std::cos(angle), radius * std::sin(angle), 0.0};
+    result.push_back(center + offset);
+    result.push_back(center + offset + vm::vec3{0.0, 0.0, height});
+  }
+  return result;
+}
+
+TEST_CASE("BrushBenchmark.createBrushes", "[BrushBenchmark]")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  auto points = std::vector<std::vector<vm::vec3>>{};
+  points.reserve(NumBrushes);
+  for (size_t i = 0; i < NumBrushes; ++i)
+  {
+    points.push_back(makePrismPoints(i));
+  }
+
+  auto brushes = std::vector<Brush>{};
+  brushes.reserve(NumBrushes);
+  timeLambda(
+    [&]() {
+      for (const auto& brushPoints : points)
+      {
+        brushes.push_back(builder.createBrush(brushPoints, "texture").value());
+      }
+    },
+    "create " + std::to_string(NumBrushes) + " brushes from points");
+
+  auto faces = std::vector<std::vector<BrushFace>>{};
+  faces.reserve(NumBrushes);
+  for (const auto& brush : brushes)
+  {
+    faces.push_back(brush.faces());
+  }
+  brushes.clear();
+
+  // this is what happens for every brush when a map is loaded
+  timeLambda(
+    [&]() {
+      for (auto& brushFaces : faces)
+      {
+        brushes.push_back(Brush::create(worldBounds, std::move(brushFaces)).value());
+      }
+    },
+    "create " + std::to_string(NumBrushes) + " brushes from faces");
+
+  timeLambda(
+    [&]() {
+      auto copies = brushes;
+      CHECK(copies.size() == NumBrushes);
+    },
+    "copy and destroy " + std::to_string(NumBrushes) + " brushes");
+
+  CHECK(brushes.size() == NumBrushes);
+}
+} // namespace Model
+} // namespace TrenchBroom
@@ -26,11 +26,20 @@
 #include "Model/MapFormat.h"
 #include "Model/WorldNode.h"
 #include "Renderer/BrushRenderer.h"
+#include "Renderer/BrushRendererBrushCache.h"
+#include "Renderer/FontManager.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "Renderer/RenderBatch.h"
+#include "Renderer/RenderContext.h"
+#include "Renderer/RenderPassTimer.h"
+#include "Renderer/ShaderManager.h"
+#include "Renderer/VboManager.h"
 
 #include <kdl/result.h>
 
 #include <algorithm>
 #include <chrono>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -154,5 +163,98 @@ TEST_CASE("BrushRendererBenchmark.benchBrushRenderer", "[BrushRendererBenchmark]
   kdl::vec_clear_and_delete(brushes);
   kdl::vec_clear_and_delete(textures);
 }
+TEST_CASE("BrushRendererBenchmark.validateUncachedBrushes", "[BrushRendererBenchmark]")
+{
+  auto brushesTextures = makeBrushes();
+  std::vector<Model::BrushNode*> brushes = brushesTextures.first;
+  std::vector<Assets::Texture*> textures = brushesTextures.second;
+
+  BrushRenderer r;
+  for (auto* brush : brushes)
+  {
+    r.addBrush(brush);
+  }
+
+  // this is what happens after loading a map, when the brushes have never been rendered
+  for (auto* brush : brushes)
+  {
+    brush->brushRendererBrushCache().invalidateVertexCache();
+  }
+
+  timeLambda(
+    [&]() { r.validate(); },
+    "validate " + std::to_string(brushes.size()) + " brushes with invalid vertex caches");
+
+  // this is what happens after changing a preference that invalidates the renderer
+  r.invalidate();
+  timeLambda(
+    [&]() { r.validate(); },
+    "validate " + std::to_string(brushes.size()) + " brushes with valid vertex caches");
+
+  // this is what happens after changing a view option that only affects some faces
+  r.invalidate();
+  brushes.front()->brushRendererBrushCache().invalidateVertexCache();
+  timeLambda(
+    [&]() { r.validate(); },
+    "validate " + std::to_string(brushes.size())
+      + " brushes with one changed brush geometry");
+
+  // changing the transparency settings does not invalidate the renderer
+  r.setForceTransparent(true);
+  r.setTransparencyAlpha(0.5f);
+  CHECK(r.valid());
+
+  kdl::vec_clear_and_delete(brushes);
+  kdl::vec_clear_and_delete(textures);
+}
+
+TEST_CASE("BrushRendererBenchmark.renderStats", "[BrushRendererBenchmark]")
+{
+  auto brushesTextures = makeBrushes();
+  std::vector<Model::BrushNode*> brushes = brushesTextures.first;
+  std::vector<Assets::Texture*> textures = brushesTextures.second;
+
+  BrushRenderer r;
+  for (auto* brush : brushes)
+  {
+    r.addBrush(brush);
+  }
+
+  auto fontManager = FontManager{};
+  auto shaderManager = ShaderManager{};
+  auto vboManager = VboManager{&shaderManager};
+  const auto camera = PerspectiveCamera{
+    90.0f,
+    1.0f,
+    8192.0f,
+    Camera::Viewport{0, 0, 1024, 768},
+    vm::vec3f{-256, 0, 0},
+    vm::vec3f::pos_x(),
+    vm::vec3f::pos_z()};
+
+  // Without an OpenGL context, the render batch cannot be rendered, so only the counters
+  // and the build times are available. The first frame validates all brushes, the second
+  // frame validates none.
+  for (const auto expectedValidatedBrushCount : {brushes.size(), size_t(0)})
+  {
+    auto renderContext =
+      RenderContext{RenderMode::Render3D, camera, fontManager, shaderManager};
+    auto renderBatch = RenderBatch{vboManager};
+    {
+      const auto timer = RenderPassTimer{renderContext, renderBatch, "Brushes"};
+      r.render(renderContext, renderBatch);
+    }
+
+    const auto& stats = renderContext.stats();
+    CHECK(stats.validatedBrushCount == expectedValidatedBrushCount);
+    REQUIRE(stats.passes.size() == 1u);
+    CHECK(stats.passes.front().name == "Brushes");
+    CHECK(stats.passes.front().buildTime >= 0.0);
+    CHECK(stats.passes.front().gpuTime == std::nullopt);
+  }
+
+  kdl::vec_clear_and_delete(brushes);
+  kdl::vec_clear_and_delete(textures);
+}
 } // namespace Renderer
 } // namespace TrenchBroom
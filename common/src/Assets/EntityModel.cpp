@@ -32,7 +32,12 @@
 
 #include <kdl/vector_utils.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
 #include <string>
+#include <tuple>
 
 namespace TrenchBroom
 {
@@ -256,6 +261,155 @@ public:
   float intersect(const vm::ray3f& /* ray */) const override { return vm::nan<float>(); }
 };
 
+// Mesh simplification
+
+namespace
+{
+/**
+ * The number of grid cells along the largest dimension of a mesh's bounds used to
+ * generate each simplified level of detail. Each level is generated from the previous
+ * one.
+ */
+constexpr auto LevelOfDetailResolutions = std::array<float, 2>{16.0f, 6.0f};
+
+/**
+ * A simplified level of detail is only kept if it has at most this fraction of the
+ * triangles of the previous level.
+ */
+constexpr auto MaxSimplifiedTriangleRatio = 0.75f;
+
+bool sufficientlySimplified(const size_t originalCount, const size_t simplifiedCount)
+{
+  return simplifiedCount > 0u
+         && float(simplifiedCount) <= float(originalCount) * MaxSimplifiedTriangleRatio;
+}
+
+/**
+ * Appends the given primitives to the given triangle list.
+ */
+void appendTriangles(
+  const std::vector<EntityModelVertex>& vertices,
+  const Renderer::PrimType primType,
+  const size_t index,
+  const size_t count,
+  std::vector<EntityModelVertex>& triangles)
+{
+  const auto append = [&](const size_t i1, const size_t i2, const size_t i3) {
+    triangles.push_back(vertices[index + i1]);
+    triangles.push_back(vertices[index + i2]);
+    triangles.push_back(vertices[index + i3]);
+  };
+
+  switch (primType)
+  {
+  case Renderer::PrimType::Points:
+  case Renderer::PrimType::Lines:
+  case Renderer::PrimType::LineStrip:
+  case Renderer::PrimType::LineLoop:
+    break;
+  case Renderer::PrimType::Triangles:
+    for (size_t i = 0; i + 2 < count; i += 3)
+    {
+      append(i, i + 1, i + 2);
+    }
+    break;
+  case Renderer::PrimType::Polygon:
+  case Renderer::PrimType::TriangleFan:
+    for (size_t i = 1; i + 1 < count; ++i)
+    {
+      append(0, i, i + 1);
+    }
+    break;
+  case Renderer::PrimType::TriangleStrip:
+    for (size_t i = 0; i + 2 < count; ++i)
+    {
+      if (i % 2 == 0)
+      {
+        append(i, i + 1, i + 2);
+      }
+      else
+      {
+        append(i + 1, i, i + 2);
+      }
+    }
+    break;
+  case Renderer::PrimType::Quads:
+    for (size_t i = 0; i + 3 < count; i += 4)
+    {
+      append(i, i + 1, i + 2);
+      append(i, i + 2, i + 3);
+    }
+    break;
+  case Renderer::PrimType::QuadStrip:
+    for (size_t i = 0; i + 3 < count; i += 2)
+    {
+      append(i, i + 1, i + 3);
+      append(i, i + 3, i + 2);
+    }
+    break;
+    switchDefault();
+  }
+}
+} // namespace
+
+std::vector<EntityModelVertex> simplifyTriangles(
+  const std::vector<EntityModelVertex>& triangles, const float cellSize)
+{
+  assert(triangles.size() % 3u == 0u);
+  assert(cellSize > 0.0f);
+
+  using Cell = std::tuple<long, long, long>;
+  const auto cellAt = [&](const vm::vec3f& position) {
+    return Cell{
+      long(std::floor(position.x() / cellSize)),
+      long(std::floor(position.y() / cellSize)),
+      long(std::floor(position.z() / cellSize))};
+  };
+
+  // accumulate the vertex positions per cell
+  auto cellIndices = std::map<Cell, size_t>{};
+  auto positionSums = std::vector<vm::vec3f>{};
+  auto vertexCounts = std::vector<float>{};
+  auto vertexCells = std::vector<size_t>{};
+  vertexCells.reserve(triangles.size());
+
+  for (const auto& vertex : triangles)
+  {
+    const auto& position = Renderer::getVertexComponent<0>(vertex);
+    const auto [it, inserted] =
+      cellIndices.try_emplace(cellAt(position), positionSums.size());
+    if (inserted)
+    {
+      positionSums.push_back(vm::vec3f::zero());
+      vertexCounts.push_back(0.0f);
+    }
+    positionSums[it->second] = positionSums[it->second] + position;
+    vertexCounts[it->second] += 1.0f;
+    vertexCells.push_back(it->second);
+  }
+
+  auto result = std::vector<EntityModelVertex>{};
+  for (size_t i = 0; i < triangles.size(); i += 3)
+  {
+    const auto c1 = vertexCells[i + 0];
+    const auto c2 = vertexCells[i + 1];
+    const auto c3 = vertexCells[i + 2];
+    if (c1 == c2 || c2 == c3 || c1 == c3)
+    {
+      continue;
+    }
+
+    for (const auto j : {i + 0, i + 1, i + 2})
+    {
+      const auto c = vertexCells[j];
+      result.emplace_back(
+        positionSums[c] / vertexCounts[c], Renderer::getVertexComponent<1>(triangles[j]));
+    }
+  }
+
+  return result;
+}
+
 // EntityModel::Mesh
 
 /**
@@ -263,6 +417,10 @@ public:
  */
 class EntityModelMesh
 {
+private:
+  bool m_levelsOfDetailBuilt = false;
+  std::vector<std::unique_ptr<EntityModelMesh>> m_simplifiedMeshes;
+
 protected:
   std::vector<EntityModelVertex> m_vertices;
 
@@ -292,7 +450,68 @@ public:
     return doBuildRenderer(skin, vertexArray);
   }
 
+  /**
+   * Returns the number of levels of detail of this mesh, including this mesh itself.
+   */
+  size_t levelOfDetailCount()
+  {
+    buildLevelsOfDetail();
+    return m_simplifiedMeshes.size() + 1u;
+  }
+
+  /**
+   * Returns the mesh for the given level of detail. Level 0 is this mesh. If there are
+   * fewer levels, the least detailed level is returned.
+   */
+  EntityModelMesh& levelOfDetail(const size_t levelOfDetail)
+  {
+    buildLevelsOfDetail();
+    if (levelOfDetail == 0u || m_simplifiedMeshes.empty())
+    {
+      return *this;
+    }
+    return *m_simplifiedMeshes[std::min(levelOfDetail, m_simplifiedMeshes.size()) - 1u];
+  }
+
 private:
+  void buildLevelsOfDetail()
+  {
+    if (m_levelsOfDetailBuilt)
+    {
+      return;
+    }
+    m_levelsOfDetailBuilt = true;
+
+    auto bounds = vm::bbox3f::builder{};
+    for (const auto& vertex : m_vertices)
+    {
+      bounds.add(Renderer::getVertexComponent<0>(vertex));
+    }
+    if (!bounds.initialized())
+    {
+      return;
+    }
+
+    const auto size = vm::get_max_component(bounds.bounds().size());
+    const EntityModelMesh* current = this;
+    for (const auto resolution : LevelOfDetailResolutions)
+    {
+      auto simplified = current->simplify(size / resolution);
+      if (!simplified)
+      {
+        break;
+      }
+      current = simplified.get();
+      m_simplifiedMeshes.push_back(std::move(simplified));
+    }
+  }
+
+  /**
+   * Returns a simplified copy of this mesh, or null if the mesh cannot be simplified
+   * sufficiently with the given cell size.
+   */
+  virtual std::unique_ptr<EntityModelMesh> simplify(float cellSize) const = 0;
+
   /**
    * Creates and returns the actual mesh renderer
    *
@@ -335,7 +554,41 @@ public:
       });
   }
 
+  /**
+   * Creates a new mesh which is not used for hit testing, such as a simplified level of
+   * detail.
+   *
+   * @param vertices the vertices
+   * @param indices the indices
+   */
+  EntityModelIndexedMesh(
+    std::vector<EntityModelVertex> vertices, EntityModelIndices indices)
+    : EntityModelMesh{std::move(vertices)}
+    , m_indices{std::move(indices)}
+  {
+  }
+
 private:
+  std::unique_ptr<EntityModelMesh> simplify(const float cellSize) const override
+  {
+    auto triangles = std::vector<EntityModelVertex>{};
+    m_indices.forEachPrimitive(
+      [&](const Renderer::PrimType primType, const size_t index, const size_t count) {
+        appendTriangles(m_vertices, primType, index, count, triangles);
+      });
+
+    auto simplified = simplifyTriangles(triangles, cellSize);
+    if (!sufficientlySimplified(triangles.size(), simplified.size()))
+    {
+      return nullptr;
+    }
+
+    const auto vertexCount = simplified.size();
+    return std::make_unique<EntityModelIndexedMesh>(
+      std::move(simplified),
+      EntityModelIndices{Renderer::PrimType::Triangles, 0, vertexCount});
+  }
+
   std::unique_ptr<Renderer::TexturedIndexRangeRenderer> doBuildRenderer(
     const Texture* skin, const Renderer::VertexArray& vertices) override
   {
@@ -380,7 +633,59 @@ public:
     });
   }
 
+  /**
+   * Creates a new mesh which is not used for hit testing, such as a simplified level of
+   * detail.
+   *
+   * @param vertices the vertices
+   * @param indices the per texture indices
+   */
+  EntityModelTexturedMesh(
+    std::vector<EntityModelVertex> vertices, EntityModelTexturedIndices indices)
+    : EntityModelMesh{std::move(vertices)}
+    , m_indices{std::move(indices)}
+  {
+  }
+
 private:
+  std::unique_ptr<EntityModelMesh> simplify(const float cellSize) const override
+  {
+    auto trianglesByTexture = std::map<const Texture*, std::vector<EntityModelVertex>>{};
+    m_indices.forEachPrimitive([&](
+                                 const Texture* texture,
+                                 const Renderer::PrimType primType,
+                                 const size_t index,
+                                 const size_t count) {
+      appendTriangles(m_vertices, primType, index, count, trianglesByTexture[texture]);
+    });
+
+    auto originalCount = size_t(0);
+    auto vertices = std::vector<EntityModelVertex>{};
+    auto size = EntityModelTexturedIndices::Size{};
+    for (auto& [texture, triangles] : trianglesByTexture)
+    {
+      originalCount += triangles.size();
+      triangles = simplifyTriangles(triangles, cellSize);
+      size.inc(texture, Renderer::PrimType::Triangles, triangles.size());
+    }
+
+    auto indices = EntityModelTexturedIndices{size};
+    for (const auto& [texture, triangles] : trianglesByTexture)
+    {
+      indices.add(
+        texture, Renderer::PrimType::Triangles, vertices.size(), triangles.size());
+      vertices.insert(std::end(vertices), std::begin(triangles), std::end(triangles));
+    }
+
+    if (!sufficientlySimplified(originalCount, vertices.size()))
+    {
+      return nullptr;
+    }
+
+    return std::make_unique<EntityModelTexturedMesh>(
+      std::move(vertices), std::move(indices));
+  }
+
   std::unique_ptr<Renderer::TexturedIndexRangeRenderer> doBuildRenderer(
     const Texture* /* skin */, const Renderer::VertexArray& vertices) override
   {
@@ -459,8 +764,16 @@ const Texture* EntityModelSurface::skin(const size_t index) const
   return m_skins->textureByIndex(index);
 }
 
+size_t EntityModelSurface::levelOfDetailCount(const size_t frameIndex)
+{
+  assert(frameIndex < frameCount());
+
+  return m_meshes[frameIndex] != nullptr ? m_meshes[frameIndex]->levelOfDetailCount()
+                                         : 1u;
+}
+
 std::unique_ptr<Renderer::TexturedIndexRangeRenderer> EntityModelSurface::buildRenderer(
-  const size_t skinIndex, const size_t frameIndex)
+  const size_t skinIndex, const size_t frameIndex, const size_t levelOfDetail)
 {
   assert(frameIndex < frameCount());
   assert(skinIndex < skinCount());
@@ -472,7 +785,7 @@ std::unique_ptr<Renderer::TexturedIndexRangeRenderer> EntityModelSurface::buildR
   else
   {
     const auto* skin = this->skin(skinIndex);
-    return m_meshes[frameIndex]->buildRenderer(skin);
+    return m_meshes[frameIndex]->levelOfDetail(levelOfDetail).buildRenderer(skin);
   }
 }
 
@@ -490,7 +803,6 @@ EntityModel::EntityModel(
 std::unique_ptr<Renderer::TexturedRenderer> EntityModel::buildRenderer(
   const size_t skinIndex, const size_t frameIndex) const
 {
-  std::vector<std::unique_ptr<Renderer::TexturedIndexRangeRenderer>> renderers;
   if (frameIndex >= frameCount())
   {
     return nullptr;
@@ -498,24 +810,48 @@ std::unique_ptr<Renderer::TexturedRenderer> EntityModel::buildRenderer(
 
   const auto& frame = this->frame(frameIndex);
   const auto actualSkinIndex = skinIndex + frame->skinOffset();
+
+  auto levelOfDetailCount = size_t(1);
   for (const auto& surface : m_surfaces)
   {
     if (actualSkinIndex < surface->skinCount())
     {
-      if (auto renderer = surface->buildRenderer(actualSkinIndex, frameIndex))
+      levelOfDetailCount =
+        std::max(levelOfDetailCount, surface->levelOfDetailCount(frameIndex));
+    }
+  }
+
+  std::vector<std::unique_ptr<Renderer::TexturedRenderer>> levels;
+  for (size_t levelOfDetail = 0; levelOfDetail < levelOfDetailCount; ++levelOfDetail)
+  {
+    std::vector<std::unique_ptr<Renderer::TexturedIndexRangeRenderer>> renderers;
+    for (const auto& surface : m_surfaces)
+    {
+      if (actualSkinIndex < surface->skinCount())
       {
-        renderers.push_back(std::move(renderer));
+        if (
+          auto renderer =
+            surface->buildRenderer(actualSkinIndex, frameIndex, levelOfDetail))
+        {
+          renderers.push_back(std::move(renderer));
+        }
       }
     }
+    if (renderers.empty())
+    {
+      return nullptr;
+    }
+    levels.push_back(std::make_unique<Renderer::MultiTexturedIndexRangeRenderer>(
+      std::move(renderers)));
   }
-  if (renderers.empty())
+
+  if (levels.size() == 1u)
   {
-    return nullptr;
+    return std::move(levels.front());
   }
   else
   {
-    return std::make_unique<Renderer::MultiTexturedIndexRangeRenderer>(
-      std::move(renderers));
+    return std::make_unique<Renderer::LevelOfDetailRenderer>(std::move(levels));
   }
 }
 
@@ -210,6 +210,18 @@ public:
     size_t count);
 };
 
+/**
+ * Simplifies the given triangles by clustering their vertices on a grid with the given
+ * cell size. The vertices in each cell are moved to their average position, keeping their
+ * texture coordinates, and triangles which become degenerate are removed.
+ *
+ * @param triangles the triangle vertices, three per triangle
+ * @param cellSize the size of the grid cells
+ * @return the vertices of the remaining triangles
+ */
+std::vector<EntityModelVertex> simplifyTriangles(
+  const std::vector<EntityModelVertex>& triangles, float cellSize);
+
 class EntityModelMesh;
 class EntityModelIndexedMesh;
 class EntityModelTexturedMesh;
@@ -326,8 +338,28 @@ public:
    */
   const Texture* skin(size_t index) const;
 
+  /**
+   * Returns the number of levels of detail of the mesh for the given frame. Simplified
+   * levels of detail are generated when this function or `buildRenderer` is first called
+   * for a frame.
+   *
+   * @param frameIndex the index of the frame
+   * @return the number of levels of detail, including the full mesh
+   */
+  size_t levelOfDetailCount(size_t frameIndex);
+
+  /**
+   * Creates a renderer for the given level of detail of the mesh for the given frame.
+   * Level 0 is the full mesh. If the mesh has fewer levels, its least detailed level is
+   * used.
+   *
+   * @param skinIndex the index of the skin to use
+   * @param frameIndex the index of the frame
+   * @param levelOfDetail the level of detail
+   * @return the renderer or null if this surface has no mesh for the given frame
+   */
   std::unique_ptr<Renderer::TexturedIndexRangeRenderer> buildRenderer(
-    size_t skinIndex, size_t frameIndex);
+    size_t skinIndex, size_t frameIndex, size_t levelOfDetail);
 };
 
 /**
@@ -358,7 +390,8 @@ public:
 
   /**
    * Creates a renderer to render the given frame of the model using the skin with the
-   * given index.
+   * given index. If simplified meshes can be generated for the frame, the returned
+   * renderer is a Renderer::LevelOfDetailRenderer.
    *
    * @param skinIndex the index of the skin to use
    * @param frameIndex the index of the frame to render
@@ -20,6 +20,7 @@
 #include "Texture.h"
 #include "Assets/TextureBuffer.h"
 #include "Assets/TextureCollection.h"
+#include "Exceptions.h"
 #include "Macros.h"
 #include "Renderer/GL.h"
 
@@ -28,6 +29,7 @@
 #include <algorithm> // for std::max
 #include <cassert>
 #include <ostream>
+#include <utility>
 
 namespace TrenchBroom
 {
@@ -36,6 +38,18 @@ namespace Assets
 
 kdl_reflect_impl(Q2Data);
 
+void TextureRequestQueue::add(const Texture& texture)
+{
+  const auto lock = std::lock_guard{m_mutex};
+  m_textures.push_back(&texture);
+}
+
+std::vector<const Texture*> TextureRequestQueue::take()
+{
+  const auto lock = std::lock_guard{m_mutex};
+  return std::exchange(m_textures, {});
+}
+
 Texture::Texture(
   const std::string& name,
   const size_t width,
@@ -57,6 +71,8 @@ Texture::Texture(
   , m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA}
   , m_textureId{0}
   , m_gameData{std::move(gameData)}
+  , m_requested{false}
+  , m_requestQueue{nullptr}
 {
   assert(m_width > 0);
   assert(m_height > 0);
@@ -86,6 +102,8 @@ Texture::Texture(
   , m_textureId(0)
   , m_buffers{std::move(buffers)}
   , m_gameData{std::move(gameData)}
+  , m_requested{false}
+  , m_requestQueue{nullptr}
 {
   assert(m_width > 0);
   assert(m_height > 0);
@@ -119,6 +137,8 @@ Texture::Texture(
   , m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA}
   , m_textureId{0}
   , m_gameData{std::move(gameData)}
+  , m_requested{false}
+  , m_requestQueue{nullptr}
 {
 }
 
@@ -141,6 +161,9 @@ Texture::Texture(Texture&& other)
   , m_textureId{std::move(other.m_textureId)}
   , m_buffers{std::move(other.m_buffers)}
   , m_gameData{std::move(other.m_gameData)}
+  , m_decoder{std::move(other.m_decoder)}
+  , m_requested{std::move(other.m_requested)}
+  , m_requestQueue{std::move(other.m_requestQueue)}
 {
 }
 
@@ -162,6 +185,9 @@ Texture& Texture::operator=(Texture&& other)
   m_textureId = std::move(other.m_textureId);
   m_buffers = std::move(other.m_buffers);
   m_gameData = std::move(other.m_gameData);
+  m_decoder = std::move(other.m_decoder);
+  m_requested = std::move(other.m_requested);
+  m_requestQueue = std::move(other.m_requestQueue);
   return *this;
 }
 
@@ -271,7 +297,10 @@ size_t Texture::usageCount() const
 
 void Texture::incUsageCount()
 {
-  ++m_usageCount;
+  if (m_usageCount++ == 0u && m_requestQueue)
+  {
+    m_requestQueue->add(*this);
+  }
 }
 
 void Texture::decUsageCount()
@@ -291,6 +320,114 @@ void Texture::setOverridden(const bool overridden)
   m_overridden = overridden;
 }
 
+bool Texture::lazy() const
+{
+  return static_cast<bool>(m_decoder);
+}
+
+void Texture::setDecoder(Decoder decoder)
+{
+  m_decoder = std::move(decoder);
+}
+
+bool Texture::loaded() const
+{
+  return isPrepared() || !m_buffers.empty();
+}
+
+void Texture::load()
+{
+  assert(lazy());
+  assert(!loaded());
+
+  auto decoded = [&]() {
+    try
+    {
+      return m_decoder();
+    }
+    catch (const Exception&)
+    {
+      // don't try to decode the texture again every time it is needed
+      m_decoder = nullptr;
+      throw;
+    }
+  }();
+
+  if (decoded.m_buffers.empty())
+  {
+    m_decoder = nullptr;
+    return;
+  }
+
+  if (decoded.m_width != m_width || decoded.m_height != m_height)
+  {
+    m_decoder = nullptr;
+    throw AssetException{
+      "Texture '" + m_name
+      + "' has changed its dimensions, reload textures to update it"};
+  }
+
+  m_averageColor = decoded.m_averageColor;
+  m_format = decoded.m_format;
+  m_type = decoded.m_type;
+  m_buffers = std::move(decoded.m_buffers);
+}
+
+void Texture::unload()
+{
+  m_buffers.clear();
+  m_textureId = 0;
+}
+
+size_t Texture::byteSize() const
+{
+  // textures are uploaded with four bytes per pixel, and the mipmaps add another third
+  const auto size = m_width * m_height * 4u;
+  return m_type == TextureType::Masked ? size : size + size / 3u;
+}
+
+size_t Texture::cpuByteSize() const
+{
+  auto result = size_t(0);
+  for (const auto& buffer : m_buffers)
+  {
+    result += buffer.size();
+  }
+  return result;
+}
+
+size_t Texture::gpuByteSize() const
+{
+  return isPrepared() ? byteSize() : 0u;
+}
+
+void Texture::request() const
+{
+  if (!m_requested)
+  {
+    m_requested = true;
+    if (m_requestQueue)
+    {
+      m_requestQueue->add(*this);
+    }
+  }
+}
+
+bool Texture::requested() const
+{
+  return m_requested;
+}
+
+void Texture::resetRequested()
+{
+  m_requested = false;
+}
+
+void Texture::setRequestQueue(TextureRequestQueue* requestQueue)
+{
+  m_requestQueue = requestQueue;
+}
+
 bool Texture::isPrepared() const
 {
   return m_textureId != 0;
@@ -382,6 +519,8 @@ void Texture::setMode(const int minFilter, const int magFilter)
 
 void Texture::activate() const
 {
+  request();
+
   if (isPrepared())
   {
     glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
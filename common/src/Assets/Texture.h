@@ -29,7 +29,9 @@
 #include <kdl/reflection_decl.h>
 
 #include <atomic>
+#include <functional>
 #include <iosfwd>
+#include <mutex>
 #include <set>
 #include <string>
 #include <variant>
@@ -93,8 +95,39 @@ struct Q2Data
 
 using GameData = std::variant<std::monostate, Q2Data>;
 
+class Texture;
+
+/**
+ * Collects the lazily loaded textures which were requested or started being used, so
+ * that the texture manager only has to consider these textures when it loads the needed
+ * textures. Textures may be added from multiple threads at once.
+ */
+class TextureRequestQueue
+{
+private:
+  std::mutex m_mutex;
+  std::vector<const Texture*> m_textures;
+
+public:
+  void add(const Texture& texture);
+
+  /**
+   * Returns the added textures and clears this queue. A texture may be returned more than
+   * once.
+   */
+  std::vector<const Texture*> take();
+};
+
 class Texture
 {
+public:
+  /**
+   * Decodes the pixel data of a texture which is loaded lazily. Returns a texture with
+   * the same dimensions and its pixel data. Must be safe to call from any thread, and
+   * must report errors by throwing exceptions instead of logging them.
+   */
+  using Decoder = std::function<Texture()>;
+
 private:
   using Buffer = TextureBuffer;
   using BufferList = std::vector<Buffer>;
@@ -130,6 +163,20 @@ private:
 
   GameData m_gameData;
 
+  Decoder m_decoder;
+
+  /**
+   * Set when this texture is activated or requested, and reset by the texture manager
+   * when it decides which lazily loaded textures to keep in memory.
+   */
+  mutable bool m_requested;
+
+  /**
+   * The queue to add this texture to when it is requested or starts being used, or null
+   * if this texture is not managed by a texture manager.
+   */
+  TextureRequestQueue* m_requestQueue;
+
 public:
   Texture(
     const std::string& name,
@@ -209,6 +256,70 @@ public:
   bool overridden() const;
   void setOverridden(bool overridden);
 
+  /**
+   * Indicates whether the pixel data of this texture is decoded on demand. Such textures
+   * are created without pixel data, and the texture manager loads and unloads them
+   * depending on whether they are needed.
+   */
+  bool lazy() const;
+  void setDecoder(Decoder decoder);
+
+  /**
+   * Indicates whether the pixel data of this texture is available, either in memory or
+   * uploaded to the graphics card.
+   */
+  bool loaded() const;
+
+  /**
+   * Decodes the pixel data of this texture using its decoder. If the decoder doesn't
+   * return any pixel data or fails, this texture is no longer loaded lazily.
+   *
+   * Textures are decoded in parallel, so this may be called for different textures from
+   * multiple threads at once.
+   *
+   * @throws Exception if the decoder fails or if the decoded texture has different
+   * dimensions
+   */
+  void load();
+
+  /**
+   * Discards the pixel data of this texture. If this texture was uploaded, the caller is
+   * responsible for deleting the texture object.
+   */
+  void unload();
+
+  /**
+   * Returns the approximate number of bytes of video memory that this texture occupies
+   * when it's uploaded, including its mipmaps.
+   */
+  size_t byteSize() const;
+
+  /**
+   * Returns the number of bytes of main memory occupied by the pixel data of this
+   * texture. The pixel data is discarded once the texture is uploaded.
+   */
+  size_t cpuByteSize() const;
+
+  /**
+   * Returns the approximate number of bytes of video memory occupied by this texture, or
+   * 0 if it isn't uploaded.
+   */
+  size_t gpuByteSize() const;
+
+  /**
+   * Marks this texture as needed so that the texture manager loads it if it is loaded
+   * lazily. Activating a texture also requests it.
+   */
+  void request() const;
+  bool requested() const;
+  void resetRequested();
+
+  /**
+   * Sets the queue to which this texture adds itself when it is requested or when its
+   * usage count becomes positive.
+   */
+  void setRequestQueue(TextureRequestQueue* requestQueue);
+
   bool isPrepared() const;
   void prepare(GLuint textureId, int minFilter, int magFilter);
   void setMode(int minFilter, int magFilter);
@@ -23,6 +23,8 @@
 
 #include <kdl/vector_utils.h>
 
+#include <iomanip>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -163,5 +165,57 @@ void TextureCollection::setTextureMode(const int minFilter, const int magFilter)
     texture.setMode(minFilter, magFilter);
   }
 }
+
+void TextureCollection::prepareTexture(
+  const size_t index, const int minFilter, const int magFilter)
+{
+  ensure(prepared(), "texture collection is prepared");
+  ensure(index < textureCount(), "texture index is valid");
+
+  m_textures[index].prepare(m_textureIds[index], minFilter, magFilter);
+}
+
+void TextureCollection::unloadTexture(const size_t index)
+{
+  ensure(index < textureCount(), "texture index is valid");
+
+  auto& texture = m_textures[index];
+  if (texture.isPrepared())
+  {
+    // deleting the texture object releases its video memory, and the new texture object
+    // is used when the texture is prepared again
+    glAssert(glDeleteTextures(1, &m_textureIds[index]));
+    glAssert(glGenTextures(1, &m_textureIds[index]));
+  }
+  texture.unload();
+}
+
+size_t TextureCollection::cpuByteSize() const
+{
+  auto result = size_t(0);
+  for (const auto& texture : m_textures)
+  {
+    result += texture.cpuByteSize();
+  }
+  return result;
+}
+
+size_t TextureCollection::gpuByteSize() const
+{
+  auto result = size_t(0);
+  for (const auto& texture : m_textures)
+  {
+    result += texture.gpuByteSize();
+  }
+  return result;
+}
+
+std::string formatByteSize(const size_t byteSize)
+{
+  auto str = std::stringstream{};
+  str << std::fixed << std::setprecision(1)
+      << static_cast<double>(byteSize) / (1024.0 * 1024.0) << " MB";
+  return str.str();
+}
 } // namespace Assets
 } // namespace TrenchBroom
@@ -74,6 +74,36 @@ public:
   bool prepared() const;
   void prepare(int minFilter, int magFilter);
   void setTextureMode(int minFilter, int magFilter);
+
+  /**
+   * Uploads the texture with the given index after it has been loaded lazily. This
+   * collection must have been prepared.
+   */
+  void prepareTexture(size_t index, int minFilter, int magFilter);
+
+  /**
+   * Unloads the texture with the given index and deletes its texture object, so that the
+   * texture can be loaded and prepared again later.
+   */
+  void unloadTexture(size_t index);
+
+  /**
+   * Returns the number of bytes of main memory occupied by the pixel data of the
+   * textures which haven't been uploaded yet.
+   */
+  size_t cpuByteSize() const;
+
+  /**
+   * Returns the approximate number of bytes of video memory occupied by the uploaded
+   * textures.
+   */
+  size_t gpuByteSize() const;
 };
+
+/**
+ * Formats the given number of bytes in megabytes with one decimal place, e.g. "1.5 MB".
+ * Used to show the memory usage of textures and texture collections.
+ */
+std::string formatByteSize(size_t byteSize);
 } // namespace Assets
 } // namespace TrenchBroom
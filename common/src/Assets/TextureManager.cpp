@@ -26,6 +26,7 @@
 #include "Logger.h"
 
 #include <kdl/map_utils.h>
+#include <kdl/parallel.h>
 #include <kdl/string_format.h>
 #include <kdl/vector_utils.h>
 
@@ -33,6 +34,7 @@
 #include <chrono>
 #include <iterator>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom
@@ -70,6 +72,8 @@ TextureManager::TextureManager(int magFilter, int minFilter, Logger& logger)
   , m_minFilter(minFilter)
   , m_magFilter(magFilter)
   , m_resetTextureMode(false)
+  , m_memoryBudget(0u)
+  , m_commitCount(0u)
 {
 }
 
@@ -155,6 +159,9 @@ void TextureManager::clear()
   m_toPrepare.clear();
   m_texturesByName.clear();
   m_textures.clear();
+  m_lazyTextures.clear();
+  m_lastUsed.clear();
+  m_requestQueue.take();
 
   // Remove logging because it might fail when the document is already destroyed.
 }
@@ -166,10 +173,16 @@ void TextureManager::setTextureMode(const int minFilter, const int magFilter)
   m_resetTextureMode = true;
 }
 
+void TextureManager::setMemoryBudget(const size_t memoryBudget)
+{
+  m_memoryBudget = memoryBudget;
+}
+
 void TextureManager::commitChanges()
 {
   resetTextureMode();
   prepare();
+  loadNeededTextures();
   m_toRemove.clear();
 }
 
@@ -219,19 +232,157 @@ void TextureManager::prepare()
   {
     auto& collection = m_collections[index];
     collection.prepare(m_minFilter, m_magFilter);
+    logMemoryUsage(collection);
   }
   m_toPrepare.clear();
 }
 
+void TextureManager::loadNeededTextures()
+{
+  ++m_commitCount;
+
+  auto toLoad = std::vector<std::tuple<size_t, size_t>>{};
+  for (const auto* requestedTexture : m_requestQueue.take())
+  {
+    // the queue may contain textures of removed collections
+    const auto it = m_lazyTextures.find(requestedTexture);
+    if (it == std::end(m_lazyTextures))
+    {
+      continue;
+    }
+
+    const auto [collectionIndex, textureIndex] = it->second;
+    auto& texture = m_collections[collectionIndex].textures()[textureIndex];
+    texture.resetRequested();
+
+    if (texture.loaded())
+    {
+      m_lastUsed[&texture] = m_commitCount;
+    }
+    else if (texture.lazy())
+    {
+      toLoad.push_back(it->second);
+    }
+  }
+
+  // a texture can be added to the queue more than once
+  std::sort(std::begin(toLoad), std::end(toLoad));
+  toLoad.erase(std::unique(std::begin(toLoad), std::end(toLoad)), std::end(toLoad));
+
+  auto errors = std::vector<std::string>(toLoad.size());
+  kdl::parallel_for(toLoad.size(), [&](const size_t i) {
+    const auto [collectionIndex, textureIndex] = toLoad[i];
+    try
+    {
+      m_collections[collectionIndex].textures()[textureIndex].load();
+    }
+    catch (const std::exception& e)
+    {
+      errors[i] = e.what();
+    }
+  });
+
+  // the textures must be uploaded and the logger must be used on this thread
+  for (size_t i = 0; i < toLoad.size(); ++i)
+  {
+    const auto [collectionIndex, textureIndex] = toLoad[i];
+    auto& collection = m_collections[collectionIndex];
+    auto& texture = collection.textures()[textureIndex];
+    if (!errors[i].empty())
+    {
+      m_logger.error() << "Could not load texture '" << texture.name()
+                       << "': " << errors[i];
+    }
+    else if (texture.loaded())
+    {
+      collection.prepareTexture(textureIndex, m_minFilter, m_magFilter);
+      m_lastUsed[&texture] = m_commitCount;
+    }
+  }
+
+  if (m_memoryBudget == 0u)
+  {
+    return;
+  }
+
+  struct LoadedTexture
+  {
+    size_t collectionIndex;
+    size_t textureIndex;
+    size_t lastUsed;
+  };
+
+  auto unloadCandidates = std::vector<LoadedTexture>{};
+  auto loadedSize = size_t(0);
+
+  for (auto& [texture, lastUsed] : m_lastUsed)
+  {
+    loadedSize += texture->byteSize();
+    if (texture->usageCount() > 0u)
+    {
+      lastUsed = m_commitCount;
+    }
+    else
+    {
+      const auto [collectionIndex, textureIndex] = m_lazyTextures.at(texture);
+      unloadCandidates.push_back({collectionIndex, textureIndex, lastUsed});
+    }
+  }
+
+  if (loadedSize <= m_memoryBudget)
+  {
+    return;
+  }
+
+  std::sort(
+    std::begin(unloadCandidates),
+    std::end(unloadCandidates),
+    [](const auto& lhs, const auto& rhs) { return lhs.lastUsed < rhs.lastUsed; });
+
+  for (const auto& candidate : unloadCandidates)
+  {
+    if (loadedSize <= m_memoryBudget)
+    {
+      break;
+    }
+
+    auto& collection = m_collections[candidate.collectionIndex];
+    const auto& texture = collection.textures()[candidate.textureIndex];
+    loadedSize -= texture.byteSize();
+    m_lastUsed.erase(&texture);
+    collection.unloadTexture(candidate.textureIndex);
+  }
+}
+
+void TextureManager::logMemoryUsage(const TextureCollection& collection) const
+{
+  m_logger.info() << "Texture collection '" << collection.path() << "' uses "
+                  << formatByteSize(collection.gpuByteSize()) << " of video memory and "
+                  << formatByteSize(collection.cpuByteSize()) << " of main memory";
+}
+
 void TextureManager::updateTextures()
 {
   m_texturesByName.clear();
   m_textures.clear();
+  m_lazyTextures.clear();
 
-  for (auto& collection : m_collections)
+  for (size_t i = 0; i < m_collections.size(); ++i)
   {
-    for (auto& texture : collection.textures())
+    auto& textures = m_collections[i].textures();
+    for (size_t j = 0; j < textures.size(); ++j)
     {
+      auto& texture = textures[j];
+      if (texture.lazy())
+      {
+        m_lazyTextures[&texture] = {i, j};
+        texture.setRequestQueue(&m_requestQueue);
+        if (!texture.loaded() && (texture.requested() || texture.usageCount() > 0u))
+        {
+          m_requestQueue.add(texture);
+        }
+      }
+
       const auto key = kdl::str_to_lower(texture.name());
       texture.setOverridden(false);
 
@@ -251,6 +402,12 @@ void TextureManager::updateTextures()
   m_textures = kdl::vec_transform(kdl::map_values(m_texturesByName), [](auto* t) {
     return const_cast<const Texture*>(t);
   });
+
+  // forget the textures of removed collections
+  for (auto it = std::begin(m_lastUsed); it != std::end(m_lastUsed);)
+  {
+    it = m_lazyTextures.count(it->first) == 0u ? m_lastUsed.erase(it) : std::next(it);
+  }
 }
 } // namespace Assets
 } // namespace TrenchBroom
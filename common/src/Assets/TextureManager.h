@@ -23,6 +23,8 @@
 
 #include <map>
 #include <string>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom
@@ -40,6 +42,17 @@ namespace Assets
 class Texture;
 class TextureCollection;
 
+/**
+ * Manages the texture collections of a document and prepares their textures for
+ * rendering.
+ *
+ * Textures which are loaded lazily are only decoded and uploaded once they are needed,
+ * that is, when they are used by the map or when they were requested since the last call
+ * to commitChanges. Such textures add themselves to a request queue, and the needed
+ * textures are decoded in parallel and uploaded on the calling thread. If the loaded lazy
+ * textures exceed the memory budget, the least recently used ones that are not used by
+ * the map are unloaded again.
+ */
 class TextureManager
 {
 private:
@@ -59,6 +72,25 @@ private:
   int m_magFilter;
   bool m_resetTextureMode;
 
+  size_t m_memoryBudget;
+  size_t m_commitCount;
+
+  /**
+   * The lazily loaded textures which were requested or started being used since the last
+   * call to commitChanges.
+   */
+  TextureRequestQueue m_requestQueue;
+
+  /**
+   * The collection index and the texture index of every lazily loaded texture.
+   */
+  std::unordered_map<const Texture*, std::tuple<size_t, size_t>> m_lazyTextures;
+
+  /**
+   * The value of m_commitCount when each loaded lazy texture was last needed.
+   */
+  std::unordered_map<const Texture*, size_t> m_lastUsed;
+
 public:
   TextureManager(int magFilter, int minFilter, Logger& logger);
   ~TextureManager();
@@ -74,6 +106,13 @@ public:
   void clear();
 
   void setTextureMode(int minFilter, int magFilter);
+
+  /**
+   * Sets the number of bytes of video memory which the lazily loaded textures may occupy.
+   * A budget of 0 means that loaded textures are never unloaded.
+   */
+  void setMemoryBudget(size_t memoryBudget);
+
   void commitChanges();
 
   const Texture* texture(const std::string& name) const;
@@ -85,6 +124,8 @@ public:
 private:
   void resetTextureMode();
   void prepare();
+  void loadNeededTextures();
+  void logMemoryUsage(const TextureCollection& collection) const;
 
   void updateTextures();
 };
@@ -0,0 +1,52 @@
+/*
+ Copyright (C) 2022 TrenchBroom contributors
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BufferingLogger.h"
+
+#include <QString>
+
+#include <utility>
+
+namespace TrenchBroom
+{
+BufferingLogger::Messages BufferingLogger::takeMessages()
+{
+  auto lock = std::lock_guard<std::mutex>{m_mutex};
+  return std::exchange(m_messages, Messages{});
+}
+
+void BufferingLogger::flush(Logger& logger)
+{
+  for (const auto& [level, message] : takeMessages())
+  {
+    logger.log(level, message);
+  }
+}
+
+void BufferingLogger::doLog(const LogLevel level, const std::string& message)
+{
+  auto lock = std::lock_guard<std::mutex>{m_mutex};
+  m_messages.emplace_back(level, message);
+}
+
+void BufferingLogger::doLog(const LogLevel level, const QString& message)
+{
+  doLog(level, message.toStdString());
+}
+} // namespace TrenchBroom
@@ -0,0 +1,60 @@
+/*
+ Copyright (C) 2022 TrenchBroom contributors
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Logger.h"
+
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace TrenchBroom
+{
+/**
+ * Records logged messages so that they can be passed on to another logger later, e.g.
+ * on the main thread. Messages may be logged concurrently from several threads.
+ */
+class BufferingLogger : public Logger
+{
+public:
+  using Messages = std::vector<std::tuple<LogLevel, std::string>>;
+
+private:
+  std::mutex m_mutex;
+  Messages m_messages;
+
+public:
+  /**
+   * Returns the recorded messages in the order in which they were logged and clears
+   * them from this logger.
+   */
+  Messages takeMessages();
+
+  /**
+   * Passes the recorded messages on to the given logger and clears them from this logger.
+   */
+  void flush(Logger& logger);
+
+private:
+  void doLog(LogLevel level, const std::string& message) override;
+  void doLog(LogLevel level, const QString& message) override;
+};
+} // namespace TrenchBroom
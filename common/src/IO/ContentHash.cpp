@@ -0,0 +1,131 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ContentHash.h"
+
+#include <cstddef>
+
+namespace TrenchBroom
+{
+namespace IO
+{
+namespace
+{
+constexpr auto Prime1 = uint64_t(11400714785074694791u);
+constexpr auto Prime2 = uint64_t(14029467366897019727u);
+constexpr auto Prime3 = uint64_t(1609587929392839161u);
+constexpr auto Prime4 = uint64_t(9650029242287828579u);
+constexpr auto Prime5 = uint64_t(2870177450012600261u);
+
+uint64_t rotateLeft(const uint64_t value, const int count)
+{
+  return (value << count) | (value >> (64 - count));
+}
+
+/**
+ * Reads a little endian integer regardless of the byte order of the platform.
+ */
+template <typename T>
+T readLittleEndian(const unsigned char* bytes)
+{
+  auto result = T(0);
+  for (size_t i = 0; i < sizeof(T); ++i)
+  {
+    result |= T(bytes[i]) << (8u * i);
+  }
+  return result;
+}
+
+uint64_t round(uint64_t accumulator, const uint64_t input)
+{
+  accumulator += input * Prime2;
+  accumulator = rotateLeft(accumulator, 31);
+  return accumulator * Prime1;
+}
+
+uint64_t mergeRound(uint64_t accumulator, const uint64_t value)
+{
+  accumulator ^= round(0, value);
+  return accumulator * Prime1 + Prime4;
+}
+} // namespace
+
+uint64_t contentHash(const std::string_view bytes)
+{
+  const auto* cur = reinterpret_cast<const unsigned char*>(bytes.data());
+  const auto* end = cur + bytes.size();
+
+  auto hash = uint64_t(0);
+  if (bytes.size() >= 32u)
+  {
+    // process the input in stripes of 32 bytes using four independent accumulators
+    auto v1 = Prime1 + Prime2;
+    auto v2 = Prime2;
+    auto v3 = uint64_t(0);
+    auto v4 = uint64_t(0) - Prime1;
+    for (; end - cur >= 32; cur += 32)
+    {
+      v1 = round(v1, readLittleEndian<uint64_t>(cur));
+      v2 = round(v2, readLittleEndian<uint64_t>(cur + 8));
+      v3 = round(v3, readLittleEndian<uint64_t>(cur + 16));
+      v4 = round(v4, readLittleEndian<uint64_t>(cur + 24));
+    }
+
+    hash =
+      rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+    hash = mergeRound(hash, v1);
+    hash = mergeRound(hash, v2);
+    hash = mergeRound(hash, v3);
+    hash = mergeRound(hash, v4);
+  }
+  else
+  {
+    hash = Prime5;
+  }
+
+  hash += static_cast<uint64_t>(bytes.size());
+
+  // process the remaining bytes
+  for (; end - cur >= 8; cur += 8)
+  {
+    hash ^= round(0, readLittleEndian<uint64_t>(cur));
+    hash = rotateLeft(hash, 27) * Prime1 + Prime4;
+  }
+  if (end - cur >= 4)
+  {
+    hash ^= uint64_t(readLittleEndian<uint32_t>(cur)) * Prime1;
+    hash = rotateLeft(hash, 23) * Prime2 + Prime3;
+    cur += 4;
+  }
+  for (; cur != end; ++cur)
+  {
+    hash ^= uint64_t(*cur) * Prime5;
+    hash = rotateLeft(hash, 11) * Prime1;
+  }
+
+  // mix the bits of the final hash
+  hash ^= hash >> 33;
+  hash *= Prime2;
+  hash ^= hash >> 29;
+  hash *= Prime3;
+  hash ^= hash >> 32;
+  return hash;
+}
+} // namespace IO
+} // namespace TrenchBroom
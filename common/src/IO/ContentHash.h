@@ -0,0 +1,37 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace TrenchBroom
+{
+namespace IO
+{
+/**
+ * Computes the 64 bit xxHash (XXH64) of the given bytes with a seed of 0.
+ *
+ * Unlike std::hash, the result does not depend on the platform, the standard library or
+ * the process, so it can be stored in files and compared when they are read again.
+ */
+uint64_t contentHash(std::string_view bytes);
+} // namespace IO
+} // namespace TrenchBroom
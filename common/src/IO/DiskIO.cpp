@@ -25,12 +25,19 @@
 #include "IO/IOUtils.h"
 #include "IO/PathQt.h"
 
-#include <kdl/string_compare.h>
+#include <kdl/string_format.h>
 
+#include <algorithm>
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
+#include <QDateTime>
 #include <QDir>
+#include <QFile>
 #include <QFileInfo>
 
 namespace TrenchBroom
@@ -39,8 +46,114 @@ namespace IO
 {
 namespace Disk
 {
+namespace
+{
+/**
+ * The entries of a directory by their lower case names.
+ */
+struct DirectoryIndex
+{
+  qint64 modificationTime;
+  bool reliable;
+  std::unordered_map<std::string, std::vector<std::string>> entries;
+};
+
+/**
+ * Caches the indices of the directories whose entries were looked up without regard to
+ * case, so that repeated lookups in the same directory don't list it again.
+ *
+ * An index is rebuilt when the modification time of its directory changes, which happens
+ * when entries are added to, removed from or renamed in the directory. Since the
+ * modification time has a limited resolution, an index built less than a second after
+ * the directory was modified might miss subsequent modifications, and is also rebuilt
+ * the next time it is used.
+ *
+ * The cache is used from multiple threads when loading assets in parallel.
+ */
+class DirectoryIndexCache
+{
+private:
+  static constexpr auto ModificationTimeResolution = qint64(1000);
+
+  std::mutex m_mutex;
+  std::unordered_map<std::string, std::shared_ptr<const DirectoryIndex>> m_indices;
+
+public:
+  /**
+   * Returns the name of the entry of the given directory that matches the given name
+   * without regard to case, preferring an exact match. Returns an empty path if there is
+   * no such entry.
+   *
+   * @throw FileSystemException if the given path is not a directory
+   */
+  Path findEntry(const Path& directoryPath, const Path& name)
+  {
+    const auto index = findIndex(directoryPath);
+
+    const auto nameStr = name.asString();
+    const auto it = index->entries.find(kdl::str_to_lower(nameStr));
+    if (it == std::end(index->entries))
+    {
+      return Path{};
+    }
+
+    const auto& candidates = it->second;
+    return std::find(std::begin(candidates), std::end(candidates), nameStr)
+               != std::end(candidates)
+             ? name
+             : Path{candidates.front()};
+  }
+
+private:
+  std::shared_ptr<const DirectoryIndex> findIndex(const Path& directoryPath)
+  {
+    const auto directoryInfo = QFileInfo{pathAsQString(directoryPath)};
+    if (!directoryInfo.isDir())
+    {
+      throw FileSystemException(
+        "Cannot open directory: '" + directoryPath.asString() + "'");
+    }
+
+    const auto key = directoryPath.asString();
+    const auto modificationTime = directoryInfo.lastModified().toMSecsSinceEpoch();
+    {
+      const auto lock = std::lock_guard<std::mutex>{m_mutex};
+      const auto it = m_indices.find(key);
+      if (
+        it != std::end(m_indices) && it->second->reliable
+        && it->second->modificationTime == modificationTime)
+      {
+        return it->second;
+      }
+    }
+
+    auto index = std::make_shared<DirectoryIndex>();
+    index->modificationTime = modificationTime;
+    index->reliable = QDateTime::currentMSecsSinceEpoch() - modificationTime
+                      > ModificationTimeResolution;
+
+    auto dir = QDir{directoryInfo.absoluteFilePath()};
+    dir.setFilter(QDir::NoDotAndDotDot | QDir::AllEntries | QDir::Hidden | QDir::System);
+    for (const auto& entry : dir.entryList())
+    {
+      auto entryStr = pathFromQString(entry).asString();
+      index->entries[kdl::str_to_lower(entryStr)].push_back(std::move(entryStr));
+    }
+
+    const auto lock = std::lock_guard<std::mutex>{m_mutex};
+    m_indices[key] = index;
+    return index;
+  }
+};
+
+DirectoryIndexCache& directoryIndexCache()
+{
+  static auto cache = DirectoryIndexCache{};
+  return cache;
+}
+} // namespace
+
 bool doCheckCaseSensitive();
-Path findCaseSensitivePath(const std::vector<Path>& list, const Path& path);
 Path fixCase(const Path& path);
 
 bool doCheckCaseSensitive()
@@ -59,16 +172,6 @@ bool isCaseSensitive()
   return caseSensitive;
 }
 
-Path findCaseSensitivePath(const std::vector<Path>& list, const Path& path)
-{
-  for (const Path& entry : list)
-  {
-    if (kdl::ci::str_is_equal(entry.asString(), path.asString()))
-      return entry;
-  }
-  return Path("");
-}
-
 Path fixCase(const Path& path)
 {
   try
@@ -87,21 +190,15 @@ Path fixCase(const Path& path)
     if (remainder.isEmpty())
       return result;
 
+    // the entries of every directory are looked up in a cached index instead of checking
+    // whether they exist and listing the directory if they don't
+    auto& cache = directoryIndexCache();
     while (!remainder.isEmpty())
     {
-      const QString nextPathStr = pathAsQString(result + remainder.firstComponent());
-      if (!QFileInfo::exists(nextPathStr))
-      {
-        const std::vector<Path> content = getDirectoryContents(result);
-        const Path part = findCaseSensitivePath(content, remainder.firstComponent());
-        if (part.isEmpty())
-          return path;
-        result = result + part;
-      }
-      else
-      {
-        result = result + remainder.firstComponent();
-      }
+      const Path part = cache.findEntry(result, remainder.firstComponent());
+      if (part.isEmpty())
+        return path;
+      result = result + part;
       remainder = remainder.deleteFirstComponent();
     }
     return result;
@@ -169,6 +266,17 @@ std::shared_ptr<File> openFile(const Path& path)
   return std::make_shared<CFile>(fixedPath);
 }
 
+std::shared_ptr<File> openMappedFile(const Path& path)
+{
+  const Path fixedPath = fixPath(path);
+  if (!fileExists(fixedPath))
+  {
+    throw FileNotFoundException(fixedPath.asString());
+  }
+
+  return std::make_shared<MappedFile>(fixedPath);
+}
+
 std::string readTextFile(const Path& path)
 {
   const Path fixedPath = fixPath(path);
@@ -320,6 +428,35 @@ void moveFile(const Path& sourcePath, const Path& destPath, const bool overwrite
       + fixedDestPath.asString() + "'");
 }
 
+void touchFile(const Path& path)
+{
+  auto file = QFile{pathAsQString(fixPath(path))};
+  if (file.open(QIODevice::ReadWrite))
+  {
+    file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+  }
+}
+
+void trimDirectory(const Path& path, const size_t maxSize)
+{
+  const auto dir = QDir{pathAsQString(fixPath(path))};
+  if (!dir.exists())
+  {
+    return;
+  }
+
+  // keep the most recently modified files that fit into the given size
+  auto totalSize = size_t(0);
+  for (const auto& fileInfo : dir.entryInfoList(QDir::Files, QDir::Time))
+  {
+    totalSize += static_cast<size_t>(fileInfo.size());
+    if (totalSize > maxSize)
+    {
+      QFile::remove(fileInfo.absoluteFilePath());
+    }
+  }
+}
+
 IO::Path resolvePath(const std::vector<Path>& searchPaths, const Path& path)
 {
   if (path.isAbsolute())
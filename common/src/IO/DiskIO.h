@@ -41,6 +41,14 @@ bool fileExists(const Path& path);
 
 std::vector<Path> getDirectoryContents(const Path& path);
 std::shared_ptr<File> openFile(const Path& path);
+/**
+ * Opens the file at the given path and maps its contents into memory. Reading from the
+ * returned file does not copy the file contents into a separate buffer.
+ *
+ * @throw FileNotFoundException if the file does not exist
+ * @throw FileSystemException if the file cannot be opened or mapped
+ */
+std::shared_ptr<File> openMappedFile(const Path& path);
 std::string readTextFile(const Path& path);
 Path getCurrentWorkingDir();
 
@@ -145,6 +153,22 @@ void moveFilesRecursively(
     moveFile(filePath, destDirPath, overwrite);
 }
 
+/**
+ * Sets the modification time of the file at the given path to the current time. Does
+ * nothing if the file does not exist.
+ */
+void touchFile(const Path& path);
+
+/**
+ * Deletes the least recently modified files in the given directory until the total size
+ * of the remaining files does not exceed the given size. Subdirectories are not affected.
+ * Files which cannot be deleted are skipped.
+ *
+ * @param path the directory to trim
+ * @param maxSize the maximum total size of the files in bytes
+ */
+void trimDirectory(const Path& path, size_t maxSize);
+
 Path resolvePath(const std::vector<Path>& searchPaths, const Path& path);
 } // namespace Disk
 } // namespace IO
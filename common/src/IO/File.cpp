@@ -21,6 +21,9 @@
 
 #include "Exceptions.h"
 #include "IO/IOUtils.h"
+#include "IO/PathQt.h"
+
+#include <QFile>
 
 namespace TrenchBroom
 {
@@ -112,6 +115,48 @@ std::FILE* CFile::file() const
   return m_file;
 }
 
+MappedFile::MappedFile(const Path& path)
+  : File(path)
+  , m_file(std::make_unique<QFile>(pathAsQString(path)))
+  , m_begin(nullptr)
+  , m_end(nullptr)
+{
+  if (!m_file->open(QIODevice::ReadOnly))
+  {
+    throw FileSystemException("Cannot open file " + path.asString());
+  }
+
+  // mapping an empty file fails, but an empty file has no contents to map anyway
+  const auto size = m_file->size();
+  if (size > 0)
+  {
+    const auto* data = m_file->map(0, size);
+    if (data == nullptr)
+    {
+      throw FileSystemException(
+        "Cannot map file " + path.asString() + ": " + m_file->errorString().toStdString());
+    }
+    m_begin = reinterpret_cast<const char*>(data);
+    m_end = m_begin + size;
+  }
+}
+
+MappedFile::~MappedFile()
+{
+  // QFile unmaps all mapped regions when it is closed
+  m_file->close();
+}
+
+Reader MappedFile::reader() const
+{
+  return Reader::from(m_begin, m_end);
+}
+
+size_t MappedFile::size() const
+{
+  return static_cast<size_t>(m_end - m_begin);
+}
+
 FileView::FileView(
   const Path& path, std::shared_ptr<File> file, const size_t offset, const size_t length)
   : File(path)
@@ -25,6 +25,8 @@
 #include <cstdio>
 #include <memory>
 
+class QFile;
+
 namespace TrenchBroom
 {
 namespace IO
@@ -146,6 +148,37 @@ public:
   std::FILE* file() const;
 };
 
+/**
+ * A file that is backed by a physical file on the disk which is mapped into memory. The
+ * file is opened and mapped in the constructor and unmapped and closed in the destructor.
+ *
+ * Since the reader of this file accesses the mapped memory directly, buffering the reader
+ * does not copy the file contents. This is useful for large files that are parsed in
+ * place, such as map files.
+ */
+class MappedFile : public File
+{
+private:
+  std::unique_ptr<QFile> m_file;
+  const char* m_begin;
+  const char* m_end;
+
+public:
+  /**
+   * Creates a new file with the given path, opens the file for reading and maps its
+   * contents into memory.
+   *
+   * @param path the path of the file
+   *
+   * @throw FileSystemException if the file cannot be opened or mapped
+   */
+  explicit MappedFile(const Path& path);
+  ~MappedFile() override;
+
+  Reader reader() const override;
+  size_t size() const override;
+};
+
 /**
  * A file that is backed by a portion of a physical file.
  */
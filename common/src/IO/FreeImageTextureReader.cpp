@@ -26,6 +26,7 @@
 #include "FreeImage.h"
 #include "IO/File.h"
 #include "IO/ImageLoaderImpl.h"
+#include "IO/TextureCache.h"
 
 #include <kdl/invoke.h>
 
@@ -154,8 +155,12 @@ Assets::Texture FreeImageTextureReader::readTextureFromMemory(
 }
 
 FreeImageTextureReader::FreeImageTextureReader(
-  const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger)
+  const NameStrategy& nameStrategy,
+  const FileSystem& fs,
+  Logger& logger,
+  std::shared_ptr<const TextureCache> cache)
   : TextureReader(nameStrategy, fs, logger)
+  , m_cache{std::move(cache)}
 {
 }
 
@@ -163,15 +168,72 @@ Assets::Texture FreeImageTextureReader::doReadTexture(std::shared_ptr<File> file
 {
   auto reader = file->reader().buffer();
 
+  const auto& path = file->path();
+  const auto name = textureName(path);
+  const auto contents = reader.stringView();
+  if (m_cache)
+  {
+    if (auto texture = m_cache->read(path, contents, name))
+    {
+      return std::move(*texture);
+    }
+  }
+
   InitFreeImage::initialize();
 
-  const auto& path = file->path();
   const auto* begin = reader.begin();
   const auto* end = reader.end();
   const auto imageSize = static_cast<size_t>(end - begin);
   auto* imageBegin = reinterpret_cast<BYTE*>(const_cast<char*>(begin));
 
-  return readTextureFromMemory(textureName(path), imageBegin, imageSize);
+  auto texture = readTextureFromMemory(name, imageBegin, imageSize);
+  if (m_cache)
+  {
+    m_cache->write(path, contents, texture);
+  }
+  return texture;
+}
+
+Assets::Texture FreeImageTextureReader::doReadTextureInfo(
+  std::shared_ptr<File> file) const
+{
+  auto reader = file->reader().buffer();
+
+  InitFreeImage::initialize();
+
+  const auto* begin = reader.begin();
+  const auto* end = reader.end();
+  const auto imageSize = static_cast<DWORD>(end - begin);
+  auto* imageBegin = reinterpret_cast<BYTE*>(const_cast<char*>(begin));
+
+  auto* imageMemory = FreeImage_OpenMemory(imageBegin, imageSize);
+  auto memoryGuard = kdl::invoke_later{[&]() { FreeImage_CloseMemory(imageMemory); }};
+
+  // only the header is read if the image format supports it
+  const auto imageFormat = FreeImage_GetFileTypeFromMemory(imageMemory);
+  auto* image = FreeImage_LoadFromMemory(imageFormat, imageMemory, FIF_LOAD_NOPIXELS);
+  auto imageGuard = kdl::invoke_later{[&]() { FreeImage_Unload(image); }};
+
+  if (image == nullptr)
+  {
+    throw AssetException("FreeImage could not load image data");
+  }
+
+  const auto imageWidth = static_cast<size_t>(FreeImage_GetWidth(image));
+  const auto imageHeight = static_cast<size_t>(FreeImage_GetHeight(image));
+
+  if (!checkTextureDimensions(imageWidth, imageHeight))
+  {
+    throw AssetException("Invalid texture dimensions");
+  }
+
+  // whether the texture is masked is only known once its pixels have been read
+  return Assets::Texture{
+    textureName(file->path()),
+    imageWidth,
+    imageHeight,
+    freeImage32BPPFormatToGLFormat(),
+    Assets::TextureType::Opaque};
 }
 } // namespace IO
 } // namespace TrenchBroom
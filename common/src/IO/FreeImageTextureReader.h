@@ -39,20 +39,32 @@ namespace IO
 {
 class File;
 class FileSystem;
+class TextureCache;
 
 class FreeImageTextureReader : public TextureReader
 {
+private:
+  std::shared_ptr<const TextureCache> m_cache;
+
 public:
   static Color getAverageColor(const Assets::TextureBuffer& buffer, GLenum format);
 
   static Assets::Texture readTextureFromMemory(
     const std::string& name, const uint8_t* begin, size_t size);
 
+  /**
+   * Creates a texture reader. If a cache is given, decoded textures are read from and
+   * written to the cache.
+   */
   explicit FreeImageTextureReader(
-    const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger);
+    const NameStrategy& nameStrategy,
+    const FileSystem& fs,
+    Logger& logger,
+    std::shared_ptr<const TextureCache> cache = nullptr);
 
 private:
   Assets::Texture doReadTexture(std::shared_ptr<File> file) const override;
+  Assets::Texture doReadTextureInfo(std::shared_ptr<File> file) const override;
 };
 } // namespace IO
 } // namespace TrenchBroom
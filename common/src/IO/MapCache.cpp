@@ -0,0 +1,748 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapCache.h"
+
+#include "Color.h"
+#include "Exceptions.h"
+#include "IO/ContentHash.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/IOUtils.h"
+#include "IO/NodeSerializer.h"
+#include "IO/NodeWriter.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+#include "IO/SystemPaths.h"
+#include "Model/BezierPatch.h"
+#include "Model/Brush.h"
+#include "Model/BrushError.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/BrushNode.h"
+#include "Model/CompactBrushGeometry.h"
+#include "Model/EntityNode.h"
+#include "Model/EntityProperties.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/ParallelTexCoordSystem.h"
+#include "Model/ParaxialTexCoordSystem.h"
+#include "Model/PatchNode.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/overload.h>
+#include <kdl/parallel.h>
+#include <kdl/string_format.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+
+namespace TrenchBroom
+{
+namespace IO
+{
+namespace
+{
+constexpr auto Magic = std::string_view{"TBMC"};
+constexpr auto Version = uint32_t(2);
+
+enum class ObjectType : uint8_t
+{
+  Entity,
+  Brush,
+  Patch,
+};
+
+class CacheWriter
+{
+private:
+  std::string m_buffer;
+
+public:
+  const std::string& buffer() const { return m_buffer; }
+  std::string takeBuffer() { return std::move(m_buffer); }
+  size_t size() const { return m_buffer.size(); }
+
+  template <typename T>
+  void write(const T value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  /**
+   * Overwrites a size that was written at the given offset before, e.g. to fill in the
+   * number of elements after they have been written.
+   */
+  void writeSizeAt(const size_t offset, const size_t size)
+  {
+    const auto value = static_cast<uint64_t>(size);
+    assert(offset + sizeof(value) <= m_buffer.size());
+    std::memcpy(m_buffer.data() + offset, &value, sizeof(value));
+  }
+
+  void writeBytes(const std::string_view bytes) { m_buffer.append(bytes); }
+
+  void writeSize(const size_t size) { write(static_cast<uint64_t>(size)); }
+
+  void writeString(const std::string_view str)
+  {
+    writeSize(str.size());
+    writeBytes(str);
+  }
+
+  template <typename T, size_t S>
+  void writeVec(const vm::vec<T, S>& vec)
+  {
+    for (size_t i = 0; i < S; ++i)
+    {
+      write(vec[i]);
+    }
+  }
+
+  template <typename T>
+  void writeOptional(const std::optional<T>& value)
+  {
+    write(uint8_t(value ? 1 : 0));
+    if (value)
+    {
+      write(*value);
+    }
+  }
+
+  void writeOptionalSize(const std::optional<size_t>& value)
+  {
+    write(uint8_t(value ? 1 : 0));
+    if (value)
+    {
+      writeSize(*value);
+    }
+  }
+};
+
+class CacheReader
+{
+private:
+  Reader m_reader;
+
+public:
+  explicit CacheReader(Reader reader)
+    : m_reader{std::move(reader)}
+  {
+  }
+
+  template <typename T>
+  T read()
+  {
+    return m_reader.read<T, T>();
+  }
+
+  size_t readSize() { return static_cast<size_t>(read<uint64_t>()); }
+
+  /**
+   * Reads a number of elements and checks that the remaining data can contain that many
+   * elements of the given minimum size. This prevents allocating huge amounts of memory
+   * when reading a damaged cache file.
+   */
+  size_t readCount(const size_t minElementSize)
+  {
+    const auto count = readSize();
+    if (count > (m_reader.size() - m_reader.position()) / minElementSize)
+    {
+      throw ReaderException{"Invalid element count: " + std::to_string(count)};
+    }
+    return count;
+  }
+
+  std::string readString()
+  {
+    auto result = std::string(readCount(1u), '\0');
+    m_reader.read(result.data(), result.size());
+    return result;
+  }
+
+  template <typename T, size_t S>
+  vm::vec<T, S> readVec()
+  {
+    return m_reader.readVec<T, S>();
+  }
+
+  template <typename T>
+  std::optional<T> readOptional()
+  {
+    return read<uint8_t>() != 0 ? std::optional{read<T>()} : std::nullopt;
+  }
+
+  std::optional<size_t> readOptionalSize()
+  {
+    return read<uint8_t>() != 0 ? std::optional{readSize()} : std::nullopt;
+  }
+
+  bool eof() const { return m_reader.eof(); }
+};
+
+void writeHeader(
+  CacheWriter& writer,
+  const uint64_t contentHash,
+  const uint64_t contentSize,
+  const std::string& gameName,
+  const Model::MapFormat mapFormat,
+  const vm::bbox3& worldBounds)
+{
+  writer.writeBytes(Magic);
+  writer.write(Version);
+  writer.write(contentHash);
+  writer.write(contentSize);
+  writer.writeString(gameName);
+  writer.writeString(Model::formatName(mapFormat));
+  writer.writeVec(worldBounds.min);
+  writer.writeVec(worldBounds.max);
+}
+
+void writeBrushFace(CacheWriter& writer, const Model::BrushFace& face)
+{
+  writer.writeSize(face.lineNumber());
+  for (const auto& point : face.points())
+  {
+    writer.writeVec(point);
+  }
+
+  const auto& attributes = face.attributes();
+  writer.writeString(attributes.textureName());
+  writer.writeVec(attributes.offset());
+  writer.writeVec(attributes.scale());
+  writer.write(attributes.rotation());
+  writer.writeOptional(attributes.surfaceContents());
+  writer.writeOptional(attributes.surfaceFlags());
+  writer.writeOptional(attributes.surfaceValue());
+  writer.write(uint8_t(attributes.hasColor() ? 1 : 0));
+  if (attributes.hasColor())
+  {
+    writer.writeVec(static_cast<const vm::vec4f&>(*attributes.color()));
+  }
+
+  // only used for map formats with a parallel texture coordinate system
+  writer.writeVec(face.textureXAxis());
+  writer.writeVec(face.textureYAxis());
+}
+
+/**
+ * Writes the faces and the geometry of the given brush, but not its file position and
+ * parent, which are written by MapCacheSerializer::doBrush.
+ */
+std::string writeBrush(const Model::Brush& brush)
+{
+  auto writer = CacheWriter{};
+
+  writer.writeSize(brush.faceCount());
+  for (const auto& face : brush.faces())
+  {
+    writeBrushFace(writer, face);
+  }
+
+  const auto& geometry = brush.geometry();
+  writer.writeSize(geometry.vertexCount());
+  for (const auto& position : geometry.vertexPositions())
+  {
+    writer.writeVec(position);
+  }
+
+  for (size_t i = 0; i < geometry.faceCount(); ++i)
+  {
+    writer.writeSize(geometry.faceVertexCount(i));
+    for (auto it = geometry.faceVertexIndicesBegin(i),
+              end = geometry.faceVertexIndicesEnd(i);
+         it != end;
+         ++it)
+    {
+      writer.write(uint32_t(*it));
+    }
+  }
+
+  return writer.takeBuffer();
+}
+
+/**
+ * Writes the nodes of a world in the format expected by MapCache::read. NodeWriter visits
+ * the nodes in the same order and passes the same entity properties as when writing a map
+ * file, so reading the cache creates the same nodes as reading the map file would.
+ */
+class MapCacheSerializer : public NodeSerializer
+{
+private:
+  CacheWriter& m_writer;
+  size_t m_objectCountOffset;
+  size_t m_objectCount = 0u;
+  std::optional<size_t> m_entityIndex;
+  size_t m_propertyCountOffset = 0u;
+  size_t m_propertyCount = 0u;
+  std::unordered_map<const Model::BrushNode*, std::string> m_brushes;
+
+public:
+  MapCacheSerializer(CacheWriter& writer, const size_t objectCountOffset)
+    : m_writer{writer}
+    , m_objectCountOffset{objectCountOffset}
+  {
+  }
+
+private:
+  void doBeginFile(const std::vector<const Model::Node*>& rootNodes) override
+  {
+    auto brushNodes = std::vector<const Model::BrushNode*>{};
+    Model::Node::visitAll(
+      rootNodes,
+      kdl::overload(
+        [](auto&& thisLambda, const Model::WorldNode* world) {
+          world->visitChildren(thisLambda);
+        },
+        [](auto&& thisLambda, const Model::LayerNode* layer) {
+          layer->visitChildren(thisLambda);
+        },
+        [](auto&& thisLambda, const Model::GroupNode* group) {
+          group->visitChildren(thisLambda);
+        },
+        [](auto&& thisLambda, const Model::EntityNode* entity) {
+          entity->visitChildren(thisLambda);
+        },
+        [&](const Model::BrushNode* brushNode) { brushNodes.push_back(brushNode); },
+        [](const Model::PatchNode*) {}));
+
+    // the brushes make up most of the data, so they are serialized in parallel
+    auto brushes = kdl::vec_parallel_transform(
+      std::move(brushNodes), [](const Model::BrushNode* brushNode) {
+        return std::make_pair(brushNode, writeBrush(brushNode->brush()));
+      });
+    m_brushes = std::unordered_map<const Model::BrushNode*, std::string>{
+      std::make_move_iterator(brushes.begin()), std::make_move_iterator(brushes.end())};
+  }
+
+  void doEndFile() override { m_writer.writeSizeAt(m_objectCountOffset, m_objectCount); }
+
+  void doBeginEntity(const Model::Node* node) override
+  {
+    m_entityIndex = m_objectCount++;
+    m_writer.write(ObjectType::Entity);
+    m_writer.writeSize(node->lineNumber());
+    m_writer.writeSize(node->lineCount());
+    m_propertyCountOffset = m_writer.size();
+    m_propertyCount = 0u;
+    m_writer.writeSize(m_propertyCount);
+  }
+
+  void doEndEntity(const Model::Node*) override
+  {
+    m_writer.writeSizeAt(m_propertyCountOffset, m_propertyCount);
+    m_entityIndex = std::nullopt;
+  }
+
+  void doEntityProperty(const Model::EntityProperty& property) override
+  {
+    m_writer.writeString(property.key());
+    m_writer.writeString(property.value());
+    ++m_propertyCount;
+  }
+
+  void doBrush(const Model::BrushNode* brushNode) override
+  {
+    ++m_objectCount;
+    m_writer.write(ObjectType::Brush);
+    m_writer.writeSize(brushNode->lineNumber());
+    m_writer.writeSize(brushNode->lineCount());
+    m_writer.writeOptionalSize(m_entityIndex);
+    m_writer.writeBytes(m_brushes.at(brushNode));
+  }
+
+  void doBrushFace(const Model::BrushFace&) override {}
+
+  void doPatch(const Model::PatchNode* patchNode) override
+  {
+    const auto& patch = patchNode->patch();
+
+    ++m_objectCount;
+    m_writer.write(ObjectType::Patch);
+    m_writer.writeSize(patchNode->lineNumber());
+    m_writer.writeSize(patchNode->lineCount());
+    m_writer.writeOptionalSize(m_entityIndex);
+    m_writer.writeSize(patch.pointRowCount());
+    m_writer.writeSize(patch.pointColumnCount());
+    m_writer.writeSize(patch.controlPoints().size());
+    for (const auto& controlPoint : patch.controlPoints())
+    {
+      m_writer.writeVec(controlPoint);
+    }
+    m_writer.writeString(patch.textureName());
+  }
+};
+
+MapReader::EntityInfo readEntityInfo(CacheReader& reader)
+{
+  const auto startLine = reader.readSize();
+  const auto lineCount = reader.readSize();
+
+  auto properties = std::vector<Model::EntityProperty>{};
+  properties.reserve(reader.readCount(2u * sizeof(uint64_t)));
+  for (size_t i = 0; i < properties.capacity(); ++i)
+  {
+    auto key = reader.readString();
+    auto value = reader.readString();
+    properties.emplace_back(std::move(key), std::move(value));
+  }
+
+  return MapReader::EntityInfo{std::move(properties), startLine, lineCount};
+}
+
+Model::BrushFace readBrushFace(CacheReader& reader, const Model::MapFormat mapFormat)
+{
+  const auto lineNumber = reader.readSize();
+  const auto point0 = reader.readVec<FloatType, 3>();
+  const auto point1 = reader.readVec<FloatType, 3>();
+  const auto point2 = reader.readVec<FloatType, 3>();
+
+  auto attributes = Model::BrushFaceAttributes{reader.readString()};
+  attributes.setOffset(reader.readVec<float, 2>());
+  attributes.setScale(reader.readVec<float, 2>());
+  attributes.setRotation(reader.read<float>());
+  attributes.setSurfaceContents(reader.readOptional<int>());
+  attributes.setSurfaceFlags(reader.readOptional<int>());
+  attributes.setSurfaceValue(reader.readOptional<float>());
+  if (reader.read<uint8_t>() != 0)
+  {
+    attributes.setColor(Color{reader.readVec<float, 4>()});
+  }
+
+  const auto xAxis = reader.readVec<FloatType, 3>();
+  const auto yAxis = reader.readVec<FloatType, 3>();
+  auto texCoordSystem =
+    Model::isParallelTexCoordSystem(mapFormat)
+      ? std::unique_ptr<Model::TexCoordSystem>{std::make_unique<
+        Model::ParallelTexCoordSystem>(xAxis, yAxis)}
+      : std::unique_ptr<Model::TexCoordSystem>{
+        std::make_unique<Model::ParaxialTexCoordSystem>(
+          point0, point1, point2, attributes)};
+
+  return Model::BrushFace::create(
+           point0, point1, point2, attributes, std::move(texCoordSystem))
+    .visit(kdl::overload(
+      [&](Model::BrushFace&& face) {
+        face.setFilePosition(lineNumber, 1u);
+        return std::move(face);
+      },
+      [](const Model::BrushError e) -> Model::BrushFace {
+        throw ReaderException{kdl::str_to_string("Invalid brush face: ", e)};
+      }));
+}
+
+/**
+ * Checks that the given geometry info describes a closed polyhedron with the given
+ * number of faces, see the corresponding constructor of Model::CompactBrushGeometry.
+ */
+bool isValidGeometry(
+  const MapReader::BrushGeometryInfo& geometryInfo, const size_t faceCount)
+{
+  if (geometryInfo.faceVertexIndices.size() != faceCount)
+  {
+    return false;
+  }
+
+  auto halfEdges = std::vector<std::tuple<size_t, size_t>>{};
+  for (const auto& indices : geometryInfo.faceVertexIndices)
+  {
+    if (indices.size() < 3u)
+    {
+      return false;
+    }
+
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      const auto origin = indices[i];
+      const auto destination = indices[(i + 1u) % indices.size()];
+      if (
+        origin >= geometryInfo.vertices.size()
+        || destination >= geometryInfo.vertices.size() || origin == destination)
+      {
+        return false;
+      }
+      halfEdges.emplace_back(origin, destination);
+    }
+  }
+
+  // every half edge must be unique and must have a twin
+  std::sort(halfEdges.begin(), halfEdges.end());
+  if (std::adjacent_find(halfEdges.begin(), halfEdges.end()) != halfEdges.end())
+  {
+    return false;
+  }
+
+  return std::all_of(halfEdges.begin(), halfEdges.end(), [&](const auto& halfEdge) {
+    const auto& [origin, destination] = halfEdge;
+    return std::binary_search(
+      halfEdges.begin(), halfEdges.end(), std::make_tuple(destination, origin));
+  });
+}
+
+MapReader::BrushInfo readBrushInfo(CacheReader& reader, const Model::MapFormat mapFormat)
+{
+  const auto startLine = reader.readSize();
+  const auto lineCount = reader.readSize();
+  const auto parentIndex = reader.readOptionalSize();
+
+  auto faces = std::vector<Model::BrushFace>{};
+  faces.reserve(reader.readCount(sizeof(uint64_t)));
+  for (size_t i = 0; i < faces.capacity(); ++i)
+  {
+    faces.push_back(readBrushFace(reader, mapFormat));
+  }
+
+  auto geometry = MapReader::BrushGeometryInfo{};
+  geometry.vertices.reserve(reader.readCount(3u * sizeof(FloatType)));
+  for (size_t i = 0; i < geometry.vertices.capacity(); ++i)
+  {
+    geometry.vertices.push_back(reader.readVec<FloatType, 3>());
+  }
+
+  geometry.faceVertexIndices.reserve(faces.size());
+  for (size_t i = 0; i < faces.size(); ++i)
+  {
+    auto& indices = geometry.faceVertexIndices.emplace_back();
+    indices.reserve(reader.readCount(sizeof(uint32_t)));
+    for (size_t j = 0; j < indices.capacity(); ++j)
+    {
+      indices.push_back(size_t(reader.read<uint32_t>()));
+    }
+  }
+
+  if (!isValidGeometry(geometry, faces.size()))
+  {
+    throw ReaderException{"Invalid brush geometry"};
+  }
+
+  return MapReader::BrushInfo{
+    std::move(faces), startLine, lineCount, parentIndex, std::move(geometry)};
+}
+
+MapReader::PatchInfo readPatchInfo(CacheReader& reader)
+{
+  const auto startLine = reader.readSize();
+  const auto lineCount = reader.readSize();
+  const auto parentIndex = reader.readOptionalSize();
+  const auto rowCount = reader.readSize();
+  const auto columnCount = reader.readSize();
+
+  auto controlPoints = std::vector<Model::BezierPatch::Point>{};
+  controlPoints.reserve(reader.readCount(5u * sizeof(FloatType)));
+  for (size_t i = 0; i < controlPoints.capacity(); ++i)
+  {
+    controlPoints.push_back(reader.readVec<FloatType, 5>());
+  }
+
+  if (rowCount < 3u || columnCount < 3u || controlPoints.size() != rowCount * columnCount)
+  {
+    throw ReaderException{"Invalid patch"};
+  }
+
+  auto textureName = reader.readString();
+  return MapReader::PatchInfo{
+    rowCount,
+    columnCount,
+    std::move(controlPoints),
+    std::move(textureName),
+    startLine,
+    lineCount,
+    parentIndex};
+}
+
+/**
+ * Checks that every parent index refers to a preceding entity.
+ */
+bool hasValidParentIndices(const std::vector<MapReader::ObjectInfo>& objectInfos)
+{
+  for (size_t i = 0; i < objectInfos.size(); ++i)
+  {
+    const auto parentIndex = std::visit(
+      kdl::overload(
+        [](const MapReader::EntityInfo&) -> std::optional<size_t> {
+          return std::nullopt;
+        },
+        [](const auto& info) { return info.parentIndex; }),
+      objectInfos[i]);
+    if (
+      parentIndex
+      && (*parentIndex >= i
+          || !std::holds_alternative<MapReader::EntityInfo>(
+            objectInfos[*parentIndex])))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+MapCache::MapCache(
+  Path path,
+  const std::string_view mapFileContents,
+  std::string gameName,
+  const Model::MapFormat mapFormat,
+  const vm::bbox3& worldBounds)
+  : m_path{std::move(path)}
+  , m_contentHash{contentHash(mapFileContents)}
+  , m_contentSize{static_cast<uint64_t>(mapFileContents.size())}
+  , m_gameName{std::move(gameName)}
+  , m_mapFormat{mapFormat}
+  , m_worldBounds{worldBounds}
+{
+}
+
+const Path& MapCache::path() const
+{
+  return m_path;
+}
+
+std::optional<std::tuple<Model::MapFormat, std::vector<MapReader::ObjectInfo>>> MapCache::
+  read() const
+{
+  if (!Disk::fileExists(m_path))
+  {
+    return std::nullopt;
+  }
+
+  try
+  {
+    auto objectInfos = std::vector<MapReader::ObjectInfo>{};
+    auto mapFormat = Model::MapFormat::Unknown;
+    {
+      // the file is only mapped and not read into memory as a whole
+      const auto file = Disk::openMappedFile(m_path);
+      auto reader = CacheReader{file->reader()};
+
+      auto expectedHeader = CacheWriter{};
+      writeHeader(
+        expectedHeader,
+        m_contentHash,
+        m_contentSize,
+        m_gameName,
+        m_mapFormat,
+        m_worldBounds);
+      for (const auto c : expectedHeader.buffer())
+      {
+        if (reader.read<char>() != c)
+        {
+          return std::nullopt;
+        }
+      }
+
+      mapFormat = Model::formatFromName(reader.readString());
+      if (mapFormat == Model::MapFormat::Unknown)
+      {
+        return std::nullopt;
+      }
+
+      objectInfos.reserve(reader.readCount(1u));
+      for (size_t i = 0; i < objectInfos.capacity(); ++i)
+      {
+        switch (reader.read<ObjectType>())
+        {
+        case ObjectType::Entity:
+          objectInfos.emplace_back(readEntityInfo(reader));
+          break;
+        case ObjectType::Brush:
+          objectInfos.emplace_back(readBrushInfo(reader, mapFormat));
+          break;
+        case ObjectType::Patch:
+          objectInfos.emplace_back(readPatchInfo(reader));
+          break;
+        default:
+          return std::nullopt;
+        }
+      }
+
+      if (!reader.eof() || !hasValidParentIndices(objectInfos))
+      {
+        return std::nullopt;
+      }
+    }
+
+    // mark the cache file as recently used so that it is kept when trimming the cache
+    Disk::touchFile(m_path);
+    return std::make_tuple(mapFormat, std::move(objectInfos));
+  }
+  catch (const Exception&)
+  {
+    // the cache file is damaged, or it was written by a different version
+    return std::nullopt;
+  }
+}
+
+std::string MapCache::serialize(const Model::WorldNode& world) const
+{
+  auto writer = CacheWriter{};
+  writeHeader(
+    writer, m_contentHash, m_contentSize, m_gameName, m_mapFormat, m_worldBounds);
+  writer.writeString(Model::formatName(world.mapFormat()));
+
+  // the number of objects is filled in by the serializer
+  const auto objectCountOffset = writer.size();
+  writer.writeSize(0u);
+
+  auto nodeWriter =
+    NodeWriter{world, std::make_unique<MapCacheSerializer>(writer, objectCountOffset)};
+  nodeWriter.writeMap();
+
+  return writer.takeBuffer();
+}
+
+void MapCache::write(const std::string& data) const
+{
+  // write to a temporary file first so that a partially written cache file is never read
+  Disk::ensureDirectoryExists(m_path.deleteLastComponent());
+  const auto tempPath = m_path.replaceExtension("tmp");
+  {
+    auto stream = openPathAsOutputStream(tempPath, std::ios::out | std::ios::binary);
+    stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!stream)
+    {
+      throw FileSystemException{"Could not write file '" + tempPath.asString() + "'"};
+    }
+  }
+  Disk::moveFile(tempPath, m_path, true);
+}
+
+Path mapCacheDirectory()
+{
+  return SystemPaths::userDataDirectory() + Path{"Map Cache"};
+}
+
+Path mapCachePath(const Path& mapFilePath)
+{
+  auto fileName = std::stringstream{};
+  fileName << std::hex << std::setw(16) << std::setfill('0')
+           << contentHash(mapFilePath.asString()) << ".tbcache";
+  return mapCacheDirectory() + Path{fileName.str()};
+}
+} // namespace IO
+} // namespace TrenchBroom
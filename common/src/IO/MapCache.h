@@ -0,0 +1,129 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FloatType.h"
+#include "IO/MapReader.h"
+#include "IO/Path.h"
+
+#include <vecmath/bbox.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+enum class MapFormat;
+class WorldNode;
+} // namespace Model
+
+namespace IO
+{
+/**
+ * A binary file that stores the entities, brushes and patches of a loaded map, including
+ * the geometry of its brushes. Reading a map from its cache skips both parsing the map
+ * file and computing the brush geometry.
+ *
+ * The cache is written from the nodes of a world after it was read from the map file,
+ * and it is read back into the same object infos that a MapReader creates when parsing
+ * the map file.
+ *
+ * A cache file is only used if it was written for the same map file contents, game, map
+ * format and world bounds. This is checked by comparing a hash and the size of the map
+ * file contents and the other parameters with the values that were stored in the cache
+ * file when it was written.
+ */
+class MapCache
+{
+private:
+  Path m_path;
+  uint64_t m_contentHash;
+  uint64_t m_contentSize;
+  std::string m_gameName;
+  Model::MapFormat m_mapFormat;
+  vm::bbox3 m_worldBounds;
+
+public:
+  /**
+   * Creates a cache for the given map file contents which is stored at the given path.
+   *
+   * @param path the path of the cache file
+   * @param mapFileContents the contents of the map file
+   * @param gameName the name of the game that the map belongs to
+   * @param mapFormat the map format requested when reading the map file, which may be
+   * unknown
+   * @param worldBounds the world bounds
+   */
+  MapCache(
+    Path path,
+    std::string_view mapFileContents,
+    std::string gameName,
+    Model::MapFormat mapFormat,
+    const vm::bbox3& worldBounds);
+
+  const Path& path() const;
+
+  /**
+   * Reads the map format of the cached map and the cached object infos. Returns nullopt
+   * if the cache file does not exist, if it was written for different parameters or if it
+   * cannot be read.
+   *
+   * Reading a cache file updates its modification time so that it is kept when the cache
+   * directory is trimmed, see Disk::trimDirectory.
+   */
+  std::optional<std::tuple<Model::MapFormat, std::vector<MapReader::ObjectInfo>>> read()
+    const;
+
+  /**
+   * Returns the contents of a cache file for the given world, which must have been read
+   * from the map file contents that this cache was created for.
+   *
+   * The world must not be modified while it is being serialized, but the returned data
+   * can be written to the cache file on any thread.
+   */
+  std::string serialize(const Model::WorldNode& world) const;
+
+  /**
+   * Writes the given data returned by serialize to the cache file, replacing any existing
+   * cache file.
+   *
+   * @throws FileSystemException if the cache file cannot be written
+   */
+  void write(const std::string& data) const;
+};
+
+/**
+ * Returns the directory in the user data directory where map cache files are stored.
+ */
+Path mapCacheDirectory();
+
+/**
+ * Returns the path of the cache file for the map file at the given path. Cache files are
+ * stored in the map cache directory and not next to the map files.
+ */
+Path mapCachePath(const Path& mapFilePath);
+} // namespace IO
+} // namespace TrenchBroom
@@ -53,8 +53,8 @@ namespace IO
 class QuakeFileSerializer : public MapFileSerializer
 {
 public:
-  explicit QuakeFileSerializer(std::ostream& stream)
-    : MapFileSerializer(stream)
+  QuakeFileSerializer(const Model::MapFormat mapFormat, std::ostream& stream)
+    : MapFileSerializer(mapFormat, stream)
   {
   }
 
@@ -145,8 +145,8 @@ protected:
 class Quake2FileSerializer : public QuakeFileSerializer
 {
 public:
-  explicit Quake2FileSerializer(std::ostream& stream)
-    : QuakeFileSerializer(stream)
+  Quake2FileSerializer(const Model::MapFormat mapFormat, std::ostream& stream)
+    : QuakeFileSerializer(mapFormat, stream)
   {
   }
 
@@ -179,8 +179,8 @@ protected:
 class Quake2ValveFileSerializer : public Quake2FileSerializer
 {
 public:
-  explicit Quake2ValveFileSerializer(std::ostream& stream)
-    : Quake2FileSerializer(stream)
+  Quake2ValveFileSerializer(const Model::MapFormat mapFormat, std::ostream& stream)
+    : Quake2FileSerializer(mapFormat, stream)
   {
   }
 
@@ -205,8 +205,8 @@ private:
   std::string SurfaceColorFormat;
 
 public:
-  explicit DaikatanaFileSerializer(std::ostream& stream)
-    : Quake2FileSerializer(stream)
+  DaikatanaFileSerializer(const Model::MapFormat mapFormat, std::ostream& stream)
+    : Quake2FileSerializer(mapFormat, stream)
     , SurfaceColorFormat(" %d %d %d")
   {
   }
@@ -244,8 +244,8 @@ protected:
 class Hexen2FileSerializer : public QuakeFileSerializer
 {
 public:
-  explicit Hexen2FileSerializer(std::ostream& stream)
-    : QuakeFileSerializer(stream)
+  Hexen2FileSerializer(const Model::MapFormat mapFormat, std::ostream& stream)
+    : QuakeFileSerializer(mapFormat, stream)
   {
   }
 
@@ -262,8 +262,8 @@ private:
 class ValveFileSerializer : public QuakeFileSerializer
 {
 public:
-  explicit ValveFileSerializer(std::ostream& stream)
-    : QuakeFileSerializer(stream)
+  ValveFileSerializer(const Model::MapFormat mapFormat, std::ostream& stream)
+    : QuakeFileSerializer(mapFormat, stream)
   {
   }
 
@@ -282,29 +282,31 @@ std::unique_ptr<NodeSerializer> MapFileSerializer::create(
   switch (format)
   {
   case Model::MapFormat::Standard:
-    return std::make_unique<QuakeFileSerializer>(stream);
+    return std::make_unique<QuakeFileSerializer>(format, stream);
   case Model::MapFormat::Quake2:
     // TODO 2427: Implement Quake3 serializers and use them
   case Model::MapFormat::Quake3:
   case Model::MapFormat::Quake3_Legacy:
-    return std::make_unique<Quake2FileSerializer>(stream);
+    return std::make_unique<Quake2FileSerializer>(format, stream);
   case Model::MapFormat::Quake2_Valve:
   case Model::MapFormat::Quake3_Valve:
-    return std::make_unique<Quake2ValveFileSerializer>(stream);
+    return std::make_unique<Quake2ValveFileSerializer>(format, stream);
   case Model::MapFormat::Daikatana:
-    return std::make_unique<DaikatanaFileSerializer>(stream);
+    return std::make_unique<DaikatanaFileSerializer>(format, stream);
   case Model::MapFormat::Valve:
-    return std::make_unique<ValveFileSerializer>(stream);
+    return std::make_unique<ValveFileSerializer>(format, stream);
   case Model::MapFormat::Hexen2:
-    return std::make_unique<Hexen2FileSerializer>(stream);
+    return std::make_unique<Hexen2FileSerializer>(format, stream);
   case Model::MapFormat::Unknown:
     throw FileFormatException("Unknown map file format");
     switchDefault();
   }
 }
 
-MapFileSerializer::MapFileSerializer(std::ostream& stream)
-  : m_line(1)
+MapFileSerializer::MapFileSerializer(
+  const Model::MapFormat mapFormat, std::ostream& stream)
+  : m_mapFormat(mapFormat)
+  , m_line(1)
   , m_stream(stream)
 {
 }
@@ -336,17 +338,26 @@ void MapFileSerializer::doBeginFile(const std::vector<const Model::Node*>& rootN
       [&](const Model::BrushNode* brush) { nodesToSerialize.push_back(brush); },
       [&](const Model::PatchNode* patchNode) { nodesToSerialize.push_back(patchNode); }));
 
-  // serialize brushes to strings in parallel
-  using Entry = std::pair<const Model::Node*, PrecomputedString>;
+  // serialize brushes to strings in parallel, reusing the text cached by nodes which
+  // haven't changed since they were last serialized
+  using Entry = std::pair<const Model::Node*, const Model::SerializedNodeText*>;
   std::vector<Entry> result =
     kdl::vec_parallel_transform(std::move(nodesToSerialize), [&](const auto& node) {
       return std::visit(
         kdl::overload(
           [&](const Model::BrushNode* brushNode) {
-            return Entry{brushNode, writeBrushFaces(brushNode->brush())};
+            if (!brushNode->serializedText(m_mapFormat))
+            {
+              brushNode->setSerializedText(writeBrushFaces(brushNode->brush()));
+            }
+            return Entry{brushNode, brushNode->serializedText(m_mapFormat)};
           },
           [&](const Model::PatchNode* patchNode) {
-            return Entry{patchNode, writePatch(patchNode->patch())};
+            if (!patchNode->serializedText(m_mapFormat))
+            {
+              patchNode->setSerializedText(writePatch(patchNode->patch()));
+            }
+            return Entry{patchNode, patchNode->serializedText(m_mapFormat)};
           }),
         node);
     });
@@ -399,8 +410,8 @@ void MapFileSerializer::doBrush(const Model::BrushNode* brush)
   ensure(
     it != std::end(m_nodeToPrecomputedString),
     "attempted to serialize a brush which was not passed to doBeginFile");
-  const PrecomputedString& precomputedString = it->second;
-  m_stream << precomputedString.string;
+  const Model::SerializedNodeText& precomputedString = *it->second;
+  m_stream << precomputedString.text;
   m_line += precomputedString.lineCount;
 
   fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "}}\n");
@@ -427,8 +438,8 @@ void MapFileSerializer::doPatch(const Model::PatchNode* patchNode)
   ensure(
     it != std::end(m_nodeToPrecomputedString),
     "attempted to serialize a patch which was not passed to doBeginFile");
-  const PrecomputedString& precomputedString = it->second;
-  m_stream << precomputedString.string;
+  const Model::SerializedNodeText& precomputedString = *it->second;
+  m_stream << precomputedString.text;
   m_line += precomputedString.lineCount;
 
   setFilePosition(patchNode);
@@ -451,7 +462,7 @@ size_t MapFileSerializer::startLine()
 /**
  * Threadsafe
  */
-MapFileSerializer::PrecomputedString MapFileSerializer::writeBrushFaces(
+Model::SerializedNodeText MapFileSerializer::writeBrushFaces(
   const Model::Brush& brush) const
 {
   std::stringstream stream;
@@ -459,10 +470,10 @@ MapFileSerializer::PrecomputedString MapFileSerializer::writeBrushFaces(
   {
     doWriteBrushFace(stream, face);
   }
-  return PrecomputedString{stream.str(), brush.faces().size()};
+  return Model::SerializedNodeText{m_mapFormat, stream.str(), brush.faces().size()};
 }
 
-MapFileSerializer::PrecomputedString MapFileSerializer::writePatch(
+Model::SerializedNodeText MapFileSerializer::writePatch(
   const Model::BezierPatch& patch) const
 {
   size_t lineCount = 0u;
@@ -511,7 +522,7 @@ MapFileSerializer::PrecomputedString MapFileSerializer::writePatch(
   fmt::format_to(std::ostreambuf_iterator<char>(stream), "}}\n");
   ++lineCount;
 
-  return PrecomputedString{stream.str(), lineCount};
+  return Model::SerializedNodeText{m_mapFormat, stream.str(), lineCount};
 }
 } // namespace IO
 } // namespace TrenchBroom
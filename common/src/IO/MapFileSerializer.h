@@ -21,6 +21,7 @@
 
 #include "IO/NodeSerializer.h"
 #include "Model/MapFormat.h"
+#include "Model/SerializedNodeText.h"
 
 #include <iosfwd>
 #include <memory>
@@ -45,23 +46,20 @@ class MapFileSerializer : public NodeSerializer
 {
 private:
   using LineStack = std::vector<size_t>;
+  Model::MapFormat m_mapFormat;
   LineStack m_startLineStack;
   size_t m_line;
   std::ostream& m_stream;
 
-  struct PrecomputedString
-  {
-    std::string string;
-    size_t lineCount;
-  };
-  std::unordered_map<const Model::Node*, PrecomputedString> m_nodeToPrecomputedString;
+  std::unordered_map<const Model::Node*, const Model::SerializedNodeText*>
+    m_nodeToPrecomputedString;
 
 public:
   static std::unique_ptr<NodeSerializer> create(
     Model::MapFormat format, std::ostream& stream);
 
 protected:
-  explicit MapFileSerializer(std::ostream& stream);
+  MapFileSerializer(Model::MapFormat mapFormat, std::ostream& stream);
 
 private:
   void doBeginFile(const std::vector<const Model::Node*>& rootNodes) override;
@@ -82,8 +80,8 @@ private:
 private: // threadsafe
   virtual void doWriteBrushFace(
     std::ostream& stream, const Model::BrushFace& face) const = 0;
-  PrecomputedString writeBrushFaces(const Model::Brush& brush) const;
-  PrecomputedString writePatch(const Model::BezierPatch& patch) const;
+  Model::SerializedNodeText writeBrushFaces(const Model::Brush& brush) const;
+  Model::SerializedNodeText writePatch(const Model::BezierPatch& patch) const;
 };
 } // namespace IO
 } // namespace TrenchBroom
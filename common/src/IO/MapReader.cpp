@@ -19,10 +19,12 @@
 
 #include "MapReader.h"
 
+#include "IO/BufferedParserStatus.h"
 #include "IO/ParserStatus.h"
 #include "Model/BrushError.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushNode.h"
+#include "Model/CompactBrushGeometry.h"
 #include "Model/Entity.h"
 #include "Model/EntityNode.h"
 #include "Model/EntityProperties.h"
@@ -37,6 +39,7 @@
 #include <vecmath/mat.h>
 #include <vecmath/mat_io.h>
 
+#include <kdl/overload.h>
 #include <kdl/parallel.h>
 #include <kdl/result.h>
 #include <kdl/result_for_each.h>
@@ -44,7 +47,9 @@
 #include <kdl/string_utils.h>
 #include <kdl/vector_utils.h>
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -60,7 +65,21 @@ MapReader::MapReader(
   const Model::MapFormat sourceMapFormat,
   const Model::MapFormat targetMapFormat,
   const Model::EntityPropertyConfig& entityPropertyConfig)
-  : StandardMapParser(std::move(str), sourceMapFormat, targetMapFormat)
+  : StandardMapParser(str, sourceMapFormat, targetMapFormat)
+  , m_str{str}
+  , m_entityPropertyConfig{entityPropertyConfig}
+{
+}
+
+MapReader::MapReader(
+  std::string_view str,
+  const size_t line,
+  const size_t column,
+  const Model::MapFormat sourceMapFormat,
+  const Model::MapFormat targetMapFormat,
+  const Model::EntityPropertyConfig& entityPropertyConfig)
+  : StandardMapParser(str, line, column, sourceMapFormat, targetMapFormat)
+  , m_str{str}
   , m_entityPropertyConfig{entityPropertyConfig}
 {
 }
@@ -68,10 +87,27 @@ MapReader::MapReader(
 void MapReader::readEntities(const vm::bbox3& worldBounds, ParserStatus& status)
 {
   m_worldBounds = worldBounds;
-  parseEntities(status);
+  m_parsedChunkCount = 0u;
+  if (!parseEntitiesInParallel(status))
+  {
+    parseEntities(status);
+  }
   createNodes(status);
 }
 
+void MapReader::readObjectInfos(
+  std::vector<ObjectInfo> objectInfos, const vm::bbox3& worldBounds, ParserStatus& status)
+{
+  m_worldBounds = worldBounds;
+  m_objectInfos = std::move(objectInfos);
+  createNodes(status);
+}
+
+size_t MapReader::parsedChunkCount() const
+{
+  return m_parsedChunkCount;
+}
+
 void MapReader::readBrushes(const vm::bbox3& worldBounds, ParserStatus& status)
 {
   m_worldBounds = worldBounds;
@@ -88,12 +124,12 @@ void MapReader::readBrushFaces(const vm::bbox3& worldBounds, ParserStatus& statu
 // implement MapParser interface
 
 void MapReader::onBeginEntity(
-  const size_t /* line */,
+  const size_t line,
   std::vector<Model::EntityProperty> properties,
   ParserStatus& /* status */)
 {
   m_currentEntityInfo = m_objectInfos.size();
-  m_objectInfos.push_back(EntityInfo{std::move(properties), 0, 0});
+  m_objectInfos.push_back(EntityInfo{std::move(properties), line, 0});
 }
 
 void MapReader::onEndEntity(
@@ -187,6 +223,185 @@ void MapReader::onPatch(
 
 // helper methods
 
+/**
+ * Parses a chunk of a map file into object infos. If the chunk starts inside of an
+ * entity, the object infos are prefixed with a placeholder for that entity so that the
+ * parent indices of its brushes and patches can be remapped when the chunks are merged.
+ */
+class MapReader::EntityChunkReader : public MapReader
+{
+private:
+  std::optional<size_t> m_entityCloseLine;
+
+public:
+  EntityChunkReader(
+    const MapChunk& chunk,
+    const Model::MapFormat sourceMapFormat,
+    const Model::MapFormat targetMapFormat,
+    const Model::EntityPropertyConfig& entityPropertyConfig)
+    : MapReader{
+      chunk.str,
+      chunk.line,
+      chunk.column,
+      sourceMapFormat,
+      targetMapFormat,
+      entityPropertyConfig}
+  {
+  }
+
+  void parse(const bool startsInsideEntity, ParserStatus& status)
+  {
+    if (startsInsideEntity)
+    {
+      m_objectInfos.push_back(EntityInfo{{}, 0, 0});
+      m_currentEntityInfo = 0;
+
+      m_entityCloseLine = parseEntityBrushesOrPatches(status);
+      if (!m_entityCloseLine)
+      {
+        return;
+      }
+      m_currentEntityInfo = std::nullopt;
+    }
+    parseEntities(status);
+  }
+
+  std::vector<ObjectInfo>& objectInfos() { return m_objectInfos; }
+
+  /**
+   * The line of the closing brace of the entity that was opened in the preceding chunk.
+   */
+  std::optional<size_t> entityCloseLine() const { return m_entityCloseLine; }
+
+  /**
+   * The index of the entity that is still open at the end of this chunk.
+   */
+  std::optional<size_t> openEntityInfo() const { return m_currentEntityInfo; }
+
+private: // nodes are not created from chunks
+  Model::Node* onWorldNode(std::unique_ptr<Model::WorldNode>, ParserStatus&) override
+  {
+    return nullptr;
+  }
+  void onLayerNode(std::unique_ptr<Model::Node>, ParserStatus&) override {}
+  void onNode(Model::Node*, std::unique_ptr<Model::Node>, ParserStatus&) override {}
+};
+
+namespace
+{
+/**
+ * The minimal size of a chunk of a map file that is parsed in parallel. Smaller inputs
+ * such as pasted objects are parsed sequentially.
+ */
+constexpr auto MinChunkSize = size_t(64u * 1024u);
+
+struct ParsedChunk
+{
+  std::vector<MapReader::ObjectInfo> objectInfos;
+  std::optional<size_t> entityCloseLine;
+  std::optional<size_t> openEntityInfo;
+  std::unique_ptr<BufferedParserStatus> status;
+  bool success;
+};
+} // namespace
+
+bool MapReader::parseEntitiesInParallel(ParserStatus& status)
+{
+  const auto minChunkSize = std::max(
+    MinChunkSize, m_str.size() / (kdl::default_thread_pool().thread_count() * 4u));
+  const auto chunks = splitMapIntoChunks(m_str, minChunkSize);
+  if (chunks.size() < 2u)
+  {
+    return false;
+  }
+
+  auto parsedChunks = kdl::vec_parallel_transform(chunks, [&](const MapChunk& chunk) {
+    auto chunkStatus = std::make_unique<BufferedParserStatus>(status);
+    auto reader = EntityChunkReader{
+      chunk, m_sourceMapFormat, m_targetMapFormat, m_entityPropertyConfig};
+    try
+    {
+      reader.parse(chunk.startsInsideEntity, *chunkStatus);
+      return ParsedChunk{
+        std::move(reader.objectInfos()),
+        reader.entityCloseLine(),
+        reader.openEntityInfo(),
+        std::move(chunkStatus),
+        true};
+    }
+    catch (const ParserException&)
+    {
+      return ParsedChunk{{}, std::nullopt, std::nullopt, std::move(chunkStatus), false};
+    }
+  });
+
+  // every chunk must have been parsed successfully, and a chunk must start inside of an
+  // entity if and only if the preceding chunk ended inside of it
+  for (size_t i = 0; i < chunks.size(); ++i)
+  {
+    const auto previousChunkEndsInsideEntity =
+      i > 0 && parsedChunks[i - 1].openEntityInfo != std::nullopt;
+    if (
+      !parsedChunks[i].success
+      || chunks[i].startsInsideEntity != previousChunkEndsInsideEntity)
+    {
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i < chunks.size(); ++i)
+  {
+    auto& parsedChunk = parsedChunks[i];
+    const auto startsInsideEntity = chunks[i].startsInsideEntity;
+    const auto offset = m_objectInfos.size();
+
+    // maps an index into the chunk's object infos to an index into m_objectInfos
+    const auto toIndex = [&, openEntityInfo = m_currentEntityInfo](const size_t index) {
+      if (startsInsideEntity)
+      {
+        return index == 0 ? *openEntityInfo : offset + index - 1u;
+      }
+      return offset + index;
+    };
+
+    if (startsInsideEntity && parsedChunk.entityCloseLine)
+    {
+      auto& entity = std::get<EntityInfo>(m_objectInfos[*m_currentEntityInfo]);
+      entity.lineCount = *parsedChunk.entityCloseLine - entity.startLine;
+    }
+
+    auto& objectInfos = parsedChunk.objectInfos;
+    for (size_t j = startsInsideEntity ? 1u : 0u; j < objectInfos.size(); ++j)
+    {
+      std::visit(
+        kdl::overload(
+          [](EntityInfo&) {},
+          [&](BrushInfo& brush) {
+            if (brush.parentIndex)
+            {
+              brush.parentIndex = toIndex(*brush.parentIndex);
+            }
+          },
+          [&](PatchInfo& patch) {
+            if (patch.parentIndex)
+            {
+              patch.parentIndex = toIndex(*patch.parentIndex);
+            }
+          }),
+        objectInfos[j]);
+      m_objectInfos.push_back(std::move(objectInfos[j]));
+    }
+
+    m_currentEntityInfo = parsedChunk.openEntityInfo
+                            ? std::optional<size_t>{toIndex(*parsedChunk.openEntityInfo)}
+                            : std::nullopt;
+    parsedChunk.status->flush();
+  }
+
+  m_parsedChunkCount = chunks.size();
+  return true;
+}
+
 namespace
 {
 /** The type of a node's container. */
@@ -556,6 +771,23 @@ static CreateNodeResult createNodeFromEntityInfo(
   }
 }
 
+/**
+ * Creates a brush from the given brush info. If the brush info contains the brush
+ * geometry, it is restored instead of being computed from the faces.
+ */
+static kdl::result<Model::Brush, Model::BrushError> createBrush(
+  MapReader::BrushInfo& brushInfo, const vm::bbox3& worldBounds)
+{
+  if (brushInfo.geometry)
+  {
+    auto geometry = Model::CompactBrushGeometry{
+      std::move(brushInfo.geometry->vertices), brushInfo.geometry->faceVertexIndices};
+    return Model::Brush{std::move(brushInfo.faces), std::move(geometry)};
+  }
+
+  return Model::Brush::create(worldBounds, std::move(brushInfo.faces));
+}
+
 /**
  * Creates a brush node from the given brush info. Returns an error if the brush could not
  * be created.
@@ -563,7 +795,7 @@ static CreateNodeResult createNodeFromEntityInfo(
 static CreateNodeResult createBrushNode(
   MapReader::BrushInfo brushInfo, const vm::bbox3& worldBounds)
 {
-  return Model::Brush::create(worldBounds, std::move(brushInfo.faces))
+  return createBrush(brushInfo, worldBounds)
     .and_then([&](Model::Brush&& brush) {
       auto brushNode = std::make_unique<Model::BrushNode>(std::move(brush));
       brushNode->setFilePosition(brushInfo.startLine, brushInfo.lineCount);
@@ -66,7 +66,8 @@ class ParserStatus;
  * The flow of control is:
  *
  * 1. MapParser callbacks get called with the raw data, which we just store
- * (m_objectInfos).
+ * (m_objectInfos). Large inputs are split into chunks which are parsed in parallel
+ * (parseEntitiesInParallel).
  * 2. Convert the raw data to nodes in parallel (createNodes) and record any additional
  * information necessary to restore the parent / child relationships.
  * 3. Validate the created nodes.
@@ -83,12 +84,28 @@ public: // only public so that helper methods can see these declarations
     size_t lineCount;
   };
 
+  /**
+   * The vertices and face boundaries of a brush geometry, see
+   * Model::CompactBrushGeometry.
+   */
+  struct BrushGeometryInfo
+  {
+    std::vector<vm::vec3> vertices;
+    std::vector<std::vector<size_t>> faceVertexIndices;
+  };
+
   struct BrushInfo
   {
     std::vector<Model::BrushFace> faces;
     size_t startLine;
     size_t lineCount;
     std::optional<size_t> parentIndex;
+    /**
+     * Only set if the brush was recorded after its geometry had been computed. In that
+     * case, the faces are in the order of the faces of the geometry and the geometry is
+     * restored instead of being computed again.
+     */
+    std::optional<BrushGeometryInfo> geometry = std::nullopt;
   };
 
   struct PatchInfo
@@ -105,8 +122,12 @@ public: // only public so that helper methods can see these declarations
   using ObjectInfo = std::variant<EntityInfo, BrushInfo, PatchInfo>;
 
 private:
+  class EntityChunkReader;
+
+  std::string_view m_str;
   Model::EntityPropertyConfig m_entityPropertyConfig;
   vm::bbox3 m_worldBounds;
+  size_t m_parsedChunkCount = 0u;
 
 private: // data populated in response to MapParser callbacks
   std::vector<ObjectInfo> m_objectInfos;
@@ -128,12 +149,40 @@ protected:
     Model::MapFormat targetMapFormat,
     const Model::EntityPropertyConfig& entityPropertyConfig);
 
+  /**
+   * Creates a new reader for a section of a map file that starts at the given line and
+   * column.
+   *
+   * @param str the string to parse
+   * @param line the line of the first character of the given string
+   * @param column the column of the first character of the given string
+   * @param sourceMapFormat the expected format of the given string
+   * @param targetMapFormat the format to convert the created objects to
+   * @param entityPropertyConfig the entity property config to use
+   */
+  MapReader(
+    std::string_view str,
+    size_t line,
+    size_t column,
+    Model::MapFormat sourceMapFormat,
+    Model::MapFormat targetMapFormat,
+    const Model::EntityPropertyConfig& entityPropertyConfig);
+
   /**
    * Attempts to parse as one or more entities.
    *
    * @throws ParserException if parsing fails
    */
   void readEntities(const vm::bbox3& worldBounds, ParserStatus& status);
+  /**
+   * Creates nodes from the given object infos instead of parsing the input, e.g. when
+   * the object infos were recorded by a previous call to readEntities.
+   */
+  void readObjectInfos(
+    std::vector<ObjectInfo> objectInfos,
+    const vm::bbox3& worldBounds,
+    ParserStatus& status);
+
   /**
    * Attempts to parse as one or more brushes without any enclosing entity.
    *
@@ -147,6 +196,13 @@ protected:
    */
   void readBrushFaces(const vm::bbox3& worldBounds, ParserStatus& status);
 
+public:
+  /**
+   * Returns the number of chunks that were parsed in parallel by the last call to
+   * readEntities, or 0 if the input was parsed sequentially.
+   */
+  size_t parsedChunkCount() const;
+
 protected: // implement MapParser interface
   void onBeginEntity(
     size_t line,
@@ -184,6 +240,16 @@ protected: // implement MapParser interface
     ParserStatus& status) override;
 
 private: // helper methods
+  /**
+   * Splits the input into chunks of entities and brushes, parses the chunks in parallel
+   * and appends the results to m_objectInfos in file order. Messages are passed on to the
+   * given status in the same order as if the input had been parsed sequentially.
+   *
+   * Returns false without changing this reader if the input is too small to be split or
+   * if any chunk cannot be parsed. In that case, the input must be parsed sequentially,
+   * which also reports any parser errors at their exact position.
+   */
+  bool parseEntitiesInParallel(ParserStatus& status);
   void createNodes(ParserStatus& status);
 
 private: // subclassing interface - these will be called in the order that nodes should be
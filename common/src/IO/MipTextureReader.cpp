@@ -141,5 +141,36 @@ Assets::Texture MipTextureReader::doReadTexture(std::shared_ptr<File> file) cons
     throw AssetException(e.what());
   }
 }
+
+Assets::Texture MipTextureReader::doReadTextureInfo(std::shared_ptr<File> file) const
+{
+  ensure(!file->path().isEmpty(), "MipTextureReader::doReadTextureInfo requires a path");
+
+  const auto path = file->path();
+  const auto basename = path.lastComponent().deleteExtension().asString();
+  const auto name = textureName(basename, path);
+  try
+  {
+    // only the header is needed, so don't buffer the entire file
+    auto reader = file->reader();
+    reader.readString(MipLayout::TextureNameLength);
+
+    const auto width = reader.readSize<int32_t>();
+    const auto height = reader.readSize<int32_t>();
+
+    if (!checkTextureDimensions(width, height))
+    {
+      throw AssetException("Invalid texture dimensions");
+    }
+
+    const auto type = (!name.empty() && name.at(0) == '{') ? Assets::TextureType::Masked
+                                                           : Assets::TextureType::Opaque;
+    return Assets::Texture(name, width, height, GL_RGBA, type);
+  }
+  catch (const ReaderException& e)
+  {
+    throw AssetException(e.what());
+  }
+}
 } // namespace IO
 } // namespace TrenchBroom
@@ -255,9 +255,8 @@ void ObjSerializer::doBrushFace(const Model::BrushFace& face)
   auto indexedVertices = std::vector<IndexedVertex>{};
   indexedVertices.reserve(face.vertexCount());
 
-  for (const Model::BrushVertex* vertex : face.vertices())
+  for (const vm::vec3& position : face.vertexPositions())
   {
-    const vm::vec3& position = vertex->position();
     const vm::vec2f texCoords = face.textureCoords(position);
 
     const size_t vertexIndex = m_vertices.index(position);
@@ -37,6 +37,11 @@ ParserStatus::ParserStatus(Logger& logger, const std::string& prefix)
 
 ParserStatus::~ParserStatus() {}
 
+size_t ParserStatus::messageCount() const
+{
+  return m_messageCount;
+}
+
 void ParserStatus::progress(const double progress)
 {
   assert(progress >= 0.0 && progress <= 1.0);
@@ -125,6 +130,7 @@ void ParserStatus::errorAndThrow(const std::string& str)
 void ParserStatus::log(
   const LogLevel level, const size_t line, const size_t column, const std::string& str)
 {
+  ++m_messageCount;
   doLog(level, buildMessage(line, column, str));
 }
 
@@ -142,6 +148,7 @@ std::string ParserStatus::buildMessage(
 
 void ParserStatus::log(const LogLevel level, const size_t line, const std::string& str)
 {
+  ++m_messageCount;
   doLog(level, buildMessage(line, str));
 }
 
@@ -158,6 +165,7 @@ std::string ParserStatus::buildMessage(const size_t line, const std::string& str
 
 void ParserStatus::log(const LogLevel level, const std::string& str)
 {
+  ++m_messageCount;
   doLog(level, buildMessage(str));
 }
 
@@ -30,9 +30,12 @@ namespace IO
 {
 class ParserStatus
 {
+  friend class BufferedParserStatus;
+
 private:
   Logger& m_logger;
   std::string m_prefix;
+  size_t m_messageCount = 0u;
 
 protected:
   explicit ParserStatus(Logger& logger, const std::string& prefix);
@@ -41,6 +44,11 @@ public:
   virtual ~ParserStatus();
 
 public:
+  /**
+   * Returns the number of messages that were logged using this status.
+   */
+  size_t messageCount() const;
+
   void progress(double progress);
 
   void debug(size_t line, size_t column, const std::string& str);
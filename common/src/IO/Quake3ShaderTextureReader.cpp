@@ -35,12 +35,28 @@ namespace TrenchBroom
 namespace IO
 {
 Quake3ShaderTextureReader::Quake3ShaderTextureReader(
-  const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger)
+  const NameStrategy& nameStrategy,
+  const FileSystem& fs,
+  Logger& logger,
+  std::shared_ptr<const TextureCache> cache)
   : TextureReader(nameStrategy, fs, logger)
+  , m_cache{std::move(cache)}
 {
 }
 
 Assets::Texture Quake3ShaderTextureReader::doReadTexture(std::shared_ptr<File> file) const
+{
+  return readShaderTexture(std::move(file), true);
+}
+
+Assets::Texture Quake3ShaderTextureReader::doReadTextureInfo(
+  std::shared_ptr<File> file) const
+{
+  return readShaderTexture(std::move(file), false);
+}
+
+Assets::Texture Quake3ShaderTextureReader::readShaderTexture(
+  std::shared_ptr<File> file, const bool readPixels) const
 {
   const auto* shaderFile = dynamic_cast<ObjectFile<Assets::Quake3Shader>*>(file.get());
   if (shaderFile == nullptr)
@@ -56,7 +72,7 @@ Assets::Texture Quake3ShaderTextureReader::doReadTexture(std::shared_ptr<File> f
       "Could not find texture path for shader '" + shader.shaderPath.asString() + "'");
   }
 
-  auto texture = loadTextureImage(shader.shaderPath, texturePath);
+  auto texture = loadTextureImage(shader.shaderPath, texturePath, readPixels);
   texture.setSurfaceParms(shader.surfaceParms);
   texture.setOpaque();
 
@@ -93,7 +109,7 @@ Assets::Texture Quake3ShaderTextureReader::doReadTexture(std::shared_ptr<File> f
 }
 
 Assets::Texture Quake3ShaderTextureReader::loadTextureImage(
-  const Path& shaderPath, const Path& imagePath) const
+  const Path& shaderPath, const Path& imagePath, const bool readPixels) const
 {
   const auto name = textureName(shaderPath);
   if (!m_fs.fileExists(imagePath))
@@ -101,8 +117,10 @@ Assets::Texture Quake3ShaderTextureReader::loadTextureImage(
     throw AssetException("Image file '" + imagePath.asString() + "' does not exist");
   }
 
-  FreeImageTextureReader imageReader(StaticNameStrategy(name), m_fs, m_logger);
-  return imageReader.readTexture(m_fs.openFile(imagePath));
+  FreeImageTextureReader imageReader(StaticNameStrategy(name), m_fs, m_logger, m_cache);
+  auto imageFile = m_fs.openFile(imagePath);
+  return readPixels ? imageReader.decodeTexture(std::move(imageFile))
+                    : imageReader.readTextureInfo(std::move(imageFile));
 }
 
 Path Quake3ShaderTextureReader::findTexturePath(const Assets::Quake3Shader& shader) const
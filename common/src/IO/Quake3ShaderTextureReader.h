@@ -35,6 +35,7 @@ namespace IO
 class File;
 class FileSystem;
 class Path;
+class TextureCache;
 
 /**
  * Loads a texture that represents a Quake 3 shader from the file system. Uses a given
@@ -43,21 +44,32 @@ class Path;
  */
 class Quake3ShaderTextureReader : public TextureReader
 {
+private:
+  std::shared_ptr<const TextureCache> m_cache;
+
 public:
   /**
    * Creates a texture reader using the given name strategy and file system to locate the
    * texture image.
    *
    * @param nameStrategy the strategy to determine the texture name
-   * @param fs the file system to use when locating the texture image
+   * @param fs the file system to use when locating the texture image, must be safe to
+   * use from multiple threads if textures are decoded in parallel
    * @param logger the logger to use
+   * @param cache the cache for the decoded texture images, may be null
    */
   Quake3ShaderTextureReader(
-    const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger);
+    const NameStrategy& nameStrategy,
+    const FileSystem& fs,
+    Logger& logger,
+    std::shared_ptr<const TextureCache> cache = nullptr);
 
 private:
   Assets::Texture doReadTexture(std::shared_ptr<File> file) const override;
-  Assets::Texture loadTextureImage(const Path& shaderPath, const Path& imagePath) const;
+  Assets::Texture doReadTextureInfo(std::shared_ptr<File> file) const override;
+  Assets::Texture readShaderTexture(std::shared_ptr<File> file, bool readPixels) const;
+  Assets::Texture loadTextureImage(
+    const Path& shaderPath, const Path& imagePath, bool readPixels) const;
   Path findTexturePath(const Assets::Quake3Shader& shader) const;
   Path findTexture(const Path& texturePath) const;
 };
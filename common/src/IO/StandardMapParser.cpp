@@ -42,8 +42,9 @@ const std::string& QuakeMapTokenizer::NumberDelim()
   return numberDelim;
 }
 
-QuakeMapTokenizer::QuakeMapTokenizer(std::string_view str)
-  : Tokenizer(std::move(str), "\"", '\\')
+QuakeMapTokenizer::QuakeMapTokenizer(
+  std::string_view str, const size_t line, const size_t column)
+  : Tokenizer(std::move(str), "\"", '\\', line, column)
   , m_skipEol(true)
 {
 }
@@ -154,6 +155,234 @@ QuakeMapTokenizer::Token QuakeMapTokenizer::emitToken()
   return Token(QuakeMapToken::Eof, nullptr, nullptr, length(), line(), column());
 }
 
+namespace
+{
+bool isWhitespace(const char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool isDigit(const char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+size_t skipDigits(std::string_view str, size_t i)
+{
+  while (i < str.size() && isDigit(str[i]))
+  {
+    ++i;
+  }
+  return i;
+}
+
+/**
+ * Returns whether the tokenizer reads the given string as an integer or a decimal number,
+ * see Tokenizer::readInteger and Tokenizer::readDecimal.
+ */
+bool isNumber(std::string_view str)
+{
+  if (str.empty())
+  {
+    return false;
+  }
+
+  if (str[0] == '+' || str[0] == '-' || isDigit(str[0]))
+  {
+    if (skipDigits(str, 1u) == str.size())
+    {
+      return true;
+    }
+  }
+  else if (str[0] != '.')
+  {
+    return false;
+  }
+
+  auto i = str[0] != '.' ? skipDigits(str, 1u) : size_t(0);
+  if (i < str.size() && str[i] == '.')
+  {
+    i = skipDigits(str, i + 1u);
+  }
+  if (i < str.size() && str[i] == 'e')
+  {
+    ++i;
+    if (i < str.size() && (str[i] == '+' || str[i] == '-' || isDigit(str[i])))
+    {
+      i = skipDigits(str, i + 1u);
+    }
+  }
+  return i == str.size();
+}
+} // namespace
+
+std::vector<MapChunk> splitMapIntoChunks(
+  std::string_view str, const size_t minChunkSize)
+{
+  auto result = std::vector<MapChunk>{};
+
+  auto chunkStart = size_t(0);
+  auto chunkLine = size_t(1);
+  auto chunkColumn = size_t(1);
+  auto chunkStartsInsideEntity = false;
+
+  auto line = size_t(1);
+  auto lineStart = size_t(0);
+  auto depth = 0;
+
+  const auto skipToEndOfLine = [&](size_t i) {
+    while (i < str.size() && str[i] != '\n' && str[i] != '\r')
+    {
+      ++i;
+    }
+    return i;
+  };
+
+  // an integer or a decimal number ends at whitespace or at a closing parenthesis, any
+  // other token ends at whitespace
+  const auto skipToken = [&](size_t i) {
+    const auto tokenStart = i;
+    while (i < str.size() && !isWhitespace(str[i]))
+    {
+      if (str[i] == ')' && isNumber(str.substr(tokenStart, i - tokenStart)))
+      {
+        break;
+      }
+      ++i;
+    }
+    return i;
+  };
+
+  auto i = size_t(0);
+  while (i < str.size())
+  {
+    switch (str[i])
+    {
+    case '\r':
+      if (i + 1u < str.size() && str[i + 1u] == '\n')
+      {
+        ++i;
+        break;
+      }
+      // handle carriage return without consecutive line feed
+      // by falling through into the line feed case
+      switchFallthrough();
+    case '\n':
+      ++i;
+      ++line;
+      lineStart = i;
+      break;
+    case ' ':
+    case '\t':
+    case '(':
+    case ')':
+    case '[':
+    case ']':
+      ++i;
+      break;
+    case '/':
+      if (i + 1u < str.size() && str[i + 1u] == '/')
+      {
+        // a comment token "/// " is followed by further tokens on the same line
+        i = i + 3u < str.size() && str[i + 2u] == '/' && str[i + 3u] == ' '
+              ? i + 3u
+              : skipToEndOfLine(i + 2u);
+      }
+      else
+      {
+        ++i;
+      }
+      break;
+    case ';':
+      i = skipToEndOfLine(i + 1u);
+      break;
+    case '{':
+    case '}':
+      if (i + 1u < str.size() && !isWhitespace(str[i + 1u]))
+      {
+        // most likely a texture name such as {fence
+        i = skipToken(i);
+        break;
+      }
+
+      if (str[i] == '{')
+      {
+        ++depth;
+        ++i;
+        break;
+      }
+
+      --depth;
+      ++i;
+      if (depth < 0)
+      {
+        return {};
+      }
+      if ((depth == 0 || depth == 1) && i - chunkStart >= minChunkSize)
+      {
+        result.push_back(MapChunk{
+          str.substr(chunkStart, i - chunkStart),
+          chunkLine,
+          chunkColumn,
+          chunkStartsInsideEntity});
+        chunkStart = i;
+        chunkLine = line;
+        chunkColumn = i - lineStart + 1u;
+        chunkStartsInsideEntity = depth == 1;
+      }
+      break;
+    case '"': {
+      // see Tokenizer::readQuotedString, a quotation mark is escaped by an odd number of
+      // backslashes, unless it is followed by a newline or a closing brace
+      auto escaped = false;
+      ++i;
+      while (i < str.size() && (str[i] != '"' || escaped))
+      {
+        const auto c = str[i];
+        if (c == '"' && i + 1u < str.size() && (str[i + 1u] == '\n' || str[i + 1u] == '}'))
+        {
+          break;
+        }
+
+        if (c == '\n' || (c == '\r' && (i + 1u == str.size() || str[i + 1u] != '\n')))
+        {
+          ++line;
+          lineStart = i + 1u;
+          escaped = false;
+        }
+        else if (c != '\r')
+        {
+          escaped = c == '\\' && !escaped;
+        }
+        ++i;
+      }
+      if (i == str.size())
+      {
+        return {};
+      }
+      ++i;
+      break;
+    }
+    default:
+      i = skipToken(i);
+      break;
+    }
+  }
+
+  if (depth != 0)
+  {
+    return {};
+  }
+
+  if (chunkStart < str.size())
+  {
+    result.push_back(MapChunk{
+      str.substr(chunkStart), chunkLine, chunkColumn, chunkStartsInsideEntity});
+  }
+
+  return result;
+}
+
 const std::string StandardMapParser::BrushPrimitiveId = "brushDef";
 const std::string StandardMapParser::PatchId = "patchDef2";
 
@@ -169,6 +398,20 @@ StandardMapParser::StandardMapParser(
   assert(targetMapFormat != Model::MapFormat::Unknown);
 }
 
+StandardMapParser::StandardMapParser(
+  std::string_view str,
+  const size_t line,
+  const size_t column,
+  const Model::MapFormat sourceMapFormat,
+  const Model::MapFormat targetMapFormat)
+  : m_tokenizer(QuakeMapTokenizer(std::move(str), line, column))
+  , m_sourceMapFormat(sourceMapFormat)
+  , m_targetMapFormat(targetMapFormat)
+{
+  assert(m_sourceMapFormat != Model::MapFormat::Unknown);
+  assert(targetMapFormat != Model::MapFormat::Unknown);
+}
+
 StandardMapParser::~StandardMapParser() = default;
 
 void StandardMapParser::parseEntities(ParserStatus& status)
@@ -182,6 +425,32 @@ void StandardMapParser::parseEntities(ParserStatus& status)
   }
 }
 
+std::optional<size_t> StandardMapParser::parseEntityBrushesOrPatches(
+  ParserStatus& status)
+{
+  auto token = m_tokenizer.peekToken();
+  while (token.type() != QuakeMapToken::Eof)
+  {
+    switch (token.type())
+    {
+    case QuakeMapToken::Comment:
+      m_tokenizer.nextToken();
+      break;
+    case QuakeMapToken::OBrace:
+      parseBrushOrBrushPrimitiveOrPatch(status);
+      break;
+    case QuakeMapToken::CBrace:
+      m_tokenizer.nextToken();
+      return token.line();
+    default:
+      expect(QuakeMapToken::Comment | QuakeMapToken::OBrace | QuakeMapToken::CBrace, token);
+    }
+
+    token = m_tokenizer.peekToken();
+  }
+  return std::nullopt;
+}
+
 void StandardMapParser::parseBrushesOrPatches(ParserStatus& status)
 {
   auto token = m_tokenizer.peekToken();
@@ -250,7 +519,7 @@ void StandardMapParser::parseEntity(ParserStatus& status)
       m_tokenizer.nextToken();
       if (!beginEntityCalled)
       {
-        onBeginEntity(startLine, properties, status);
+        onBeginEntity(startLine, std::move(properties), status);
       }
       onEndEntity(startLine, token.line() - startLine, status);
       return;
@@ -272,22 +541,22 @@ void StandardMapParser::parseEntityProperty(
 {
   auto token = m_tokenizer.nextToken();
   assert(token.type() == QuakeMapToken::String);
-  const auto name = token.data();
+  const auto name = token.view();
 
   const auto line = token.line();
   const auto column = token.column();
 
   expect(QuakeMapToken::String, token = m_tokenizer.nextToken());
-  const auto value = token.data();
+  const auto value = token.view();
 
-  if (keys.count(name) == 0)
+  if (keys.insert(name).second)
   {
-    properties.push_back(Model::EntityProperty(name, value));
-    keys.insert(name);
+    properties.emplace_back(std::string(name), std::string(value));
   }
   else
   {
-    status.warn(line, column, "Ignoring duplicate entity property '" + name + "'");
+    status.warn(
+      line, column, "Ignoring duplicate entity property '" + std::string(name) + "'");
   }
 }
 
@@ -29,6 +29,7 @@
 
 #include <vecmath/forward.h>
 
+#include <optional>
 #include <string_view>
 #include <tuple>
 #include <vector>
@@ -64,7 +65,7 @@ private:
   bool m_skipEol;
 
 public:
-  explicit QuakeMapTokenizer(std::string_view str);
+  explicit QuakeMapTokenizer(std::string_view str, size_t line = 1, size_t column = 1);
 
   void setSkipEol(bool skipEol);
 
@@ -72,11 +73,44 @@ private:
   Token emitToken() override;
 };
 
+/**
+ * A section of a map file that can be parsed independently of the other sections.
+ *
+ * A chunk starts either with a top level entity or, if startsInsideEntity is true, with a
+ * brush or patch of an entity that was opened in the preceding chunk. The line and column
+ * refer to the position of the first character of the chunk in the entire map file.
+ */
+struct MapChunk
+{
+  std::string_view str;
+  size_t line;
+  size_t column;
+  bool startsInsideEntity;
+};
+
+/**
+ * Splits the given map file into chunks of at least the given size. Chunks are split
+ * after the closing brace of a top level entity or after the closing brace of a brush or
+ * patch. The scanner follows the lexical rules of QuakeMapTokenizer, so quoted strings and
+ * comments are skipped.
+ *
+ * A brace only counts as a delimiter if it is followed by whitespace or the end of the
+ * file, so that texture names such as "{fence" are not mistaken for braces. Therefore,
+ * the returned chunks must be validated by parsing them. If the braces of the file are
+ * unbalanced, an empty vector is returned and the file must be parsed sequentially.
+ *
+ * @param str the map file to split
+ * @param minChunkSize the minimal size of a chunk in bytes, the last chunk may be smaller
+ * @return the chunks in file order, or an empty vector if the file cannot be split
+ */
+std::vector<MapChunk> splitMapIntoChunks(std::string_view str, size_t minChunkSize);
+
 class StandardMapParser : public MapParser, public Parser<QuakeMapToken::Type>
 {
 private:
   using Token = QuakeMapTokenizer::Token;
-  using EntityPropertyKeys = kdl::vector_set<std::string>;
+  // the keys refer to the parsed source to avoid copying them
+  using EntityPropertyKeys = kdl::vector_set<std::string_view>;
 
   static const std::string BrushPrimitiveId;
   static const std::string PatchId;
@@ -101,10 +135,35 @@ public:
     Model::MapFormat sourceMapFormat,
     Model::MapFormat targetMapFormat);
 
+  /**
+   * Creates a new parser for a section of a map file that starts at the given line and
+   * column. The positions reported by this parser refer to the entire map file.
+   *
+   * @param str the string to parse
+   * @param line the line of the first character of the given string
+   * @param column the column of the first character of the given string
+   * @param sourceMapFormat the expected format of the given string
+   * @param targetMapFormat the format to convert the created objects to
+   */
+  StandardMapParser(
+    std::string_view str,
+    size_t line,
+    size_t column,
+    Model::MapFormat sourceMapFormat,
+    Model::MapFormat targetMapFormat);
+
   ~StandardMapParser() override;
 
 protected:
   void parseEntities(ParserStatus& status);
+  /**
+   * Parses the brushes and patches of an entity whose opening brace and properties have
+   * already been consumed, up to and including the closing brace of the entity.
+   *
+   * @return the line of the closing brace, or std::nullopt if the end of the input was
+   * reached before the entity was closed
+   */
+  std::optional<size_t> parseEntityBrushesOrPatches(ParserStatus& status);
   void parseBrushesOrPatches(ParserStatus& status);
   void parseBrushFaces(ParserStatus& status);
 
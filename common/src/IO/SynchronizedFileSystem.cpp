@@ -0,0 +1,89 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SynchronizedFileSystem.h"
+
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace IO
+{
+namespace
+{
+std::shared_ptr<File> readIntoMemory(std::shared_ptr<File> file)
+{
+  if (
+    dynamic_cast<const FileView*>(file.get()) == nullptr
+    && dynamic_cast<const CFile*>(file.get()) == nullptr)
+  {
+    return file;
+  }
+
+  auto reader = file->reader().buffer();
+  const auto size = reader.size();
+  auto buffer = std::make_unique<char[]>(size);
+  std::copy(reader.begin(), reader.end(), buffer.get());
+  return std::make_shared<OwningBufferFile>(file->path(), std::move(buffer), size);
+}
+} // namespace
+
+SynchronizedFileSystem::SynchronizedFileSystem(std::shared_ptr<const FileSystem> fs)
+  : m_fs{std::move(fs)}
+{
+}
+
+Path SynchronizedFileSystem::doMakeAbsolute(const Path& path) const
+{
+  const auto lock = std::lock_guard{m_mutex};
+  return m_fs->makeAbsolute(path);
+}
+
+bool SynchronizedFileSystem::doDirectoryExists(const Path& path) const
+{
+  const auto lock = std::lock_guard{m_mutex};
+  return m_fs->directoryExists(path);
+}
+
+bool SynchronizedFileSystem::doFileExists(const Path& path) const
+{
+  const auto lock = std::lock_guard{m_mutex};
+  return m_fs->fileExists(path);
+}
+
+std::vector<Path> SynchronizedFileSystem::doGetDirectoryContents(const Path& path) const
+{
+  const auto lock = std::lock_guard{m_mutex};
+  return m_fs->getDirectoryContents(path);
+}
+
+std::shared_ptr<File> SynchronizedFileSystem::doOpenFile(const Path& path) const
+{
+  const auto lock = std::lock_guard{m_mutex};
+  return readIntoMemory(m_fs->openFile(path));
+}
+} // namespace IO
+} // namespace TrenchBroom
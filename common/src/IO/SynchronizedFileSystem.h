@@ -0,0 +1,63 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "IO/FileSystem.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace IO
+{
+class File;
+class Path;
+
+/**
+ * Gives access to another file system from multiple threads. Every query is forwarded to
+ * the other file system while holding a lock, and the files it opens are read into memory
+ * before the lock is released, since the files of an archive share one file handle.
+ *
+ * The other file system must not be used directly while this file system is in use on
+ * other threads.
+ */
+class SynchronizedFileSystem : public FileSystem
+{
+private:
+  std::shared_ptr<const FileSystem> m_fs;
+  mutable std::mutex m_mutex;
+
+public:
+  explicit SynchronizedFileSystem(std::shared_ptr<const FileSystem> fs);
+
+private:
+  Path doMakeAbsolute(const Path& path) const override;
+
+  bool doDirectoryExists(const Path& path) const override;
+  bool doFileExists(const Path& path) const override;
+
+  std::vector<Path> doGetDirectoryContents(const Path& path) const override;
+
+  std::shared_ptr<File> doOpenFile(const Path& path) const override;
+};
+} // namespace IO
+} // namespace TrenchBroom
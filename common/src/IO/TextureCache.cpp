@@ -0,0 +1,330 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureCache.h"
+
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Color.h"
+#include "Exceptions.h"
+#include "IO/ContentHash.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/IOUtils.h"
+#include "IO/Reader.h"
+#include "IO/SystemPaths.h"
+#include "Renderer/GL.h"
+
+#include <kdl/vector_utils.h>
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace IO
+{
+namespace
+{
+constexpr auto Magic = std::string_view{"TBTC"};
+constexpr auto Version = uint32_t(2);
+constexpr auto Alignment = size_t(8);
+constexpr auto MaxMipCount = size_t(16);
+
+size_t align(const size_t offset)
+{
+  return (offset + Alignment - 1u) & ~(Alignment - 1u);
+}
+
+class CacheWriter
+{
+private:
+  std::string m_buffer;
+
+public:
+  const std::string& buffer() const { return m_buffer; }
+
+  template <typename T>
+  void write(const T value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void writeBytes(const std::string_view bytes) { m_buffer.append(bytes); }
+};
+
+void writeHeader(
+  CacheWriter& writer, const uint64_t contentHash, const uint64_t contentSize)
+{
+  writer.writeBytes(Magic);
+  writer.write(Version);
+  writer.write(contentHash);
+  writer.write(contentSize);
+}
+
+bool isValidFormat(const GLenum format)
+{
+  return format == GL_RGB || format == GL_BGR || format == GL_RGBA || format == GL_BGRA;
+}
+
+Path cacheFilePath(const Path& directory, const Path& imagePath)
+{
+  auto fileName = std::stringstream{};
+  fileName << std::hex << std::setw(16) << std::setfill('0')
+           << contentHash(imagePath.asString()) << ".tbtexture";
+  return directory + Path{fileName.str()};
+}
+
+std::optional<Assets::Texture> readCacheFile(
+  const Path& cachePath,
+  const std::string_view imageContents,
+  const std::string& textureName)
+{
+  // the file is only mapped and not read into memory as a whole
+  const auto file = Disk::openMappedFile(cachePath);
+  auto reader = file->reader();
+
+  auto expectedHeader = CacheWriter{};
+  writeHeader(
+    expectedHeader, contentHash(imageContents), uint64_t(imageContents.size()));
+  for (const auto c : expectedHeader.buffer())
+  {
+    if (reader.read<char, char>() != c)
+    {
+      return std::nullopt;
+    }
+  }
+
+  const auto width = size_t(reader.read<uint32_t, uint32_t>());
+  const auto height = size_t(reader.read<uint32_t, uint32_t>());
+  const auto format = GLenum(reader.read<uint32_t, uint32_t>());
+  const auto type = reader.read<uint32_t, uint32_t>();
+  const auto averageColor = Color{reader.readVec<float, 4>()};
+  const auto mipCount = size_t(reader.read<uint32_t, uint32_t>());
+  reader.seekForward(sizeof(uint32_t));
+
+  if (
+    width == 0u || height == 0u || !isValidFormat(format)
+    || type > uint32_t(Assets::TextureType::Masked) || mipCount == 0u
+    || mipCount > MaxMipCount)
+  {
+    return std::nullopt;
+  }
+
+  const auto bytesPerPixel = Assets::bytesPerPixelForFormat(format);
+  auto buffers = Assets::TextureBufferList{};
+  buffers.reserve(mipCount);
+  for (size_t level = 0; level < mipCount; ++level)
+  {
+    const auto offset = size_t(reader.read<uint64_t, uint64_t>());
+    const auto size = size_t(reader.read<uint64_t, uint64_t>());
+
+    const auto mipSize = Assets::sizeAtMipLevel(width, height, level);
+    if (
+      size != bytesPerPixel * mipSize.x() * mipSize.y() || offset % Alignment != 0u
+      || offset > reader.size() || size > reader.size() - offset)
+    {
+      return std::nullopt;
+    }
+
+    auto buffer = Assets::TextureBuffer{size};
+    reader.subReaderFromBegin(offset, size).read(buffer.data(), size);
+    buffers.push_back(std::move(buffer));
+  }
+
+  return Assets::Texture{
+    textureName,
+    width,
+    height,
+    averageColor,
+    std::move(buffers),
+    format,
+    Assets::TextureType(type)};
+}
+} // namespace
+
+TextureCache::TextureCache(Path directory, const size_t maxSize)
+  : m_directory{std::move(directory)}
+  , m_maxSize{maxSize}
+{
+}
+
+TextureCache::~TextureCache()
+{
+  touchReadFiles();
+}
+
+const Path& TextureCache::directory() const
+{
+  return m_directory;
+}
+
+std::optional<Assets::Texture> TextureCache::read(
+  const Path& imagePath,
+  const std::string_view imageContents,
+  const std::string& textureName) const
+{
+  const auto cachePath = cacheFilePath(m_directory, imagePath);
+  if (!Disk::fileExists(cachePath))
+  {
+    return std::nullopt;
+  }
+
+  try
+  {
+    auto texture = readCacheFile(cachePath, imageContents, textureName);
+    if (texture)
+    {
+      // mark the cache file as recently used so that it is kept when trimming the cache
+      const auto lock = std::lock_guard{m_readFilesMutex};
+      m_readFiles.push_back(cachePath);
+    }
+    return texture;
+  }
+  catch (const Exception&)
+  {
+    // the cache file is damaged, or it was written by a different version
+    return std::nullopt;
+  }
+}
+
+void TextureCache::write(
+  const Path& imagePath,
+  const std::string_view imageContents,
+  const Assets::Texture& texture) const
+{
+  const auto& buffers = texture.buffersIfUnprepared();
+  if (buffers.empty() || buffers.size() > MaxMipCount)
+  {
+    return;
+  }
+
+  auto writer = CacheWriter{};
+  writeHeader(writer, contentHash(imageContents), uint64_t(imageContents.size()));
+  writer.write(uint32_t(texture.width()));
+  writer.write(uint32_t(texture.height()));
+  writer.write(uint32_t(texture.format()));
+  writer.write(uint32_t(texture.type()));
+  for (size_t i = 0; i < 4; ++i)
+  {
+    writer.write(texture.averageColor()[i]);
+  }
+  writer.write(uint32_t(buffers.size()));
+  writer.write(uint32_t(0));
+
+  // the table of the mipmaps' offsets and sizes is followed by their pixel data
+  auto offsets = std::vector<size_t>{};
+  auto offset = align(writer.buffer().size() + buffers.size() * 2u * sizeof(uint64_t));
+  for (const auto& buffer : buffers)
+  {
+    writer.write(uint64_t(offset));
+    writer.write(uint64_t(buffer.size()));
+    offsets.push_back(offset);
+    offset = align(offset + buffer.size());
+  }
+
+  if (offset > m_maxSize)
+  {
+    // the cache file would be removed when trimming the cache
+    return;
+  }
+
+  try
+  {
+    const auto cachePath = cacheFilePath(m_directory, imagePath);
+    Disk::ensureDirectoryExists(m_directory);
+
+    // write to a temporary file first so that a partially written cache file is never
+    // read, and use a file name per thread in case the same image is read by multiple
+    // threads at once
+    auto tempFileName = std::stringstream{};
+    tempFileName << cachePath.lastComponent().asString() << "."
+                 << std::hash<std::thread::id>{}(std::this_thread::get_id()) << ".tmp";
+    const auto tempPath = m_directory + Path{tempFileName.str()};
+    {
+      auto stream = openPathAsOutputStream(tempPath, std::ios::out | std::ios::binary);
+      stream.write(
+        writer.buffer().data(), static_cast<std::streamsize>(writer.buffer().size()));
+
+      auto position = writer.buffer().size();
+      for (size_t i = 0; i < buffers.size(); ++i)
+      {
+        const auto padding = std::string(offsets[i] - position, '\0');
+        stream.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        stream.write(
+          reinterpret_cast<const char*>(buffers[i].data()),
+          static_cast<std::streamsize>(buffers[i].size()));
+        position = offsets[i] + buffers[i].size();
+      }
+
+      if (!stream)
+      {
+        throw FileSystemException{"Could not write file '" + tempPath.asString() + "'"};
+      }
+    }
+    Disk::moveFile(tempPath, cachePath, true);
+  }
+  catch (const Exception&)
+  {
+    // the texture is decoded from its image file again next time
+  }
+}
+
+void TextureCache::trim() const
+{
+  touchReadFiles();
+  Disk::trimDirectory(m_directory, m_maxSize);
+}
+
+void TextureCache::touchReadFiles() const
+{
+  auto readFiles = std::vector<Path>{};
+  {
+    const auto lock = std::lock_guard{m_readFilesMutex};
+    std::swap(readFiles, m_readFiles);
+  }
+
+  for (const auto& path : kdl::vec_sort_and_remove_duplicates(std::move(readFiles)))
+  {
+    try
+    {
+      Disk::touchFile(path);
+    }
+    catch (const Exception&)
+    {
+      // the cache file is removed sooner when trimming the cache
+    }
+  }
+}
+
+Path textureCacheDirectory()
+{
+  return SystemPaths::userDataDirectory() + Path{"Texture Cache"};
+}
+} // namespace IO
+} // namespace TrenchBroom
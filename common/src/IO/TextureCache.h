@@ -0,0 +1,133 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "IO/Path.h"
+
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Assets
+{
+class Texture;
+}
+
+namespace IO
+{
+/**
+ * A directory of binary files that store decoded textures. Reading a texture from the
+ * cache skips decoding its image file, generating its mipmaps and computing its average
+ * color.
+ *
+ * Every image file has one cache file, which is named after a hash of the path of the
+ * image file. A cache file is only used if it was written for the same image file
+ * contents. This is checked by comparing a hash and the size of the image file contents
+ * with the values that were stored in the cache file when it was written. Both hashes
+ * are computed with contentHash, so they are the same on every platform.
+ *
+ * The pixel data of the mipmaps is stored in consecutive blocks that are aligned to 8
+ * bytes and that are listed in a table following the header, so that it can be copied
+ * directly from the memory mapped cache file.
+ *
+ * The total size of the cache files is limited. Trimming the cache removes the cache
+ * files with the oldest modification times until the cache is within its size limit
+ * again. To avoid writing to the file system on every read, the cache remembers which
+ * cache files were read, and it updates their modification times in one go when it is
+ * trimmed or destroyed.
+ *
+ * Textures are read and written from multiple threads when texture collections are
+ * loaded in parallel. Errors when writing or trimming the cache are ignored, since the
+ * textures can always be decoded from their image files.
+ */
+class TextureCache
+{
+private:
+  Path m_directory;
+  size_t m_maxSize;
+
+  mutable std::mutex m_readFilesMutex;
+  mutable std::vector<Path> m_readFiles;
+
+public:
+  /**
+   * Creates a cache that stores its files in the given directory.
+   *
+   * @param directory the directory of the cache files, which is created when the first
+   * cache file is written
+   * @param maxSize the maximum total size of the cache files in bytes
+   */
+  TextureCache(Path directory, size_t maxSize);
+
+  /**
+   * Updates the modification times of the cache files read since the cache was last
+   * trimmed.
+   */
+  ~TextureCache();
+
+  const Path& directory() const;
+
+  /**
+   * Reads the texture cached for the image file at the given path with the given
+   * contents. Returns nullopt if there is no cache file for the image file, if it was
+   * written for different contents or if it cannot be read.
+   *
+   * @param imagePath the path of the image file
+   * @param imageContents the contents of the image file
+   * @param textureName the name of the returned texture
+   */
+  std::optional<Assets::Texture> read(
+    const Path& imagePath,
+    std::string_view imageContents,
+    const std::string& textureName) const;
+
+  /**
+   * Writes the given texture decoded from the image file at the given path with the
+   * given contents to the cache, replacing any existing cache file for the image file.
+   * Does nothing if the texture has no pixel data.
+   */
+  void write(
+    const Path& imagePath,
+    std::string_view imageContents,
+    const Assets::Texture& texture) const;
+
+  /**
+   * Updates the modification times of the cache files read since the cache was last
+   * trimmed, and then removes the least recently used cache files until the total size of
+   * the cache files does not exceed the maximum size.
+   */
+  void trim() const;
+
+private:
+  void touchReadFiles() const;
+};
+
+/**
+ * Returns the directory of the texture cache files. Cache files are stored in the user
+ * data directory and not next to the image files.
+ */
+Path textureCacheDirectory();
+} // namespace IO
+} // namespace TrenchBroom
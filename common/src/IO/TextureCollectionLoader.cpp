@@ -19,16 +19,23 @@
 
 #include "TextureCollectionLoader.h"
 
+#include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
+#include "Exceptions.h"
 #include "IO/DiskIO.h"
 #include "IO/File.h"
 #include "IO/FileMatcher.h"
 #include "IO/FileSystem.h"
+#include "IO/SynchronizedFileSystem.h"
 #include "IO/TextureReader.h"
 #include "IO/WadFileSystem.h"
 #include "Logger.h"
 
+#include <kdl/parallel.h>
+
+#include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace TrenchBroom
@@ -36,9 +43,10 @@ namespace TrenchBroom
 namespace IO
 {
 TextureCollectionLoader::TextureCollectionLoader(
-  Logger& logger, const std::vector<std::string>& exclusions)
+  Logger& logger, const std::vector<std::string>& exclusions, const bool loadLazily)
   : m_logger(logger)
   , m_textureExclusions(exclusions)
+  , m_loadLazily(loadLazily)
 {
 }
 
@@ -56,11 +64,72 @@ bool TextureCollectionLoader::shouldExclude(const std::string& textureName)
   return false;
 }
 
+std::vector<std::optional<Assets::Texture>> TextureCollectionLoader::readTextures(
+  const std::vector<Path>& paths,
+  const FileSystem& fs,
+  const TextureReader& textureReader)
+{
+  auto textures = std::vector<std::optional<Assets::Texture>>(paths.size());
+  auto errors = std::vector<std::string>(paths.size());
+
+  kdl::parallel_for(paths.size(), [&](const size_t i) {
+    try
+    {
+      textures[i] = textureReader.decodeTexture(fs.openFile(paths[i]));
+    }
+    catch (const AssetException&)
+    {
+      // read the texture again below to log the error and load the default texture
+    }
+    catch (const std::exception& e)
+    {
+      errors[i] = e.what();
+    }
+  });
+
+  // the logger must only be used on this thread
+  for (size_t i = 0; i < paths.size(); ++i)
+  {
+    if (!textures[i] && errors[i].empty())
+    {
+      try
+      {
+        textures[i] = textureReader.readTexture(fs.openFile(paths[i]));
+      }
+      catch (const std::exception& e)
+      {
+        errors[i] = e.what();
+      }
+    }
+
+    if (!errors[i].empty())
+    {
+      m_logger.warn() << errors[i];
+    }
+  }
+
+  return textures;
+}
+
+Assets::Texture TextureCollectionLoader::readTextureLazily(
+  std::shared_ptr<File> file,
+  std::function<std::shared_ptr<File>()> openFile,
+  std::shared_ptr<const TextureReader> textureReader)
+{
+  auto texture = textureReader->readTextureInfo(std::move(file));
+  texture.setDecoder(
+    [openFile = std::move(openFile), textureReader = std::move(textureReader)]() {
+      return textureReader->decodeTexture(openFile());
+    });
+  return texture;
+}
+
 FileTextureCollectionLoader::FileTextureCollectionLoader(
   Logger& logger,
   const std::vector<IO::Path>& searchPaths,
-  const std::vector<std::string>& exclusions)
-  : TextureCollectionLoader(logger, exclusions)
+  const std::vector<std::string>& exclusions,
+  const bool loadLazily)
+  : TextureCollectionLoader(logger, exclusions, loadLazily)
   , m_searchPaths(searchPaths)
 {
 }
@@ -68,31 +137,53 @@ FileTextureCollectionLoader::FileTextureCollectionLoader(
 Assets::TextureCollection FileTextureCollectionLoader::loadTextureCollection(
   const Path& path,
   const std::vector<std::string>& textureExtensions,
-  const TextureReader& textureReader)
+  std::shared_ptr<const TextureReader> textureReader)
 {
   const auto wadPath = Disk::resolvePath(m_searchPaths, path);
-  WadFileSystem wadFS(wadPath, m_logger);
+  const auto wadFS = std::make_shared<SynchronizedFileSystem>(
+    std::make_shared<WadFileSystem>(wadPath, m_logger));
 
   const auto texturePaths =
-    wadFS.findItems(Path(""), FileExtensionMatcher(textureExtensions));
+    wadFS->findItems(Path(""), FileExtensionMatcher(textureExtensions));
+  auto pathsToRead = std::vector<Path>();
   auto textures = std::vector<Assets::Texture>();
+  pathsToRead.reserve(texturePaths.size());
   textures.reserve(texturePaths.size());
 
   for (const auto& texturePath : texturePaths)
   {
-    try
+    const auto name = texturePath.lastComponent().deleteExtension().asString();
+    if (shouldExclude(name))
+    {
+      continue;
+    }
+
+    if (m_loadLazily)
     {
-      auto file = wadFS.openFile(texturePath);
-      const auto name = file->path().lastComponent().deleteExtension().asString();
-      if (shouldExclude(name))
+      try
+      {
+        // the file system keeps the wad file open, so it can be read again when decoding
+        textures.push_back(readTextureLazily(
+          wadFS->openFile(texturePath),
+          [wadFS, texturePath]() { return wadFS->openFile(texturePath); },
+          textureReader));
+      }
+      catch (const std::exception& e)
       {
-        continue;
+        m_logger.warn() << e.what();
       }
-      textures.push_back(textureReader.readTexture(file));
     }
-    catch (const std::exception& e)
+    else
     {
-      m_logger.warn() << e.what();
+      pathsToRead.push_back(texturePath);
+    }
+  }
+
+  for (auto& texture : readTextures(pathsToRead, *wadFS, *textureReader))
+  {
+    if (texture)
+    {
+      textures.push_back(std::move(*texture));
     }
   }
 
@@ -100,52 +191,82 @@ Assets::TextureCollection FileTextureCollectionLoader::loadTextureCollection(
 }
 
 DirectoryTextureCollectionLoader::DirectoryTextureCollectionLoader(
-  Logger& logger, const FileSystem& gameFS, const std::vector<std::string>& exclusions)
-  : TextureCollectionLoader(logger, exclusions)
-  , m_gameFS(gameFS)
+  Logger& logger,
+  std::shared_ptr<const SynchronizedFileSystem> gameFS,
+  const std::vector<std::string>& exclusions,
+  const bool loadLazily)
+  : TextureCollectionLoader(logger, exclusions, loadLazily)
+  , m_gameFS(std::move(gameFS))
 {
 }
 
 Assets::TextureCollection DirectoryTextureCollectionLoader::loadTextureCollection(
   const Path& path,
   const std::vector<std::string>& textureExtensions,
-  const TextureReader& textureReader)
+  std::shared_ptr<const TextureReader> textureReader)
 {
   const auto texturePaths =
-    m_gameFS.findItems(path, FileExtensionMatcher(textureExtensions));
+    m_gameFS->findItems(path, FileExtensionMatcher(textureExtensions));
+  auto pathsToRead = std::vector<Path>();
+  auto absolutePaths = std::vector<Path>();
   auto textures = std::vector<Assets::Texture>();
+  pathsToRead.reserve(texturePaths.size());
+  absolutePaths.reserve(texturePaths.size());
   textures.reserve(texturePaths.size());
 
   for (const auto& texturePath : texturePaths)
   {
+    const auto name = texturePath.lastComponent().deleteExtension().asString();
+    if (shouldExclude(name))
+    {
+      continue;
+    }
+
+    // Store the absolute path to the original file (may be used by .obj export)
+    IO::Path absolutePath;
     try
     {
-      auto file = m_gameFS.openFile(texturePath);
+      absolutePath = m_gameFS->makeAbsolute(texturePath);
+    }
+    catch (const FileSystemException& e)
+    {
+      m_logger.debug() << e.what();
+    }
 
-      // Store the absolute path to the original file (may be used by .obj export)
-      IO::Path absolutePath;
+    if (m_loadLazily)
+    {
       try
       {
-        absolutePath = m_gameFS.makeAbsolute(texturePath);
+        // open the file again when decoding instead of keeping every file in memory,
+        // the decoder also keeps the file system alive for the texture reader
+        auto texture = readTextureLazily(
+          m_gameFS->openFile(texturePath),
+          [gameFS = m_gameFS, texturePath]() { return gameFS->openFile(texturePath); },
+          textureReader);
+        texture.setAbsolutePath(absolutePath);
+        texture.setRelativePath(texturePath);
+        textures.push_back(std::move(texture));
       }
-      catch (const FileSystemException& e)
+      catch (const std::exception& e)
       {
-        m_logger.debug() << e.what();
+        m_logger.warn() << e.what();
       }
-
-      const auto name = file->path().lastComponent().deleteExtension().asString();
-      if (shouldExclude(name))
-      {
-        continue;
-      }
-      auto texture = textureReader.readTexture(file);
-      texture.setAbsolutePath(absolutePath);
-      texture.setRelativePath(texturePath);
-      textures.push_back(std::move(texture));
     }
-    catch (const std::exception& e)
+    else
+    {
+      pathsToRead.push_back(texturePath);
+      absolutePaths.push_back(std::move(absolutePath));
+    }
+  }
+
+  auto readResults = readTextures(pathsToRead, *m_gameFS, *textureReader);
+  for (size_t i = 0; i < readResults.size(); ++i)
+  {
+    if (auto& texture = readResults[i])
     {
-      m_logger.warn() << e.what();
+      texture->setAbsolutePath(absolutePaths[i]);
+      texture->setRelativePath(pathsToRead[i]);
+      textures.push_back(std::move(*texture));
     }
   }
 
@@ -19,7 +19,9 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -29,14 +31,16 @@ class Logger;
 
 namespace Assets
 {
+class Texture;
 class TextureCollection;
-}
+} // namespace Assets
 
 namespace IO
 {
 class File;
 class FileSystem;
 class Path;
+class SynchronizedFileSystem;
 class TextureReader;
 
 class TextureCollectionLoader
@@ -48,9 +52,15 @@ protected:
   Logger& m_logger;
   const std::vector<std::string> m_textureExclusions;
 
+  /**
+   * If set, the pixel data of the textures is not decoded when loading a collection, see
+   * readTextureLazily.
+   */
+  const bool m_loadLazily;
+
 protected:
-  explicit TextureCollectionLoader(
-    Logger& logger, const std::vector<std::string>& exclusions);
+  TextureCollectionLoader(
+    Logger& logger, const std::vector<std::string>& exclusions, bool loadLazily);
 
 public:
   virtual ~TextureCollectionLoader();
@@ -59,10 +69,45 @@ public:
   virtual Assets::TextureCollection loadTextureCollection(
     const Path& path,
     const std::vector<std::string>& textureExtensions,
-    const TextureReader& textureReader) = 0;
+    std::shared_ptr<const TextureReader> textureReader) = 0;
 
 protected:
   bool shouldExclude(const std::string& textureName);
+
+  /**
+   * Reads the textures at the given paths of the given file system with the given texture
+   * reader. Every file is opened, read and decoded by a task of its own, and the tasks
+   * run in parallel, so only the files currently being decoded are kept in memory.
+   *
+   * Since the texture reader may look up other files in its file system, both file
+   * systems must be safe to use from multiple threads, see SynchronizedFileSystem.
+   *
+   * Returns the textures in the order of the given paths. If a texture cannot be decoded,
+   * it is read again on the calling thread, which logs the error and loads the default
+   * texture. If a file cannot be opened, a warning is logged and the corresponding
+   * texture is empty.
+   */
+  std::vector<std::optional<Assets::Texture>> readTextures(
+    const std::vector<Path>& paths,
+    const FileSystem& fs,
+    const TextureReader& textureReader);
+
+  /**
+   * Reads the given file without decoding its pixel data, and gives the texture a decoder
+   * which decodes the file returned by the given function. Since the texture manager
+   * decodes the texture at some later time, the decoder shares the ownership of the
+   * texture reader, and the given function must share the ownership of the file system
+   * it opens the file from.
+   *
+   * The texture manager runs the decoders of several textures in parallel, so the given
+   * function and the texture reader must only use file systems which are safe to use from
+   * multiple threads, see SynchronizedFileSystem. The decoder reports errors by throwing
+   * an exception instead of logging them.
+   */
+  static Assets::Texture readTextureLazily(
+    std::shared_ptr<File> file,
+    std::function<std::shared_ptr<File>()> openFile,
+    std::shared_ptr<const TextureReader> textureReader);
 };
 
 class FileTextureCollectionLoader : public TextureCollectionLoader
@@ -74,29 +119,33 @@ public:
   FileTextureCollectionLoader(
     Logger& logger,
     const std::vector<Path>& searchPaths,
-    const std::vector<std::string>& exclusions);
+    const std::vector<std::string>& exclusions,
+    bool loadLazily);
 
 private:
   Assets::TextureCollection loadTextureCollection(
     const Path& path,
     const std::vector<std::string>& textureExtensions,
-    const TextureReader& textureReader);
+    std::shared_ptr<const TextureReader> textureReader);
 };
 
 class DirectoryTextureCollectionLoader : public TextureCollectionLoader
 {
 private:
-  const FileSystem& m_gameFS;
+  std::shared_ptr<const SynchronizedFileSystem> m_gameFS;
 
 public:
   DirectoryTextureCollectionLoader(
-    Logger& logger, const FileSystem& gameFS, const std::vector<std::string>& exclusions);
+    Logger& logger,
+    std::shared_ptr<const SynchronizedFileSystem> gameFS,
+    const std::vector<std::string>& exclusions,
+    bool loadLazily);
 
 private:
   Assets::TextureCollection loadTextureCollection(
     const Path& path,
     const std::vector<std::string>& textureExtensions,
-    const TextureReader& textureReader);
+    std::shared_ptr<const TextureReader> textureReader);
 };
 } // namespace IO
 } // namespace TrenchBroom
@@ -30,6 +30,8 @@
 #include "IO/M8TextureReader.h"
 #include "IO/Path.h"
 #include "IO/Quake3ShaderTextureReader.h"
+#include "IO/SynchronizedFileSystem.h"
+#include "IO/TextureCache.h"
 #include "IO/TextureCollectionLoader.h"
 #include "IO/WalTextureReader.h"
 #include "Logger.h"
@@ -45,14 +47,18 @@ namespace TrenchBroom
 namespace IO
 {
 TextureLoader::TextureLoader(
-  const FileSystem& gameFS,
+  std::shared_ptr<const SynchronizedFileSystem> gameFS,
   const std::vector<IO::Path>& fileSearchPaths,
   const Model::TextureConfig& textureConfig,
-  Logger& logger)
+  Logger& logger,
+  const bool loadLazily,
+  std::shared_ptr<const TextureCache> textureCache)
   : m_textureExtensions(getTextureExtensions(textureConfig))
-  , m_textureReader(createTextureReader(gameFS, textureConfig, logger))
-  , m_textureCollectionLoader(
-      createTextureCollectionLoader(gameFS, fileSearchPaths, textureConfig, logger))
+  , m_textureCache(std::move(textureCache))
+  , m_textureReader(
+      createTextureReader(*gameFS, textureConfig, logger, m_textureCache))
+  , m_textureCollectionLoader(createTextureCollectionLoader(
+      std::move(gameFS), fileSearchPaths, textureConfig, logger, loadLazily))
 {
   ensure(m_textureReader != nullptr, "textureReader is null");
   ensure(m_textureCollectionLoader != nullptr, "textureCollectionLoader is null");
@@ -67,7 +73,10 @@ std::vector<std::string> TextureLoader::getTextureExtensions(
 }
 
 std::unique_ptr<TextureReader> TextureLoader::createTextureReader(
-  const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger)
+  const FileSystem& gameFS,
+  const Model::TextureConfig& textureConfig,
+  Logger& logger,
+  std::shared_ptr<const TextureCache> textureCache)
 {
   const auto prefixLength = getRootDirectory(textureConfig.package).length();
   const TextureReader::PathSuffixNameStrategy nameStrategy(prefixLength);
@@ -88,11 +97,13 @@ std::unique_ptr<TextureReader> TextureLoader::createTextureReader(
   }
   else if (textureConfig.format.format == "image")
   {
-    return std::make_unique<FreeImageTextureReader>(nameStrategy, gameFS, logger);
+    return std::make_unique<FreeImageTextureReader>(
+      nameStrategy, gameFS, logger, std::move(textureCache));
   }
   else if (textureConfig.format.format == "q3shader")
   {
-    return std::make_unique<Quake3ShaderTextureReader>(nameStrategy, gameFS, logger);
+    return std::make_unique<Quake3ShaderTextureReader>(
+      nameStrategy, gameFS, logger, std::move(textureCache));
   }
   else if (textureConfig.format.format == "m8")
   {
@@ -126,10 +137,11 @@ Assets::Palette TextureLoader::loadPalette(
 }
 
 std::unique_ptr<TextureCollectionLoader> TextureLoader::createTextureCollectionLoader(
-  const FileSystem& gameFS,
+  std::shared_ptr<const SynchronizedFileSystem> gameFS,
   const std::vector<IO::Path>& fileSearchPaths,
   const Model::TextureConfig& textureConfig,
-  Logger& logger)
+  Logger& logger,
+  const bool loadLazily)
 {
   using Model::GameConfig;
   return std::visit(
@@ -137,12 +149,12 @@ std::unique_ptr<TextureCollectionLoader> TextureLoader::createTextureCollectionL
       [&](const Model::TextureFilePackageConfig&)
         -> std::unique_ptr<TextureCollectionLoader> {
         return std::make_unique<FileTextureCollectionLoader>(
-          logger, fileSearchPaths, textureConfig.excludes);
+          logger, fileSearchPaths, textureConfig.excludes, loadLazily);
       },
       [&](const Model::TextureDirectoryPackageConfig&)
         -> std::unique_ptr<TextureCollectionLoader> {
         return std::make_unique<DirectoryTextureCollectionLoader>(
-          logger, gameFS, textureConfig.excludes);
+          logger, gameFS, textureConfig.excludes, loadLazily);
       }),
     textureConfig.package);
 }
@@ -150,13 +162,17 @@ std::unique_ptr<TextureCollectionLoader> TextureLoader::createTextureCollectionL
 Assets::TextureCollection TextureLoader::loadTextureCollection(const Path& path)
 {
   return m_textureCollectionLoader->loadTextureCollection(
-    path, m_textureExtensions, *m_textureReader);
+    path, m_textureExtensions, m_textureReader);
 }
 
 void TextureLoader::loadTextures(
   const std::vector<Path>& paths, Assets::TextureManager& textureManager)
 {
   textureManager.setTextureCollections(paths, *this);
+  if (m_textureCache)
+  {
+    m_textureCache->trim();
+  }
 }
 } // namespace IO
 } // namespace TrenchBroom
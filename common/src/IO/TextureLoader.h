@@ -45,6 +45,8 @@ namespace IO
 {
 class FileSystem;
 class Path;
+class SynchronizedFileSystem;
+class TextureCache;
 class TextureCollectionLoader;
 class TextureReader;
 
@@ -52,29 +54,45 @@ class TextureLoader
 {
 private:
   std::vector<std::string> m_textureExtensions;
-  std::unique_ptr<TextureReader> m_textureReader;
+  std::shared_ptr<const TextureCache> m_textureCache;
+  std::shared_ptr<TextureReader> m_textureReader;
   std::unique_ptr<TextureCollectionLoader> m_textureCollectionLoader;
 
 public:
+  /**
+   * Creates a texture loader. The textures are decoded on multiple threads, so the game
+   * file system is synchronized. If loadLazily is set, the pixel data of the textures is
+   * not decoded until the texture manager needs it, see Assets::TextureManager. In that
+   * case, the given logger must outlive the loaded textures.
+   *
+   * If a texture cache is given, textures decoded from image files are read from and
+   * written to the cache, and the cache is trimmed after loading the textures.
+   */
   TextureLoader(
-    const FileSystem& gameFS,
+    std::shared_ptr<const SynchronizedFileSystem> gameFS,
     const std::vector<Path>& fileSearchPaths,
     const Model::TextureConfig& textureConfig,
-    Logger& logger);
+    Logger& logger,
+    bool loadLazily = false,
+    std::shared_ptr<const TextureCache> textureCache = nullptr);
   ~TextureLoader();
 
 private:
   static std::vector<std::string> getTextureExtensions(
     const Model::TextureConfig& textureConfig);
   static std::unique_ptr<TextureReader> createTextureReader(
-    const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger);
+    const FileSystem& gameFS,
+    const Model::TextureConfig& textureConfig,
+    Logger& logger,
+    std::shared_ptr<const TextureCache> textureCache);
   static Assets::Palette loadPalette(
     const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger);
   static std::unique_ptr<TextureCollectionLoader> createTextureCollectionLoader(
-    const FileSystem& gameFS,
+    std::shared_ptr<const SynchronizedFileSystem> gameFS,
     const std::vector<Path>& fileSearchPaths,
     const Model::TextureConfig& textureConfig,
-    Logger& logger);
+    Logger& logger,
+    bool loadLazily);
 
 public:
   Assets::TextureCollection loadTextureCollection(const Path& path);
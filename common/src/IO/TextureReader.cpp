@@ -126,6 +126,32 @@ Assets::Texture TextureReader::readTexture(std::shared_ptr<File> file) const
   }
 }
 
+Assets::Texture TextureReader::readTextureInfo(std::shared_ptr<File> file) const
+{
+  try
+  {
+    return doReadTextureInfo(file);
+  }
+  catch (const AssetException& e)
+  {
+    m_logger.error() << "Could not read texture '" << file->path() << "': " << e.what();
+    return loadDefaultTexture(
+      m_fs, m_logger, textureName(file->path().deleteExtension()));
+  }
+}
+
+Assets::Texture TextureReader::decodeTexture(std::shared_ptr<File> file) const
+{
+  return doReadTexture(std::move(file));
+}
+
+Assets::Texture TextureReader::doReadTextureInfo(std::shared_ptr<File> file) const
+{
+  auto texture = doReadTexture(std::move(file));
+  texture.unload();
+  return texture;
+}
+
 std::string TextureReader::textureName(
   const std::string& textureName, const Path& path) const
 {
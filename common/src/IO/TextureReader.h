@@ -143,6 +143,32 @@ public:
    */
   Assets::Texture readTexture(std::shared_ptr<File> file) const;
 
+  /**
+   * Loads the name, the dimensions and the other properties of a texture from the given
+   * file, but not its pixel data unless that is required to determine them. This is used
+   * to load textures lazily. If an error occurs while loading the texture, the default
+   * texture is returned.
+   *
+   * @param file the file containing the texture
+   * @return an Assets::Texture object without pixel data
+   */
+  Assets::Texture readTextureInfo(std::shared_ptr<File> file) const;
+
+  /**
+   * Loads a texture from the given file and returns it. Unlike readTexture, errors are
+   * reported by throwing an exception instead of logging them, so that textures can be
+   * decoded on other threads while the logger is used by the calling thread only.
+   *
+   * Textures are decoded in parallel, so this may be called from multiple threads at
+   * once. Implementations must not modify any shared state, and the file system given to
+   * this reader must be safe to use from multiple threads, see SynchronizedFileSystem.
+   *
+   * @param file the file containing the texture
+   * @return an Assets::Texture object
+   * @throws AssetException if the texture cannot be read
+   */
+  Assets::Texture decodeTexture(std::shared_ptr<File> file) const;
+
 protected:
   std::string textureName(const std::string& textureName, const Path& path) const;
   std::string textureName(const Path& path) const;
@@ -158,6 +184,16 @@ private:
    */
   virtual Assets::Texture doReadTexture(std::shared_ptr<File> file) const = 0;
 
+  /**
+   * Loads a texture without its pixel data. The default implementation loads the entire
+   * texture and discards its pixel data, so readers should override this if they can
+   * read the texture's properties more cheaply.
+   *
+   * @param file the file containing the texture
+   * @return an Assets::Texture object without pixel data
+   */
+  virtual Assets::Texture doReadTextureInfo(std::shared_ptr<File> file) const;
+
 protected:
   static bool checkTextureDimensions(size_t width, size_t height);
 
@@ -21,6 +21,7 @@
 
 #include <cassert>
 #include <string>
+#include <string_view>
 
 #include <kdl/string_utils.h>
 
@@ -77,6 +78,12 @@ public:
 
   const std::string data() const { return std::string(m_begin, length()); }
 
+  /**
+   * Returns a view of this token's text. The view refers to the tokenized source and is
+   * only valid as long as the source is alive.
+   */
+  std::string_view view() const { return std::string_view(m_begin, length()); }
+
   size_t position() const { return m_position; }
 
   size_t length() const { return static_cast<size_t>(m_end - m_begin); }
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Token.h"
+#include "TokenizerScan.h"
 
 #include "Exceptions.h"
 #include "Macros.h"
@@ -53,11 +54,18 @@ struct TokenizerStateAndSource
 class TokenizerBase
 {
 protected:
+  /**
+   * The number of characters that are examined one at a time before a run of characters
+   * is skipped using the scanning functions.
+   */
+  static constexpr size_t ShortRunLength = 16;
+
   const char* m_begin;
   const char* m_end;
   std::string m_escapableChars;
   char m_escapeChar;
   TokenizerState m_state;
+  bool m_skipRunsInBulk = true;
 
 public:
   TokenizerBase(
@@ -83,6 +91,13 @@ public:
     reset();
   }
 
+  /**
+   * Controls whether long runs of characters are skipped using the scanning functions.
+   * If disabled, every character is examined one at a time. This is only useful to
+   * compare the performance of both methods.
+   */
+  void setSkipRunsInBulk(const bool skipRunsInBulk) { m_skipRunsInBulk = skipRunsInBulk; }
+
   TokenizerStateAndSource snapshotStateAndSource() const
   {
     return {m_state, m_begin, m_end};
@@ -135,10 +150,89 @@ protected:
 
   void advance(size_t offset)
   {
-    for (size_t i = 0; i < offset; ++i)
+    if (offset > static_cast<size_t>(m_end - m_state.cur))
+    {
+      throw ParserException("Unexpected end of file");
+    }
+    advanceTo(m_state.cur + offset);
+  }
+
+  /**
+   * Advances to the given position, which must not be before the current position or
+   * after the end of the input. This has the same effect on the line, column and escape
+   * state as calling advance() for every character up to the given position, but the
+   * skipped characters are processed in bulk.
+   */
+  void advanceTo(const char* target)
+  {
+    assert(target >= m_state.cur && target <= m_end);
+    if (target == m_state.cur)
+    {
+      return;
+    }
+
+    // a carriage return at the end of the range only counts as a line break if it is not
+    // followed by a line feed, see advance()
+    const auto isLineBreak = [&](const char* c) {
+      return *c == '\n' || (*c == '\r' && (c + 1 == m_end || c[1] != '\n'));
+    };
+
+    // find the last line break in the range
+    const auto* lineStart = target;
+    while (lineStart != m_state.cur && !isLineBreak(lineStart - 1))
+    {
+      --lineStart;
+    }
+
+    // a carriage return that is followed by a line feed doesn't affect the escape state
+    const auto* escapeEnd = target;
+    if (escapeEnd[-1] == '\r' && escapeEnd != m_end && *escapeEnd == '\n')
+    {
+      --escapeEnd;
+    }
+
+    // the escape state is toggled by every escape character and reset by any other one
+    const auto* escapeStart = escapeEnd;
+    while (escapeStart != lineStart && escapeStart[-1] == m_escapeChar)
+    {
+      --escapeStart;
+    }
+    const auto escapeCount = static_cast<size_t>(escapeEnd - escapeStart);
+
+    if (lineStart == m_state.cur)
+    {
+      m_state.column += static_cast<size_t>(target - m_state.cur);
+      m_state.escaped =
+        escapeStart == m_state.cur ? m_state.escaped != (escapeCount % 2u == 1u)
+                                   : escapeCount % 2u == 1u;
+    }
+    else
+    {
+      m_state.line += Scan::countLineBreaks(m_state.cur, lineStart, m_end);
+      m_state.column = static_cast<size_t>(target - lineStart) + 1u;
+      m_state.escaped = escapeCount % 2u == 1u;
+    }
+    m_state.cur = target;
+  }
+
+  /**
+   * Advances past the characters that satisfy the given predicate. Most tokens and runs
+   * of whitespace are short, so the first few characters are examined one at a time, and
+   * only a longer run is skipped using the given scanning function, which must return the
+   * first character in the given range that does not satisfy the predicate.
+   */
+  template <typename P, typename S>
+  void advanceWhile(const P& predicate, const S& scan)
+  {
+    for (size_t i = 0; !m_skipRunsInBulk || i < ShortRunLength; ++i)
     {
+      if (eof() || !predicate(curChar()))
+      {
+        return;
+      }
       advance();
     }
+    advanceTo(scan(m_state.cur, m_end));
   }
 
   void advance()
@@ -387,10 +481,7 @@ protected:
     {
       advance();
     }
-    while (!eof() && isDigit(curChar()))
-    {
-      advance();
-    }
+    readDigits();
     if (eof() || isAnyOf(curChar(), delims))
     {
       return curPos();
@@ -440,12 +531,28 @@ protected:
   }
 
 private:
+  void skipWhile(std::string_view allow)
+  {
+    advanceWhile(
+      [&](const char c) { return isAnyOf(c, allow); },
+      [&](const char* begin, const char* end) {
+        return Scan::findFirstNotOf(begin, end, allow);
+      });
+  }
+
+  void skipUntil(std::string_view delims)
+  {
+    advanceWhile(
+      [&](const char c) { return !isAnyOf(c, delims); },
+      [&](const char* begin, const char* end) {
+        return Scan::findFirstOf(begin, end, delims);
+      });
+  }
+
   void readDigits()
   {
-    while (!eof() && isDigit(curChar()))
-    {
-      advance();
-    }
+    advanceWhile(
+      [](const char c) { return c >= '0' && c <= '9'; }, &Scan::findFirstNonDigit);
   }
 
 protected:
@@ -453,28 +560,36 @@ protected:
   {
     if (!eof())
     {
-      do
-      {
-        advance();
-      } while (!eof() && !isAnyOf(curChar(), delims));
+      advance();
+      skipUntil(delims);
     }
     return curPos();
   }
 
   const char* readWhile(std::string_view allow)
   {
-    while (!eof() && isAnyOf(curChar(), allow))
-    {
-      advance();
-    }
+    skipWhile(allow);
     return curPos();
   }
 
   const char* readQuotedString(
     const char delim = '"', std::string_view hackDelims = std::string_view())
   {
-    while (!eof() && (curChar() != delim || isEscaped()))
-    {
+    const char stopChars[] = {delim, m_escapeChar};
+    const auto stopCharsView = std::string_view(stopChars, sizeof(stopChars));
+    while (!eof())
+    {
+      // skip ahead to the next character that may end the string or escape the delimiter
+      advanceWhile(
+        [&](const char c) { return c != delim && c != m_escapeChar; },
+        [&](const char* begin, const char* end) {
+          return Scan::findFirstOf(begin, end, stopCharsView);
+        });
+      if (eof() || (curChar() == delim && !isEscaped()))
+      {
+        break;
+      }
+
       // This is a hack to handle paths with trailing backslashes that get misinterpreted
       // as escaped double quotation marks.
       if (
@@ -494,19 +609,13 @@ protected:
 
   const char* discardWhile(std::string_view allow)
   {
-    while (!eof() && isAnyOf(curChar(), allow))
-    {
-      advance();
-    }
+    skipWhile(allow);
     return curPos();
   }
 
   const char* discardUntil(std::string_view delims)
   {
-    while (!eof() && !isAnyOf(curChar(), delims))
-    {
-      advance();
-    }
+    skipUntil(delims);
     return curPos();
   }
 
@@ -0,0 +1,254 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TB_TOKENIZER_SCAN_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace TrenchBroom
+{
+namespace IO
+{
+/**
+ * Scanning functions used by the tokenizers to skip over runs of characters.
+ *
+ * On x86 processors, the functions examine 16 characters at a time using SSE2
+ * instructions. Otherwise, and for the remainder of a range that is shorter than 16
+ * characters, they fall back to examining one character at a time. The functions never
+ * read outside of the given range.
+ */
+namespace Scan
+{
+namespace detail
+{
+inline bool isAnyOf(const char c, std::string_view chars)
+{
+  for (const auto x : chars)
+  {
+    if (c == x)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+inline bool isDigit(const char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+#ifdef TB_TOKENIZER_SCAN_SSE2
+constexpr auto BlockSize = 16;
+
+inline unsigned int firstSetBit(const unsigned int mask)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned int>(index);
+#else
+  return static_cast<unsigned int>(__builtin_ctz(mask));
+#endif
+}
+
+inline unsigned int countSetBits(unsigned int mask)
+{
+  auto count = 0u;
+  while (mask != 0u)
+  {
+    mask &= mask - 1u;
+    ++count;
+  }
+  return count;
+}
+
+inline __m128i load(const char* ptr)
+{
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+}
+
+/**
+ * Returns a mask with bit i set if the character at position i of the given block is one
+ * of the given characters.
+ */
+inline unsigned int matchAnyOf(const __m128i block, std::string_view chars)
+{
+  auto matches = _mm_setzero_si128();
+  for (const auto c : chars)
+  {
+    matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, _mm_set1_epi8(c)));
+  }
+  return static_cast<unsigned int>(_mm_movemask_epi8(matches));
+}
+
+/**
+ * Returns a mask with bit i set if the character at position i of the given block is a
+ * decimal digit.
+ */
+inline unsigned int matchDigits(const __m128i block)
+{
+  // a character is a digit if c - '0' is at most 9 when compared as an unsigned value
+  const auto offset = _mm_sub_epi8(block, _mm_set1_epi8('0'));
+  const auto digits = _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(9)), offset);
+  return static_cast<unsigned int>(_mm_movemask_epi8(digits));
+}
+
+template <typename M>
+const char* findFirstMatch(const char* begin, const char* end, M match)
+{
+  while (end - begin >= BlockSize)
+  {
+    if (const auto mask = match(load(begin)))
+    {
+      return begin + firstSetBit(mask);
+    }
+    begin += BlockSize;
+  }
+  return begin;
+}
+#endif
+} // namespace detail
+
+/**
+ * Returns a pointer to the first character in the given range which is one of the given
+ * characters, or end if there is no such character.
+ */
+inline const char* findFirstOf(const char* begin, const char* end, std::string_view chars)
+{
+  // tokens are often short, so check the first character before scanning blocks
+  if (begin == end || detail::isAnyOf(*begin, chars))
+  {
+    return begin;
+  }
+
+#ifdef TB_TOKENIZER_SCAN_SSE2
+  begin = detail::findFirstMatch(begin, end, [&](const __m128i block) {
+    return detail::matchAnyOf(block, chars);
+  });
+#endif
+
+  while (begin != end && !detail::isAnyOf(*begin, chars))
+  {
+    ++begin;
+  }
+  return begin;
+}
+
+/**
+ * Returns a pointer to the first character in the given range which is not one of the
+ * given characters, or end if there is no such character.
+ */
+inline const char* findFirstNotOf(
+  const char* begin, const char* end, std::string_view chars)
+{
+  if (begin == end || !detail::isAnyOf(*begin, chars))
+  {
+    return begin;
+  }
+
+#ifdef TB_TOKENIZER_SCAN_SSE2
+  begin = detail::findFirstMatch(begin, end, [&](const __m128i block) {
+    return ~detail::matchAnyOf(block, chars) & 0xFFFFu;
+  });
+#endif
+
+  while (begin != end && detail::isAnyOf(*begin, chars))
+  {
+    ++begin;
+  }
+  return begin;
+}
+
+/**
+ * Returns a pointer to the first character in the given range which is not a decimal
+ * digit, or end if there is no such character.
+ */
+inline const char* findFirstNonDigit(const char* begin, const char* end)
+{
+  if (begin == end || !detail::isDigit(*begin))
+  {
+    return begin;
+  }
+
+#ifdef TB_TOKENIZER_SCAN_SSE2
+  begin = detail::findFirstMatch(begin, end, [](const __m128i block) {
+    return ~detail::matchDigits(block) & 0xFFFFu;
+  });
+#endif
+
+  while (begin != end && detail::isDigit(*begin))
+  {
+    ++begin;
+  }
+  return begin;
+}
+
+/**
+ * Counts the line breaks in the given range. A line break is either a line feed or a
+ * carriage return that is not followed by a line feed. A carriage return at the end of
+ * the range is checked against the character at the end of the range, unless the end of
+ * the range is the end of the buffer.
+ *
+ * @param begin the start of the range
+ * @param end the end of the range
+ * @param bufferEnd the end of the buffer that contains the range
+ */
+inline size_t countLineBreaks(const char* begin, const char* end, const char* bufferEnd)
+{
+  auto count = size_t(0);
+
+#ifdef TB_TOKENIZER_SCAN_SSE2
+  const auto lineFeed = _mm_set1_epi8('\n');
+  const auto carriageReturn = _mm_set1_epi8('\r');
+  // the block after the current one is loaded too, so one more character must be readable
+  while (end - begin > detail::BlockSize)
+  {
+    const auto block = detail::load(begin);
+    const auto next = detail::load(begin + 1);
+    const auto lineFeeds =
+      static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, lineFeed)));
+    const auto carriageReturns = static_cast<unsigned int>(_mm_movemask_epi8(
+      _mm_andnot_si128(_mm_cmpeq_epi8(next, lineFeed), _mm_cmpeq_epi8(block, carriageReturn))));
+    count += detail::countSetBits(lineFeeds) + detail::countSetBits(carriageReturns);
+    begin += detail::BlockSize;
+  }
+#endif
+
+  for (; begin != end; ++begin)
+  {
+    if (*begin == '\n' || (*begin == '\r' && (begin + 1 == bufferEnd || begin[1] != '\n')))
+    {
+      ++count;
+    }
+  }
+  return count;
+}
+} // namespace Scan
+} // namespace IO
+} // namespace TrenchBroom
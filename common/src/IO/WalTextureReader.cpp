@@ -50,9 +50,20 @@ WalTextureReader::WalTextureReader(
 
 Assets::Texture WalTextureReader::doReadTexture(std::shared_ptr<File> file) const
 {
-  const auto& path = file->path();
   auto reader = file->reader().buffer();
+  return readWal(reader, file->path(), true);
+}
+
+Assets::Texture WalTextureReader::doReadTextureInfo(std::shared_ptr<File> file) const
+{
+  // only the header is needed, so don't buffer the entire file
+  auto reader = file->reader();
+  return readWal(reader, file->path(), false);
+}
 
+Assets::Texture WalTextureReader::readWal(
+  Reader& reader, const Path& path, const bool readPixels) const
+{
   try
   {
     const char version = reader.readChar<char>();
@@ -60,11 +71,11 @@ Assets::Texture WalTextureReader::doReadTexture(std::shared_ptr<File> file) cons
 
     if (version == 3)
     {
-      return readDkWal(reader, path);
+      return readDkWal(reader, path, readPixels);
     }
     else
     {
-      return readQ2Wal(reader, path);
+      return readQ2Wal(reader, path, readPixels);
     }
   }
   catch (const ReaderException&)
@@ -74,12 +85,12 @@ Assets::Texture WalTextureReader::doReadTexture(std::shared_ptr<File> file) cons
 }
 
 Assets::Texture WalTextureReader::readQ2Wal(
-  BufferedReader& reader, const Path& path) const
+  Reader& reader, const Path& path, const bool readPixels) const
 {
   static const size_t MaxMipLevels = 4;
-  static Color averageColor;
-  static Assets::TextureBufferList buffers(MaxMipLevels);
-  static size_t offsets[MaxMipLevels];
+  Color averageColor;
+  Assets::TextureBufferList buffers(MaxMipLevels);
+  size_t offsets[MaxMipLevels];
 
   // https://github.com/id-Software/Quake-2-Tools/blob/master/qe4/qfiles.h#L142
 
@@ -100,7 +111,7 @@ Assets::Texture WalTextureReader::readQ2Wal(
   const auto value = reader.readInt<int32_t>();
   const auto gameData = Assets::Q2Data{flags, contents, value};
 
-  if (!m_palette.initialized())
+  if (!readPixels || !m_palette.initialized())
   {
     return Assets::Texture(
       textureName(name, path),
@@ -134,12 +145,12 @@ Assets::Texture WalTextureReader::readQ2Wal(
 }
 
 Assets::Texture WalTextureReader::readDkWal(
-  BufferedReader& reader, const Path& path) const
+  Reader& reader, const Path& path, const bool readPixels) const
 {
   static const size_t MaxMipLevels = 9;
-  static Color averageColor;
-  static Assets::TextureBufferList buffers(MaxMipLevels);
-  static size_t offsets[MaxMipLevels];
+  Color averageColor;
+  Assets::TextureBufferList buffers(MaxMipLevels);
+  size_t offsets[MaxMipLevels];
 
   // https://gist.github.com/DanielGibson/a53c74b10ddd0a1f3d6ab42909d5b7e1
 
@@ -158,7 +169,6 @@ Assets::Texture WalTextureReader::readDkWal(
   }
 
   const auto mipLevels = readMipOffsets(MaxMipLevels, offsets, width, height, reader);
-  Assets::setMipBufferSize(buffers, mipLevels, width, height, GL_RGBA);
 
   /* const std::string animname = */ reader.readString(WalLayout::TextureNameLength);
   const auto flags = reader.readInt<int32_t>();
@@ -169,6 +179,19 @@ Assets::Texture WalTextureReader::readDkWal(
   const auto value = reader.readInt<int32_t>();
   const auto gameData = Assets::Q2Data{flags, contents, value};
 
+  if (!readPixels)
+  {
+    // whether the texture is masked is only known once its pixels have been read
+    return Assets::Texture(
+      textureName(name, path),
+      width,
+      height,
+      GL_RGBA,
+      Assets::TextureType::Opaque,
+      gameData);
+  }
+
+  Assets::setMipBufferSize(buffers, mipLevels, width, height, GL_RGBA);
   const auto embeddedPalette = Assets::Palette::fromRaw(paletteReader);
   const auto hasTransparency = readMips(
     embeddedPalette,
@@ -223,12 +246,12 @@ bool WalTextureReader::readMips(
   const size_t offsets[],
   const size_t width,
   const size_t height,
-  BufferedReader& reader,
+  Reader& reader,
   Assets::TextureBufferList& buffers,
   Color& averageColor,
   const Assets::PaletteTransparency transparency)
 {
-  static Color tempColor;
+  Color tempColor;
 
   auto hasTransparency = false;
   for (size_t i = 0; i < mipLevels; ++i)
@@ -49,8 +49,10 @@ public:
 
 private:
   Assets::Texture doReadTexture(std::shared_ptr<File> file) const override;
-  Assets::Texture readQ2Wal(BufferedReader& reader, const Path& path) const;
-  Assets::Texture readDkWal(BufferedReader& reader, const Path& path) const;
+  Assets::Texture doReadTextureInfo(std::shared_ptr<File> file) const override;
+  Assets::Texture readWal(Reader& reader, const Path& path, bool readPixels) const;
+  Assets::Texture readQ2Wal(Reader& reader, const Path& path, bool readPixels) const;
+  Assets::Texture readDkWal(Reader& reader, const Path& path, bool readPixels) const;
   size_t readMipOffsets(
     size_t maxMipLevels,
     size_t offsets[],
@@ -63,7 +65,7 @@ private:
     const size_t offsets[],
     size_t width,
     size_t height,
-    BufferedReader& reader,
+    Reader& reader,
     Assets::TextureBufferList& buffers,
     Color& averageColor,
     Assets::PaletteTransparency transparency);
@@ -20,6 +20,7 @@
 #include "WorldReader.h"
 
 #include "Color.h"
+#include "IO/MapCache.h"
 #include "IO/ParserStatus.h"
 #include "Model/BrushNode.h"
 #include "Model/Entity.h"
@@ -125,6 +126,29 @@ std::unique_ptr<Model::WorldNode> WorldReader::read(
   const vm::bbox3& worldBounds, ParserStatus& status)
 {
   readEntities(worldBounds, status);
+  return finishReading(status);
+}
+
+std::unique_ptr<Model::WorldNode> WorldReader::readFromCache(
+  const MapCache& cache,
+  const vm::bbox3& worldBounds,
+  const Model::EntityPropertyConfig& entityPropertyConfig,
+  ParserStatus& status)
+{
+  auto cachedData = cache.read();
+  if (!cachedData)
+  {
+    return nullptr;
+  }
+
+  auto& [mapFormat, objectInfos] = *cachedData;
+  auto reader = WorldReader{std::string_view{}, mapFormat, entityPropertyConfig};
+  reader.readObjectInfos(std::move(objectInfos), worldBounds, status);
+  return reader.finishReading(status);
+}
+
+std::unique_ptr<Model::WorldNode> WorldReader::finishReading(ParserStatus& status)
+{
   sanitizeLayerSortIndicies(status);
   m_world->rebuildNodeTree();
   m_world->enableNodeTreeUpdates();
@@ -37,6 +37,7 @@ class WorldNode;
 
 namespace IO
 {
+class MapCache;
 class ParserStatus;
 
 class WorldReaderException : public Exception
@@ -63,6 +64,15 @@ public:
   std::unique_ptr<Model::WorldNode> read(
     const vm::bbox3& worldBounds, ParserStatus& status);
 
+  /**
+   * Restores the world from the given cache. Returns null if the cache cannot be used.
+   */
+  static std::unique_ptr<Model::WorldNode> readFromCache(
+    const MapCache& cache,
+    const vm::bbox3& worldBounds,
+    const Model::EntityPropertyConfig& entityPropertyConfig,
+    ParserStatus& status);
+
   /**
    * Try to parse the given string as the given map formats, in order.
    * Returns the world if parsing is successful, otherwise throws an exception.
@@ -82,6 +92,7 @@ public:
     ParserStatus& status);
 
 private:
+  std::unique_ptr<Model::WorldNode> finishReading(ParserStatus& status);
   void sanitizeLayerSortIndicies(ParserStatus& status);
 
 private: // implement MapReader interface
@@ -22,6 +22,7 @@
 #include "IO/ImageFileSystem.h"
 
 #include <memory>
+#include <mutex>
 
 #include <miniz/miniz.h>
 
@@ -36,6 +37,12 @@ class ZipFileSystem : public ImageFileSystem
 private:
   mz_zip_archive m_archive;
 
+  /**
+   * Guards the archive, which reads from a shared file, so that files can be opened from
+   * multiple threads.
+   */
+  std::mutex m_archiveMutex;
+
 private:
   class ZipCompressedFile : public FileEntry
   {
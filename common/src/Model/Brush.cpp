@@ -24,6 +24,7 @@
 #include "Model/BrushError.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
+#include "Model/CompactBrushGeometry.h"
 #include "Model/MapFormat.h"
 #include "Model/TexCoordSystem.h"
 #include "Polyhedron.h"
@@ -37,6 +38,7 @@
 #include <vecmath/intersection.h>
 #include <vecmath/mat.h>
 #include <vecmath/mat_ext.h>
+#include <vecmath/plane.h>
 #include <vecmath/polygon.h>
 #include <vecmath/segment.h>
 #include <vecmath/util.h>
@@ -44,6 +46,7 @@
 #include <vecmath/vec_ext.h>
 
 #include <iterator>
+#include <map>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -53,35 +56,14 @@ namespace TrenchBroom
 {
 namespace Model
 {
-class Brush::CopyCallback : public BrushGeometry::CopyCallback
-{
-public:
-  void faceWasCopied(
-    const BrushFaceGeometry* original, BrushFaceGeometry* copy) const override
-  {
-    copy->setPayload(original->payload());
-  }
-};
-
 Brush::Brush() {}
 
 Brush::Brush(const Brush& other)
   : m_faces(other.m_faces)
-  , m_geometry(
-      other.m_geometry
-        ? std::make_unique<BrushGeometry>(*other.m_geometry, CopyCallback())
-        : nullptr)
 {
-  if (m_geometry)
+  if (other.m_geometry)
   {
-    for (BrushFaceGeometry* faceGeometry : m_geometry->faces())
-    {
-      if (const auto faceIndex = faceGeometry->payload())
-      {
-        BrushFace& face = m_faces[*faceIndex];
-        face.setGeometry(faceGeometry);
-      }
-    }
+    setGeometry(other.m_geometry);
   }
 }
 
@@ -121,21 +103,27 @@ kdl::result<Brush, BrushError> Brush::create(
   });
 }
 
+Brush::Brush(std::vector<BrushFace> faces, CompactBrushGeometry geometry)
+  : m_faces(std::move(faces))
+{
+  assert(geometry.faceCount() == m_faces.size());
+  setGeometry(std::make_shared<const CompactBrushGeometry>(std::move(geometry)));
+}
+
 kdl::result<void, BrushError> Brush::updateGeometryFromFaces(const vm::bbox3& worldBounds)
 {
   // First, add all faces to the brush geometry
   BrushFace::sortFaces(m_faces);
 
-  auto geometry = std::make_unique<BrushGeometry>(worldBounds);
+  auto geometry = BrushGeometry{worldBounds};
 
   for (size_t i = 0u; i < m_faces.size(); ++i)
   {
     BrushFace& face = m_faces[i];
-    const auto result = geometry->clip(face.boundary());
+    const auto result = geometry.clip(face.boundary());
     if (result.success())
     {
       BrushFaceGeometry* faceGeometry = result.face();
-      face.setGeometry(faceGeometry);
       faceGeometry->setPayload(i);
     }
     else if (result.empty())
@@ -145,8 +133,8 @@ kdl::result<void, BrushError> Brush::updateGeometryFromFaces(const vm::bbox3& wo
   }
 
   // Correct vertex positions and heal short edges
-  geometry->correctVertexPositions();
-  if (!geometry->healEdges())
+  geometry.correctVertexPositions();
+  if (!geometry.healEdges())
   {
     return BrushError::InvalidBrush;
   }
@@ -155,7 +143,7 @@ kdl::result<void, BrushError> Brush::updateGeometryFromFaces(const vm::bbox3& wo
   std::vector<BrushFace> remainingFaces;
   remainingFaces.reserve(m_faces.size());
 
-  for (BrushFaceGeometry* faceGeometry : geometry->faces())
+  for (BrushFaceGeometry* faceGeometry : geometry.faces())
   {
     if (const auto faceIndex = faceGeometry->payload())
     {
@@ -169,11 +157,27 @@ kdl::result<void, BrushError> Brush::updateGeometryFromFaces(const vm::bbox3& wo
   }
 
   m_faces = std::move(remainingFaces);
+  setGeometry(std::make_shared<const CompactBrushGeometry>(geometry));
+
+  return kdl::void_success;
+}
+
+void Brush::setGeometry(std::shared_ptr<const CompactBrushGeometry> geometry)
+{
   m_geometry = std::move(geometry);
+  for (size_t i = 0u; i < m_faces.size(); ++i)
+  {
+    m_faces[i].setGeometry(m_geometry.get(), i);
+  }
 
   assert(checkFaceLinks());
+}
 
-  return kdl::void_success;
+BrushGeometry Brush::makeGeometry() const
+{
+  ensure(m_geometry != nullptr, "geometry is null");
+  return m_geometry->makeBrushGeometry(
+    kdl::vec_transform(m_faces, [](const auto& face) { return face.boundary(); }));
 }
 
 const vm::bbox3& Brush::bounds() const
@@ -258,16 +262,9 @@ bool Brush::closed() const
 
 bool Brush::fullySpecified() const
 {
+  // every face of the geometry corresponds to a brush face
   ensure(m_geometry != nullptr, "geometry is null");
-
-  for (auto* current : m_geometry->faces())
-  {
-    if (!current->payload().has_value())
-    {
-      return false;
-    }
-  }
-  return true;
+  return m_geometry->faceCount() == m_faces.size();
 }
 
 void Brush::cloneFaceAttributesFrom(const Brush& brush)
@@ -409,19 +406,19 @@ kdl::result<void, BrushError> Brush::expand(
   return updateGeometryFromFaces(worldBounds);
 }
 
-size_t Brush::vertexCount() const
+const CompactBrushGeometry& Brush::geometry() const
 {
   ensure(m_geometry != nullptr, "geometry is null");
-  return m_geometry->vertexCount();
+  return *m_geometry;
 }
 
-const Brush::VertexList& Brush::vertices() const
+size_t Brush::vertexCount() const
 {
   ensure(m_geometry != nullptr, "geometry is null");
-  return m_geometry->vertices();
+  return m_geometry->vertexCount();
 }
 
-const std::vector<vm::vec3> Brush::vertexPositions() const
+const std::vector<vm::vec3>& Brush::vertexPositions() const
 {
   ensure(m_geometry != nullptr, "geometry is null");
   return m_geometry->vertexPositions();
@@ -430,13 +427,15 @@ const std::vector<vm::vec3> Brush::vertexPositions() const
 bool Brush::hasVertex(const vm::vec3& position, const FloatType epsilon) const
 {
   ensure(m_geometry != nullptr, "geometry is null");
-  return m_geometry->findVertexByPosition(position, epsilon) != nullptr;
+  return m_geometry->findVertex(position, epsilon).has_value();
 }
 
 vm::vec3 Brush::findClosestVertexPosition(const vm::vec3& position) const
 {
   ensure(m_geometry != nullptr, "geometry is null");
-  return m_geometry->findClosestVertex(position)->position();
+  const auto vertexIndex = m_geometry->findClosestVertex(position);
+  ensure(vertexIndex.has_value(), "brush has vertices");
+  return m_geometry->vertexPosition(*vertexIndex);
 }
 
 std::vector<vm::vec3> Brush::findClosestVertexPositions(
@@ -449,10 +448,11 @@ std::vector<vm::vec3> Brush::findClosestVertexPositions(
 
   for (const auto& position : positions)
   {
-    const auto* newVertex = m_geometry->findClosestVertex(position, CloseVertexEpsilon);
-    if (newVertex != nullptr)
+    if (
+      const auto vertexIndex =
+        m_geometry->findClosestVertex(position, CloseVertexEpsilon))
     {
-      result.push_back(newVertex->position());
+      result.push_back(m_geometry->vertexPosition(*vertexIndex));
     }
   }
 
@@ -469,12 +469,13 @@ std::vector<vm::segment3> Brush::findClosestEdgePositions(
 
   for (const auto& edgePosition : positions)
   {
-    const auto* newEdge = m_geometry->findClosestEdge(
-      edgePosition.start(), edgePosition.end(), CloseVertexEpsilon);
-    if (newEdge != nullptr)
+    if (const auto edgeIndex = m_geometry->findClosestEdge(
+          edgePosition.start(), edgePosition.end(), CloseVertexEpsilon))
     {
+      const auto [vertexIndex1, vertexIndex2] = m_geometry->edgeVertexIndices(*edgeIndex);
       result.push_back(vm::segment3(
-        newEdge->firstVertex()->position(), newEdge->secondVertex()->position()));
+        m_geometry->vertexPosition(vertexIndex1),
+        m_geometry->vertexPosition(vertexIndex2)));
     }
   }
 
@@ -491,11 +492,11 @@ std::vector<vm::polygon3> Brush::findClosestFacePositions(
 
   for (const auto& facePosition : positions)
   {
-    const auto* newFace =
-      m_geometry->findClosestFace(facePosition.vertices(), CloseVertexEpsilon);
-    if (newFace != nullptr)
+    if (
+      const auto faceIndex =
+        m_geometry->findClosestFace(facePosition.vertices(), CloseVertexEpsilon))
     {
-      result.push_back(vm::polygon3(newFace->vertexPositions()));
+      result.push_back(vm::polygon3(m_geometry->faceVertexPositions(*faceIndex)));
     }
   }
 
@@ -505,13 +506,13 @@ std::vector<vm::polygon3> Brush::findClosestFacePositions(
 bool Brush::hasEdge(const vm::segment3& edge, const FloatType epsilon) const
 {
   ensure(m_geometry != nullptr, "geometry is null");
-  return m_geometry->findEdgeByPositions(edge.start(), edge.end(), epsilon) != nullptr;
+  return m_geometry->findEdge(edge.start(), edge.end(), epsilon).has_value();
 }
 
 bool Brush::hasFace(const vm::polygon3& face, const FloatType epsilon) const
 {
   ensure(m_geometry != nullptr, "geometry is null");
-  return m_geometry->hasFace(face.vertices(), epsilon);
+  return m_geometry->findFace(face.vertices(), epsilon).has_value();
 }
 
 size_t Brush::edgeCount() const
@@ -520,12 +521,6 @@ size_t Brush::edgeCount() const
   return m_geometry->edgeCount();
 }
 
-const Brush::EdgeList& Brush::edges() const
-{
-  ensure(m_geometry != nullptr, "geometry is null");
-  return m_geometry->edges();
-}
-
 bool Brush::containsPoint(const vm::vec3& point) const
 {
   if (!bounds().contains(point))
@@ -545,23 +540,12 @@ bool Brush::containsPoint(const vm::vec3& point) const
   }
 }
 
-std::vector<const BrushFace*> Brush::incidentFaces(const BrushVertex* vertex) const
+std::vector<const BrushFace*> Brush::incidentFaces(const size_t vertexIndex) const
 {
-  std::vector<const BrushFace*> result;
-  result.reserve(m_faces.size());
-
-  auto* first = vertex->leaving();
-  auto* current = first;
-  do
-  {
-    if (const auto faceIndex = current->face()->payload())
-    {
-      result.push_back(&m_faces[*faceIndex]);
-    }
-    current = current->nextIncident();
-  } while (current != first);
-
-  return result;
+  ensure(m_geometry != nullptr, "geometry is null");
+  return kdl::vec_transform(
+    m_geometry->incidentFaces(vertexIndex),
+    [&](const auto faceIndex) { return &m_faces[faceIndex]; });
 }
 
 bool Brush::canMoveVertices(
@@ -599,21 +583,21 @@ kdl::result<void, BrushError> Brush::addVertex(
 {
   assert(canAddVertex(worldBounds, position));
 
+  const BrushGeometry oldGeometry = makeGeometry();
   BrushGeometry newGeometry(
     kdl::vec_concat(m_geometry->vertexPositions(), std::vector<vm::vec3>({position})));
-  const PolyhedronMatcher<BrushGeometry> matcher(*m_geometry, newGeometry);
+  const PolyhedronMatcher<BrushGeometry> matcher(oldGeometry, newGeometry);
   return updateFacesFromGeometry(worldBounds, matcher, newGeometry);
 }
 
 static BrushGeometry removeVerticesFromGeometry(
-  const BrushGeometry& geometry, const std::vector<vm::vec3>& vertexPositions)
+  const CompactBrushGeometry& geometry, const std::vector<vm::vec3>& vertexPositions)
 {
   std::vector<vm::vec3> points;
   points.reserve(geometry.vertexCount());
 
-  for (const auto* vertex : geometry.vertices())
+  for (const auto& position : geometry.vertexPositions())
   {
-    const auto& position = vertex->position();
     if (!kdl::vec_contains(vertexPositions, position))
     {
       points.push_back(position);
@@ -639,21 +623,22 @@ kdl::result<void, BrushError> Brush::removeVertices(
   ensure(!vertexPositions.empty(), "no vertex positions");
   assert(canRemoveVertices(worldBounds, vertexPositions));
 
+  const BrushGeometry oldGeometry = makeGeometry();
   const BrushGeometry newGeometry =
     removeVerticesFromGeometry(*m_geometry, vertexPositions);
-  const PolyhedronMatcher<BrushGeometry> matcher(*m_geometry, newGeometry);
+  const PolyhedronMatcher<BrushGeometry> matcher(oldGeometry, newGeometry);
   return updateFacesFromGeometry(worldBounds, matcher, newGeometry);
 }
 
 static BrushGeometry snappedGeometry(
-  const BrushGeometry& geometry, const FloatType snapToF)
+  const CompactBrushGeometry& geometry, const FloatType snapToF)
 {
   std::vector<vm::vec3> points;
   points.reserve(geometry.vertexCount());
 
-  for (const auto* vertex : geometry.vertices())
+  for (const auto& position : geometry.vertexPositions())
   {
-    points.push_back(snapToF * vm::round(vertex->position() / snapToF));
+    points.push_back(snapToF * vm::round(position / snapToF));
   }
 
   return BrushGeometry(std::move(points));
@@ -674,9 +659,8 @@ kdl::result<void, BrushError> Brush::snapVertices(
   const BrushGeometry newGeometry = snappedGeometry(*m_geometry, snapToF);
 
   std::map<vm::vec3, vm::vec3> vertexMapping;
-  for (const auto* vertex : m_geometry->vertices())
+  for (const auto& origin : m_geometry->vertexPositions())
   {
-    const auto& origin = vertex->position();
     const auto destination = snapToF * round(origin / snapToF);
     if (newGeometry.hasVertex(destination))
     {
@@ -684,7 +668,8 @@ kdl::result<void, BrushError> Brush::snapVertices(
     }
   }
 
-  const PolyhedronMatcher<BrushGeometry> matcher(*m_geometry, newGeometry, vertexMapping);
+  const BrushGeometry oldGeometry = makeGeometry();
+  const PolyhedronMatcher<BrushGeometry> matcher(oldGeometry, newGeometry, vertexMapping);
   return updateFacesFromGeometry(worldBounds, matcher, newGeometry, uvLock);
 }
 
@@ -854,9 +839,8 @@ Brush::CanMoveVerticesResult Brush::doCanMoveVertices(
   std::vector<vm::vec3> resultPoints;
   resultPoints.reserve(vertexCount());
 
-  for (const auto* vertex : m_geometry->vertices())
+  for (const auto& position : m_geometry->vertexPositions())
   {
-    const auto& position = vertex->position();
     if (!vertexSet.count(position))
     {
       // the vertex is not moving
@@ -962,9 +946,8 @@ kdl::result<void, BrushError> Brush::doMoveVertices(
   std::vector<vm::vec3> newVertices;
   newVertices.reserve(vertexCount());
 
-  for (const auto* vertex : m_geometry->vertices())
+  for (const auto& position : m_geometry->vertexPositions())
   {
-    const auto& position = vertex->position();
     if (kdl::vec_contains(vertexPositions, position))
     {
       newVertices.push_back(position + delta);
@@ -979,9 +962,8 @@ kdl::result<void, BrushError> Brush::doMoveVertices(
 
   using VecMap = std::map<vm::vec3, vm::vec3>;
   VecMap vertexMapping;
-  for (auto* oldVertex : m_geometry->vertices())
+  for (const auto& oldPosition : m_geometry->vertexPositions())
   {
-    const auto& oldPosition = oldVertex->position();
     const auto moved = kdl::vec_contains(vertexPositions, oldPosition);
     const auto newPosition = moved ? oldPosition + delta : oldPosition;
     const auto* newVertex =
@@ -992,7 +974,8 @@ kdl::result<void, BrushError> Brush::doMoveVertices(
     }
   }
 
-  const PolyhedronMatcher<BrushGeometry> matcher(*m_geometry, newGeometry, vertexMapping);
+  const BrushGeometry oldGeometry = makeGeometry();
+  const PolyhedronMatcher<BrushGeometry> matcher(oldGeometry, newGeometry, vertexMapping);
   return updateFacesFromGeometry(worldBounds, matcher, newGeometry, uvLock);
 }
 
@@ -1066,11 +1049,12 @@ std::tuple<bool, vm::mat4x4> Brush::findTransformForUVLock(
 
 void Brush::applyUVLock(
   const PolyhedronMatcher<BrushGeometry>& matcher,
+  BrushFaceGeometry* left,
+  BrushFaceGeometry* right,
   const BrushFace& leftFace,
   BrushFace& rightFace)
 {
-  const auto [success, M] =
-    findTransformForUVLock(matcher, leftFace.geometry(), rightFace.geometry());
+  const auto [success, M] = findTransformForUVLock(matcher, left, right);
   if (!success)
   {
     return;
@@ -1091,8 +1075,13 @@ void Brush::applyUVLock(
       {
         // Note, the wrap style doesn't matter because the source and destination faces
         // should have the same plane
+        const auto& rightPositions = right->vertexPositions();
         rightFace.copyTexCoordSystemFromFace(
-          *snapshot, leftClone.attributes(), leftClone.boundary(), WrapStyle::Rotation);
+          *snapshot,
+          leftClone.attributes(),
+          leftClone.boundary(),
+          WrapStyle::Rotation,
+          vm::average(rightPositions.begin(), rightPositions.end()));
       }
       rightFace.resetTexCoordSystemCache();
     })
@@ -1117,12 +1106,11 @@ kdl::result<void, BrushError> Brush::updateFacesFromGeometry(
       const BrushFace& leftFace = m_faces[*leftFaceIndex];
       BrushFace& rightFace = newFaces.emplace_back(leftFace);
 
-      rightFace.setGeometry(right);
-      rightFace.updatePointsFromVertices()
+      rightFace.updatePointsFromVertices(right->vertexPositions())
         .and_then([&]() {
           if (uvLock)
           {
-            applyUVLock(matcher, leftFace, rightFace);
+            applyUVLock(matcher, left, right, leftFace, rightFace);
           }
         })
         .handle_errors([&](const BrushError e) {
@@ -1149,15 +1137,17 @@ std::vector<kdl::result<Brush, BrushError>> Brush::subtract(
   const std::string& defaultTextureName,
   const std::vector<const Brush*>& subtrahends) const
 {
-  auto result = std::vector<BrushGeometry>{*m_geometry};
+  auto result = std::vector<BrushGeometry>{};
+  result.push_back(makeGeometry());
 
   for (const auto* subtrahend : subtrahends)
   {
+    const auto subtrahendGeometry = subtrahend->makeGeometry();
     auto nextResults = std::vector<BrushGeometry>{};
 
     for (const BrushGeometry& fragment : result)
     {
-      auto subFragments = fragment.subtract(*subtrahend->m_geometry);
+      auto subFragments = fragment.subtract(subtrahendGeometry);
       nextResults = kdl::vec_concat(std::move(nextResults), std::move(subFragments));
     }
 
@@ -1221,7 +1211,25 @@ bool Brush::contains(const vm::bbox3& bounds) const
 
 bool Brush::contains(const Brush& brush) const
 {
-  return m_geometry->contains(*brush.m_geometry);
+  if (!bounds().contains(brush.bounds()))
+  {
+    return false;
+  }
+
+  for (const auto& position : brush.vertexPositions())
+  {
+    for (const auto& face : m_faces)
+    {
+      if (
+        face.boundary().point_status(
+          position, vm::constants<FloatType>::point_status_epsilon())
+        == vm::plane_status::above)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
 }
 
 bool Brush::intersects(const vm::bbox3& bounds) const
@@ -1229,9 +1237,99 @@ bool Brush::intersects(const vm::bbox3& bounds) const
   return this->bounds().intersects(bounds);
 }
 
+/**
+ * Returns the position of the given vertices relative to the given plane, see
+ * Polyhedron::pointStatus.
+ */
+static vm::plane_status pointStatus(
+  const vm::plane3& plane, const std::vector<vm::vec3>& positions)
+{
+  auto above = size_t(0);
+  auto below = size_t(0);
+  for (const auto& position : positions)
+  {
+    const auto status = plane.point_status(position);
+    if (status == vm::plane_status::above)
+    {
+      ++above;
+    }
+    else if (status == vm::plane_status::below)
+    {
+      ++below;
+    }
+    if (above > 0u && below > 0u)
+    {
+      return vm::plane_status::inside;
+    }
+  }
+  return above > 0u ? vm::plane_status::above : vm::plane_status::below;
+}
+
+static bool separate(const Brush& lhs, const Brush& rhs)
+{
+  for (const auto& face : lhs.faces())
+  {
+    if (pointStatus(face.boundary(), rhs.vertexPositions()) == vm::plane_status::above)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+static vm::vec3 edgeVector(const CompactBrushGeometry& geometry, const size_t edgeIndex)
+{
+  const auto [vertexIndex1, vertexIndex2] = geometry.edgeVertexIndices(edgeIndex);
+  return geometry.vertexPosition(vertexIndex2) - geometry.vertexPosition(vertexIndex1);
+}
+
+/**
+ * Tests the brushes for intersection using the separating axis theorem in the same way
+ * as Polyhedron::polyhedronIntersectsPolyhedron.
+ */
 bool Brush::intersects(const Brush& brush) const
 {
-  return m_geometry->intersects(*brush.m_geometry);
+  if (!bounds().intersects(brush.bounds()))
+  {
+    return false;
+  }
+
+  if (separate(*this, brush) || separate(brush, *this))
+  {
+    return false;
+  }
+
+  const auto& lhsGeometry = geometry();
+  const auto& rhsGeometry = brush.geometry();
+  for (size_t i = 0u; i < lhsGeometry.edgeCount(); ++i)
+  {
+    const auto lhsEdgeVec = edgeVector(lhsGeometry, i);
+    const auto& lhsEdgeOrigin =
+      lhsGeometry.vertexPosition(lhsGeometry.edgeVertexIndices(i).first);
+
+    for (size_t j = 0u; j < rhsGeometry.edgeCount(); ++j)
+    {
+      const auto rhsEdgeVec = edgeVector(rhsGeometry, j);
+      const auto direction = vm::cross(lhsEdgeVec, rhsEdgeVec);
+
+      if (!vm::is_zero(direction, vm::constants<FloatType>::almost_zero()))
+      {
+        const auto plane = vm::plane3(lhsEdgeOrigin, direction);
+
+        const auto lhsStatus = pointStatus(plane, lhsGeometry.vertexPositions());
+        if (lhsStatus != vm::plane_status::inside)
+        {
+          const auto rhsStatus = pointStatus(plane, rhsGeometry.vertexPositions());
+          if (rhsStatus != vm::plane_status::inside && lhsStatus != rhsStatus)
+          {
+            return false;
+          }
+        }
+      }
+    }
+  }
+
+  return true;
 }
 
 kdl::result<Brush, BrushError> Brush::createBrush(
@@ -1291,65 +1389,14 @@ Brush Brush::convertToParallel() const
 
 bool Brush::checkFaceLinks() const
 {
-  if (faceCount() != m_geometry->faceCount())
+  if (m_geometry == nullptr || faceCount() != m_geometry->faceCount())
   {
     return false;
   }
 
-  const auto findFaceGeometry = [&](const BrushFaceGeometry* g) {
-    for (const auto* fg : m_geometry->faces())
-    {
-      if (fg == g)
-      {
-        return true;
-      }
-    }
-    return false;
-  };
-
-  for (const auto* faceGeometry : m_geometry->faces())
-  {
-    if (const auto faceIndex = faceGeometry->payload())
-    {
-      if (*faceIndex >= m_faces.size())
-      {
-        return false;
-      }
-    }
-    else
-    {
-      return false;
-    }
-  }
-
-  std::set<const BrushFaceGeometry*> faceGeometries;
-  for (const auto& face : m_faces)
+  for (size_t i = 0u; i < m_faces.size(); ++i)
   {
-    const auto* faceGeometry = face.geometry();
-    if (faceGeometry == nullptr)
-    {
-      return false;
-    }
-    if (!findFaceGeometry(faceGeometry))
-    {
-      return false;
-    }
-    if (const auto faceIndex = faceGeometry->payload())
-    {
-      if (*faceIndex >= m_faces.size())
-      {
-        return false;
-      }
-      if (&m_faces[*faceIndex] != &face)
-      {
-        return false;
-      }
-    }
-    else
-    {
-      return false;
-    }
-    if (!faceGeometries.insert(faceGeometry).second)
+    if (m_faces[i].geometry() != m_geometry.get() || m_faces[i].faceIndex() != i)
     {
       return false;
     }
@@ -22,6 +22,7 @@
 #include "FloatType.h"
 #include "Macros.h"
 #include "Model/BrushGeometry.h"
+#include "Model/CompactBrushGeometry.h"
 
 #include <kdl/result_forward.h>
 
@@ -45,20 +46,18 @@ enum class MapFormat;
 class Brush
 {
 private:
-  class CopyCallback;
-
   /**
    * Epsilon value to use when finding a vertex after applying a vertex operation
    */
   constexpr static FloatType CloseVertexEpsilon = static_cast<FloatType>(0.01);
 
-public:
-  using VertexList = BrushVertexList;
-  using EdgeList = BrushEdgeList;
-
-private:
   std::vector<BrushFace> m_faces;
-  std::unique_ptr<BrushGeometry> m_geometry;
+
+  /**
+   * The geometry is immutable and shared between copies of this brush, e.g. the
+   * snapshots kept for undo. A new geometry is created whenever the faces change.
+   */
+  std::shared_ptr<const CompactBrushGeometry> m_geometry;
 
 public:
   Brush();
@@ -74,10 +73,28 @@ public:
   static kdl::result<Brush, BrushError> create(
     const vm::bbox3& worldBounds, std::vector<BrushFace> faces);
 
+  /**
+   * Creates a brush with the given faces and the given geometry without computing the
+   * geometry from the faces. This is used to restore brushes whose geometry was computed
+   * previously, e.g. when reading a map from a cache.
+   *
+   * The given geometry must have one face for each of the given faces, and its faces must
+   * be in the same order as the given faces.
+   */
+  Brush(std::vector<BrushFace> faces, CompactBrushGeometry geometry);
+
 private:
   Brush(std::vector<BrushFace> faces);
 
   kdl::result<void, BrushError> updateGeometryFromFaces(const vm::bbox3& worldBounds);
+  void setGeometry(std::shared_ptr<const CompactBrushGeometry> geometry);
+
+  /**
+   * Builds the half edge representation of the geometry of this brush for operations that
+   * change its topology. The payload of each face of the returned geometry is the index
+   * of the corresponding brush face.
+   */
+  BrushGeometry makeGeometry() const;
 
 public:
   const vm::bbox3& bounds() const;
@@ -143,9 +160,11 @@ public: // move face along normal
 
 public:
   // geometry access
+
+  const CompactBrushGeometry& geometry() const;
+
   size_t vertexCount() const;
-  const VertexList& vertices() const;
-  const std::vector<vm::vec3> vertexPositions() const;
+  const std::vector<vm::vec3>& vertexPositions() const;
 
   vm::vec3 findClosestVertexPosition(const vm::vec3& position) const;
   std::vector<vm::vec3> findClosestVertexPositions(
@@ -163,10 +182,9 @@ public:
     const vm::polygon3& face, FloatType epsilon = static_cast<FloatType>(0.0)) const;
 
   size_t edgeCount() const;
-  const EdgeList& edges() const;
   bool containsPoint(const vm::vec3& point) const;
 
-  std::vector<const BrushFace*> incidentFaces(const BrushVertex* vertex) const;
+  std::vector<const BrushFace*> incidentFaces(size_t vertexIndex) const;
 
   // vertex operations
   bool canMoveVertices(
@@ -271,11 +289,15 @@ private:
    * Brush::createBrushWithNewGeometry
    *
    * @param matcher a polyhedron matcher which is used to identify related vertices
+   * @param left the geometry of the left face
+   * @param right the geometry of the right face
    * @param leftFace the face of the left polyhedron
    * @param rightFace the face of the right polyhedron
    */
   static void applyUVLock(
     const PolyhedronMatcher<BrushGeometry>& matcher,
+    BrushFaceGeometry* left,
+    BrushFaceGeometry* right,
     const BrushFace& leftFace,
     BrushFace& rightFace);
   kdl::result<void, BrushError> updateFacesFromGeometry(
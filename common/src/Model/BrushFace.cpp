@@ -30,7 +30,7 @@
 #include "Model/TagMatcher.h"
 #include "Model/TagVisitor.h"
 #include "Model/TexCoordSystem.h"
-#include "Polyhedron.h"
+#include "Model/CompactBrushGeometry.h"
 
 #include <kdl/overload.h>
 #include <kdl/reflection_impl.h>
@@ -48,6 +48,7 @@
 #include <vecmath/vec.h>
 #include <vecmath/vec_io.h>
 
+#include <iterator>
 #include <sstream>
 #include <string>
 
@@ -55,18 +56,6 @@ namespace TrenchBroom
 {
 namespace Model
 {
-const BrushVertex* BrushFace::TransformHalfEdgeToVertex::operator()(
-  const BrushHalfEdge* halfEdge) const
-{
-  return halfEdge->origin();
-}
-
-const BrushEdge* BrushFace::TransformHalfEdgeToEdge::operator()(
-  const BrushHalfEdge* halfEdge) const
-{
-  return halfEdge->edge();
-}
-
 BrushFace::BrushFace(const BrushFace& other)
   : Taggable(other)
   , m_points(other.m_points)
@@ -75,6 +64,7 @@ BrushFace::BrushFace(const BrushFace& other)
   , m_textureReference(other.m_textureReference)
   , m_texCoordSystem(other.m_texCoordSystem ? other.m_texCoordSystem->clone() : nullptr)
   , m_geometry(nullptr)
+  , m_faceIndex(0u)
   , m_lineNumber(other.m_lineNumber)
   , m_lineCount(other.m_lineCount)
   , m_selected(other.m_selected)
@@ -90,6 +80,7 @@ BrushFace::BrushFace(BrushFace&& other) noexcept
   , m_textureReference(std::move(other.m_textureReference))
   , m_texCoordSystem(std::move(other.m_texCoordSystem))
   , m_geometry(other.m_geometry)
+  , m_faceIndex(other.m_faceIndex)
   , m_lineNumber(other.m_lineNumber)
   , m_lineCount(other.m_lineCount)
   , m_selected(other.m_selected)
@@ -114,6 +105,7 @@ void swap(BrushFace& lhs, BrushFace& rhs) noexcept
   swap(lhs.m_textureReference, rhs.m_textureReference);
   swap(lhs.m_texCoordSystem, rhs.m_texCoordSystem);
   swap(lhs.m_geometry, rhs.m_geometry);
+  swap(lhs.m_faceIndex, rhs.m_faceIndex);
   swap(lhs.m_lineNumber, rhs.m_lineNumber);
   swap(lhs.m_lineCount, rhs.m_lineCount);
   swap(lhs.m_selected, rhs.m_selected);
@@ -235,6 +227,7 @@ BrushFace::BrushFace(
   , m_attributes(attributes)
   , m_texCoordSystem(std::move(texCoordSystem))
   , m_geometry(nullptr)
+  , m_faceIndex(0u)
   , m_lineNumber(0)
   , m_lineCount(0)
   , m_selected(false)
@@ -287,11 +280,22 @@ void BrushFace::copyTexCoordSystemFromFace(
   const BrushFaceAttributes& attributes,
   const vm::plane3& sourceFacePlane,
   const WrapStyle wrapStyle)
+{
+  copyTexCoordSystemFromFace(
+    coordSystemSnapshot, attributes, sourceFacePlane, wrapStyle, center());
+}
+
+void BrushFace::copyTexCoordSystemFromFace(
+  const TexCoordSystemSnapshot& coordSystemSnapshot,
+  const BrushFaceAttributes& attributes,
+  const vm::plane3& sourceFacePlane,
+  const WrapStyle wrapStyle,
+  const vm::vec3& center)
 {
   // Get a line, and a reference point, that are on both the source face's plane and our
   // plane
   const auto seam = vm::intersect_plane_plane(sourceFacePlane, m_boundary);
-  const auto refPoint = vm::project_point(seam, center());
+  const auto refPoint = vm::project_point(seam, center);
 
   coordSystemSnapshot.restore(*m_texCoordSystem);
 
@@ -332,9 +336,10 @@ const vm::vec3& BrushFace::normal() const
 vm::vec3 BrushFace::center() const
 {
   ensure(m_geometry != nullptr, "geometry is null");
-  const BrushHalfEdgeList& boundary = m_geometry->boundary();
   return vm::average(
-    std::begin(boundary), std::end(boundary), BrushGeometry::GetVertexPosition());
+    m_geometry->faceVertexIndicesBegin(m_faceIndex),
+    m_geometry->faceVertexIndicesEnd(m_faceIndex),
+    [&](const auto vertexIndex) { return m_geometry->vertexPosition(vertexIndex); });
 }
 
 vm::vec3 BrushFace::boundsCenter() const
@@ -347,29 +352,32 @@ vm::vec3 BrushFace::boundsCenter() const
   assert(invertible);
   unused(invertible);
 
-  const auto* first = m_geometry->boundary().front();
-  const auto* current = first;
+  auto it = m_geometry->faceVertexIndicesBegin(m_faceIndex);
+  const auto end = m_geometry->faceVertexIndicesEnd(m_faceIndex);
 
   vm::bbox3 bounds;
-  bounds.min = bounds.max = toPlane * current->origin()->position();
-
-  current = current->next();
-  while (current != first)
+  bounds.min = bounds.max = toPlane * m_geometry->vertexPosition(*it++);
+  while (it != end)
   {
-    bounds = merge(bounds, toPlane * current->origin()->position());
-    current = current->next();
+    bounds = merge(bounds, toPlane * m_geometry->vertexPosition(*it++));
   }
   return fromPlane * bounds.center();
 }
 
 FloatType BrushFace::projectedArea(const vm::axis::type axis) const
 {
+  ensure(m_geometry != nullptr, "geometry is null");
+
+  const auto begin = m_geometry->faceVertexIndicesBegin(m_faceIndex);
+  const auto end = m_geometry->faceVertexIndicesEnd(m_faceIndex);
+
   FloatType c1 = 0.0;
   FloatType c2 = 0.0;
-  for (const BrushHalfEdge* halfEdge : m_geometry->boundary())
+  for (auto it = begin; it != end; ++it)
   {
-    const auto origin = vm::swizzle(halfEdge->origin()->position(), axis);
-    const auto destination = vm::swizzle(halfEdge->destination()->position(), axis);
+    const auto next = std::next(it) != end ? std::next(it) : begin;
+    const auto origin = vm::swizzle(m_geometry->vertexPosition(*it), axis);
+    const auto destination = vm::swizzle(m_geometry->vertexPosition(*next), axis);
     c1 += origin.x() * destination.y();
     c2 += origin.y() * destination.x();
   }
@@ -378,21 +386,20 @@ FloatType BrushFace::projectedArea(const vm::axis::type axis) const
 
 FloatType BrushFace::area() const
 {
+  ensure(m_geometry != nullptr, "geometry is null");
+
   auto result = static_cast<FloatType>(0);
 
-  const auto* firstEdge = m_geometry->boundary().front();
-  const auto* currentEdge = firstEdge->next();
-  const auto* vertex0 = firstEdge->origin();
-  do
+  // triangulate the face as a fan around its first vertex
+  const auto begin = m_geometry->faceVertexIndicesBegin(m_faceIndex);
+  const auto end = m_geometry->faceVertexIndicesEnd(m_faceIndex);
+  const auto& position0 = m_geometry->vertexPosition(*begin);
+  for (auto it = std::next(begin); std::next(it) != end; ++it)
   {
-    const auto* vertex1 = currentEdge->origin();
-    const auto* vertex2 = currentEdge->destination();
-    const auto side0 = vertex1->position() - vertex0->position();
-    const auto side1 = vertex2->position() - vertex0->position();
+    const auto side0 = m_geometry->vertexPosition(*it) - position0;
+    const auto side1 = m_geometry->vertexPosition(*std::next(it)) - position0;
     result += vm::length(vm::cross(side0, side1));
-
-    currentEdge = currentEdge->next();
-  } while (currentEdge->next() != firstEdge);
+  }
 
   return result / 2.0;
 }
@@ -685,23 +692,21 @@ void BrushFace::invert()
   swap(m_points[1], m_points[2]);
 }
 
-kdl::result<void, BrushError> BrushFace::updatePointsFromVertices()
+kdl::result<void, BrushError> BrushFace::updatePointsFromVertices(
+  const std::vector<vm::vec3>& vertexPositions)
 {
-  ensure(m_geometry != nullptr, "geometry is null");
+  assert(vertexPositions.size() >= 3u);
 
-  const auto* first = m_geometry->boundary().front();
   const auto oldPlane = m_boundary;
-  return setPoints(
-           first->next()->origin()->position(),
-           first->origin()->position(),
-           first->previous()->origin()->position())
+  return setPoints(vertexPositions[1], vertexPositions[0], vertexPositions.back())
     .and_then([&]() {
       // Get a line, and a reference point, that are on both the old plane
       // (before moving the face) and after moving the face.
       const auto seam = vm::intersect_plane_plane(oldPlane, m_boundary);
       if (!vm::is_zero(seam.direction, vm::C::almost_zero()))
       {
-        const auto refPoint = project_point(seam, center());
+        const auto refPoint = project_point(
+          seam, vm::average(vertexPositions.begin(), vertexPositions.end()));
 
         // Get the texcoords at the refPoint using the old face's attribs and tex coord
         // system
@@ -769,31 +774,19 @@ float BrushFace::measureTextureAngle(
 size_t BrushFace::vertexCount() const
 {
   assert(m_geometry != nullptr);
-  return m_geometry->boundary().size();
-}
-
-BrushFace::EdgeList BrushFace::edges() const
-{
-  ensure(m_geometry != nullptr, "geometry is null");
-  return EdgeList(m_geometry->boundary(), TransformHalfEdgeToEdge());
-}
-
-BrushFace::VertexList BrushFace::vertices() const
-{
-  ensure(m_geometry != nullptr, "geometry is null");
-  return VertexList(m_geometry->boundary(), TransformHalfEdgeToVertex());
+  return m_geometry->faceVertexCount(m_faceIndex);
 }
 
 std::vector<vm::vec3> BrushFace::vertexPositions() const
 {
   ensure(m_geometry != nullptr, "geometry is null");
-  return m_geometry->vertexPositions();
+  return m_geometry->faceVertexPositions(m_faceIndex);
 }
 
 bool BrushFace::hasVertices(const vm::polygon3& vertices, const FloatType epsilon) const
 {
   ensure(m_geometry != nullptr, "geometry is null");
-  return m_geometry->hasVertexPositions(vertices.vertices(), epsilon);
+  return m_geometry->faceHasVertexPositions(m_faceIndex, vertices.vertices(), epsilon);
 }
 
 vm::polygon3 BrushFace::polygon() const
@@ -802,14 +795,21 @@ vm::polygon3 BrushFace::polygon() const
   return vm::polygon3(vertexPositions());
 }
 
-BrushFaceGeometry* BrushFace::geometry() const
+const CompactBrushGeometry* BrushFace::geometry() const
 {
   return m_geometry;
 }
 
-void BrushFace::setGeometry(BrushFaceGeometry* geometry)
+size_t BrushFace::faceIndex() const
+{
+  return m_faceIndex;
+}
+
+void BrushFace::setGeometry(const CompactBrushGeometry* geometry, const size_t faceIndex)
 {
+  assert(geometry == nullptr || faceIndex < geometry->faceCount());
   m_geometry = geometry;
+  m_faceIndex = faceIndex;
 }
 
 size_t BrushFace::lineNumber() const
@@ -859,9 +859,9 @@ FloatType BrushFace::intersectWithRay(const vm::ray3& ray) const
     return vm::intersect_ray_polygon(
       ray,
       m_boundary,
-      m_geometry->boundary().begin(),
-      m_geometry->boundary().end(),
-      BrushGeometry::GetVertexPosition());
+      m_geometry->faceVertexIndicesBegin(m_faceIndex),
+      m_geometry->faceVertexIndicesEnd(m_faceIndex),
+      [&](const auto vertexIndex) { return m_geometry->vertexPosition(vertexIndex); });
   }
 }
 
@@ -23,12 +23,10 @@
 #include "FloatType.h"
 #include "Macros.h"
 #include "Model/BrushFaceAttributes.h"
-#include "Model/BrushGeometry.h"
 #include "Model/Tag.h" // BrushFace inherits from Taggable
 
 #include <kdl/reflection_decl.h>
 #include <kdl/result_forward.h>
-#include <kdl/transform_range.h>
 
 #include <vecmath/plane.h>
 #include <vecmath/util.h>
@@ -48,6 +46,7 @@ class Texture;
 
 namespace Model
 {
+class CompactBrushGeometry;
 class TexCoordSystem;
 class TexCoordSystemSnapshot;
 enum class WrapStyle;
@@ -69,27 +68,6 @@ public:
    */
   using Points = std::array<vm::vec3, 3u>;
 
-private:
-  /**
-   * For use in VertexList transformation below.
-   */
-  struct TransformHalfEdgeToVertex
-  {
-    const BrushVertex* operator()(const BrushHalfEdge* halfEdge) const;
-  };
-
-  /**
-   * For use in EdgeList transformation below.
-   */
-  struct TransformHalfEdgeToEdge
-  {
-    const BrushEdge* operator()(const BrushHalfEdge* halfEdge) const;
-  };
-
-public:
-  using VertexList = kdl::transform_adapter<BrushHalfEdgeList, TransformHalfEdgeToVertex>;
-  using EdgeList = kdl::transform_adapter<BrushHalfEdgeList, TransformHalfEdgeToEdge>;
-
 private:
   BrushFace::Points m_points;
   vm::plane3 m_boundary;
@@ -97,7 +75,8 @@ private:
 
   Assets::AssetReference<Assets::Texture> m_textureReference;
   std::unique_ptr<TexCoordSystem> m_texCoordSystem;
-  BrushFaceGeometry* m_geometry;
+  const CompactBrushGeometry* m_geometry;
+  size_t m_faceIndex;
 
   mutable size_t m_lineNumber;
   mutable size_t m_lineCount;
@@ -189,6 +168,17 @@ public:
     const BrushFaceAttributes& attributes,
     const vm::plane3& sourceFacePlane,
     WrapStyle wrapStyle);
+  /**
+   * Like the above, but takes the texture coordinates to preserve from the given point
+   * projected onto the seam instead of from this face's center. Use this for faces that
+   * are not yet attached to a geometry.
+   */
+  void copyTexCoordSystemFromFace(
+    const TexCoordSystemSnapshot& coordSystemSnapshot,
+    const BrushFaceAttributes& attributes,
+    const vm::plane3& sourceFacePlane,
+    WrapStyle wrapStyle,
+    const vm::vec3& center);
 
   const BrushFace::Points& points() const;
   const vm::plane3& boundary() const;
@@ -236,7 +226,13 @@ public:
   kdl::result<void, BrushError> transform(const vm::mat4x4& transform, bool lockTexture);
   void invert();
 
-  kdl::result<void, BrushError> updatePointsFromVertices();
+  /**
+   * Updates the points of this face from the given positions of its vertices in counter
+   * clockwise order, and adjusts the texture offset so that the texture stays in place
+   * where the old and the new plane of this face intersect.
+   */
+  kdl::result<void, BrushError> updatePointsFromVertices(
+    const std::vector<vm::vec3>& vertexPositions);
 
   vm::mat4x4 projectToBoundaryMatrix() const;
   vm::mat4x4 toTexCoordSystemMatrix(
@@ -246,8 +242,6 @@ public:
   float measureTextureAngle(const vm::vec2f& center, const vm::vec2f& point) const;
 
   size_t vertexCount() const;
-  EdgeList edges() const;
-  VertexList vertices() const;
   std::vector<vm::vec3> vertexPositions() const;
 
   bool hasVertices(
@@ -255,8 +249,17 @@ public:
   vm::polygon3 polygon() const;
 
 public:
-  BrushFaceGeometry* geometry() const;
-  void setGeometry(BrushFaceGeometry* geometry);
+  /**
+   * Returns the geometry of the brush this face belongs to, or null if this face does not
+   * belong to a brush.
+   */
+  const CompactBrushGeometry* geometry() const;
+
+  /**
+   * Returns the index of this face in its brush and in the brush geometry.
+   */
+  size_t faceIndex() const;
+  void setGeometry(const CompactBrushGeometry* geometry, size_t faceIndex);
 
   size_t lineNumber() const;
   void setFilePosition(size_t lineNumber, size_t lineCount) const;
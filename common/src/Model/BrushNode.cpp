@@ -124,6 +124,7 @@ Brush BrushNode::setBrush(Brush brush)
   updateSelectedFaceCount();
   invalidateIssues();
   invalidateVertexCache();
+  m_serializedText = std::nullopt;
 
   return brush;
 }
@@ -156,6 +157,9 @@ void BrushNode::setFaceTexture(const size_t faceIndex, Assets::Texture* texture)
 
   invalidateIssues();
   invalidateVertexCache();
+
+  // the serialized surface attributes can depend on the texture
+  m_serializedText = std::nullopt;
 }
 
 static bool containsPatch(const Brush& brush, const PatchGrid& grid)
@@ -427,6 +431,17 @@ Renderer::BrushRendererBrushCache& BrushNode::brushRendererBrushCache() const
   return *m_brushRendererBrushCache;
 }
 
+const SerializedNodeText* BrushNode::serializedText(const MapFormat mapFormat) const
+{
+  return m_serializedText && m_serializedText->mapFormat == mapFormat ? &*m_serializedText
+                                                                      : nullptr;
+}
+
+void BrushNode::setSerializedText(SerializedNodeText serializedText) const
+{
+  m_serializedText = std::move(serializedText);
+}
+
 void BrushNode::initializeTags(TagManager& tagManager)
 {
   Taggable::initializeTags(tagManager);
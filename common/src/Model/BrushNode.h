@@ -26,6 +26,7 @@
 #include "Model/HitType.h"
 #include "Model/Node.h"
 #include "Model/Object.h"
+#include "Model/SerializedNodeText.h"
 #include "Model/TagType.h"
 
 #include <kdl/result_forward.h>
@@ -71,6 +72,7 @@ private:
     m_brushRendererBrushCache; // unique_ptr for breaking header dependencies
   Brush m_brush;               // must be destroyed before the brush renderer cache
   size_t m_selectedFaceCount = 0u;
+  mutable std::optional<SerializedNodeText> m_serializedText;
 
 public:
   explicit BrushNode(Brush brush);
@@ -140,6 +142,14 @@ public: // renderer cache
   void invalidateVertexCache();
   Renderer::BrushRendererBrushCache& brushRendererBrushCache() const;
 
+public: // serialization cache
+  /**
+   * Returns the text that was last generated for this brush by a map file serializer for
+   * the given map format, or null if this brush changed since then.
+   */
+  const SerializedNodeText* serializedText(MapFormat mapFormat) const;
+  void setSerializedText(SerializedNodeText serializedText) const;
+
 private: // implement Taggable interface
 public:
   void initializeTags(TagManager& tagManager) override;
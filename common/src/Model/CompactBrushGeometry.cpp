@@ -0,0 +1,479 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CompactBrushGeometry.h"
+
+#include "Ensure.h"
+#include "Model/Polyhedron.h"
+
+#include <vecmath/plane.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <unordered_map>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+static CompactBrushGeometry::Index toIndex(const size_t index)
+{
+  assert(index <= std::numeric_limits<CompactBrushGeometry::Index>::max());
+  return static_cast<CompactBrushGeometry::Index>(index);
+}
+
+CompactBrushGeometry::CompactBrushGeometry()
+  : m_faceOffsets{0u}
+{
+}
+
+CompactBrushGeometry::CompactBrushGeometry(const BrushGeometry& geometry)
+{
+  auto vertexIndices = std::unordered_map<const BrushVertex*, Index>{};
+  vertexIndices.reserve(geometry.vertexCount());
+
+  m_vertexPositions.reserve(geometry.vertexCount());
+  for (const auto* vertex : geometry.vertices())
+  {
+    vertexIndices.emplace(vertex, toIndex(m_vertexPositions.size()));
+    m_vertexPositions.push_back(vertex->position());
+  }
+
+  auto faceGeometries = std::vector<const BrushFaceGeometry*>(geometry.faceCount());
+  for (const auto* faceGeometry : geometry.faces())
+  {
+    const auto faceIndex = faceGeometry->payload();
+    ensure(faceIndex && *faceIndex < faceGeometries.size(), "face index is valid");
+    faceGeometries[*faceIndex] = faceGeometry;
+  }
+
+  m_faceOffsets.reserve(faceGeometries.size() + 1u);
+  m_faceVertexIndices.reserve(2u * geometry.edgeCount());
+  for (const auto* faceGeometry : faceGeometries)
+  {
+    m_faceOffsets.push_back(toIndex(m_faceVertexIndices.size()));
+    for (const auto* halfEdge : faceGeometry->boundary())
+    {
+      m_faceVertexIndices.push_back(vertexIndices.at(halfEdge->origin()));
+    }
+  }
+  m_faceOffsets.push_back(toIndex(m_faceVertexIndices.size()));
+
+  m_edgeVertexIndices.reserve(geometry.edgeCount());
+  m_edgeFaceIndices.reserve(geometry.edgeCount());
+  for (const auto* edge : geometry.edges())
+  {
+    assert(edge->fullySpecified());
+    m_edgeVertexIndices.emplace_back(
+      vertexIndices.at(edge->firstVertex()), vertexIndices.at(edge->secondVertex()));
+    m_edgeFaceIndices.emplace_back(
+      toIndex(*edge->firstFace()->payload()), toIndex(*edge->secondFace()->payload()));
+  }
+
+  m_bounds = geometry.bounds();
+}
+
+CompactBrushGeometry::CompactBrushGeometry(
+  std::vector<vm::vec3> vertexPositions,
+  const std::vector<std::vector<size_t>>& faceVertexIndices)
+  : m_vertexPositions{std::move(vertexPositions)}
+{
+  m_faceOffsets.reserve(faceVertexIndices.size() + 1u);
+  for (const auto& indices : faceVertexIndices)
+  {
+    m_faceOffsets.push_back(toIndex(m_faceVertexIndices.size()));
+    for (const auto index : indices)
+    {
+      assert(index < m_vertexPositions.size());
+      m_faceVertexIndices.push_back(toIndex(index));
+    }
+  }
+  m_faceOffsets.push_back(toIndex(m_faceVertexIndices.size()));
+
+  // every edge is found twice, once in the boundary of each of its faces; the first face
+  // is the one whose boundary leads from the lower to the higher vertex index
+  const auto edgeKey = [](const Index index1, const Index index2) {
+    return uint64_t(index1) << 32u | uint64_t(index2);
+  };
+
+  auto edgeIndices = std::unordered_map<uint64_t, size_t>{};
+  edgeIndices.reserve(m_faceVertexIndices.size() / 2u);
+  m_edgeVertexIndices.reserve(m_faceVertexIndices.size() / 2u);
+  m_edgeFaceIndices.reserve(m_faceVertexIndices.size() / 2u);
+
+  for (size_t i = 0u; i < faceCount(); ++i)
+  {
+    const auto faceIndex = toIndex(i);
+    const auto begin = m_faceOffsets[i];
+    const auto end = m_faceOffsets[i + 1u];
+    for (auto j = begin; j < end; ++j)
+    {
+      const auto origin = m_faceVertexIndices[j];
+      const auto destination = m_faceVertexIndices[j + 1u < end ? j + 1u : begin];
+      if (origin < destination)
+      {
+        const auto [it, inserted] =
+          edgeIndices.emplace(edgeKey(origin, destination), m_edgeVertexIndices.size());
+        if (inserted)
+        {
+          m_edgeVertexIndices.emplace_back(origin, destination);
+          m_edgeFaceIndices.emplace_back(faceIndex, faceIndex);
+        }
+        else
+        {
+          m_edgeFaceIndices[it->second].first = faceIndex;
+        }
+      }
+      else
+      {
+        const auto [it, inserted] =
+          edgeIndices.emplace(edgeKey(destination, origin), m_edgeVertexIndices.size());
+        if (inserted)
+        {
+          m_edgeVertexIndices.emplace_back(destination, origin);
+          m_edgeFaceIndices.emplace_back(faceIndex, faceIndex);
+        }
+        else
+        {
+          m_edgeFaceIndices[it->second].second = faceIndex;
+        }
+      }
+    }
+  }
+
+  updateBounds();
+}
+
+BrushGeometry CompactBrushGeometry::makeBrushGeometry(
+  const std::vector<vm::plane3>& facePlanes) const
+{
+  assert(facePlanes.size() == faceCount());
+
+  auto faceVertexIndices = std::vector<std::vector<size_t>>{};
+  faceVertexIndices.reserve(faceCount());
+  for (size_t i = 0u; i < faceCount(); ++i)
+  {
+    faceVertexIndices.emplace_back(faceVertexIndicesBegin(i), faceVertexIndicesEnd(i));
+  }
+
+  auto geometry = BrushGeometry{m_vertexPositions, faceVertexIndices, facePlanes};
+
+  size_t faceIndex = 0u;
+  for (auto* faceGeometry : geometry.faces())
+  {
+    faceGeometry->setPayload(faceIndex++);
+  }
+
+  return geometry;
+}
+
+const vm::bbox3& CompactBrushGeometry::bounds() const
+{
+  return m_bounds;
+}
+
+bool CompactBrushGeometry::closed() const
+{
+  return vertexCount() + faceCount() == edgeCount() + 2u;
+}
+
+size_t CompactBrushGeometry::vertexCount() const
+{
+  return m_vertexPositions.size();
+}
+
+const std::vector<vm::vec3>& CompactBrushGeometry::vertexPositions() const
+{
+  return m_vertexPositions;
+}
+
+const vm::vec3& CompactBrushGeometry::vertexPosition(const size_t vertexIndex) const
+{
+  assert(vertexIndex < m_vertexPositions.size());
+  return m_vertexPositions[vertexIndex];
+}
+
+size_t CompactBrushGeometry::faceCount() const
+{
+  return m_faceOffsets.size() - 1u;
+}
+
+size_t CompactBrushGeometry::faceVertexCount(const size_t faceIndex) const
+{
+  assert(faceIndex < faceCount());
+  return m_faceOffsets[faceIndex + 1u] - m_faceOffsets[faceIndex];
+}
+
+CompactBrushGeometry::IndexIterator CompactBrushGeometry::faceVertexIndicesBegin(
+  const size_t faceIndex) const
+{
+  assert(faceIndex < faceCount());
+  return std::next(
+    m_faceVertexIndices.begin(), static_cast<std::ptrdiff_t>(m_faceOffsets[faceIndex]));
+}
+
+CompactBrushGeometry::IndexIterator CompactBrushGeometry::faceVertexIndicesEnd(
+  const size_t faceIndex) const
+{
+  assert(faceIndex < faceCount());
+  return std::next(
+    m_faceVertexIndices.begin(),
+    static_cast<std::ptrdiff_t>(m_faceOffsets[faceIndex + 1u]));
+}
+
+std::vector<vm::vec3> CompactBrushGeometry::faceVertexPositions(
+  const size_t faceIndex) const
+{
+  auto result = std::vector<vm::vec3>{};
+  result.reserve(faceVertexCount(faceIndex));
+  for (auto it = faceVertexIndicesBegin(faceIndex), end = faceVertexIndicesEnd(faceIndex);
+       it != end;
+       ++it)
+  {
+    result.push_back(m_vertexPositions[*it]);
+  }
+  return result;
+}
+
+size_t CompactBrushGeometry::edgeCount() const
+{
+  return m_edgeVertexIndices.size();
+}
+
+const std::pair<CompactBrushGeometry::Index, CompactBrushGeometry::Index>&
+CompactBrushGeometry::edgeVertexIndices(const size_t edgeIndex) const
+{
+  assert(edgeIndex < m_edgeVertexIndices.size());
+  return m_edgeVertexIndices[edgeIndex];
+}
+
+const std::pair<CompactBrushGeometry::Index, CompactBrushGeometry::Index>&
+CompactBrushGeometry::edgeFaceIndices(const size_t edgeIndex) const
+{
+  assert(edgeIndex < m_edgeFaceIndices.size());
+  return m_edgeFaceIndices[edgeIndex];
+}
+
+std::vector<size_t> CompactBrushGeometry::incidentFaces(const size_t vertexIndex) const
+{
+  assert(vertexIndex < vertexCount());
+
+  auto result = std::vector<size_t>{};
+  for (size_t i = 0u; i < faceCount(); ++i)
+  {
+    if (std::find(faceVertexIndicesBegin(i), faceVertexIndicesEnd(i), vertexIndex)
+        != faceVertexIndicesEnd(i))
+    {
+      result.push_back(i);
+    }
+  }
+  return result;
+}
+
+std::optional<size_t> CompactBrushGeometry::findVertex(
+  const vm::vec3& position, const FloatType epsilon) const
+{
+  for (size_t i = 0u; i < m_vertexPositions.size(); ++i)
+  {
+    if (vm::is_equal(position, m_vertexPositions[i], epsilon))
+    {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<size_t> CompactBrushGeometry::findClosestVertex(
+  const vm::vec3& position, const FloatType maxDistance) const
+{
+  auto closestDistance2 = maxDistance * maxDistance;
+  auto result = std::optional<size_t>{};
+  for (size_t i = 0u; i < m_vertexPositions.size(); ++i)
+  {
+    const auto distance2 = vm::squared_distance(position, m_vertexPositions[i]);
+    if (distance2 < closestDistance2)
+    {
+      closestDistance2 = distance2;
+      result = i;
+    }
+  }
+  return result;
+}
+
+std::optional<size_t> CompactBrushGeometry::findEdge(
+  const vm::vec3& position1, const vm::vec3& position2, const FloatType epsilon) const
+{
+  for (size_t i = 0u; i < m_edgeVertexIndices.size(); ++i)
+  {
+    const auto& [vertexIndex1, vertexIndex2] = m_edgeVertexIndices[i];
+    const auto& vertexPosition1 = m_vertexPositions[vertexIndex1];
+    const auto& vertexPosition2 = m_vertexPositions[vertexIndex2];
+    if (
+      (vm::is_equal(vertexPosition1, position1, epsilon)
+       && vm::is_equal(vertexPosition2, position2, epsilon))
+      || (vm::is_equal(vertexPosition1, position2, epsilon)
+          && vm::is_equal(vertexPosition2, position1, epsilon)))
+    {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<size_t> CompactBrushGeometry::findClosestEdge(
+  const vm::vec3& position1, const vm::vec3& position2, const FloatType maxDistance) const
+{
+  auto closestDistance = maxDistance;
+  auto result = std::optional<size_t>{};
+  for (size_t i = 0u; i < m_edgeVertexIndices.size(); ++i)
+  {
+    const auto& [vertexIndex1, vertexIndex2] = m_edgeVertexIndices[i];
+    const auto& vertexPosition1 = m_vertexPositions[vertexIndex1];
+    const auto& vertexPosition2 = m_vertexPositions[vertexIndex2];
+
+    // like Polyhedron_Edge::distanceTo, this compares squared distances to maxDistance
+    const auto distance1 = vm::min(
+      vm::squared_distance(vertexPosition1, position1),
+      vm::squared_distance(vertexPosition2, position1));
+    const auto distance2 = vm::min(
+      vm::squared_distance(vertexPosition1, position2),
+      vm::squared_distance(vertexPosition2, position2));
+    const auto distance = vm::max(distance1, distance2);
+    if (distance < closestDistance)
+    {
+      closestDistance = distance;
+      result = i;
+    }
+  }
+  return result;
+}
+
+bool CompactBrushGeometry::faceHasVertexPositions(
+  const size_t faceIndex,
+  const std::vector<vm::vec3>& positions,
+  const FloatType epsilon) const
+{
+  const auto count = faceVertexCount(faceIndex);
+  if (positions.size() != count)
+  {
+    return false;
+  }
+
+  const auto* indices = m_faceVertexIndices.data() + m_faceOffsets[faceIndex];
+  for (size_t start = 0u; start < count; ++start)
+  {
+    auto matches = true;
+    for (size_t i = 0u; i < count && matches; ++i)
+    {
+      matches = vm::is_equal(
+        m_vertexPositions[indices[(start + i) % count]], positions[i], epsilon);
+    }
+    if (matches)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::optional<size_t> CompactBrushGeometry::findFace(
+  const std::vector<vm::vec3>& positions, const FloatType epsilon) const
+{
+  for (size_t i = 0u; i < faceCount(); ++i)
+  {
+    if (faceHasVertexPositions(i, positions, epsilon))
+    {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<size_t> CompactBrushGeometry::findClosestFace(
+  const std::vector<vm::vec3>& positions, const FloatType maxDistance) const
+{
+  auto closestDistance = maxDistance;
+  auto result = std::optional<size_t>{};
+  for (size_t i = 0u; i < faceCount(); ++i)
+  {
+    const auto distance = faceDistanceTo(i, positions);
+    if (distance < closestDistance)
+    {
+      closestDistance = distance;
+      result = i;
+    }
+  }
+  return result;
+}
+
+/**
+ * Starts at the boundary vertex closest to the first of the given positions and returns
+ * the maximum distance of the following boundary vertices to the remaining positions, see
+ * Polyhedron_Face::distanceTo.
+ */
+FloatType CompactBrushGeometry::faceDistanceTo(
+  const size_t faceIndex, const std::vector<vm::vec3>& positions) const
+{
+  const auto maxDistance = std::numeric_limits<FloatType>::max();
+
+  const auto count = faceVertexCount(faceIndex);
+  if (positions.size() != count)
+  {
+    return maxDistance;
+  }
+
+  const auto* indices = m_faceVertexIndices.data() + m_faceOffsets[faceIndex];
+
+  auto closestDistance = maxDistance;
+  auto start = std::optional<size_t>{};
+  for (size_t i = 0u; i < count; ++i)
+  {
+    const auto distance = vm::distance(m_vertexPositions[indices[i]], positions.front());
+    if (distance < closestDistance)
+    {
+      closestDistance = distance;
+      start = i;
+    }
+  }
+
+  if (!start)
+  {
+    return maxDistance;
+  }
+
+  for (size_t i = 1u; i < count; ++i)
+  {
+    closestDistance = vm::max(
+      closestDistance,
+      vm::distance(m_vertexPositions[indices[(*start + i) % count]], positions[i]));
+  }
+  return closestDistance;
+}
+
+void CompactBrushGeometry::updateBounds()
+{
+  auto builder = vm::bbox3::builder{};
+  builder.add(m_vertexPositions.begin(), m_vertexPositions.end());
+  m_bounds = builder.initialized() ? builder.bounds() : vm::bbox3{};
+}
+} // namespace Model
+} // namespace TrenchBroom
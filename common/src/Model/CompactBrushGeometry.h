@@ -0,0 +1,182 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FloatType.h"
+#include "Model/BrushGeometry.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+/**
+ * The geometry of a brush in a compact, immutable form.
+ *
+ * The vertex positions, face boundaries and edges are stored in contiguous arrays which
+ * refer to vertices and faces by their 32 bit index. This is the only form in which a
+ * brush keeps its geometry. Operations that change the topology of a brush build a
+ * temporary BrushGeometry from it and create a new compact geometry from the result.
+ *
+ * The faces are in the same order as the faces of the brush.
+ */
+class CompactBrushGeometry
+{
+public:
+  using Index = uint32_t;
+  using IndexIterator = std::vector<Index>::const_iterator;
+
+private:
+  std::vector<vm::vec3> m_vertexPositions;
+
+  /**
+   * The vertex indices of the boundaries of all faces in counter clockwise order, one
+   * face after the other.
+   */
+  std::vector<Index> m_faceVertexIndices;
+
+  /**
+   * The offset of each face's boundary in m_faceVertexIndices, followed by the total
+   * number of face vertex indices.
+   */
+  std::vector<Index> m_faceOffsets;
+
+  std::vector<std::pair<Index, Index>> m_edgeVertexIndices;
+  std::vector<std::pair<Index, Index>> m_edgeFaceIndices;
+
+  vm::bbox3 m_bounds;
+
+public:
+  CompactBrushGeometry();
+
+  /**
+   * Creates a compact copy of the given geometry. The payload of each face of the given
+   * geometry must be the index of the corresponding brush face.
+   */
+  explicit CompactBrushGeometry(const BrushGeometry& geometry);
+
+  /**
+   * Creates a compact geometry with the given vertices and faces, e.g. one that was
+   * previously obtained from another compact geometry. Each face is given by the indices
+   * of the vertices of its boundary in counter clockwise order.
+   *
+   * The given data must describe a closed polyhedron: every pair of consecutive vertices
+   * of a face boundary must occur in the reverse order in exactly one other face
+   * boundary.
+   */
+  CompactBrushGeometry(
+    std::vector<vm::vec3> vertexPositions,
+    const std::vector<std::vector<size_t>>& faceVertexIndices);
+
+  /**
+   * Creates a BrushGeometry with the vertices and faces of this geometry. The payload of
+   * each face of the returned geometry is its index.
+   *
+   * @param facePlanes the plane of each face
+   */
+  BrushGeometry makeBrushGeometry(const std::vector<vm::plane3>& facePlanes) const;
+
+  const vm::bbox3& bounds() const;
+  bool closed() const;
+
+  size_t vertexCount() const;
+  const std::vector<vm::vec3>& vertexPositions() const;
+  const vm::vec3& vertexPosition(size_t vertexIndex) const;
+
+  size_t faceCount() const;
+  size_t faceVertexCount(size_t faceIndex) const;
+
+  /**
+   * Returns the range of the vertex indices of the given face's boundary in counter
+   * clockwise order.
+   */
+  IndexIterator faceVertexIndicesBegin(size_t faceIndex) const;
+  IndexIterator faceVertexIndicesEnd(size_t faceIndex) const;
+
+  /**
+   * Returns the positions of the vertices of the given face's boundary in counter
+   * clockwise order.
+   */
+  std::vector<vm::vec3> faceVertexPositions(size_t faceIndex) const;
+
+  size_t edgeCount() const;
+
+  /**
+   * Returns the indices of the first and second vertex of the given edge.
+   */
+  const std::pair<Index, Index>& edgeVertexIndices(size_t edgeIndex) const;
+
+  /**
+   * Returns the indices of the first and second face incident to the given edge. The
+   * boundary of the first face leads from the first to the second vertex of the edge,
+   * and the boundary of the second face leads back.
+   */
+  const std::pair<Index, Index>& edgeFaceIndices(size_t edgeIndex) const;
+
+  /**
+   * Returns the indices of the faces incident to the given vertex.
+   */
+  std::vector<size_t> incidentFaces(size_t vertexIndex) const;
+
+  /**
+   * The following functions find vertices, edges and faces in the same way as the
+   * corresponding functions of Polyhedron.
+   */
+  std::optional<size_t> findVertex(
+    const vm::vec3& position, FloatType epsilon = static_cast<FloatType>(0.0)) const;
+  std::optional<size_t> findClosestVertex(
+    const vm::vec3& position,
+    FloatType maxDistance = std::numeric_limits<FloatType>::max()) const;
+
+  std::optional<size_t> findEdge(
+    const vm::vec3& position1,
+    const vm::vec3& position2,
+    FloatType epsilon = static_cast<FloatType>(0.0)) const;
+  std::optional<size_t> findClosestEdge(
+    const vm::vec3& position1,
+    const vm::vec3& position2,
+    FloatType maxDistance = std::numeric_limits<FloatType>::max()) const;
+
+  bool faceHasVertexPositions(
+    size_t faceIndex,
+    const std::vector<vm::vec3>& positions,
+    FloatType epsilon = static_cast<FloatType>(0.0)) const;
+  std::optional<size_t> findFace(
+    const std::vector<vm::vec3>& positions,
+    FloatType epsilon = static_cast<FloatType>(0.0)) const;
+  std::optional<size_t> findClosestFace(
+    const std::vector<vm::vec3>& positions,
+    FloatType maxDistance = std::numeric_limits<FloatType>::max()) const;
+
+private:
+  FloatType faceDistanceTo(
+    size_t faceIndex, const std::vector<vm::vec3>& positions) const;
+  void updateBounds();
+};
+} // namespace Model
+} // namespace TrenchBroom
@@ -40,6 +40,7 @@
 #include "IO/GameConfigParser.h"
 #include "IO/IOUtils.h"
 #include "IO/ImageSpriteParser.h"
+#include "IO/MapCache.h"
 #include "IO/Md2Parser.h"
 #include "IO/Md3Parser.h"
 #include "IO/MdlParser.h"
@@ -50,7 +51,9 @@
 #include "IO/ObjSerializer.h"
 #include "IO/SimpleParserStatus.h"
 #include "IO/SprParser.h"
+#include "IO/SynchronizedFileSystem.h"
 #include "IO/SystemPaths.h"
+#include "IO/TextureCache.h"
 #include "IO/TextureLoader.h"
 #include "IO/WorldReader.h"
 #include "Logger.h"
@@ -63,6 +66,8 @@
 #include "Model/GameConfig.h"
 #include "Model/LayerNode.h"
 #include "Model/WorldNode.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
 
 #include <kdl/overload.h>
 #include <kdl/result.h>
@@ -74,6 +79,7 @@
 #include <vecmath/vec_io.h>
 
 #include <fstream>
+#include <future>
 #include <string>
 #include <vector>
 
@@ -83,6 +89,8 @@ namespace Model
 {
 GameImpl::GameImpl(GameConfig& config, IO::Path gamePath, Logger& logger)
   : m_config{config}
+  , m_fs{std::make_shared<GameFileSystem>()}
+  , m_textureFS{std::make_shared<IO::SynchronizedFileSystem>(m_fs)}
   , m_gamePath{std::move(gamePath)}
 {
   initializeFileSystem(logger);
@@ -90,7 +98,7 @@ GameImpl::GameImpl(GameConfig& config, IO::Path gamePath, Logger& logger)
 
 void GameImpl::initializeFileSystem(Logger& logger)
 {
-  m_fs.initialize(m_config, m_gamePath, m_additionalSearchPaths, logger);
+  m_fs->initialize(m_config, m_gamePath, m_additionalSearchPaths, logger);
 }
 
 const std::string& GameImpl::doGameName() const
@@ -214,8 +222,31 @@ std::unique_ptr<WorldNode> GameImpl::doLoadMap(
   Logger& logger) const
 {
   auto parserStatus = IO::SimpleParserStatus{logger};
-  auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
+  // the map file is mapped into memory and parsed in place to avoid copying its contents
+  auto file = IO::Disk::openMappedFile(IO::Disk::fixPath(path));
   auto fileReader = file->reader().buffer();
+
+  const auto mapCacheSize = pref(Preferences::MapCacheSize);
+  auto cache = std::optional<IO::MapCache>{};
+  if (mapCacheSize > 0)
+  {
+    cache = IO::MapCache{
+      IO::mapCachePath(path),
+      fileReader.stringView(),
+      m_config.name,
+      format,
+      worldBounds};
+    if (
+      auto worldNode = IO::WorldReader::readFromCache(
+        *cache, worldBounds, entityPropertyConfig(), parserStatus))
+    {
+      logger.debug() << "Loaded map from cache " << cache->path();
+      return worldNode;
+    }
+  }
+
+  const auto messageCount = parserStatus.messageCount();
+  auto worldNode = std::unique_ptr<WorldNode>{};
   if (format == MapFormat::Unknown)
   {
     // Try all formats listed in the game config
@@ -223,7 +254,7 @@ std::unique_ptr<WorldNode> GameImpl::doLoadMap(
       m_config.fileFormats,
       [](const auto& config) { return Model::formatFromName(config.format); });
 
-    return IO::WorldReader::tryRead(
+    worldNode = IO::WorldReader::tryRead(
       fileReader.stringView(),
       possibleFormats,
       worldBounds,
@@ -234,8 +265,37 @@ std::unique_ptr<WorldNode> GameImpl::doLoadMap(
   {
     auto worldReader =
       IO::WorldReader{fileReader.stringView(), format, entityPropertyConfig()};
-    return worldReader.read(worldBounds, parserStatus);
+    worldNode = worldReader.read(worldBounds, parserStatus);
   }
+
+  // messages logged while reading the map would be lost when reading it from the cache
+  if (cache && parserStatus.messageCount() == messageCount)
+  {
+    writeMapCache(*cache, *worldNode, static_cast<size_t>(mapCacheSize) * 1024u * 1024u);
+  }
+
+  return worldNode;
+}
+
+void GameImpl::writeMapCache(
+  const IO::MapCache& cache, const WorldNode& worldNode, const size_t maxCacheSize) const
+{
+  // the world must be serialized before it is returned and can be modified, but writing
+  // the cache file and trimming the cache directory happen on a worker thread so that
+  // they don't delay loading the map
+  auto data = cache.serialize(worldNode);
+  m_pendingMapCacheWrite =
+    std::async(std::launch::async, [cache, data = std::move(data), maxCacheSize]() {
+      try
+      {
+        cache.write(data);
+        IO::Disk::trimDirectory(IO::mapCacheDirectory(), maxCacheSize);
+      }
+      catch (const Exception&)
+      {
+        // the map will be parsed again when it is loaded the next time
+      }
+    });
 }
 
 void GameImpl::doWriteMap(
@@ -260,6 +320,14 @@ void GameImpl::doWriteMap(WorldNode& world, const IO::Path& path) const
   doWriteMap(world, path, false);
 }
 
+void GameImpl::doWriteMapToStream(WorldNode& world, std::ostream& stream) const
+{
+  IO::writeGameComment(stream, gameName(), formatName(world.mapFormat()));
+
+  auto writer = IO::NodeWriter{world, stream};
+  writer.writeMap();
+}
+
 void GameImpl::doExportMap(WorldNode& world, const IO::ExportOptions& options) const
 {
   std::visit(
@@ -347,8 +415,19 @@ void GameImpl::doLoadTextureCollections(
   const auto paths = extractTextureCollections(entity);
 
   const auto fileSearchPaths = textureCollectionSearchPaths(documentPath);
-  auto textureLoader =
-    IO::TextureLoader{m_fs, fileSearchPaths, m_config.textureConfig, logger};
+  const auto textureCacheSize = pref(Preferences::TextureCacheSize);
+  auto textureCache = textureCacheSize > 0
+                        ? std::make_shared<IO::TextureCache>(
+                          IO::textureCacheDirectory(),
+                          static_cast<size_t>(textureCacheSize) * 1024u * 1024u)
+                        : nullptr;
+  auto textureLoader = IO::TextureLoader{
+    m_textureFS,
+    fileSearchPaths,
+    m_config.textureConfig,
+    logger,
+    pref(Preferences::LoadTexturesOnDemand),
+    std::move(textureCache)};
   textureLoader.loadTextures(paths, textureManager);
 }
 
@@ -378,11 +457,11 @@ std::vector<IO::Path> GameImpl::doFindTextureCollections() const
   try
   {
     const auto searchPath = getRootDirectory(m_config.textureConfig.package);
-    if (!searchPath.isEmpty() && m_fs.directoryExists(searchPath))
+    if (!searchPath.isEmpty() && m_fs->directoryExists(searchPath))
     {
       return kdl::vec_concat(
         std::vector<IO::Path>{searchPath},
-        m_fs.findItemsRecursively(
+        m_fs->findItemsRecursively(
           searchPath, IO::FileTypeMatcher{!true(files), true(directories)}));
     }
     return {};
@@ -429,7 +508,7 @@ void GameImpl::doUpdateTextureCollections(
 
 void GameImpl::doReloadShaders()
 {
-  m_fs.reloadShaders();
+  m_fs->reloadShaders();
 }
 
 bool GameImpl::doIsEntityDefinitionFile(const IO::Path& path) const
@@ -605,7 +684,7 @@ std::unique_ptr<Assets::EntityModel> GameImpl::doInitializeModel(
   try
   {
     return withEntityParser(
-      m_fs,
+      *m_fs,
       path,
       [&]() { return loadTexturePalette(); },
       [&](auto& parser) { return parser.initializeModel(logger); });
@@ -638,14 +717,14 @@ void GameImpl::doLoadFrame(
     ensure(model.frame(frameIndex) != nullptr, "invalid frame index");
     ensure(!model.frame(frameIndex)->loaded(), "frame already loaded");
 
-    const auto file = m_fs.openFile(path);
+    const auto file = m_fs->openFile(path);
     ensure(file != nullptr, "file is null");
 
     const auto modelName = path.lastComponent().asString();
     const auto extension = kdl::str_to_lower(path.extension());
 
     return withEntityParser(
-      m_fs,
+      *m_fs,
       path,
       [&]() { return loadTexturePalette(); },
       [&](auto& parser) { return parser.loadFrame(frameIndex, model, logger); });
@@ -664,7 +743,7 @@ void GameImpl::doLoadFrame(
 
 Assets::Palette GameImpl::loadTexturePalette() const
 {
-  return Assets::Palette::loadFile(m_fs, m_config.textureConfig.palette);
+  return Assets::Palette::loadFile(*m_fs, m_config.textureConfig.palette);
 }
 
 std::vector<std::string> GameImpl::doAvailableMods() const
@@ -24,6 +24,7 @@
 #include "Model/Game.h"
 #include "Model/GameFileSystem.h"
 
+#include <future>
 #include <memory>
 #include <optional>
 #include <string>
@@ -38,6 +39,12 @@ namespace Assets
 class Palette;
 }
 
+namespace IO
+{
+class MapCache;
+class SynchronizedFileSystem;
+} // namespace IO
+
 namespace Model
 {
 struct EntityPropertyConfig;
@@ -46,9 +53,17 @@ class GameImpl : public Game
 {
 private:
   GameConfig& m_config;
-  GameFileSystem m_fs;
+  std::shared_ptr<GameFileSystem> m_fs;
+
+  /**
+   * Gives the texture loaders access to m_fs from multiple threads. Textures which are
+   * loaded lazily share its ownership, so that they can still be decoded after the game
+   * has been destroyed.
+   */
+  std::shared_ptr<IO::SynchronizedFileSystem> m_textureFS;
   IO::Path m_gamePath;
   std::vector<IO::Path> m_additionalSearchPaths;
+  mutable std::future<void> m_pendingMapCacheWrite;
 
 public:
   GameImpl(GameConfig& config, IO::Path gamePath, Logger& logger);
@@ -83,6 +98,7 @@ private:
     Logger& logger) const override;
   void doWriteMap(WorldNode& world, const IO::Path& path, bool exporting) const;
   void doWriteMap(WorldNode& world, const IO::Path& path) const override;
+  void doWriteMapToStream(WorldNode& world, std::ostream& stream) const override;
   void doExportMap(WorldNode& world, const IO::ExportOptions& options) const override;
 
   std::vector<Node*> doParseNodes(
@@ -155,6 +171,9 @@ private:
 private:
   EntityPropertyConfig entityPropertyConfig() const;
 
+  void writeMapCache(
+    const IO::MapCache& cache, const WorldNode& worldNode, size_t maxCacheSize) const;
+
   void writeLongAttribute(
     EntityNodeBase& node,
     const std::string& baseName,
@@ -53,9 +53,9 @@ NonIntegerVerticesValidator::NonIntegerVerticesValidator()
 void NonIntegerVerticesValidator::doValidate(
   BrushNode& brushNode, std::vector<std::unique_ptr<Issue>>& issues) const
 {
-  const auto& vertices = brushNode.brush().vertices();
-  if (!std::all_of(vertices.begin(), vertices.end(), [](const auto* vertex) {
-        return vm::is_integral(vertex->position());
+  const auto& vertices = brushNode.brush().vertexPositions();
+  if (!std::all_of(vertices.begin(), vertices.end(), [](const auto& vertex) {
+        return vm::is_integral(vertex);
       }))
   {
     issues.push_back(
@@ -42,6 +42,7 @@
 #include <cassert>
 #include <ostream>
 #include <string>
+#include <utility>
 
 namespace TrenchBroom
 {
@@ -339,6 +340,7 @@ BezierPatch PatchNode::setPatch(BezierPatch patch)
 
   auto previousPatch = std::exchange(m_patch, std::move(patch));
   m_grid = makePatchGrid(m_patch, DefaultSubdivisionsPerSurface);
+  m_serializedText = std::nullopt;
   return previousPatch;
 }
 
@@ -352,6 +354,17 @@ const PatchGrid& PatchNode::grid() const
   return m_grid;
 }
 
+const SerializedNodeText* PatchNode::serializedText(const MapFormat mapFormat) const
+{
+  return m_serializedText && m_serializedText->mapFormat == mapFormat ? &*m_serializedText
+                                                                      : nullptr;
+}
+
+void PatchNode::setSerializedText(SerializedNodeText serializedText) const
+{
+  m_serializedText = std::move(serializedText);
+}
+
 const std::string& PatchNode::doGetName() const
 {
   static const auto name = std::string{"patch"};
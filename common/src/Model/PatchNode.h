@@ -23,6 +23,7 @@
 #include "Model/HitType.h"
 #include "Model/Node.h"
 #include "Model/Object.h"
+#include "Model/SerializedNodeText.h"
 
 #include <vecmath/bbox.h>
 #include <vecmath/vec.h>
@@ -83,6 +84,7 @@ public:
 private:
   BezierPatch m_patch;
   PatchGrid m_grid;
+  mutable std::optional<SerializedNodeText> m_serializedText;
 
 public:
   explicit PatchNode(BezierPatch patch);
@@ -97,6 +99,13 @@ public:
 
   const PatchGrid& grid() const;
 
+  /**
+   * Returns the text that was last generated for this patch by a map file serializer for
+   * the given map format, or null if this patch changed since then.
+   */
+  const SerializedNodeText* serializedText(MapFormat mapFormat) const;
+  void setSerializedText(SerializedNodeText serializedText) const;
+
 private: // implement Node interface
   const std::string& doGetName() const override;
   const vm::bbox3& doGetLogicalBounds() const override;
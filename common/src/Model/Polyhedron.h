@@ -113,6 +113,13 @@ private:
   explicit Polyhedron_Vertex(const vm::vec<T, 3>& position);
 
 public:
+  /**
+   * Vertices, edges, half edges and faces are allocated from a kdl::object_pool because
+   * building and modifying polyhedra creates and destroys large numbers of them.
+   */
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr) noexcept;
+
   /**
    * Returns the position of this vertex.
    */
@@ -260,6 +267,12 @@ private:
   Polyhedron_Edge(HalfEdge* first, HalfEdge* second = nullptr);
 
 public:
+  /**
+   * Allocates from a kdl::object_pool, see Polyhedron_Vertex::operator new.
+   */
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr) noexcept;
+
   /**
    * Returns the origin of the first half edge.
    */
@@ -577,6 +590,12 @@ private:
   Polyhedron_HalfEdge(Vertex* origin);
 
 public:
+  /**
+   * Allocates from a kdl::object_pool, see Polyhedron_Vertex::operator new.
+   */
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr) noexcept;
+
   /**
    * Returns the origin vertex of this half edge.
    */
@@ -803,6 +822,12 @@ private:
   explicit Polyhedron_Face(HalfEdgeList&& boundary, const vm::plane<T, 3>& plane);
 
 public:
+  /**
+   * Allocates from a kdl::object_pool, see Polyhedron_Vertex::operator new.
+   */
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr) noexcept;
+
   /**
    * Returns the circular list of half edges that make up the boundary of this face.
    */
@@ -1213,6 +1238,25 @@ public: // Constructors
    */
   explicit Polyhedron(std::vector<vm::vec<T, 3>> positions);
 
+  /**
+   * Constructs a polyhedron with the given vertices and faces without computing its
+   * topology. Each face is given by the indices of the vertices of its boundary and by
+   * its plane. The faces are added in the given order.
+   *
+   * The given data must describe a valid polyhedron, e.g. one that was previously
+   * obtained from another polyhedron. In particular, every pair of consecutive vertices
+   * of a face boundary must occur in the reverse order in exactly one other face
+   * boundary.
+   *
+   * @param positions the vertex positions
+   * @param faceVertexIndices the vertex indices of each face boundary
+   * @param facePlanes the plane of each face
+   */
+  Polyhedron(
+    std::vector<vm::vec<T, 3>> positions,
+    const std::vector<std::vector<size_t>>& faceVertexIndices,
+    const std::vector<vm::plane<T, 3>>& facePlanes);
+
   /**
    * Copy constructor.
    */
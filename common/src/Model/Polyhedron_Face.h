@@ -23,6 +23,8 @@
 
 #include "Polyhedron.h"
 
+#include <kdl/object_pool.h>
+
 #include <vecmath/constants.h>
 #include <vecmath/intersection.h>
 #include <vecmath/plane.h>
@@ -31,6 +33,7 @@
 #include <vecmath/util.h>
 #include <vecmath/vec.h>
 
+#include <cassert>
 #include <unordered_set>
 
 namespace TrenchBroom
@@ -77,6 +80,20 @@ Polyhedron_Face<T, FP, VP>::Polyhedron_Face(
   countAndSetFace(m_boundary.front(), m_boundary.back(), this);
 }
 
+template <typename T, typename FP, typename VP>
+void* Polyhedron_Face<T, FP, VP>::operator new(const size_t size)
+{
+  assert(size == sizeof(Polyhedron_Face));
+  unused(size);
+  return kdl::object_pool<Polyhedron_Face>::allocate();
+}
+
+template <typename T, typename FP, typename VP>
+void Polyhedron_Face<T, FP, VP>::operator delete(void* ptr) noexcept
+{
+  kdl::object_pool<Polyhedron_Face>::deallocate(ptr);
+}
+
 template <typename T, typename FP, typename VP>
 const typename Polyhedron_Face<T, FP, VP>::HalfEdgeList& Polyhedron_Face<T, FP, VP>::
   boundary() const
@@ -32,8 +32,10 @@
 #include <vecmath/vec_io.h>
 
 #include <sstream>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace TrenchBroom
 {
@@ -217,6 +219,70 @@ Polyhedron<T, FP, VP>::Polyhedron(std::vector<vm::vec<T, 3>> positions)
   addPoints(std::move(positions));
 }
 
+template <typename T, typename FP, typename VP>
+Polyhedron<T, FP, VP>::Polyhedron(
+  std::vector<vm::vec<T, 3>> positions,
+  const std::vector<std::vector<size_t>>& faceVertexIndices,
+  const std::vector<vm::plane<T, 3>>& facePlanes)
+{
+  assert(faceVertexIndices.size() == facePlanes.size());
+
+  auto vertices = std::vector<Vertex*>{};
+  vertices.reserve(positions.size());
+  for (const auto& position : positions)
+  {
+    auto* vertex = new Vertex(position);
+    vertices.push_back(vertex);
+    m_vertices.push_back(vertex);
+  }
+
+  // for each vertex, the half edges leaving it and the indices of their destinations
+  auto leavingHalfEdges =
+    std::vector<std::vector<std::tuple<size_t, HalfEdge*>>>(positions.size());
+
+  for (size_t i = 0u; i < faceVertexIndices.size(); ++i)
+  {
+    const auto& indices = faceVertexIndices[i];
+    assert(indices.size() >= 3u);
+
+    HalfEdgeList boundary;
+    for (size_t j = 0u; j < indices.size(); ++j)
+    {
+      const auto origin = indices[j];
+      const auto destination = indices[(j + 1u) % indices.size()];
+      assert(origin < vertices.size() && destination < vertices.size());
+
+      HalfEdge* halfEdge = new HalfEdge(vertices[origin]);
+      leavingHalfEdges[origin].emplace_back(destination, halfEdge);
+      boundary.push_back(halfEdge);
+    }
+    m_faces.push_back(new Face(std::move(boundary), facePlanes[i]));
+  }
+
+  // every edge connects a half edge with the half edge leaving its destination in the
+  // opposite direction
+  for (size_t origin = 0u; origin < leavingHalfEdges.size(); ++origin)
+  {
+    for (const auto& [destination, halfEdge] : leavingHalfEdges[origin])
+    {
+      if (origin < destination)
+      {
+        for (const auto& [twinDestination, twin] : leavingHalfEdges[destination])
+        {
+          if (twinDestination == origin)
+          {
+            m_edges.push_back(new Edge(halfEdge, twin));
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  updateBounds();
+  assert(checkInvariant());
+}
+
 template <typename T, typename FP, typename VP>
 Polyhedron<T, FP, VP>::Polyhedron(const Polyhedron<T, FP, VP>& other)
 {
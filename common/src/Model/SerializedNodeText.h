@@ -0,0 +1,42 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Model/MapFormat.h"
+
+#include <string>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+/**
+ * The text that a map file serializer generated for a brush or a patch. Nodes keep this
+ * text until they change so that saving a map only needs to serialize the nodes that
+ * were modified since the map was last saved.
+ */
+struct SerializedNodeText
+{
+  MapFormat mapFormat;
+  std::string text;
+  size_t lineCount;
+};
+} // namespace Model
+} // namespace TrenchBroom
@@ -61,6 +61,11 @@ Preference<Color> PortalFileBorderColor(
 Preference<Color> PortalFileFillColor(
   IO::Path("Renderer/Colors/Portal file fill"), Color(1.0f, 0.4f, 0.4f, 0.2f));
 Preference<bool> ShowFPS(IO::Path("Renderer/Show FPS"), false);
+Preference<bool> ShowRenderStats(IO::Path("Renderer/Show render statistics"), false);
+Preference<bool> OcclusionCulling(IO::Path("Renderer/Occlusion culling"), false);
+Preference<bool> CompactBrushVertices(IO::Path("Renderer/Compact brush vertices"), true);
+Preference<bool> PersistentlyMappedBuffers(
+  IO::Path("Renderer/Persistently mapped buffers"), true);
 
 Preference<Color>& axisColor(vm::axis::type axis)
 {
@@ -339,6 +344,15 @@ QString entityLinkModeNone()
 }
 Preference<QString> EntityLinkMode(IO::Path("Map view/Entity link mode"), "direct");
 
+Preference<int> MaxThreadCount(IO::Path("Performance/Max thread count"), 0);
+Preference<int> MapCacheSize(IO::Path("Performance/Map cache size"), 256);
+Preference<bool> AutosaveInBackground(
+  IO::Path("Performance/Autosave in background"), true);
+Preference<bool> LoadTexturesOnDemand(
+  IO::Path("Performance/Load textures on demand"), true);
+Preference<int> TextureMemoryBudget(IO::Path("Performance/Texture memory budget"), 512);
+Preference<int> TextureCacheSize(IO::Path("Performance/Texture cache size"), 1024);
+
 const std::vector<PreferenceBase*>& staticPreferences()
 {
   static const std::vector<PreferenceBase*> list{
@@ -354,6 +368,10 @@ const std::vector<PreferenceBase*>& staticPreferences()
     &PortalFileBorderColor,
     &PortalFileFillColor,
     &ShowFPS,
+    &ShowRenderStats,
+    &OcclusionCulling,
+    &CompactBrushVertices,
+    &PersistentlyMappedBuffers,
     &CompassBackgroundColor,
     &CompassBackgroundOutlineColor,
     &CompassAxisOutlineColor,
@@ -452,7 +470,13 @@ const std::vector<PreferenceBase*>& staticPreferences()
     &ShowSoftMapBounds,
     &ShowPointEntities,
     &ShowBrushes,
-    &EntityLinkMode};
+    &EntityLinkMode,
+    &MaxThreadCount,
+    &MapCacheSize,
+    &AutosaveInBackground,
+    &LoadTexturesOnDemand,
+    &TextureMemoryBudget,
+    &TextureCacheSize};
 
   return list;
 }
@@ -54,6 +54,10 @@ extern Preference<Color> PointFileColor;
 extern Preference<Color> PortalFileBorderColor;
 extern Preference<Color> PortalFileFillColor;
 extern Preference<bool> ShowFPS;
+extern Preference<bool> ShowRenderStats;
+extern Preference<bool> OcclusionCulling;
+extern Preference<bool> CompactBrushVertices;
+extern Preference<bool> PersistentlyMappedBuffers;
 
 Preference<Color>& axisColor(vm::axis::type axis);
 
@@ -200,6 +204,47 @@ QString entityLinkModeDirect();
 QString entityLinkModeNone();
 extern Preference<QString> EntityLinkMode;
 
+/**
+ * The maximum number of threads used for parallel processing, e.g. when loading or saving
+ * maps. A value of 0 means to use all available hardware threads.
+ */
+extern Preference<int> MaxThreadCount;
+
+/**
+ * The size in megabytes of the cache in the user data directory which stores the contents
+ * of loaded map files in a binary format, so that reopening an unchanged map file doesn't
+ * need to parse it again. The least recently used cache files are removed when the cache
+ * grows larger. A value of 0 disables the cache.
+ */
+extern Preference<int> MapCacheSize;
+
+/**
+ * Whether autosave backups are written on a worker thread. Only serializing the map
+ * happens on the main thread, everything else, such as rotating old backups and writing
+ * the file, happens in the background.
+ */
+extern Preference<bool> AutosaveInBackground;
+
+/**
+ * Whether the pixel data of textures is only decoded once a texture is used by the map or
+ * shown in the texture browser, so that loading textures doesn't depend on the size of
+ * the texture collections.
+ */
+extern Preference<bool> LoadTexturesOnDemand;
+
+/**
+ * The video memory in megabytes that textures which are loaded on demand may occupy
+ * before the least recently used ones are unloaded. A value of 0 means no limit.
+ */
+extern Preference<int> TextureMemoryBudget;
+
+/**
+ * The size in megabytes of the cache in the user data directory which stores textures
+ * decoded from image files, so that they need not be decoded again when they are loaded
+ * the next time. A value of 0 disables the cache.
+ */
+extern Preference<int> TextureCacheSize;
+
 /**
  * Returns all Preferences declared in this file. Needed for migrating preference formats
  * or if we wanted to do a Path to Preference lookup.
@@ -22,23 +22,67 @@
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushNode.h"
+#include "Model/CompactBrushGeometry.h"
 #include "Model/EditorContext.h"
-#include "Model/Polyhedron.h"
 #include "Model/TagAttribute.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "Renderer/BrushRendererArrays.h"
 #include "Renderer/BrushRendererBrushCache.h"
+#include "Renderer/Camera.h"
+#include "Renderer/OcclusionCuller.h"
 #include "Renderer/RenderContext.h"
 
+#include <kdl/parallel.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/plane.h>
+
+#include <algorithm>
 #include <cassert>
-#include <cstring>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom
 {
 namespace Renderer
 {
+namespace
+{
+/**
+ * The edge length of the grid cells which partition the brushes into chunks.
+ */
+constexpr auto ChunkSize = 1024.0;
+
+/**
+ * The minimum area of an opaque face to be used as an occluder.
+ */
+constexpr auto MinOccluderArea = 64.0 * 64.0;
+
+using TextureToBrushIndexPoolMap =
+  std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexPool>>;
+
+std::shared_ptr<BrushIndexPool> findOrCreatePool(
+  TextureToBrushIndexPoolMap& pools, const Assets::Texture* texture)
+{
+  auto& pool = pools[texture];
+  if (pool == nullptr)
+  {
+    pool = std::make_shared<BrushIndexPool>();
+  }
+  return pool;
+}
+
+void releaseUnusedPool(TextureToBrushIndexPoolMap& pools, const Assets::Texture* texture)
+{
+  const auto it = pools.find(texture);
+  if (it != pools.end() && !it->second->hasPages())
+  {
+    pools.erase(it);
+  }
+}
+} // namespace
+
 // Filter
 
 BrushRenderer::Filter::Filter() = default;
@@ -70,15 +114,14 @@ bool BrushRenderer::DefaultFilter::visible(
 }
 
 bool BrushRenderer::DefaultFilter::visible(
-  const Model::BrushNode& brushNode, const Model::BrushEdge& edge) const
+  const Model::BrushNode& brushNode, const size_t edgeIndex) const
 {
   const auto& brush = brushNode.brush();
-  const auto firstFaceIndex = edge.firstFace()->payload();
-  const auto secondFaceIndex = edge.secondFace()->payload();
-  assert(firstFaceIndex && secondFaceIndex);
+  const auto [firstFaceIndex, secondFaceIndex] =
+    brush.geometry().edgeFaceIndices(edgeIndex);
 
-  const auto& firstFace = brush.face(*firstFaceIndex);
-  const auto& secondFace = brush.face(*secondFaceIndex);
+  const auto& firstFace = brush.face(firstFaceIndex);
+  const auto& secondFace = brush.face(secondFaceIndex);
 
   return m_context.visible(&brushNode, firstFace)
          || m_context.visible(&brushNode, secondFace);
@@ -107,15 +150,14 @@ bool BrushRenderer::DefaultFilter::selected(
 }
 
 bool BrushRenderer::DefaultFilter::selected(
-  const Model::BrushNode& brushNode, const Model::BrushEdge& edge) const
+  const Model::BrushNode& brushNode, const size_t edgeIndex) const
 {
   const auto& brush = brushNode.brush();
-  const auto firstFaceIndex = edge.firstFace()->payload();
-  const auto secondFaceIndex = edge.secondFace()->payload();
-  assert(firstFaceIndex && secondFaceIndex);
+  const auto [firstFaceIndex, secondFaceIndex] =
+    brush.geometry().edgeFaceIndices(edgeIndex);
 
-  const auto& firstFace = brush.face(*firstFaceIndex);
-  const auto& secondFace = brush.face(*secondFaceIndex);
+  const auto& firstFace = brush.face(firstFaceIndex);
+  const auto& secondFace = brush.face(secondFaceIndex);
 
   return selected(brushNode) || selected(brushNode, firstFace)
          || selected(brushNode, secondFace);
@@ -150,23 +192,14 @@ BrushRenderer::BrushRenderer()
   , m_forceTransparent{false}
   , m_transparencyAlpha{1.0f}
   , m_showHiddenBrushes{false}
+  , m_compactVertices{false}
 {
   clear();
 }
 
 void BrushRenderer::invalidate()
 {
-  for (auto* brushNode : m_allBrushes)
-  {
-    // this will also invalidate already invalid brushes, which
-    // is unnecessary
-    removeBrushFromVbo(*brushNode);
-  }
   m_invalidBrushes = m_allBrushes;
-
-  assert(m_brushInfo.empty());
-  assert(m_transparentFaces->empty());
-  assert(m_opaqueFaces->empty());
 }
 
 void BrushRenderer::invalidateBrush(const Model::BrushNode* brushNode)
@@ -179,10 +212,7 @@ void BrushRenderer::invalidateBrush(const Model::BrushNode* brushNode)
     return;
   }
   // if it's not in the invalid set, put it in
-  if (m_invalidBrushes.insert(brushNode).second)
-  {
-    removeBrushFromVbo(*brushNode);
-  }
+  m_invalidBrushes.insert(brushNode);
 }
 
 bool BrushRenderer::valid() const
@@ -195,16 +225,16 @@ void BrushRenderer::clear()
   m_brushInfo.clear();
   m_allBrushes.clear();
   m_invalidBrushes.clear();
+  m_chunks.clear();
+  m_opaqueFacePools.clear();
+  m_transparentFacePools.clear();
+  m_edgeIndexPool = std::make_shared<BrushIndexPool>();
 
-  m_vertexArray = std::make_shared<BrushVertexArray>();
-  m_edgeIndices = std::make_shared<BrushIndexArray>();
-  m_transparentFaces = std::make_shared<TextureToBrushIndicesMap>();
-  m_opaqueFaces = std::make_shared<TextureToBrushIndicesMap>();
+  m_vertexArray = std::make_shared<BrushVertexArray>(m_compactVertices);
 
-  m_opaqueFaceRenderer = FaceRenderer{m_vertexArray, m_opaqueFaces, m_faceColor};
-  m_transparentFaceRenderer =
-    FaceRenderer{m_vertexArray, m_transparentFaces, m_faceColor};
-  m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
+  m_opaqueFaceRenderer = FaceRenderer{};
+  m_transparentFaceRenderer = FaceRenderer{};
+  m_edgeRenderer = IndexedEdgeRenderer{};
 }
 
 void BrushRenderer::setFaceColor(const Color& faceColor)
@@ -249,20 +279,12 @@ void BrushRenderer::setOccludedEdgeColor(const Color& occludedEdgeColor)
 
 void BrushRenderer::setForceTransparent(const bool transparent)
 {
-  if (transparent != m_forceTransparent)
-  {
-    m_forceTransparent = transparent;
-    invalidate();
-  }
+  m_forceTransparent = transparent;
 }
 
 void BrushRenderer::setTransparencyAlpha(const float transparencyAlpha)
 {
-  if (transparencyAlpha != m_transparencyAlpha)
-  {
-    m_transparencyAlpha = transparencyAlpha;
-    invalidate();
-  }
+  m_transparencyAlpha = transparencyAlpha;
 }
 
 void BrushRenderer::setShowHiddenBrushes(const bool showHiddenBrushes)
@@ -274,6 +296,28 @@ void BrushRenderer::setShowHiddenBrushes(const bool showHiddenBrushes)
   }
 }
 
+void BrushRenderer::setCompactVertices(const bool compactVertices)
+{
+  if (compactVertices != m_compactVertices)
+  {
+    m_compactVertices = compactVertices;
+
+    // the vertex format changes, so every brush must be uploaded again
+    m_brushInfo.clear();
+    m_chunks.clear();
+    m_opaqueFacePools.clear();
+    m_transparentFacePools.clear();
+    m_edgeIndexPool = std::make_shared<BrushIndexPool>();
+    m_invalidBrushes = m_allBrushes;
+
+    m_vertexArray = std::make_shared<BrushVertexArray>(m_compactVertices);
+
+    m_opaqueFaceRenderer = FaceRenderer{};
+    m_transparentFaceRenderer = FaceRenderer{};
+    m_edgeRenderer = IndexedEdgeRenderer{};
+  }
+}
+
 void BrushRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
   renderOpaque(renderContext, renderBatch);
@@ -286,15 +330,57 @@ void BrushRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& rend
   {
     if (!valid())
     {
+      renderContext.countValidatedBrushes(m_invalidBrushes.size());
       validate();
     }
-    if (renderContext.showFaces())
+
+    const auto showFaces = renderContext.showFaces();
+    const auto showEdges = renderContext.showEdges() || m_showEdges;
+    const auto showUntaggedFaces = showFaces && !inTransparentPass(false);
+    const auto showTaggedFaces = showFaces && !inTransparentPass(true);
+
+    auto faces = std::vector<std::shared_ptr<const TextureToBrushIndicesMap>>{};
+    auto edgeIndices = std::vector<std::shared_ptr<BrushIndexArray>>{};
+    for (const auto& entry : m_chunks)
     {
-      renderOpaqueFaces(renderBatch);
+      const auto& chunk = entry.second;
+      const auto primitiveCount =
+        (showUntaggedFaces ? countTriangles(*chunk.opaqueFaces) : 0u)
+        + (showTaggedFaces ? countTriangles(*chunk.transparentFaces) : 0u)
+        + (showEdges ? countEdges(*chunk.edgeIndices) : 0u);
+
+      if (renderContext.camera().culls(chunk.bounds))
+      {
+        renderContext.countCulledPrimitives(primitiveCount);
+        continue;
+      }
+
+      // occluded edges are rendered on top of the occluders, so they must not be culled
+      if (!m_showOccludedEdges && renderContext.occludes(chunk.bounds))
+      {
+        renderContext.countOccludedObject(primitiveCount);
+        continue;
+      }
+
+      renderContext.countDrawnPrimitives(primitiveCount);
+      if (showUntaggedFaces)
+      {
+        faces.push_back(chunk.opaqueFaces);
+      }
+      if (showTaggedFaces)
+      {
+        faces.push_back(chunk.transparentFaces);
+      }
+      edgeIndices.push_back(chunk.edgeIndices);
     }
-    if (renderContext.showEdges() || m_showEdges)
+
+    if (showFaces)
+    {
+      renderOpaqueFaces(std::move(faces), renderBatch);
+    }
+    if (showEdges)
     {
-      renderEdges(renderBatch);
+      renderEdges(std::move(edgeIndices), renderBatch);
     }
   }
 }
@@ -306,25 +392,136 @@ void BrushRenderer::renderTransparent(
   {
     if (!valid())
     {
+      renderContext.countValidatedBrushes(m_invalidBrushes.size());
       validate();
     }
-    if (renderContext.showFaces())
+    const auto showUntaggedFaces = inTransparentPass(false);
+    const auto showTaggedFaces = inTransparentPass(true);
+    if (renderContext.showFaces() && (showUntaggedFaces || showTaggedFaces))
+    {
+      auto faces = std::vector<std::shared_ptr<const TextureToBrushIndicesMap>>{};
+      for (const auto& entry : m_chunks)
+      {
+        const auto& chunk = entry.second;
+        const auto primitiveCount =
+          (showUntaggedFaces ? countTriangles(*chunk.opaqueFaces) : 0u)
+          + (showTaggedFaces ? countTriangles(*chunk.transparentFaces) : 0u);
+
+        if (renderContext.camera().culls(chunk.bounds))
+        {
+          renderContext.countCulledPrimitives(primitiveCount);
+          continue;
+        }
+
+        if (renderContext.occludes(chunk.bounds))
+        {
+          renderContext.countOccludedObject(primitiveCount);
+          continue;
+        }
+
+        renderContext.countDrawnPrimitives(primitiveCount);
+        if (showUntaggedFaces)
+        {
+          faces.push_back(chunk.opaqueFaces);
+        }
+        if (showTaggedFaces)
+        {
+          faces.push_back(chunk.transparentFaces);
+        }
+      }
+
+      renderTransparentFaces(std::move(faces), renderBatch);
+    }
+  }
+}
+
+void BrushRenderer::addOccluders(
+  RenderContext& renderContext, OcclusionCuller& occlusionCuller)
+{
+  if (m_allBrushes.empty() || !renderContext.showFaces() || inTransparentPass(false))
+  {
+    return;
+  }
+
+  if (!valid())
+  {
+    renderContext.countValidatedBrushes(m_invalidBrushes.size());
+    validate();
+  }
+
+  const auto& camera = renderContext.camera();
+  const auto& cameraPosition = camera.position();
+
+  auto chunks = std::vector<std::tuple<float, const Chunk*>>{};
+  for (const auto& entry : m_chunks)
+  {
+    const auto& chunk = entry.second;
+    if (!chunk.occluders.empty() && !camera.culls(chunk.bounds))
+    {
+      const auto closestPoint =
+        vm::max(chunk.bounds.min, vm::min(cameraPosition, chunk.bounds.max));
+      chunks.emplace_back(vm::squared_distance(cameraPosition, closestPoint), &chunk);
+    }
+  }
+
+  // the nearest occluders are likely to hide the most objects
+  std::sort(chunks.begin(), chunks.end());
+
+  const auto viewPoint = vm::vec3{cameraPosition};
+  auto polygon = std::vector<vm::vec3f>{};
+  for (const auto& [distance, chunk] : chunks)
+  {
+    for (const auto* brushNode : chunk->occluders)
     {
-      renderTransparentFaces(renderBatch);
+      const auto& info = m_brushInfo.at(brushNode);
+      const auto& faces = brushNode->brush().faces();
+      for (size_t i = 0; i < faces.size(); ++i)
+      {
+        const auto& face = faces[i];
+
+        // only use large opaque faces which face the camera, back faces are hidden by
+        // the front faces of the same brush anyway
+        if (
+          !info.faceFlags[2u * i] || info.faceFlags[2u * i + 1u]
+          || face.boundary().point_status(viewPoint) != vm::plane_status::above
+          || face.area() < MinOccluderArea)
+        {
+          continue;
+        }
+
+        polygon.clear();
+        for (const auto& position : face.vertexPositions())
+        {
+          polygon.emplace_back(position);
+        }
+        occlusionCuller.addOccluder(polygon);
+
+        if (occlusionCuller.full())
+        {
+          return;
+        }
+      }
     }
   }
 }
 
-void BrushRenderer::renderOpaqueFaces(RenderBatch& renderBatch)
+void BrushRenderer::renderOpaqueFaces(
+  std::vector<std::shared_ptr<const TextureToBrushIndicesMap>> faces,
+  RenderBatch& renderBatch)
 {
+  m_opaqueFaceRenderer = FaceRenderer{m_vertexArray, std::move(faces), m_faceColor};
   m_opaqueFaceRenderer.setGrayscale(m_grayscale);
   m_opaqueFaceRenderer.setTint(m_tint);
   m_opaqueFaceRenderer.setTintColor(m_tintColor);
   m_opaqueFaceRenderer.render(renderBatch);
 }
 
-void BrushRenderer::renderTransparentFaces(RenderBatch& renderBatch)
+void BrushRenderer::renderTransparentFaces(
+  std::vector<std::shared_ptr<const TextureToBrushIndicesMap>> faces,
+  RenderBatch& renderBatch)
 {
+  m_transparentFaceRenderer =
+    FaceRenderer{m_vertexArray, std::move(faces), m_faceColor};
   m_transparentFaceRenderer.setGrayscale(m_grayscale);
   m_transparentFaceRenderer.setTint(m_tint);
   m_transparentFaceRenderer.setTintColor(m_tintColor);
@@ -332,8 +529,10 @@ void BrushRenderer::renderTransparentFaces(RenderBatch& renderBatch)
   m_transparentFaceRenderer.render(renderBatch);
 }
 
-void BrushRenderer::renderEdges(RenderBatch& renderBatch)
+void BrushRenderer::renderEdges(
+  std::vector<std::shared_ptr<BrushIndexArray>> edgeIndices, RenderBatch& renderBatch)
 {
+  m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, std::move(edgeIndices)};
   if (m_showOccludedEdges)
   {
     m_edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
@@ -341,6 +540,21 @@ void BrushRenderer::renderEdges(RenderBatch& renderBatch)
   m_edgeRenderer.render(renderBatch, m_edgeColor);
 }
 
+size_t BrushRenderer::countTriangles(const TextureToBrushIndicesMap& faces)
+{
+  auto result = size_t(0);
+  for (const auto& [texture, indexArray] : faces)
+  {
+    result += indexArray->validIndexCount() / 3u;
+  }
+  return result;
+}
+
+size_t BrushRenderer::countEdges(const BrushIndexArray& edgeIndices)
+{
+  return edgeIndices.validIndexCount() / 2u;
+}
+
 class BrushRenderer::FilterWrapper : public BrushRenderer::Filter
 {
 private:
@@ -377,17 +591,50 @@ void BrushRenderer::validate()
 {
   assert(!valid());
 
-  for (auto* brushNode : m_invalidBrushes)
+  const auto wrapper = FilterWrapper{*m_filter, m_showHiddenBrushes};
+
+  // evaluate filter. only evaluate the filter once per brush.
+  auto brushesToValidate =
+    std::vector<std::tuple<const Model::BrushNode*, Filter::RenderSettings>>{};
+  brushesToValidate.reserve(m_invalidBrushes.size());
+
+  for (const auto* brushNode : m_invalidBrushes)
   {
-    validateBrush(*brushNode);
+    const auto settings = wrapper.markFaces(*brushNode);
+    const auto [facePolicy, edgePolicy] = settings;
+
+    if (
+      facePolicy != Filter::FaceRenderPolicy::RenderNone
+      || edgePolicy != Filter::EdgeRenderPolicy::RenderNone)
+    {
+      brushesToValidate.emplace_back(brushNode, settings);
+    }
+    else if (auto it = m_brushInfo.find(brushNode); it != std::end(m_brushInfo))
+    {
+      // NOTE: skipped brushes keep their vertices, but not their indices
+      removeBrushIndicesFromVbo(*brushNode, it->second);
+    }
+  }
+
+  // Building the vertex caches (computing the vertex positions and texture coordinates of
+  // every face) is the expensive part, and it only touches the brushes themselves, so
+  // this is done in parallel. The VBO blocks must be allocated serially.
+  kdl::parallel_for(brushesToValidate.size(), [&](const size_t i) {
+    const auto* brushNode = std::get<0>(brushesToValidate[i]);
+    brushNode->brushRendererBrushCache().validateVertexCache(*brushNode);
+  });
+
+  for (const auto& [brushNode, settings] : brushesToValidate)
+  {
+    validateBrush(*brushNode, settings);
   }
   m_invalidBrushes.clear();
   assert(valid());
+}
 
-  m_opaqueFaceRenderer = FaceRenderer{m_vertexArray, m_opaqueFaces, m_faceColor};
-  m_transparentFaceRenderer =
-    FaceRenderer{m_vertexArray, m_transparentFaces, m_faceColor};
-  m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
+vm::vec3i BrushRenderer::chunkKey(const Model::BrushNode& brushNode)
+{
+  return vm::vec3i{vm::floor(brushNode.physicalBounds().center() / ChunkSize)};
 }
 
 static size_t triIndicesCountForPolygon(const size_t vertexCount)
@@ -478,66 +725,107 @@ static void getMarkedEdgeIndices(
   }
 }
 
-bool BrushRenderer::shouldDrawFaceInTransparentPass(
-  const Model::BrushNode& brushNode, const Model::BrushFace& face) const
+static bool hasTransparencyTag(
+  const Model::BrushNode& brushNode, const Model::BrushFace& face)
 {
-  if (m_transparencyAlpha >= 1.0f)
+  return brushNode.hasAttribute(Model::TagAttributes::Transparency)
+         || face.hasAttribute(Model::TagAttributes::Transparency);
+}
+
+/**
+ * Records for every face of the given brush whether it is marked and whether it has a
+ * transparency tag, which determines the edge and face indices of the brush.
+ */
+static void getFaceFlags(const Model::BrushNode& brushNode, std::vector<bool>& faceFlags)
+{
+  faceFlags.clear();
+  for (const auto& face : brushNode.brush().faces())
   {
-    // In this case, draw everything in the opaque pass
-    // see: https://github.com/TrenchBroom/TrenchBroom/issues/2848
-    return false;
+    faceFlags.push_back(face.isMarked());
+    faceFlags.push_back(hasTransparencyTag(brushNode, face));
   }
+}
 
-  if (m_forceTransparent)
+static bool faceFlagsChanged(
+  const Model::BrushNode& brushNode, const std::vector<bool>& faceFlags)
+{
+  const auto& faces = brushNode.brush().faces();
+  if (faceFlags.size() != 2u * faces.size())
   {
     return true;
   }
-  if (brushNode.hasAttribute(Model::TagAttributes::Transparency))
+
+  for (size_t i = 0; i < faces.size(); ++i)
   {
-    return true;
+    if (
+      faceFlags[2u * i] != faces[i].isMarked()
+      || faceFlags[2u * i + 1u] != hasTransparencyTag(brushNode, faces[i]))
+    {
+      return true;
+    }
   }
-  if (face.hasAttribute(Model::TagAttributes::Transparency))
+  return false;
+}
+
+bool BrushRenderer::inTransparentPass(const bool hasTransparencyTag) const
+{
+  if (m_transparencyAlpha >= 1.0f)
   {
-    return true;
+    // In this case, draw everything in the opaque pass
+    // see: https://github.com/TrenchBroom/TrenchBroom/issues/2848
+    return false;
   }
-  return false;
+  return m_forceTransparent || hasTransparencyTag;
 }
 
-void BrushRenderer::validateBrush(const Model::BrushNode& brushNode)
+void BrushRenderer::validateBrush(
+  const Model::BrushNode& brushNode, const Filter::RenderSettings& settings)
 {
   assert(m_allBrushes.find(&brushNode) != std::end(m_allBrushes));
   assert(m_invalidBrushes.find(&brushNode) != std::end(m_invalidBrushes));
-  assert(m_brushInfo.find(&brushNode) == std::end(m_brushInfo));
-
-  const auto wrapper = FilterWrapper{*m_filter, m_showHiddenBrushes};
 
-  // evaluate filter. only evaluate the filter once per brush.
-  const auto settings = wrapper.markFaces(brushNode);
-  const auto [facePolicy, edgePolicy] = settings;
+  const auto edgePolicy = std::get<1>(settings);
+  const auto& brushCache = brushNode.brushRendererBrushCache();
 
-  if (
-    facePolicy == Filter::FaceRenderPolicy::RenderNone
-    && edgePolicy == Filter::EdgeRenderPolicy::RenderNone)
+  auto it = m_brushInfo.find(&brushNode);
+  if (it != std::end(m_brushInfo))
   {
-    // NOTE: this skips inserting the brush into m_brushInfo
-    return;
+    auto& existingInfo = it->second;
+    if (existingInfo.vertexCacheGeneration != brushCache.generation())
+    {
+      // the brush geometry has changed since its vertices were uploaded
+      removeBrushFromVbo(brushNode);
+      it = std::end(m_brushInfo);
+    }
+    else if (
+      existingInfo.renderSettings == settings
+      && !faceFlagsChanged(brushNode, existingInfo.faceFlags))
+    {
+      // the brush renders the same edges and faces as before
+      return;
+    }
+    else
+    {
+      removeBrushIndicesFromVbo(brushNode, existingInfo);
+    }
   }
 
-  BrushInfo& info = m_brushInfo[&brushNode];
+  if (it == std::end(m_brushInfo))
+  {
+    it = m_brushInfo.emplace(&brushNode, BrushInfo{}).first;
+    uploadBrushVertices(brushNode, it->second);
+  }
 
-  // collect vertices
-  auto& brushCache = brushNode.brushRendererBrushCache();
-  brushCache.validateVertexCache(brushNode);
-  const auto& cachedVertices = brushCache.cachedVertices();
-  ensure(!cachedVertices.empty(), "Brush must have cached vertices");
+  BrushInfo& info = it->second;
+  info.renderSettings = settings;
+  getFaceFlags(brushNode, info.faceFlags);
 
-  assert(m_vertexArray != nullptr);
-  auto [vertBlock, dest] =
-    m_vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
-  std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
-  info.vertexHolderKey = vertBlock;
+  assert(info.edgeIndicesKey == nullptr);
+  assert(info.opaqueFaceIndicesKeys.empty());
+  assert(info.transparentFaceIndicesKeys.empty());
 
-  const auto brushVerticesStartIndex = static_cast<GLuint>(vertBlock->pos);
+  auto& chunk = m_chunks.at(info.chunkKey);
+  const auto brushVerticesStartIndex = static_cast<GLuint>(info.vertexHolderKey->pos);
 
   // insert edge indices into VBO
   {
@@ -545,7 +833,7 @@ void BrushRenderer::validateBrush(const Model::BrushNode& brushNode)
     if (edgeIndexCount > 0)
     {
       auto [key, insertDest] =
-        m_edgeIndices->getPointerToInsertElementsAt(edgeIndexCount);
+        chunk.edgeIndices->getPointerToInsertElementsAt(edgeIndexCount);
       info.edgeIndicesKey = key;
       getMarkedEdgeIndices(brushNode, edgePolicy, brushVerticesStartIndex, insertDest);
     }
@@ -554,7 +842,7 @@ void BrushRenderer::validateBrush(const Model::BrushNode& brushNode)
       // it's possible to have no edges to render
       // e.g. select all faces of a brush, and the unselected brush renderer
       // will hit this branch.
-      ensure(info.edgeIndicesKey == nullptr, "BrushInfo not initialized");
+      ensure(info.edgeIndicesKey == nullptr, "BrushInfo has stale edge indices");
     }
   }
 
@@ -585,7 +873,7 @@ void BrushRenderer::validateBrush(const Model::BrushNode& brushNode)
       if (cache.face->isMarked())
       {
         assert(cache.texture == texture);
-        if (shouldDrawFaceInTransparentPass(brushNode, *cache.face))
+        if (hasTransparencyTag(brushNode, *cache.face))
         {
           transparentIndexCount += triIndicesCountForPolygon(cache.vertexCount);
         }
@@ -598,12 +886,13 @@ void BrushRenderer::validateBrush(const Model::BrushNode& brushNode)
 
     if (transparentIndexCount > 0)
     {
-      auto& faceVboMap = *m_transparentFaces;
+      auto& faceVboMap = *chunk.transparentFaces;
       auto& holderPtr = faceVboMap[texture];
       if (holderPtr == nullptr)
       {
         // inserts into map!
-        holderPtr = std::make_shared<BrushIndexArray>();
+        holderPtr = std::make_shared<BrushIndexArray>(
+          findOrCreatePool(m_transparentFacePools, texture), chunk.origin);
       }
 
       auto [key, insertDest] =
@@ -616,8 +905,7 @@ void BrushRenderer::validateBrush(const Model::BrushNode& brushNode)
       {
         const auto& cache = facesSortedByTex[j];
         if (
-          cache.face->isMarked()
-          && shouldDrawFaceInTransparentPass(brushNode, *cache.face))
+          cache.face->isMarked() && hasTransparencyTag(brushNode, *cache.face))
         {
           addTriIndicesForPolygon(
             currentDest,
@@ -633,12 +921,13 @@ void BrushRenderer::validateBrush(const Model::BrushNode& brushNode)
 
     if (opaqueIndexCount > 0)
     {
-      auto& faceVboMap = *m_opaqueFaces;
+      auto& faceVboMap = *chunk.opaqueFaces;
       auto& holderPtr = faceVboMap[texture];
       if (holderPtr == nullptr)
       {
         // inserts into map!
-        holderPtr = std::make_shared<BrushIndexArray>();
+        holderPtr = std::make_shared<BrushIndexArray>(
+          findOrCreatePool(m_opaqueFacePools, texture), chunk.origin);
       }
 
       auto [key, insertDest] = holderPtr->getPointerToInsertElementsAt(opaqueIndexCount);
@@ -650,8 +939,7 @@ void BrushRenderer::validateBrush(const Model::BrushNode& brushNode)
       {
         const auto& cache = facesSortedByTex[j];
         if (
-          cache.face->isMarked()
-          && !shouldDrawFaceInTransparentPass(brushNode, *cache.face))
+          cache.face->isMarked() && !hasTransparencyTag(brushNode, *cache.face))
         {
           addTriIndicesForPolygon(
             currentDest,
@@ -665,6 +953,44 @@ void BrushRenderer::validateBrush(const Model::BrushNode& brushNode)
       assert(currentDest == (insertDest + opaqueIndexCount));
     }
   }
+
+  const auto& faces = brushNode.brush().faces();
+  if (std::any_of(faces.begin(), faces.end(), [&](const auto& face) {
+        return face.isMarked() && !hasTransparencyTag(brushNode, face)
+               && face.area() >= MinOccluderArea;
+      }))
+  {
+    chunk.occluders.insert(&brushNode);
+  }
+}
+
+void BrushRenderer::uploadBrushVertices(
+  const Model::BrushNode& brushNode, BrushInfo& info)
+{
+  const auto bounds = vm::bbox3f{brushNode.physicalBounds()};
+  info.chunkKey = chunkKey(brushNode);
+
+  auto& chunk = m_chunks[info.chunkKey];
+  if (chunk.brushCount++ == 0u)
+  {
+    chunk.bounds = bounds;
+    chunk.origin = (vm::vec3f{info.chunkKey} + vm::vec3f::fill(0.5f)) * float(ChunkSize);
+    chunk.edgeIndices = std::make_shared<BrushIndexArray>(m_edgeIndexPool, chunk.origin);
+    chunk.transparentFaces = std::make_shared<TextureToBrushIndicesMap>();
+    chunk.opaqueFaces = std::make_shared<TextureToBrushIndicesMap>();
+  }
+  else
+  {
+    chunk.bounds = vm::merge(chunk.bounds, bounds);
+  }
+
+  const auto& brushCache = brushNode.brushRendererBrushCache();
+  const auto& cachedVertices = brushCache.cachedVertices();
+  ensure(!cachedVertices.empty(), "Brush must have cached vertices");
+
+  assert(m_vertexArray != nullptr);
+  info.vertexHolderKey = m_vertexArray->insertVertices(cachedVertices, chunk.origin);
+  info.vertexCacheGeneration = brushCache.generation();
 }
 
 void BrushRenderer::addBrush(const Model::BrushNode* brushNode)
@@ -682,14 +1008,9 @@ void BrushRenderer::removeBrush(const Model::BrushNode* brushNode)
 {
   // update m_brushValid
   m_allBrushes.erase(brushNode);
+  m_invalidBrushes.erase(brushNode);
 
-  if (m_invalidBrushes.erase(brushNode) > 0u)
-  {
-    // invalid brushes are not in the VBO, so we can return  now.
-    assert(m_brushInfo.find(brushNode) == std::end(m_brushInfo));
-    return;
-  }
-
+  // invalid brushes may still have their vertices in the VBO
   removeBrushFromVbo(*brushNode);
 }
 
@@ -704,41 +1025,64 @@ void BrushRenderer::removeBrushFromVbo(const Model::BrushNode& brushNode)
     return;
   }
 
-  const BrushInfo& info = it->second;
+  auto& info = it->second;
+  removeBrushIndicesFromVbo(brushNode, info);
 
   // update Vbo's
   m_vertexArray->deleteVerticesWithKey(info.vertexHolderKey);
+
+  auto chunkIt = m_chunks.find(info.chunkKey);
+  assert(chunkIt != std::end(m_chunks));
+  if (--chunkIt->second.brushCount == 0u)
+  {
+    m_chunks.erase(chunkIt);
+  }
+
+  m_brushInfo.erase(it);
+}
+
+void BrushRenderer::removeBrushIndicesFromVbo(
+  const Model::BrushNode& brushNode, BrushInfo& info)
+{
+  auto& chunk = m_chunks.at(info.chunkKey);
+  chunk.occluders.erase(&brushNode);
+
   if (info.edgeIndicesKey != nullptr)
   {
-    m_edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
+    chunk.edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
+    info.edgeIndicesKey = nullptr;
   }
 
   for (const auto& [texture, opaqueKey] : info.opaqueFaceIndicesKeys)
   {
-    std::shared_ptr<BrushIndexArray> faceIndexHolder = m_opaqueFaces->at(texture);
-    faceIndexHolder->zeroElementsWithKey(opaqueKey);
+    auto& faceIndexHolder = *chunk.opaqueFaces->at(texture);
+    faceIndexHolder.zeroElementsWithKey(opaqueKey);
 
-    if (!faceIndexHolder->hasValidIndices())
+    if (!faceIndexHolder.hasValidIndices())
     {
       // There are no indices left to render for this texture, so delete the <Texture,
       // BrushIndexArray> entry from the map
-      m_opaqueFaces->erase(texture);
+      chunk.opaqueFaces->erase(texture);
+      releaseUnusedPool(m_opaqueFacePools, texture);
     }
   }
+  info.opaqueFaceIndicesKeys.clear();
+
   for (const auto& [texture, transparentKey] : info.transparentFaceIndicesKeys)
   {
-    std::shared_ptr<BrushIndexArray> faceIndexHolder = m_transparentFaces->at(texture);
-    faceIndexHolder->zeroElementsWithKey(transparentKey);
+    auto& faceIndexHolder = *chunk.transparentFaces->at(texture);
+    faceIndexHolder.zeroElementsWithKey(transparentKey);
 
-    if (!faceIndexHolder->hasValidIndices())
+    if (!faceIndexHolder.hasValidIndices())
     {
       // There are no indices left to render for this texture, so delete the <Texture,
       // BrushIndexArray> entry from the map
-      m_transparentFaces->erase(texture);
+      chunk.transparentFaces->erase(texture);
+      releaseUnusedPool(m_transparentFacePools, texture);
     }
   }
-
-  m_brushInfo.erase(it);
+  info.transparentFaceIndicesKeys.clear();
+  info.faceFlags.clear();
 }
 } // namespace Renderer
 } // namespace TrenchBroom
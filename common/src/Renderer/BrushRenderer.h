@@ -21,11 +21,14 @@
 
 #include "Color.h"
 #include "Macros.h"
-#include "Model/BrushGeometry.h"
 #include "Renderer/AllocationTracker.h"
 #include "Renderer/EdgeRenderer.h"
 #include "Renderer/FaceRenderer.h"
 
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <map>
 #include <memory>
 #include <tuple>
 #include <unordered_map>
@@ -43,6 +46,9 @@ class EditorContext;
 
 namespace Renderer
 {
+class BrushIndexPool;
+class OcclusionCuller;
+
 class BrushRenderer
 {
 public:
@@ -99,14 +105,14 @@ public:
 
     bool visible(const Model::BrushNode& brush) const;
     bool visible(const Model::BrushNode& brush, const Model::BrushFace& face) const;
-    bool visible(const Model::BrushNode& brush, const Model::BrushEdge& edge) const;
+    bool visible(const Model::BrushNode& brush, size_t edgeIndex) const;
 
     bool editable(const Model::BrushNode& brush) const;
     bool editable(const Model::BrushNode& brush, const Model::BrushFace& face) const;
 
     bool selected(const Model::BrushNode& brush) const;
     bool selected(const Model::BrushNode& brush, const Model::BrushFace& face) const;
-    bool selected(const Model::BrushNode& brush, const Model::BrushEdge& edge) const;
+    bool selected(const Model::BrushNode& brush, size_t edgeIndex) const;
     bool hasSelectedFaces(const Model::BrushNode& brush) const;
   };
 
@@ -123,24 +129,92 @@ private:
 private:
   std::unique_ptr<Filter> m_filter;
 
+  using TextureToBrushIndicesMap =
+    std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
+
+  /**
+   * Brushes are partitioned into chunks by the cell of a coarse grid which contains the
+   * center of their bounds. Every chunk has its own index arrays so that the chunks which
+   * are not in view can be skipped when rendering. All chunks share the vertex array, and
+   * their index arrays share one index pool per texture so that the chunks in view can be
+   * drawn with one multi draw call per texture, see BrushMultiDraw.
+   *
+   * Faces are sorted into the opaque and transparent index arrays by their transparency
+   * tags only. Which render pass draws them is decided when rendering, so that changing
+   * the transparency settings does not require rebuilding the index arrays.
+   */
+  struct Chunk
+  {
+    /**
+     * Contains the bounds of every brush in this chunk. The bounds are only ever grown
+     * while the chunk is in use, so they may be larger than necessary.
+     */
+    vm::bbox3f bounds;
+    size_t brushCount = 0u;
+
+    /**
+     * The center of the chunk's grid cell. Compact vertices are stored relative to it.
+     */
+    vm::vec3f origin;
+
+    std::shared_ptr<BrushIndexArray> edgeIndices;
+    std::shared_ptr<TextureToBrushIndicesMap> transparentFaces;
+    std::shared_ptr<TextureToBrushIndicesMap> opaqueFaces;
+
+    /**
+     * The brushes in this chunk which have opaque faces large enough to be used as
+     * occluders.
+     */
+    std::unordered_set<const Model::BrushNode*> occluders;
+  };
+  std::map<vm::vec3i, Chunk> m_chunks;
+
+  using TextureToBrushIndexPoolMap =
+    std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexPool>>;
+
+  /**
+   * The index pools of the chunks' index arrays. A face pool is discarded once none of
+   * the chunks uses it anymore.
+   */
+  TextureToBrushIndexPoolMap m_opaqueFacePools;
+  TextureToBrushIndexPoolMap m_transparentFacePools;
+  std::shared_ptr<BrushIndexPool> m_edgeIndexPool;
+
   struct BrushInfo
   {
-    AllocationTracker::Block* vertexHolderKey;
-    AllocationTracker::Block* edgeIndicesKey;
+    vm::vec3i chunkKey;
+    /**
+     * The generation of the brush's vertex cache when its vertices were uploaded.
+     */
+    size_t vertexCacheGeneration = 0u;
+    AllocationTracker::Block* vertexHolderKey = nullptr;
+    AllocationTracker::Block* edgeIndicesKey = nullptr;
     std::vector<std::pair<const Assets::Texture*, AllocationTracker::Block*>>
       opaqueFaceIndicesKeys;
     std::vector<std::pair<const Assets::Texture*, AllocationTracker::Block*>>
       transparentFaceIndicesKeys;
+    /**
+     * The filter settings and the face flags (whether each face is marked and whether
+     * it has a transparency tag) when the indices were uploaded. If they are unchanged
+     * when the brush is validated again, its indices are kept.
+     */
+    Filter::RenderSettings renderSettings;
+    std::vector<bool> faceFlags;
   };
   /**
-   * Tracks all brushes that are stored in the VBO, with the information necessary to
-   * remove them from the VBO later.
+   * Tracks all brushes whose vertices are stored in the VBO, with the information
+   * necessary to remove them from the VBO later.
+   *
+   * A brush keeps its vertices and indices when it is invalidated. When it is validated
+   * again, its vertices are uploaded again only if the brush geometry has changed, and
+   * its indices are rebuilt only if the Filter selects different faces or edges. A brush
+   * that is hidden by the Filter keeps its vertices, but not its indices.
    */
   std::unordered_map<const Model::BrushNode*, BrushInfo> m_brushInfo;
 
   /**
-   * If a brush is in the VBO, it's always valid.
-   * If a brush is valid, it might not be in the VBO if it was hidden by the Filter.
+   * If a brush is valid, its indices in the VBO are up to date. It might not have any
+   * indices in the VBO if it was hidden by the Filter.
    *
    * Do not attempt to use vector_set here, it turns out to be slower.
    */
@@ -148,13 +222,10 @@ private:
   std::unordered_set<const Model::BrushNode*> m_invalidBrushes;
 
   std::shared_ptr<BrushVertexArray> m_vertexArray;
-  std::shared_ptr<BrushIndexArray> m_edgeIndices;
-
-  using TextureToBrushIndicesMap =
-    std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
-  std::shared_ptr<TextureToBrushIndicesMap> m_transparentFaces;
-  std::shared_ptr<TextureToBrushIndicesMap> m_opaqueFaces;
 
+  /**
+   * These render the chunks which are in view. They are recreated for every frame.
+   */
   FaceRenderer m_opaqueFaceRenderer;
   FaceRenderer m_transparentFaceRenderer;
   IndexedEdgeRenderer m_edgeRenderer;
@@ -171,6 +242,7 @@ private:
   float m_transparencyAlpha;
 
   bool m_showHiddenBrushes;
+  bool m_compactVertices;
 
 public:
   template <typename FilterT>
@@ -183,6 +255,7 @@ public:
     , m_forceTransparent{false}
     , m_transparencyAlpha{1.0f}
     , m_showHiddenBrushes{false}
+    , m_compactVertices{false}
   {
     clear();
   }
@@ -204,9 +277,13 @@ public:
    * Until a brush is invalidated, we don't re-evaluate the Filter, and don't check the
    * Brush object for modification.
    *
-   * Additionally, calling `invalidate()` guarantees the m_brushInfo, m_transparentFaces,
-   * and m_opaqueFaces maps will be empty, so the BrushRenderer will not have any
-   * lingering Texture* pointers.
+   * The vertices and indices of a brush are only uploaded again if its geometry or the
+   * result of the Filter has changed, so invalidating is much cheaper than removing and
+   * adding all brushes.
+   *
+   * The index arrays may refer to textures which are no longer valid until the brushes
+   * are validated, which happens before anything is rendered. Changing the texture of a
+   * face invalidates the vertex cache of its brush, so its indices will be rebuilt.
    */
   void invalidate();
   void invalidateBrush(const Model::BrushNode* brush);
@@ -279,15 +356,38 @@ public:
    */
   void setShowHiddenBrushes(bool showHiddenBrushes);
 
+  /**
+   * Specifies whether or not brush vertices should be compressed. Compact vertices take
+   * half of the memory, but their positions and texture coordinates are less precise.
+   * Changing this uploads all brushes again.
+   *
+   * @see BrushVertexArray
+   */
+  void setCompactVertices(bool compactVertices);
+
 public: // rendering
   void render(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
 
+  /**
+   * Adds the large opaque faces of the brushes in view to the given occlusion culler,
+   * nearest chunks first, until the culler is full.
+   */
+  void addOccluders(RenderContext& renderContext, OcclusionCuller& occlusionCuller);
+
 private:
-  void renderOpaqueFaces(RenderBatch& renderBatch);
-  void renderTransparentFaces(RenderBatch& renderBatch);
-  void renderEdges(RenderBatch& renderBatch);
+  void renderOpaqueFaces(
+    std::vector<std::shared_ptr<const TextureToBrushIndicesMap>> faces,
+    RenderBatch& renderBatch);
+  void renderTransparentFaces(
+    std::vector<std::shared_ptr<const TextureToBrushIndicesMap>> faces,
+    RenderBatch& renderBatch);
+  void renderEdges(
+    std::vector<std::shared_ptr<BrushIndexArray>> edgeIndices, RenderBatch& renderBatch);
+
+  static size_t countTriangles(const TextureToBrushIndicesMap& faces);
+  static size_t countEdges(const BrushIndexArray& edgeIndices);
 
 public:
   /**
@@ -296,9 +396,32 @@ public:
   void validate();
 
 private:
-  bool shouldDrawFaceInTransparentPass(
-    const Model::BrushNode& brushNode, const Model::BrushFace& face) const;
-  void validateBrush(const Model::BrushNode& brushNode);
+  /**
+   * Indicates whether faces with or without a transparency tag are drawn in the
+   * transparent pass, given the current transparency settings.
+   */
+  bool inTransparentPass(bool hasTransparencyTag) const;
+
+  /**
+   * Uploads the given brush to the VBOs. The brush's faces must have been marked by the
+   * filter, which returned the given settings, and its vertex cache must be valid.
+   *
+   * If the brush's vertices are already stored in the VBO and its geometry has not
+   * changed since, only its indices are uploaded, and only if the filter selected
+   * different faces or edges than before.
+   */
+  void validateBrush(
+    const Model::BrushNode& brushNode, const Filter::RenderSettings& settings);
+
+  /**
+   * Uploads the vertices of the given brush and adds it to its chunk.
+   */
+  void uploadBrushVertices(const Model::BrushNode& brushNode, BrushInfo& info);
+
+  /**
+   * Returns the key of the chunk the given brush belongs to.
+   */
+  static vm::vec3i chunkKey(const Model::BrushNode& brushNode);
 
 public:
   /**
@@ -320,6 +443,12 @@ private:
    */
   void removeBrushFromVbo(const Model::BrushNode& brush);
 
+  /**
+   * Zeroes out the edge and face indices of the given brush, causing it to no longer
+   * draw, but keeps its vertices in the VBO.
+   */
+  void removeBrushIndicesFromVbo(const Model::BrushNode& brushNode, BrushInfo& info);
+
   deleteCopyAndMove(BrushRenderer);
 };
 } // namespace Renderer
@@ -19,9 +19,17 @@
 
 #include "Renderer/BrushRendererArrays.h"
 
+#include "Renderer/ShaderProgram.h"
+
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <cstring>
+#include <limits>
 #include <stdexcept>
 
 namespace TrenchBroom
@@ -72,6 +80,13 @@ void DirtyRangeTracker::markDirty(const size_t pos, const size_t size)
     throw std::invalid_argument("markDirty provided range out of bounds");
   }
 
+  if (clean())
+  {
+    m_dirtyPos = pos;
+    m_dirtySize = size;
+    return;
+  }
+
   const size_t newPos = std::min(pos, m_dirtyPos);
   const size_t newEnd = std::max(pos + size, m_dirtyPos + m_dirtySize);
 
@@ -84,6 +99,73 @@ bool DirtyRangeTracker::clean() const
   return m_dirtySize == 0;
 }
 
+// RingDirtyRangeTracker
+
+RingDirtyRangeTracker::RingDirtyRangeTracker(
+  const size_t regionCount, const size_t capacity)
+  : m_regions(regionCount, DirtyRangeTracker(capacity))
+  , m_currentRegion(0)
+{
+  assert(regionCount > 0u);
+
+  // the other regions have never been written
+  for (size_t i = 1u; i < regionCount; ++i)
+  {
+    m_regions[i].markDirty(0, capacity);
+  }
+}
+
+size_t RingDirtyRangeTracker::regionCount() const
+{
+  return m_regions.size();
+}
+
+size_t RingDirtyRangeTracker::currentRegion() const
+{
+  return m_currentRegion;
+}
+
+size_t RingDirtyRangeTracker::capacity() const
+{
+  return current().capacity();
+}
+
+const DirtyRangeTracker& RingDirtyRangeTracker::current() const
+{
+  return m_regions[m_currentRegion];
+}
+
+void RingDirtyRangeTracker::markDirty(const size_t pos, const size_t size)
+{
+  for (auto& region : m_regions)
+  {
+    region.markDirty(pos, size);
+  }
+}
+
+void RingDirtyRangeTracker::expand(const size_t newcap)
+{
+  for (auto& region : m_regions)
+  {
+    region.expand(newcap);
+  }
+}
+
+void RingDirtyRangeTracker::advance()
+{
+  m_currentRegion = (m_currentRegion + 1u) % m_regions.size();
+}
+
+void RingDirtyRangeTracker::markCurrentClean()
+{
+  m_regions[m_currentRegion] = DirtyRangeTracker(capacity());
+}
+
+bool RingDirtyRangeTracker::clean() const
+{
+  return current().clean();
+}
+
 // IndexHolder
 
 IndexHolder::IndexHolder()
@@ -118,12 +200,232 @@ std::shared_ptr<IndexHolder> IndexHolder::swap(std::vector<IndexHolder::Index>&
 
 VertexArrayInterface::~VertexArrayInterface() {}
 
+// BrushIndexRange
+
+bool operator==(const BrushIndexRange& lhs, const BrushIndexRange& rhs)
+{
+  return lhs.pos == rhs.pos && lhs.count == rhs.count && lhs.origin == rhs.origin;
+}
+
+bool operator!=(const BrushIndexRange& lhs, const BrushIndexRange& rhs)
+{
+  return !(lhs == rhs);
+}
+
+// BrushIndexPool
+
+BrushIndexPool::BrushIndexPool()
+  : m_indexHolder()
+  , m_allocationTracker(0)
+  , m_drawCommands(VboType::DrawIndirectBuffer)
+  , m_chunkOrigins()
+  , m_drawRanges()
+  , m_drawOffset(0)
+{
+}
+
+bool BrushIndexPool::hasPages() const
+{
+  return m_allocationTracker.hasAllocations();
+}
+
+size_t BrushIndexPool::capacity() const
+{
+  return m_allocationTracker.capacity();
+}
+
+const std::vector<GLuint>& BrushIndexPool::indices() const
+{
+  return m_indexHolder.elements();
+}
+
+AllocationTracker::Block* BrushIndexPool::allocatePage(const size_t size)
+{
+  auto* page = m_allocationTracker.allocate(size);
+  if (page == nullptr)
+  {
+    const size_t newSize =
+      std::max(2 * m_allocationTracker.capacity(), m_allocationTracker.capacity() + size);
+    m_allocationTracker.expand(newSize);
+    m_indexHolder.resize(newSize);
+
+    page = m_allocationTracker.allocate(size);
+    assert(page != nullptr);
+  }
+
+  // the page may have been used by another index array before
+  zeroRange(page->pos, page->size);
+  return page;
+}
+
+void BrushIndexPool::freePage(AllocationTracker::Block* page)
+{
+  // freed pages are not drawn, so they need not be zeroed
+  m_allocationTracker.free(page);
+}
+
+GLuint* BrushIndexPool::getPointerToWriteElementsTo(const size_t pos, const size_t count)
+{
+  return m_indexHolder.getPointerToWriteElementsTo(pos, count);
+}
+
+void BrushIndexPool::copyElements(const size_t from, const size_t to, const size_t count)
+{
+  m_indexHolder.copyElements(from, to, count);
+}
+
+void BrushIndexPool::zeroRange(const size_t pos, const size_t count)
+{
+  m_indexHolder.zeroRange(pos, count);
+}
+
+bool BrushIndexPool::prepared() const
+{
+  return m_indexHolder.prepared();
+}
+
+void BrushIndexPool::prepare(VboManager& vboManager)
+{
+  m_indexHolder.prepare(vboManager);
+  assert(m_indexHolder.prepared());
+}
+
+size_t BrushIndexPool::offset() const
+{
+  return m_indexHolder.offset();
+}
+
+void BrushIndexPool::setupIndices()
+{
+  m_indexHolder.bindBlock();
+}
+
+void BrushIndexPool::cleanupIndices()
+{
+  m_indexHolder.unbindBlock();
+}
+
+void BrushIndexPool::render(
+  const PrimType primType, const size_t pos, const size_t count) const
+{
+  assert(m_indexHolder.prepared());
+  m_indexHolder.render(primType, pos, count);
+}
+
+void BrushIndexPool::prepareDrawCommands(
+  const std::vector<BrushIndexRange>& ranges, const bool compact, VboManager& vboManager)
+{
+  assert(m_indexHolder.prepared());
+
+  const auto offset = m_indexHolder.offset();
+  if (ranges != m_drawRanges || offset != m_drawOffset)
+  {
+    if (ranges.size() > m_drawCommands.size())
+    {
+      m_drawCommands.resize(std::max(2u * m_drawCommands.size(), ranges.size()));
+    }
+    if (compact && ranges.size() > m_chunkOrigins.size())
+    {
+      m_chunkOrigins.resize(std::max(2u * m_chunkOrigins.size(), ranges.size()));
+    }
+
+    const auto firstIndex = offset / sizeof(GLuint);
+    auto* commands = m_drawCommands.getPointerToWriteElementsTo(0, ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+      commands[i] = DrawElementsIndirectCommand{
+        static_cast<GLuint>(ranges[i].count),
+        1u,
+        static_cast<GLuint>(firstIndex + ranges[i].pos),
+        0,
+        static_cast<GLuint>(i)};
+    }
+
+    if (compact)
+    {
+      auto* chunkOrigins = m_chunkOrigins.getPointerToWriteElementsTo(0, ranges.size());
+      for (size_t i = 0; i < ranges.size(); ++i)
+      {
+        chunkOrigins[i] = GLVertexTypes::ChunkOriginInstance::Vertex{ranges[i].origin};
+      }
+    }
+
+    m_drawRanges = ranges;
+    m_drawOffset = offset;
+  }
+
+  m_drawCommands.prepare(vboManager);
+  m_chunkOrigins.prepare(vboManager);
+}
+
+void BrushIndexPool::renderDrawCommands(const PrimType primType, const bool compact)
+{
+  assert(m_drawCommands.prepared());
+
+  m_drawCommands.bindBlock();
+  if (compact)
+  {
+    m_chunkOrigins.setupVertices();
+  }
+
+  glAssert(glMultiDrawElementsIndirect(
+    toGL(primType),
+    glType<GLuint>(),
+    reinterpret_cast<const GLvoid*>(m_drawCommands.offset()),
+    static_cast<GLsizei>(m_drawRanges.size()),
+    0));
+
+  if (compact)
+  {
+    m_chunkOrigins.cleanupVertices();
+  }
+  m_drawCommands.unbindBlock();
+}
+
 // BrushIndexArray
 
 BrushIndexArray::BrushIndexArray()
-  : m_indexHolder()
+  : BrushIndexArray(vm::vec3f::zero())
+{
+}
+
+BrushIndexArray::BrushIndexArray(const vm::vec3f& origin)
+  : BrushIndexArray(std::make_shared<BrushIndexPool>(), origin)
+{
+}
+
+BrushIndexArray::BrushIndexArray(
+  std::shared_ptr<BrushIndexPool> pool, const vm::vec3f& origin)
+  : m_pool(std::move(pool))
+  , m_page(nullptr)
   , m_allocationTracker(0)
+  , m_validIndexCount(0)
+  , m_origin(origin)
+{
+  ensure(m_pool != nullptr, "pool must not be null");
+}
+
+BrushIndexArray::~BrushIndexArray()
 {
+  if (m_page != nullptr)
+  {
+    m_pool->freePage(m_page);
+  }
+}
+
+const std::shared_ptr<BrushIndexPool>& BrushIndexArray::pool() const
+{
+  return m_pool;
+}
+
+size_t BrushIndexArray::pagePos() const
+{
+  return m_page != nullptr ? m_page->pos : 0u;
+}
+
+const vm::vec3f& BrushIndexArray::origin() const
+{
+  return m_origin;
 }
 
 bool BrushIndexArray::hasValidIndices() const
@@ -131,27 +433,43 @@ bool BrushIndexArray::hasValidIndices() const
   return m_allocationTracker.hasAllocations();
 }
 
+size_t BrushIndexArray::validIndexCount() const
+{
+  return m_validIndexCount;
+}
+
+size_t BrushIndexArray::indexCount() const
+{
+  return m_page != nullptr ? m_page->size : 0u;
+}
+
 std::pair<AllocationTracker::Block*, GLuint*> BrushIndexArray::
   getPointerToInsertElementsAt(const size_t elementCount)
 {
+  m_validIndexCount += elementCount;
+
   auto block = m_allocationTracker.allocate(elementCount);
-  if (block != nullptr)
+  if (block == nullptr)
   {
-    GLuint* dest = m_indexHolder.getPointerToWriteElementsTo(block->pos, elementCount);
-    return {block, dest};
+    // move the indices to a larger page
+    const size_t newSize = std::max(
+      2 * m_allocationTracker.capacity(), m_allocationTracker.capacity() + elementCount);
+    auto* newPage = m_pool->allocatePage(newSize);
+    if (m_page != nullptr)
+    {
+      m_pool->copyElements(m_page->pos, newPage->pos, m_page->size);
+      m_pool->freePage(m_page);
+    }
+    m_page = newPage;
+    m_allocationTracker.expand(newSize);
+
+    // insert again
+    block = m_allocationTracker.allocate(elementCount);
+    assert(block != nullptr);
   }
 
-  // retry
-  const size_t newSize = std::max(
-    2 * m_allocationTracker.capacity(), m_allocationTracker.capacity() + elementCount);
-  m_allocationTracker.expand(newSize);
-  m_indexHolder.resize(newSize);
-
-  // insert again
-  block = m_allocationTracker.allocate(elementCount);
-  assert(block != nullptr);
-
-  GLuint* dest = m_indexHolder.getPointerToWriteElementsTo(block->pos, elementCount);
+  GLuint* dest =
+    m_pool->getPointerToWriteElementsTo(m_page->pos + block->pos, elementCount);
   return {block, dest};
 }
 
@@ -160,67 +478,134 @@ void BrushIndexArray::zeroElementsWithKey(AllocationTracker::Block* key)
   const auto pos = key->pos;
   const auto size = key->size;
   m_allocationTracker.free(key);
+  m_validIndexCount -= size;
 
-  m_indexHolder.zeroRange(pos, size);
+  m_pool->zeroRange(m_page->pos + pos, size);
 }
 
 void BrushIndexArray::render(const PrimType primType) const
 {
-  assert(m_indexHolder.prepared());
-  m_indexHolder.render(primType, 0, m_indexHolder.size());
+  if (m_page != nullptr)
+  {
+    m_pool->render(primType, m_page->pos, m_page->size);
+  }
 }
 
 bool BrushIndexArray::prepared() const
 {
-  return m_indexHolder.prepared();
+  return m_pool->prepared();
 }
 
 void BrushIndexArray::prepare(VboManager& vboManager)
 {
-  m_indexHolder.prepare(vboManager);
-  assert(m_indexHolder.prepared());
+  m_pool->prepare(vboManager);
 }
 
 void BrushIndexArray::setupIndices()
 {
-  m_indexHolder.bindBlock();
+  m_pool->setupIndices();
 }
 
 void BrushIndexArray::cleanupIndices()
 {
-  m_indexHolder.unbindBlock();
+  m_pool->cleanupIndices();
 }
 
 // BrushVertexArray
 
-BrushVertexArray::BrushVertexArray()
-  : m_vertexHolder()
+namespace
+{
+const auto MaxQuantized = float(std::numeric_limits<GLshort>::max());
+
+GLshort quantize(const float value)
+{
+  return static_cast<GLshort>(std::clamp(std::round(value), -MaxQuantized, MaxQuantized));
+}
+
+/**
+ * Returns the smallest exponent which scales the given offset into the range of a short.
+ */
+int positionExponent(const vm::vec3f& offset)
+{
+  const auto maxOffset = vm::get_max_component(vm::abs(offset));
+  auto exponent = BrushVertexArray::MinPositionExponent;
+  while (exponent < 32 && std::ldexp(MaxQuantized, exponent) < maxOffset)
+  {
+    ++exponent;
+  }
+  return exponent;
+}
+
+/**
+ * Maps the given unit vector onto the octahedron and unfolds the octahedron into the
+ * square [-1, 1]^2.
+ */
+vm::vec2f encodeOctahedral(const vm::vec3f& normal)
+{
+  const auto signs = vm::vec2f{
+    normal.x() >= 0.0f ? 1.0f : -1.0f,
+    normal.y() >= 0.0f ? 1.0f : -1.0f,
+  };
+
+  const auto projected =
+    normal / (std::abs(normal.x()) + std::abs(normal.y()) + std::abs(normal.z()));
+  if (projected.z() >= 0.0f)
+  {
+    return projected.xy();
+  }
+  return vm::vec2f{
+    (1.0f - std::abs(projected.y())) * signs.x(),
+    (1.0f - std::abs(projected.x())) * signs.y(),
+  };
+}
+} // namespace
+
+BrushVertexArray::BrushVertexArray(const bool compact)
+  : m_compact(compact)
+  , m_vertexHolder()
+  , m_compactVertexHolder()
   , m_allocationTracker(0)
 {
 }
 
-std::pair<AllocationTracker::Block*, BrushVertexArray::Vertex*> BrushVertexArray::
-  getPointerToInsertVerticesAt(const size_t vertexCount)
+bool BrushVertexArray::compact() const
 {
-  auto block = m_allocationTracker.allocate(vertexCount);
-  if (block != nullptr)
+  return m_compact;
+}
+
+AllocationTracker::Block* BrushVertexArray::insertVertices(
+  const std::vector<Vertex>& vertices, const vm::vec3f& origin)
+{
+  if (m_compact)
   {
-    Vertex* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
-    return {block, dest};
+    return insertVertices(m_compactVertexHolder, compactVertices(vertices, origin));
   }
+  return insertVertices(m_vertexHolder, vertices);
+}
 
-  // retry
-  const size_t newSize = std::max(
-    2 * m_allocationTracker.capacity(), m_allocationTracker.capacity() + vertexCount);
-  m_allocationTracker.expand(newSize);
-  m_vertexHolder.resize(newSize);
+template <typename V>
+AllocationTracker::Block* BrushVertexArray::insertVertices(
+  VertexHolder<V>& vertexHolder, const std::vector<V>& vertices)
+{
+  const auto vertexCount = vertices.size();
 
-  // insert again
-  block = m_allocationTracker.allocate(vertexCount);
-  assert(block != nullptr);
+  auto block = m_allocationTracker.allocate(vertexCount);
+  if (block == nullptr)
+  {
+    // retry
+    const size_t newSize = std::max(
+      2 * m_allocationTracker.capacity(), m_allocationTracker.capacity() + vertexCount);
+    m_allocationTracker.expand(newSize);
+    vertexHolder.resize(newSize);
+
+    // insert again
+    block = m_allocationTracker.allocate(vertexCount);
+    assert(block != nullptr);
+  }
 
-  Vertex* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
-  return {block, dest};
+  V* dest = vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
+  std::memcpy(dest, vertices.data(), vertexCount * sizeof(V));
+  return block;
 }
 
 void BrushVertexArray::deleteVerticesWithKey(AllocationTracker::Block* key)
@@ -235,23 +620,337 @@ void BrushVertexArray::deleteVerticesWithKey(AllocationTracker::Block* key)
 
 bool BrushVertexArray::setupVertices()
 {
-  return m_vertexHolder.setupVertices();
+  return m_compact ? m_compactVertexHolder.setupVertices()
+                   : m_vertexHolder.setupVertices();
 }
 
 void BrushVertexArray::cleanupVertices()
 {
-  m_vertexHolder.cleanupVertices();
+  if (m_compact)
+  {
+    m_compactVertexHolder.cleanupVertices();
+  }
+  else
+  {
+    m_vertexHolder.cleanupVertices();
+  }
 }
 
 bool BrushVertexArray::prepared() const
 {
-  return m_vertexHolder.prepared();
+  return m_compact ? m_compactVertexHolder.prepared() : m_vertexHolder.prepared();
 }
 
 void BrushVertexArray::prepare(VboManager& vboManager)
 {
-  m_vertexHolder.prepare(vboManager);
-  assert(m_vertexHolder.prepared());
+  if (m_compact)
+  {
+    m_compactVertexHolder.prepare(vboManager);
+  }
+  else
+  {
+    m_vertexHolder.prepare(vboManager);
+  }
+  assert(prepared());
+}
+
+std::vector<BrushVertexArray::CompactVertex> BrushVertexArray::compactVertices(
+  const std::vector<Vertex>& vertices, const vm::vec3f& origin)
+{
+  auto result = std::vector<CompactVertex>{};
+  result.reserve(vertices.size());
+
+  for (size_t first = 0; first < vertices.size();)
+  {
+    const auto& normal = vertices[first].rest.attr;
+
+    auto last = first;
+    auto minTexCoords = vertices[first].rest.rest.attr;
+    auto maxTexCoords = minTexCoords;
+    while (last < vertices.size() && vertices[last].rest.attr == normal)
+    {
+      minTexCoords = vm::min(minTexCoords, vertices[last].rest.rest.attr);
+      maxTexCoords = vm::max(maxTexCoords, vertices[last].rest.rest.attr);
+      ++last;
+    }
+
+    const auto texCoordOffset = vm::round((minTexCoords + maxTexCoords) / 2.0f);
+    const auto octahedral = encodeOctahedral(normal);
+    const auto encodedNormal = vm::vec<GLshort, 2>{
+      quantize(octahedral.x() * MaxQuantized), quantize(octahedral.y() * MaxQuantized)};
+
+    for (size_t i = first; i < last; ++i)
+    {
+      const auto offset = vertices[i].attr - origin;
+      const auto exponent = positionExponent(offset);
+      const auto scaled = offset / std::ldexp(1.0f, exponent);
+      const auto texCoords = vertices[i].rest.rest.attr - texCoordOffset;
+
+      result.emplace_back(
+        vm::vec<GLshort, 4>{
+          quantize(scaled.x()),
+          quantize(scaled.y()),
+          quantize(scaled.z()),
+          static_cast<GLshort>(exponent)},
+        vm::vec<GLshort, 4>{
+          toHalfFloat(texCoords.x()),
+          toHalfFloat(texCoords.y()),
+          encodedNormal.x(),
+          encodedNormal.y()});
+    }
+
+    first = last;
+  }
+
+  return result;
+}
+
+GLshort BrushVertexArray::toHalfFloat(const float value)
+{
+  auto floatBits = uint32_t(0);
+  std::memcpy(&floatBits, &value, sizeof(value));
+
+  const auto sign = (floatBits >> 16u) & 0x8000u;
+  const auto exponent = static_cast<int>((floatBits >> 23u) & 0xFFu) - 127 + 15;
+  auto mantissa = floatBits & 0x7FFFFFu;
+
+  auto bits = uint32_t(0);
+  if (std::isnan(value))
+  {
+    bits = sign | 0x7E00u;
+  }
+  else if (exponent >= 31)
+  {
+    // clamp to the largest finite half float
+    bits = sign | 0x7BFFu;
+  }
+  else if (exponent <= 0)
+  {
+    if (exponent < -10)
+    {
+      bits = sign;
+    }
+    else
+    {
+      // subnormal, round to nearest
+      mantissa |= 0x800000u;
+      const auto shift = static_cast<uint32_t>(14 - exponent);
+      bits = sign | ((mantissa + (1u << (shift - 1u))) >> shift);
+    }
+  }
+  else
+  {
+    // round to nearest; a carry into the exponent is correct, but must not overflow
+    bits = (static_cast<uint32_t>(exponent) << 10u) | (mantissa >> 13u);
+    bits += (mantissa >> 12u) & 1u;
+    bits = sign | std::min(bits, uint32_t(0x7BFFu));
+  }
+
+  return static_cast<GLshort>(static_cast<int16_t>(static_cast<uint16_t>(bits)));
+}
+
+float BrushVertexArray::fromHalfFloat(const GLshort bits)
+{
+  const auto unsignedBits = static_cast<uint16_t>(bits);
+  const auto factor = (unsignedBits & 0x8000u) != 0u ? -1.0f : 1.0f;
+  const auto exponent = static_cast<int>((unsignedBits >> 10u) & 0x1Fu);
+  const auto mantissa = static_cast<float>(unsignedBits & 0x3FFu);
+
+  if (exponent == 0)
+  {
+    return factor * std::ldexp(mantissa, -24);
+  }
+  if (exponent == 31)
+  {
+    return mantissa == 0.0f ? factor * std::numeric_limits<float>::infinity()
+                            : std::numeric_limits<float>::quiet_NaN();
+  }
+  return factor * std::ldexp(1.0f + mantissa / 1024.0f, exponent - 15);
+}
+
+vm::vec3f BrushVertexArray::decodePosition(
+  const CompactVertex& vertex, const vm::vec3f& origin)
+{
+  const auto& position = vertex.attr;
+  const auto scale = std::ldexp(1.0f, position.w());
+  return origin
+         + vm::vec3f{
+             float(position.x()) * scale,
+             float(position.y()) * scale,
+             float(position.z()) * scale};
+}
+
+vm::vec3f BrushVertexArray::decodeNormal(const CompactVertex& vertex)
+{
+  const auto& texCoords = vertex.rest.attr;
+  const auto octahedral = vm::vec2f{
+    std::clamp(float(texCoords.z()) / MaxQuantized, -1.0f, 1.0f),
+    std::clamp(float(texCoords.w()) / MaxQuantized, -1.0f, 1.0f)};
+
+  auto result = vm::vec3f{
+    octahedral.x(),
+    octahedral.y(),
+    1.0f - std::abs(octahedral.x()) - std::abs(octahedral.y())};
+  if (result.z() < 0.0f)
+  {
+    result = vm::vec3f{
+      (1.0f - std::abs(octahedral.y())) * (octahedral.x() >= 0.0f ? 1.0f : -1.0f),
+      (1.0f - std::abs(octahedral.x())) * (octahedral.y() >= 0.0f ? 1.0f : -1.0f),
+      result.z()};
+  }
+  return vm::normalize(result);
+}
+
+vm::vec2f BrushVertexArray::decodeTexCoords(const CompactVertex& vertex)
+{
+  const auto& texCoords = vertex.rest.attr;
+  return vm::vec2f{fromHalfFloat(texCoords.x()), fromHalfFloat(texCoords.y())};
+}
+
+void BrushVertexArray::setChunkOrigin(ShaderProgram& program, const vm::vec3f& origin)
+{
+  const auto attributeIndex = static_cast<GLuint>(
+    program.findAttributeLocation(GLVertexTypes::ChunkOriginName::name));
+  glAssert(glVertexAttrib3f(attributeIndex, origin.x(), origin.y(), origin.z()));
+}
+
+// BrushMultiDraw
+
+BrushMultiDraw::BrushMultiDraw(std::shared_ptr<BrushIndexPool> pool, const bool compact)
+  : m_pool(std::move(pool))
+  , m_compact(compact)
+  , m_indirect(false)
+{
+}
+
+const std::shared_ptr<BrushIndexPool>& BrushMultiDraw::pool() const
+{
+  return m_pool;
+}
+
+const std::vector<BrushMultiDraw::Range>& BrushMultiDraw::ranges() const
+{
+  return m_ranges;
+}
+
+size_t BrushMultiDraw::indexCount() const
+{
+  auto result = size_t(0);
+  for (const auto& range : m_ranges)
+  {
+    result += range.count;
+  }
+  return result;
+}
+
+void BrushMultiDraw::add(const BrushIndexArray& indexArray)
+{
+  assert(indexArray.pool() == m_pool);
+  if (indexArray.indexCount() > 0u)
+  {
+    m_ranges.push_back(
+      Range{indexArray.pagePos(), indexArray.indexCount(), indexArray.origin()});
+  }
+}
+
+void BrushMultiDraw::prepare(VboManager& vboManager)
+{
+  m_pool->prepare(vboManager);
+  m_ranges = mergeRanges(std::move(m_ranges), m_compact);
+
+  m_indirect = !m_ranges.empty() && vboManager.multiDrawIndirectSupported();
+  if (m_indirect)
+  {
+    m_pool->prepareDrawCommands(m_ranges, m_compact, vboManager);
+  }
+}
+
+size_t BrushMultiDraw::render(const PrimType primType, ShaderProgram& program)
+{
+  if (m_ranges.empty())
+  {
+    return 0u;
+  }
+
+  auto drawCallCount = size_t(0);
+  m_pool->setupIndices();
+
+  if (m_indirect)
+  {
+    m_pool->renderDrawCommands(primType, m_compact);
+    ++drawCallCount;
+  }
+  else
+  {
+    // the chunk origin is constant for a draw call, so only ranges with the same origin
+    // can be drawn together
+    auto ranges = m_ranges;
+    if (m_compact)
+    {
+      std::stable_sort(
+        ranges.begin(), ranges.end(), [](const auto& lhs, const auto& rhs) {
+          return lhs.origin < rhs.origin;
+        });
+    }
+
+    const auto offset = m_pool->offset();
+    auto counts = std::vector<GLsizei>{};
+    auto offsets = std::vector<const GLvoid*>{};
+
+    size_t next;
+    for (size_t i = 0; i < ranges.size(); i = next)
+    {
+      counts.clear();
+      offsets.clear();
+      for (next = i; next < ranges.size()
+                     && (!m_compact || ranges[next].origin == ranges[i].origin);
+           ++next)
+      {
+        counts.push_back(static_cast<GLsizei>(ranges[next].count));
+        offsets.push_back(
+          reinterpret_cast<const GLvoid*>(offset + sizeof(GLuint) * ranges[next].pos));
+      }
+
+      if (m_compact)
+      {
+        BrushVertexArray::setChunkOrigin(program, ranges[i].origin);
+      }
+      glAssert(glMultiDrawElements(
+        toGL(primType),
+        counts.data(),
+        glType<GLuint>(),
+        offsets.data(),
+        static_cast<GLsizei>(counts.size())));
+      ++drawCallCount;
+    }
+  }
+
+  m_pool->cleanupIndices();
+  return drawCallCount;
+}
+
+std::vector<BrushMultiDraw::Range> BrushMultiDraw::mergeRanges(
+  std::vector<Range> ranges, const bool compact)
+{
+  std::sort(ranges.begin(), ranges.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.pos < rhs.pos;
+  });
+
+  auto result = std::vector<Range>{};
+  for (const auto& range : ranges)
+  {
+    if (
+      !result.empty() && result.back().pos + result.back().count == range.pos
+      && (!compact || result.back().origin == range.origin))
+    {
+      result.back().count += range.count;
+    }
+    else
+    {
+      result.push_back(range);
+    }
+  }
+  return result;
 }
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -30,8 +30,10 @@
 
 #include <vecmath/vec.h>
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -39,6 +41,8 @@ namespace TrenchBroom
 {
 namespace Renderer
 {
+class ShaderProgram;
+
 struct DirtyRangeTracker
 {
   size_t m_dirtyPos;
@@ -60,26 +64,166 @@ struct DirtyRangeTracker
   bool clean() const;
 };
 
+/**
+ * Tracks the dirty range of each region of a ring of buffer regions, see Vbo. Edits are
+ * made to every region, but only the current region is brought up to date when it
+ * becomes current.
+ */
+class RingDirtyRangeTracker
+{
+private:
+  std::vector<DirtyRangeTracker> m_regions;
+  size_t m_currentRegion;
+
+public:
+  /**
+   * Creates a tracker for the given number of regions of the given capacity. The current
+   * region is initially clean, and all other regions are entirely dirty.
+   */
+  explicit RingDirtyRangeTracker(size_t regionCount = 1u, size_t capacity = 0u);
+
+  size_t regionCount() const;
+  size_t currentRegion() const;
+  size_t capacity() const;
+
+  /**
+   * Returns the dirty range of the current region.
+   */
+  const DirtyRangeTracker& current() const;
+
+  /**
+   * Marks the given range as dirty in every region.
+   */
+  void markDirty(size_t pos, size_t size);
+
+  /**
+   * Expands every region and marks the new range as dirty.
+   */
+  void expand(size_t newcap);
+
+  /**
+   * Makes the next region current, wrapping around after the last region.
+   */
+  void advance();
+
+  /**
+   * Marks the current region as clean once it has been brought up to date.
+   */
+  void markCurrentClean();
+
+  /**
+   * Returns true if the current region is up to date.
+   */
+  bool clean() const;
+};
+
+/**
+ * Records edits of a buffer which are not written yet, in the order in which they were
+ * made, so that they can be applied to the buffer later.
+ */
+template <typename T>
+class PendingEdits
+{
+private:
+  struct Edit
+  {
+    size_t pos;
+    size_t count;
+    /**
+     * If set, the elements are copied from this position of the buffer when the edit is
+     * applied, otherwise they are taken from `elements`.
+     */
+    std::optional<size_t> copyFrom;
+    std::vector<T> elements;
+  };
+
+  std::vector<Edit> m_edits;
+
+public:
+  bool empty() const { return m_edits.empty(); }
+
+  /**
+   * Records writing the given number of elements at the given position and returns a
+   * pointer where the caller must write them. The pointer remains valid until the edits
+   * are applied.
+   */
+  T* write(const size_t pos, const size_t count)
+  {
+    m_edits.push_back(Edit{pos, count, std::nullopt, std::vector<T>(count)});
+    return m_edits.back().elements.data();
+  }
+
+  /**
+   * Records copying the given number of elements within the buffer. The source and the
+   * destination range must not overlap.
+   */
+  void copy(const size_t from, const size_t to, const size_t count)
+  {
+    assert(from + count <= to || to + count <= from);
+    m_edits.push_back(Edit{to, count, from, {}});
+  }
+
+  /**
+   * Applies the recorded edits to the given buffer in order and clears them.
+   */
+  void apply(T* buffer)
+  {
+    for (const auto& edit : m_edits)
+    {
+      if (edit.copyFrom)
+      {
+        const auto* src = buffer + *edit.copyFrom;
+        std::copy(src, src + edit.count, buffer + edit.pos);
+      }
+      else
+      {
+        std::copy(edit.elements.begin(), edit.elements.end(), buffer + edit.pos);
+      }
+    }
+    m_edits.clear();
+  }
+};
+
 /**
  * Wrapper around a std::vector<T> and VboBlock.
  *
  * Non-copyable; meant to be held in a std::shared_ptr.
  * Able to be resized, and handles copying edits made in the local std::vector to the VBO.
  *
- * Currently uses a single range to track the modified region which might upload much more
- * than necessary; it might be worth mapping the VBO and editing it directly.
+ * Currently uses a single range per buffer region to track the modified region which
+ * might upload much more than necessary. Large modified regions are uploaded by orphaning
+ * the VBO's storage so that the upload does not wait for pending draw calls.
+ *
+ * If the VboManager has persistent mapping enabled, the VBO holds a ring of regions and
+ * the local std::vector is released after the first upload. Edits are then recorded as
+ * PendingEdits. Every time the holder is prepared after it was edited, it moves on to the
+ * next region, copies the edits which that region has missed from the previous region,
+ * and applies the pending edits. The GPU can meanwhile keep reading from the previous
+ * regions, so preparing only waits if the ring wraps around before the GPU has finished
+ * reading. If waiting fails or persistent mapping is disabled, the holder reads its
+ * elements back and falls back to an ordinary VBO.
  */
 template <typename T>
 class VboHolder
 {
+public:
+  /**
+   * The number of regions of a persistently mapped VBO.
+   */
+  static const size_t MappedRegionCount = 3u;
+
 protected:
   VboType m_type;
   std::vector<T> m_snapshot;
-  DirtyRangeTracker m_dirtyRange;
+  size_t m_size;
+  PendingEdits<T> m_pendingEdits;
+  RingDirtyRangeTracker m_dirtyRanges;
   VboManager* m_vboManager;
   Vbo* m_vbo;
 
 private:
+  bool mapped() const { return m_vbo != nullptr && m_vbo->persistentlyMapped(); }
+
   void freeBlock()
   {
     if (m_vbo != nullptr)
@@ -100,23 +244,84 @@ private:
       m_vboManager = &vboManager;
     }
     assert(m_vbo == nullptr);
+    assert(m_snapshot.size() == m_size);
 
-    m_vbo = m_vboManager->allocateVbo(
-      m_type, m_snapshot.size() * sizeof(T), VboUsage::DynamicDraw);
+    const auto capacity = m_size * sizeof(T);
+    m_vbo = m_vboManager->persistentMappingEnabled()
+              ? m_vboManager->allocateMappedVbo(m_type, capacity, MappedRegionCount)
+              : m_vboManager->allocateVbo(m_type, capacity, VboUsage::DynamicDraw);
     assert(m_vbo != nullptr);
 
     m_vbo->writeElements(0, m_snapshot);
+    if (mapped())
+    {
+      // from now on, the mapped regions hold the elements
+      m_snapshot = std::vector<T>{};
+    }
 
-    m_dirtyRange = DirtyRangeTracker(m_snapshot.size());
-    assert(m_dirtyRange.clean());
-    assert((m_vbo->capacity() / sizeof(T)) == m_dirtyRange.capacity());
+    m_dirtyRanges = RingDirtyRangeTracker(m_vbo->regionCount(), m_size);
+    assert(m_dirtyRanges.clean());
+    assert((m_vbo->capacity() / sizeof(T)) == m_dirtyRanges.capacity());
+  }
+
+  /**
+   * Replaces the mapped VBO with a new VBO. The elements are read back from the given
+   * region, which must be up to date, and the pending edits are applied to them.
+   */
+  void reallocateMappedBlock(VboManager& vboManager, const size_t region)
+  {
+    assert(mapped());
+
+    const auto count = std::min(m_size, m_vbo->capacity() / sizeof(T));
+    const auto* elements = m_vbo->mappedElements<T>(region, 0);
+    m_snapshot = std::vector<T>(m_size);
+    std::copy(elements, elements + count, m_snapshot.begin());
+    m_pendingEdits.apply(m_snapshot.data());
+
+    freeBlock();
+    allocateBlock(vboManager);
+  }
+
+  void prepareMapped(VboManager& vboManager)
+  {
+    // resize?
+    if (m_dirtyRanges.capacity() != (m_vbo->capacity() / sizeof(T)))
+    {
+      reallocateMappedBlock(vboManager, m_vbo->currentRegion());
+      return;
+    }
+
+    // the GPU may still read from the current region, so write the next one
+    const auto previousRegion = m_vbo->currentRegion();
+    if (!m_vbo->nextRegion())
+    {
+      // the next region might still be in use, upload with glBufferSubData instead
+      m_vboManager->disablePersistentMapping();
+      reallocateMappedBlock(vboManager, previousRegion);
+      return;
+    }
+
+    m_dirtyRanges.advance();
+    assert(m_dirtyRanges.currentRegion() == m_vbo->currentRegion());
+
+    // the previous region is up to date except for the pending edits
+    const auto& dirtyRange = m_dirtyRanges.current();
+    if (!dirtyRange.clean())
+    {
+      const auto address = dirtyRange.m_dirtyPos * sizeof(T);
+      const auto* src = m_vbo->mappedElements<T>(previousRegion, address);
+      m_vbo->writeArray(address, src, dirtyRange.m_dirtySize);
+    }
+    m_pendingEdits.apply(m_vbo->mappedElements<T>(0));
   }
 
 public:
   explicit VboHolder(const VboType type)
     : m_type(type)
     , m_snapshot()
-    , m_dirtyRange(0)
+    , m_size(0)
+    , m_pendingEdits()
+    , m_dirtyRanges()
     , m_vboManager(nullptr)
     , m_vbo(nullptr)
   {
@@ -128,13 +333,15 @@ public:
   VboHolder(const VboType type, std::vector<T>& elements)
     : m_type(type)
     , m_snapshot()
-    , m_dirtyRange(elements.size())
+    , m_size(elements.size())
+    , m_pendingEdits()
+    , m_dirtyRanges(1u, elements.size())
     , m_vboManager(nullptr)
     , m_vbo(nullptr)
   {
 
     const size_t elementsCount = elements.size();
-    m_dirtyRange.markDirty(0, elementsCount);
+    m_dirtyRanges.markDirty(0, elementsCount);
 
     elements.swap(m_snapshot);
 
@@ -154,27 +361,66 @@ public:
     freeBlock();
   }
 
+  /**
+   * Grows the holder. The new elements are value initialized.
+   */
   void resize(const size_t newSize)
   {
-    m_snapshot.resize(newSize);
-    m_dirtyRange.expand(newSize);
+    if (!mapped())
+    {
+      m_snapshot.resize(newSize);
+    }
+    m_size = newSize;
+    m_dirtyRanges.expand(newSize);
   }
 
+  /**
+   * Returns a pointer where the caller must write the given number of elements. If the
+   * VBO is persistently mapped, the pointer refers to a pending edit, so the caller must
+   * not read from it.
+   */
   T* getPointerToWriteElementsTo(
     const size_t offsetWithinBlock, const size_t elementCount)
   {
-    assert(offsetWithinBlock + elementCount <= m_snapshot.size());
+    assert(offsetWithinBlock + elementCount <= m_size);
 
     // mark dirty range
-    m_dirtyRange.markDirty(offsetWithinBlock, elementCount);
+    m_dirtyRanges.markDirty(offsetWithinBlock, elementCount);
 
+    if (mapped())
+    {
+      return m_pendingEdits.write(offsetWithinBlock, elementCount);
+    }
     return m_snapshot.data() + offsetWithinBlock;
   }
 
+  /**
+   * Copies the given number of elements within the holder. The source and the
+   * destination range must not overlap.
+   */
+  void copyElements(const size_t from, const size_t to, const size_t count)
+  {
+    assert(from + count <= m_size);
+    assert(to + count <= m_size);
+
+    m_dirtyRanges.markDirty(to, count);
+
+    if (mapped())
+    {
+      m_pendingEdits.copy(from, to, count);
+    }
+    else
+    {
+      assert(from + count <= to || to + count <= from);
+      const auto* src = m_snapshot.data() + from;
+      std::copy(src, src + count, m_snapshot.data() + to);
+    }
+  }
+
   bool prepared() const
   {
     // NOTE: this returns true if the capacity is 0
-    return m_dirtyRange.clean();
+    return m_dirtyRanges.clean();
   }
 
   void prepare(VboManager& vboManager)
@@ -197,8 +443,25 @@ public:
       return;
     }
 
+    if (mapped())
+    {
+      if (m_vboManager->persistentMappingEnabled())
+      {
+        prepareMapped(vboManager);
+      }
+      else
+      {
+        reallocateMappedBlock(vboManager, m_vbo->currentRegion());
+      }
+
+      m_dirtyRanges.markCurrentClean();
+      assert(m_pendingEdits.empty());
+      assert(prepared());
+      return;
+    }
+
     // resize?
-    if (m_dirtyRange.capacity() != (m_vbo->capacity() / sizeof(T)))
+    if (m_dirtyRanges.capacity() != (m_vbo->capacity() / sizeof(T)))
     {
       freeBlock();
       allocateBlock(vboManager);
@@ -208,22 +471,46 @@ public:
 
     // otherwise, it's an incremental update of the dirty ranges.
 
-    if (!m_dirtyRange.clean())
+    const auto& dirtyRange = m_dirtyRanges.current();
+    if (!dirtyRange.clean())
     {
-      const size_t pos = m_dirtyRange.m_dirtyPos;
-      const size_t size = m_dirtyRange.m_dirtySize;
-
-      const size_t bytesFromStart = pos * sizeof(T);
-      m_vbo->writeArray(bytesFromStart, m_snapshot.data() + pos, size);
+      const size_t pos = dirtyRange.m_dirtyPos;
+      const size_t size = dirtyRange.m_dirtySize;
+
+      if (2u * size > m_snapshot.size())
+      {
+        // orphan the old storage instead of waiting for the GPU to finish reading it
+        m_vbo->replaceArray(m_snapshot.data(), m_snapshot.size());
+      }
+      else
+      {
+        const size_t bytesFromStart = pos * sizeof(T);
+        m_vbo->writeArray(bytesFromStart, m_snapshot.data() + pos, size);
+      }
     }
 
-    m_dirtyRange = DirtyRangeTracker(m_snapshot.size());
+    m_dirtyRanges.markCurrentClean();
     assert(prepared());
   }
 
-  bool empty() const { return m_snapshot.empty(); }
+  bool empty() const { return m_size == 0; }
 
-  size_t size() const { return m_snapshot.size(); }
+  size_t size() const { return m_size; }
+
+  /**
+   * Returns the local copy of the elements. Must not be called once the elements have
+   * been uploaded to a persistently mapped VBO.
+   */
+  const std::vector<T>& elements() const
+  {
+    assert(!mapped());
+    return m_snapshot;
+  }
+
+  /**
+   * Returns the byte offset of the VBO's current region, see Vbo::offset().
+   */
+  size_t offset() const { return m_vbo->offset(); }
 
   void bindBlock() { m_vbo->bind(); }
 
@@ -246,51 +533,6 @@ public:
   static std::shared_ptr<IndexHolder> swap(std::vector<Index>& elements);
 };
 
-/**
- * VboBlock handle that supports dynamically allocating ranges of indices, grows as
- * needed, and also supports freeing allocations and zeroing the corresponding indicies so
- * they become degenerate primitives.
- */
-class BrushIndexArray
-{
-private:
-  IndexHolder m_indexHolder;
-  AllocationTracker m_allocationTracker;
-
-public:
-  BrushIndexArray();
-
-  /**
-   * Returns true if there are any valid indices to render. Ranges zeroed by
-   * zeroElementsWithKey() do not count.
-   */
-  bool hasValidIndices() const;
-
-  /**
-   * Call this to request writing the given number of indices.
-   *
-   * The VboBlock will be expanded if needed to accommodate the allocation.
-   *
-   * Returns a AllocationTracker::Block pointer which can be used later in a call to
-   * zeroElementsWithKey(), and also a GLuint pointer where the caller should write
-   * `elementCount` GLuint's.
-   */
-  std::pair<AllocationTracker::Block*, GLuint*> getPointerToInsertElementsAt(
-    size_t elementCount);
-
-  /**
-   * Deletes indices for the given brush and marks the allocation as free.
-   */
-  void zeroElementsWithKey(AllocationTracker::Block* key);
-
-  void render(const PrimType primType) const;
-  bool prepared() const;
-  void prepare(VboManager& vboManager);
-
-  void setupIndices();
-  void cleanupIndices();
-};
-
 class VertexArrayInterface
 {
 public:
@@ -344,33 +586,243 @@ public:
   }
 };
 
+/**
+ * A range of indices of a BrushIndexPool and the origin of the vertices which they
+ * reference if the vertices are compact.
+ */
+struct BrushIndexRange
+{
+  size_t pos;
+  size_t count;
+  vm::vec3f origin;
+};
+
+bool operator==(const BrushIndexRange& lhs, const BrushIndexRange& rhs);
+bool operator!=(const BrushIndexRange& lhs, const BrushIndexRange& rhs);
+
+/**
+ * The layout of the draw commands of glMultiDrawElementsIndirect.
+ */
+struct DrawElementsIndirectCommand
+{
+  GLuint count;
+  GLuint instanceCount;
+  GLuint firstIndex;
+  GLint baseVertex;
+  GLuint baseInstance;
+};
+
+/**
+ * An index buffer which is shared by the index arrays of many chunks so that they can be
+ * drawn together with a single multi draw call, see BrushMultiDraw. Every index array
+ * occupies one contiguous page of the pool. Pages are zeroed when they are allocated, so
+ * that their unused indices form degenerate primitives.
+ */
+class BrushIndexPool
+{
+private:
+  IndexHolder m_indexHolder;
+  AllocationTracker m_allocationTracker;
+
+  /**
+   * The indirect draw commands and the chunk origins of the ranges which were last drawn,
+   * see prepareDrawCommands().
+   */
+  VboHolder<DrawElementsIndirectCommand> m_drawCommands;
+  VertexHolder<GLVertexTypes::ChunkOriginInstance::Vertex> m_chunkOrigins;
+  std::vector<BrushIndexRange> m_drawRanges;
+  size_t m_drawOffset;
+
+public:
+  BrushIndexPool();
+
+  bool hasPages() const;
+  size_t capacity() const;
+
+  /**
+   * Returns the local copy of the indices, see VboHolder::elements().
+   */
+  const std::vector<GLuint>& indices() const;
+
+  /**
+   * Allocates a zeroed page of the given size. The pool is expanded if needed.
+   */
+  AllocationTracker::Block* allocatePage(size_t size);
+  void freePage(AllocationTracker::Block* page);
+
+  GLuint* getPointerToWriteElementsTo(size_t pos, size_t count);
+  void copyElements(size_t from, size_t to, size_t count);
+  void zeroRange(size_t pos, size_t count);
+
+  bool prepared() const;
+  void prepare(VboManager& vboManager);
+
+  /**
+   * Returns the byte offset of the current region of the index buffer. Draw calls must
+   * add it to the offsets of the indices they draw.
+   */
+  size_t offset() const;
+
+  void setupIndices();
+  void cleanupIndices();
+  void render(PrimType primType, size_t pos, size_t count) const;
+
+  /**
+   * Writes the indirect draw commands for the given ranges of this pool, and their chunk
+   * origins if the vertices are compact. The pool must be prepared. The commands are only
+   * rewritten if the ranges or the offset of the index buffer's current region have
+   * changed since they were last written, and their buffers only grow, so drawing the
+   * same ranges again doesn't touch any buffers.
+   *
+   * Since the commands of only one set of ranges are kept, all ranges of this pool which
+   * are drawn together must be passed at once.
+   */
+  void prepareDrawCommands(
+    const std::vector<BrushIndexRange>& ranges, bool compact, VboManager& vboManager);
+
+  /**
+   * Draws the ranges passed to prepareDrawCommands() with a single
+   * glMultiDrawElementsIndirect call. The indices must be set up.
+   */
+  void renderDrawCommands(PrimType primType, bool compact);
+};
+
+/**
+ * Index array handle that supports dynamically allocating ranges of indices, grows as
+ * needed, and also supports freeing allocations and zeroing the corresponding indicies so
+ * they become degenerate primitives.
+ *
+ * The indices are stored in a page of a BrushIndexPool, which may be shared with other
+ * index arrays. When the page is full, the indices are moved to a larger page.
+ */
+class BrushIndexArray
+{
+private:
+  std::shared_ptr<BrushIndexPool> m_pool;
+  AllocationTracker::Block* m_page;
+  AllocationTracker m_allocationTracker;
+  size_t m_validIndexCount;
+  vm::vec3f m_origin;
+
+public:
+  BrushIndexArray();
+
+  /**
+   * Creates an index array for vertices which are stored relative to the given origin if
+   * the vertex array is compact.
+   */
+  explicit BrushIndexArray(const vm::vec3f& origin);
+
+  /**
+   * Creates an index array which stores its indices in the given pool.
+   */
+  BrushIndexArray(std::shared_ptr<BrushIndexPool> pool, const vm::vec3f& origin);
+
+  BrushIndexArray(const BrushIndexArray& other) = delete;
+  BrushIndexArray& operator=(const BrushIndexArray& other) = delete;
+  ~BrushIndexArray();
+
+  const std::shared_ptr<BrushIndexPool>& pool() const;
+
+  /**
+   * The position of this array's page in the pool.
+   */
+  size_t pagePos() const;
+
+  /**
+   * The origin of the vertices referenced by this index array if the vertex array is
+   * compact.
+   */
+  const vm::vec3f& origin() const;
+
+  /**
+   * Returns true if there are any valid indices to render. Ranges zeroed by
+   * zeroElementsWithKey() do not count.
+   */
+  bool hasValidIndices() const;
+
+  /**
+   * Returns the number of valid indices. Ranges zeroed by zeroElementsWithKey() do not
+   * count.
+   */
+  size_t validIndexCount() const;
+
+  /**
+   * Returns the number of indices submitted by render(), i.e. the size of the page,
+   * including zeroed ranges.
+   */
+  size_t indexCount() const;
+
+  /**
+   * Call this to request writing the given number of indices.
+   *
+   * The page will be expanded if needed to accommodate the allocation.
+   *
+   * Returns a AllocationTracker::Block pointer which can be used later in a call to
+   * zeroElementsWithKey(), and also a GLuint pointer where the caller should write
+   * `elementCount` GLuint's.
+   */
+  std::pair<AllocationTracker::Block*, GLuint*> getPointerToInsertElementsAt(
+    size_t elementCount);
+
+  /**
+   * Deletes indices for the given brush and marks the allocation as free.
+   */
+  void zeroElementsWithKey(AllocationTracker::Block* key);
+
+  void render(const PrimType primType) const;
+  bool prepared() const;
+  void prepare(VboManager& vboManager);
+
+  void setupIndices();
+  void cleanupIndices();
+};
+
 /**
  * Same as BrushIndexArray but for vertices instead of indices.
  * The only difference is deleteVerticesWithKey() doesn't need to zero out
  * the deleted memory in the VBO, while BrushIndexArray's does.
+ *
+ * If the array is compact, the vertices are compressed into CompactBrushVertex, which
+ * takes half of the memory and bandwidth of a full vertex. Compact vertices must be
+ * rendered with the compact face and edge shaders, and the origin of the index array
+ * being rendered must be passed as the chunkOrigin attribute, see setChunkOrigin() and
+ * BrushMultiDraw.
  */
 class BrushVertexArray
 {
-private:
+public:
   using Vertex = Renderer::GLVertexTypes::P3NT2::Vertex;
+  using CompactVertex = Renderer::GLVertexTypes::CompactBrushVertex::Vertex;
 
+  /**
+   * The smallest exponent of compact vertex positions, i.e. positions which are close
+   * enough to the origin are quantized to 1/16 units.
+   */
+  static const int MinPositionExponent = -4;
+
+private:
+  bool m_compact;
   VertexHolder<Vertex> m_vertexHolder;
+  VertexHolder<CompactVertex> m_compactVertexHolder;
   AllocationTracker m_allocationTracker;
 
 public:
-  BrushVertexArray();
+  explicit BrushVertexArray(bool compact = false);
+
+  bool compact() const;
 
   /**
-   * Call this to request writing the given number of vertices.
+   * Inserts the given vertices, which are compressed relative to the given origin if this
+   * array is compact.
    *
    * The VboBlock will be expanded if needed to accommodate the allocation.
    *
    * Returns a AllocationTracker::Block pointer which can be used later in a call to
-   * deleteVerticesWithKey(), and also a Vertex pointer where the caller should write
-   * `elementCount` Vertex objects.
+   * deleteVerticesWithKey().
    */
-  std::pair<AllocationTracker::Block*, Vertex*> getPointerToInsertVerticesAt(
-    size_t vertexCount);
+  AllocationTracker::Block* insertVertices(
+    const std::vector<Vertex>& vertices, const vm::vec3f& origin);
 
   void deleteVerticesWithKey(AllocationTracker::Block* key);
 
@@ -381,6 +833,109 @@ public:
   // uploading the VBO
   bool prepared() const;
   void prepare(VboManager& vboManager);
+
+  /**
+   * Compresses the given vertices relative to the given origin.
+   *
+   * The texture coordinates of every run of vertices with the same normal, i.e. of every
+   * face, are translated by whole texture repetitions so that they are close to zero,
+   * which preserves the precision of the half floats.
+   */
+  static std::vector<CompactVertex> compactVertices(
+    const std::vector<Vertex>& vertices, const vm::vec3f& origin);
+
+  /**
+   * Returns the bits of the half float closest to the given value. Values which are too
+   * large are clamped to the largest finite half float.
+   */
+  static GLshort toHalfFloat(float value);
+
+  /**
+   * Returns the value of the given half float bits.
+   */
+  static float fromHalfFloat(GLshort bits);
+
+  /**
+   * Returns the position of the given compact vertex relative to the given origin.
+   */
+  static vm::vec3f decodePosition(const CompactVertex& vertex, const vm::vec3f& origin);
+
+  /**
+   * Returns the normal of the given compact vertex.
+   */
+  static vm::vec3f decodeNormal(const CompactVertex& vertex);
+
+  /**
+   * Returns the texture coordinates of the given compact vertex.
+   */
+  static vm::vec2f decodeTexCoords(const CompactVertex& vertex);
+
+  /**
+   * Sets the chunkOrigin attribute of the given program, which must be a compact shader,
+   * to the given origin for all subsequent draw calls.
+   */
+  static void setChunkOrigin(ShaderProgram& program, const vm::vec3f& origin);
+
+private:
+  template <typename V>
+  AllocationTracker::Block* insertVertices(
+    VertexHolder<V>& vertexHolder, const std::vector<V>& vertices);
+};
+
+/**
+ * Draws the pages of index arrays which share a BrushIndexPool with as few draw calls as
+ * possible. Adjacent pages are merged into a single range first.
+ *
+ * If the VboManager supports it, all ranges are drawn with a single
+ * glMultiDrawElementsIndirect call, where every draw command reads the chunk origin of
+ * its range from a per instance attribute. The commands are kept by the pool, see
+ * BrushIndexPool::prepareDrawCommands(). Otherwise, the ranges are drawn with a single
+ * glMultiDrawElements call, or with one call per chunk origin if the vertices are
+ * compact.
+ */
+class BrushMultiDraw
+{
+public:
+  using Range = BrushIndexRange;
+
+private:
+  std::shared_ptr<BrushIndexPool> m_pool;
+  std::vector<Range> m_ranges;
+  bool m_compact;
+  bool m_indirect;
+
+public:
+  BrushMultiDraw(std::shared_ptr<BrushIndexPool> pool, bool compact);
+
+  const std::shared_ptr<BrushIndexPool>& pool() const;
+  const std::vector<Range>& ranges() const;
+
+  /**
+   * Returns the number of indices submitted by render().
+   */
+  size_t indexCount() const;
+
+  /**
+   * Adds the page of the given index array, which must belong to this draw's pool.
+   */
+  void add(const BrushIndexArray& indexArray);
+
+  /**
+   * Uploads the pool and merges the ranges. If indirect draw calls are supported, the
+   * pool's draw commands are updated too.
+   */
+  void prepare(VboManager& vboManager);
+
+  /**
+   * Draws the ranges with the given program and returns the number of draw calls.
+   */
+  size_t render(PrimType primType, ShaderProgram& program);
+
+  /**
+   * Sorts the given ranges by their position and merges adjacent ranges. If the vertices
+   * are compact, only ranges with the same origin are merged.
+   */
+  static std::vector<Range> mergeRanges(std::vector<Range> ranges, bool compact);
 };
 } // namespace Renderer
 } // namespace TrenchBroom
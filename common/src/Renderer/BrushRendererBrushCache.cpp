@@ -19,12 +19,14 @@
 
 #include "BrushRendererBrushCache.h"
 
+#include "Model/Brush.h"
 #include "Model/BrushFace.h"
-#include "Model/BrushGeometry.h"
 #include "Model/BrushNode.h"
-#include "Model/Polyhedron.h"
+#include "Model/CompactBrushGeometry.h"
 
 #include <algorithm>
+#include <iterator>
+#include <vector>
 
 namespace TrenchBroom
 {
@@ -53,6 +55,7 @@ BrushRendererBrushCache::CachedEdge::CachedEdge(
 
 BrushRendererBrushCache::BrushRendererBrushCache()
   : m_rendererCacheValid{false}
+  , m_generation{0u}
 {
 }
 
@@ -73,6 +76,7 @@ void BrushRendererBrushCache::validateVertexCache(const Model::BrushNode& brushN
 
   // build vertex cache and face cache
   const auto& brush = brushNode.brush();
+  const auto& geometry = brush.geometry();
 
   m_cachedVertices.clear();
   m_cachedVertices.reserve(brush.vertexCount());
@@ -80,31 +84,32 @@ void BrushRendererBrushCache::validateVertexCache(const Model::BrushNode& brushN
   m_cachedFacesSortedByTexture.clear();
   m_cachedFacesSortedByTexture.reserve(brush.faceCount());
 
-  for (const auto& face : brush.faces())
+  // Maps the index of each brush vertex to the index of one of its cached vertices,
+  // relative to the brush's first vertex being 0. This is used below when building the
+  // edge cache. NOTE: we'll overwrite the index as we visit the same vertex several times
+  // while visiting different faces, this is fine.
+  auto cachedVertexIndices = std::vector<size_t>(geometry.vertexCount());
+
+  for (size_t faceIndex = 0u; faceIndex < brush.faceCount(); ++faceIndex)
   {
+    const auto& face = brush.face(faceIndex);
     const auto indexOfFirstVertexRelativeToBrush = m_cachedVertices.size();
 
     // The boundary is in CCW order, but the renderer expects CW order:
-    auto& boundary = face.geometry()->boundary();
-    for (auto it = std::rbegin(boundary), end = std::rend(boundary); it != end; ++it)
+    const auto rbegin =
+      std::make_reverse_iterator(geometry.faceVertexIndicesEnd(faceIndex));
+    const auto rend =
+      std::make_reverse_iterator(geometry.faceVertexIndicesBegin(faceIndex));
+    for (auto it = rbegin; it != rend; ++it)
     {
-      auto* currentHalfEdge = *it;
-      auto* vertex = currentHalfEdge->origin();
-
-      // Set the vertex payload to the index, relative to the brush's first vertex being
-      // 0. This is used below when building the edge cache. NOTE: we'll overwrite the
-      // payload as we visit the same vertex several times while visiting different faces,
-      // this is fine.
-      const auto currentIndex = m_cachedVertices.size();
-      vertex->setPayload(static_cast<GLuint>(currentIndex));
+      const auto vertexIndex = *it;
+      cachedVertexIndices[vertexIndex] = m_cachedVertices.size();
 
-      const auto& position = vertex->position();
+      const auto& position = geometry.vertexPosition(vertexIndex);
       m_cachedVertices.emplace_back(
         vm::vec3f{position},
         vm::vec3f{face.boundary().normal},
         face.textureCoords(position));
-
-      currentHalfEdge = currentHalfEdge->previous();
     }
 
     // face cache
@@ -123,25 +128,22 @@ void BrushRendererBrushCache::validateVertexCache(const Model::BrushNode& brushN
   // Build edge index cache
 
   m_cachedEdges.clear();
-  m_cachedEdges.reserve(brush.edgeCount());
+  m_cachedEdges.reserve(geometry.edgeCount());
 
-  for (const auto* currentEdge : brush.edges())
+  for (size_t edgeIndex = 0u; edgeIndex < geometry.edgeCount(); ++edgeIndex)
   {
-    const auto faceIndex1 = currentEdge->firstFace()->payload();
-    const auto faceIndex2 = currentEdge->secondFace()->payload();
-    assert(faceIndex1 && faceIndex2);
-
-    const auto& face1 = brush.face(*faceIndex1);
-    const auto& face2 = brush.face(*faceIndex2);
-
-    const auto vertexIndex1RelativeToBrush = currentEdge->firstVertex()->payload();
-    const auto vertexIndex2RelativeToBrush = currentEdge->secondVertex()->payload();
+    const auto [faceIndex1, faceIndex2] = geometry.edgeFaceIndices(edgeIndex);
+    const auto [vertexIndex1, vertexIndex2] = geometry.edgeVertexIndices(edgeIndex);
 
     m_cachedEdges.emplace_back(
-      &face1, &face2, vertexIndex1RelativeToBrush, vertexIndex2RelativeToBrush);
+      &brush.face(faceIndex1),
+      &brush.face(faceIndex2),
+      cachedVertexIndices[vertexIndex1],
+      cachedVertexIndices[vertexIndex2]);
   }
 
   m_rendererCacheValid = true;
+  ++m_generation;
 }
 
 const std::vector<BrushRendererBrushCache::Vertex>& BrushRendererBrushCache::
@@ -164,5 +166,10 @@ const std::vector<BrushRendererBrushCache::CachedEdge>& BrushRendererBrushCache:
   assert(m_rendererCacheValid);
   return m_cachedEdges;
 }
+
+size_t BrushRendererBrushCache::generation() const
+{
+  return m_generation;
+}
 } // namespace Renderer
 } // namespace TrenchBroom
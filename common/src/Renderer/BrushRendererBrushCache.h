@@ -74,6 +74,7 @@ private:
   std::vector<CachedEdge> m_cachedEdges;
   std::vector<CachedFace> m_cachedFacesSortedByTexture;
   bool m_rendererCacheValid;
+  size_t m_generation;
 
 public:
   BrushRendererBrushCache();
@@ -98,6 +99,13 @@ public:
   const std::vector<Vertex>& cachedVertices() const;
   const std::vector<CachedFace>& cachedFacesSortedByTexture() const;
   const std::vector<CachedEdge>& cachedEdges() const;
+
+  /**
+   * Returns a number which is incremented whenever the cache is rebuilt. Renderers can
+   * compare it to the generation of vertices they have uploaded earlier to find out
+   * whether the brush geometry has changed since.
+   */
+  size_t generation() const;
 };
 } // namespace Renderer
 } // namespace TrenchBroom
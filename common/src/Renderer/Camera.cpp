@@ -21,10 +21,15 @@
 
 #include "Macros.h"
 
+#include <vecmath/bbox.h>
 #include <vecmath/distance.h>
 #include <vecmath/intersection.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 
+#include <algorithm>
+#include <array>
+
 namespace TrenchBroom
 {
 namespace Renderer
@@ -207,6 +212,23 @@ void Camera::frustumPlanes(
   doComputeFrustumPlanes(top, right, bottom, left);
 }
 
+bool Camera::culls(const vm::bbox3f& bounds) const
+{
+  auto planes = std::array<vm::plane3f, 5>{};
+  frustumPlanes(planes[0], planes[1], planes[2], planes[3]);
+  planes[4] = vm::plane3f{m_position + m_direction * m_farPlane, m_direction};
+
+  // the plane normals point out of the frustum, so the box is outside if the corner which
+  // is furthest in the direction opposite to a plane's normal is still above that plane
+  return std::any_of(planes.begin(), planes.end(), [&](const auto& plane) {
+    const auto corner = vm::vec3f{
+      plane.normal.x() > 0.0f ? bounds.min.x() : bounds.max.x(),
+      plane.normal.y() > 0.0f ? bounds.min.y() : bounds.max.y(),
+      plane.normal.z() > 0.0f ? bounds.min.z() : bounds.max.z()};
+    return plane.point_distance(corner) > 0.0f;
+  });
+}
+
 vm::ray3f Camera::viewRay() const
 {
   return vm::ray3f(m_position, m_direction);
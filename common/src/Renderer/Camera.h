@@ -123,6 +123,14 @@ public:
     vm::plane3f& bottomPlane,
     vm::plane3f& leftPlane) const;
 
+  /**
+   * Indicates whether the given box lies entirely outside of the view frustum or beyond
+   * the far plane, in which case nothing within it needs to be rendered.
+   *
+   * This test is conservative: it may return false for some boxes that are not visible.
+   */
+  bool culls(const vm::bbox3f& bounds) const;
+
   vm::ray3f viewRay() const;
   vm::ray3f pickRay(float x, float y) const;
   vm::ray3f pickRay(const vm::vec3f& point) const;
@@ -102,6 +102,12 @@ void Circle::render()
   m_array.render(m_filled ? PrimType::TriangleFan : PrimType::LineLoop);
 }
 
+void Circle::renderInstances(VertexArray& instanceArray)
+{
+  m_array.renderInstances(
+    m_filled ? PrimType::TriangleFan : PrimType::LineLoop, instanceArray);
+}
+
 void Circle::init2D(
   const float radius,
   const size_t segments,
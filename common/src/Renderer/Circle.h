@@ -55,6 +55,7 @@ public:
   bool prepared() const;
   void prepare(VboManager& vboManager);
   void render();
+  void renderInstances(VertexArray& instanceArray);
 
 private:
   void init3D(
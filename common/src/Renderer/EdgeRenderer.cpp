@@ -28,8 +28,11 @@
 #include "Renderer/RenderContext.h"
 #include "Renderer/RenderUtils.h"
 #include "Renderer/ShaderManager.h"
+#include "Renderer/ShaderProgram.h"
 #include "Renderer/Shaders.h"
 
+#include <algorithm>
+
 namespace TrenchBroom
 {
 namespace Renderer
@@ -74,7 +77,8 @@ EdgeRenderer::RenderBase::RenderBase(const Params& params)
 
 EdgeRenderer::RenderBase::~RenderBase() = default;
 
-void EdgeRenderer::RenderBase::renderEdges(RenderContext& renderContext)
+void EdgeRenderer::RenderBase::renderEdges(
+  RenderContext& renderContext, const ShaderConfig& shaderConfig)
 {
   if (m_params.offset != 0.0)
   {
@@ -92,7 +96,7 @@ void EdgeRenderer::RenderBase::renderEdges(RenderContext& renderContext)
   }
 
   {
-    auto shader = ActiveShader{renderContext.shaderManager(), Shaders::EdgeShader};
+    auto shader = ActiveShader{renderContext.shaderManager(), shaderConfig};
     shader.set("ShowSoftMapBounds", !renderContext.softMapBounds().is_empty());
     shader.set("SoftMapBoundsMin", renderContext.softMapBounds().min);
     shader.set("SoftMapBoundsMax", renderContext.softMapBounds().max);
@@ -184,9 +188,11 @@ void EdgeRenderer::render(
 DirectEdgeRenderer::Render::Render(
   const EdgeRenderer::Params& params,
   VertexArray& vertexArray,
+  VertexArray& instanceArray,
   IndexRangeMap& indexRanges)
   : RenderBase{params}
   , m_vertexArray{vertexArray}
+  , m_instanceArray{instanceArray}
   , m_indexRanges{indexRanges}
 {
 }
@@ -194,19 +200,29 @@ DirectEdgeRenderer::Render::Render(
 void DirectEdgeRenderer::Render::doPrepareVertices(VboManager& vboManager)
 {
   m_vertexArray.prepare(vboManager);
+  m_instanceArray.prepare(vboManager);
 }
 
 void DirectEdgeRenderer::Render::doRender(RenderContext& renderContext)
 {
   if (m_vertexArray.vertexCount() > 0)
   {
-    renderEdges(renderContext);
+    renderEdges(
+      renderContext,
+      m_instanceArray.empty() ? Shaders::EdgeShader : Shaders::BoxInstanceEdgeShader);
   }
 }
 
 void DirectEdgeRenderer::Render::doRenderVertices(RenderContext&)
 {
-  m_indexRanges.render(m_vertexArray);
+  if (m_instanceArray.empty())
+  {
+    m_indexRanges.render(m_vertexArray);
+  }
+  else
+  {
+    m_indexRanges.renderInstances(m_vertexArray, m_instanceArray);
+  }
 }
 
 DirectEdgeRenderer::DirectEdgeRenderer() {}
@@ -223,10 +239,20 @@ DirectEdgeRenderer::DirectEdgeRenderer(VertexArray vertexArray, const PrimType p
 {
 }
 
+DirectEdgeRenderer::DirectEdgeRenderer(
+  VertexArray vertexArray, VertexArray instanceArray, const PrimType primType)
+  // without any instances, there is nothing to render
+  : m_vertexArray{instanceArray.empty() ? VertexArray{} : std::move(vertexArray)}
+  , m_instanceArray{std::move(instanceArray)}
+  , m_indexRanges{IndexRangeMap{primType, 0, m_vertexArray.vertexCount()}}
+{
+}
+
 void DirectEdgeRenderer::doRender(
   RenderBatch& renderBatch, const EdgeRenderer::Params& params)
 {
-  renderBatch.addOneShot(new Render{params, m_vertexArray, m_indexRanges});
+  renderBatch.addOneShot(
+    new Render{params, m_vertexArray, m_instanceArray, m_indexRanges});
 }
 
 // IndexedEdgeRenderer::Render
@@ -234,34 +260,67 @@ void DirectEdgeRenderer::doRender(
 IndexedEdgeRenderer::Render::Render(
   const EdgeRenderer::Params& params,
   std::shared_ptr<BrushVertexArray> vertexArray,
-  std::shared_ptr<BrushIndexArray> indexArray)
+  std::vector<std::shared_ptr<BrushIndexArray>> indexArrays)
   : RenderBase{params}
   , m_vertexArray{std::move(vertexArray)}
-  , m_indexArray{std::move(indexArray)}
+  , m_indexArrays{std::move(indexArrays)}
 {
 }
 
 void IndexedEdgeRenderer::Render::prepareVerticesAndIndices(VboManager& vboManager)
 {
   m_vertexArray->prepare(vboManager);
-  m_indexArray->prepare(vboManager);
+
+  // draw the index arrays of every pool together
+  auto indexArrays = std::vector<const BrushIndexArray*>{};
+  for (const auto& indexArray : m_indexArrays)
+  {
+    if (indexArray->hasValidIndices())
+    {
+      indexArrays.push_back(indexArray.get());
+    }
+  }
+  std::sort(indexArrays.begin(), indexArrays.end(), [](const auto* lhs, const auto* rhs) {
+    return lhs->pool() < rhs->pool();
+  });
+
+  m_multiDraws.clear();
+  for (const auto* indexArray : indexArrays)
+  {
+    if (m_multiDraws.empty() || m_multiDraws.back()->pool() != indexArray->pool())
+    {
+      m_multiDraws.push_back(
+        std::make_shared<BrushMultiDraw>(indexArray->pool(), m_vertexArray->compact()));
+    }
+    m_multiDraws.back()->add(*indexArray);
+  }
+
+  for (auto& multiDraw : m_multiDraws)
+  {
+    multiDraw->prepare(vboManager);
+  }
 }
 
 void IndexedEdgeRenderer::Render::doRender(RenderContext& renderContext)
 {
-  if (m_indexArray->hasValidIndices())
+  if (!m_multiDraws.empty())
   {
-    renderEdges(renderContext);
+    renderEdges(
+      renderContext,
+      m_vertexArray->compact() ? Shaders::CompactEdgeShader : Shaders::EdgeShader);
   }
 }
 
-void IndexedEdgeRenderer::Render::doRenderVertices(RenderContext&)
+void IndexedEdgeRenderer::Render::doRenderVertices(RenderContext& renderContext)
 {
+  auto& program = *renderContext.shaderManager().currentProgram();
   m_vertexArray->setupVertices();
-  m_indexArray->setupIndices();
-  m_indexArray->render(PrimType::Lines);
+  for (auto& multiDraw : m_multiDraws)
+  {
+    renderContext.countDrawCalls(multiDraw->render(PrimType::Lines, program));
+    renderContext.countDrawnVertices(multiDraw->indexCount());
+  }
   m_vertexArray->cleanupVertices();
-  m_indexArray->cleanupIndices();
 }
 
 // IndexedEdgeRenderer
@@ -271,15 +330,24 @@ IndexedEdgeRenderer::IndexedEdgeRenderer() = default;
 IndexedEdgeRenderer::IndexedEdgeRenderer(
   std::shared_ptr<BrushVertexArray> vertexArray,
   std::shared_ptr<BrushIndexArray> indexArray)
+  : IndexedEdgeRenderer{
+    std::move(vertexArray),
+    std::vector<std::shared_ptr<BrushIndexArray>>{std::move(indexArray)}}
+{
+}
+
+IndexedEdgeRenderer::IndexedEdgeRenderer(
+  std::shared_ptr<BrushVertexArray> vertexArray,
+  std::vector<std::shared_ptr<BrushIndexArray>> indexArrays)
   : m_vertexArray{std::move(vertexArray)}
-  , m_indexArray{std::move(indexArray)}
+  , m_indexArrays{std::move(indexArrays)}
 {
 }
 
 void IndexedEdgeRenderer::doRender(
   RenderBatch& renderBatch, const EdgeRenderer::Params& params)
 {
-  renderBatch.addOneShot(new Render{params, m_vertexArray, m_indexArray});
+  renderBatch.addOneShot(new Render{params, m_vertexArray, m_indexArrays});
 }
 } // namespace Renderer
 } // namespace TrenchBroom
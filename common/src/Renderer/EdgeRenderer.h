@@ -25,14 +25,17 @@
 #include "Renderer/VertexArray.h"
 
 #include <memory>
+#include <vector>
 
 namespace TrenchBroom
 {
 namespace Renderer
 {
 class BrushIndexArray;
+class BrushMultiDraw;
 class BrushVertexArray;
 class RenderBatch;
+class ShaderConfig;
 
 class EdgeRenderer
 {
@@ -65,7 +68,7 @@ public:
     virtual ~RenderBase();
 
   protected:
-    void renderEdges(RenderContext& renderContext);
+    void renderEdges(RenderContext& renderContext, const ShaderConfig& shaderConfig);
 
   private:
     virtual void doRenderVertices(RenderContext& renderContext) = 0;
@@ -117,10 +120,15 @@ private:
   {
   private:
     VertexArray m_vertexArray;
+    VertexArray m_instanceArray;
     IndexRangeMap m_indexRanges;
 
   public:
-    Render(const Params& params, VertexArray& vertexArray, IndexRangeMap& indexRanges);
+    Render(
+      const Params& params,
+      VertexArray& vertexArray,
+      VertexArray& instanceArray,
+      IndexRangeMap& indexRanges);
 
   private:
     void doPrepareVertices(VboManager& vboManager) override;
@@ -130,6 +138,7 @@ private:
 
 private:
   VertexArray m_vertexArray;
+  VertexArray m_instanceArray;
   IndexRangeMap m_indexRanges;
 
 public:
@@ -137,6 +146,14 @@ public:
   DirectEdgeRenderer(VertexArray vertexArray, IndexRangeMap indexRanges);
   DirectEdgeRenderer(VertexArray vertexArray, PrimType primType);
 
+  /**
+   * Renders the given unit box mesh once for every box in the given instance array,
+   * which must contain vertices of type GLVertexTypes::BoxInstance. Requires the
+   * ARB_instanced_arrays extension.
+   */
+  DirectEdgeRenderer(
+    VertexArray vertexArray, VertexArray instanceArray, PrimType primType);
+
 private:
   void doRender(RenderBatch& renderBatch, const EdgeRenderer::Params& params) override;
 };
@@ -148,13 +165,14 @@ private:
   {
   private:
     std::shared_ptr<BrushVertexArray> m_vertexArray;
-    std::shared_ptr<BrushIndexArray> m_indexArray;
+    std::vector<std::shared_ptr<BrushIndexArray>> m_indexArrays;
+    std::vector<std::shared_ptr<BrushMultiDraw>> m_multiDraws;
 
   public:
     Render(
       const Params& params,
       std::shared_ptr<BrushVertexArray> vertexArray,
-      std::shared_ptr<BrushIndexArray> indexArray);
+      std::vector<std::shared_ptr<BrushIndexArray>> indexArrays);
 
   private:
     void prepareVerticesAndIndices(VboManager& vboManager) override;
@@ -164,7 +182,7 @@ private:
 
 private:
   std::shared_ptr<BrushVertexArray> m_vertexArray;
-  std::shared_ptr<BrushIndexArray> m_indexArray;
+  std::vector<std::shared_ptr<BrushIndexArray>> m_indexArrays;
 
 public:
   IndexedEdgeRenderer();
@@ -172,6 +190,13 @@ public:
     std::shared_ptr<BrushVertexArray> vertexArray,
     std::shared_ptr<BrushIndexArray> indexArray);
 
+  /**
+   * Renders the edges of all of the given index arrays with a single shader setup.
+   */
+  IndexedEdgeRenderer(
+    std::shared_ptr<BrushVertexArray> vertexArray,
+    std::vector<std::shared_ptr<BrushIndexArray>> indexArrays);
+
 private:
   void doRender(RenderBatch& renderBatch, const EdgeRenderer::Params& params) override;
 };
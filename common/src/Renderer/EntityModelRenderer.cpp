@@ -32,21 +32,50 @@
 #include "Preferences.h"
 #include "Renderer/ActiveShader.h"
 #include "Renderer/Camera.h"
+#include "Renderer/GL.h"
+#include "Renderer/GLVertexType.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/ShaderManager.h"
 #include "Renderer/Shaders.h"
 #include "Renderer/TexturedIndexRangeRenderer.h"
-#include "Renderer/Transformation.h"
 
+#include <vecmath/bbox.h>
 #include <vecmath/mat.h>
 
-#include <vector>
+#include <kdl/vector_utils.h>
+
+#include <algorithm>
+#include <array>
 
 namespace TrenchBroom
 {
 namespace Renderer
 {
+namespace
+{
+/**
+ * Models whose bounds are projected to fewer pixels than these sizes are rendered with
+ * the corresponding simplified level of detail.
+ */
+constexpr auto LevelOfDetailPixelSizes = std::array<float, 2>{96.0f, 32.0f};
+
+size_t selectLevelOfDetail(const Camera& camera, const vm::bbox3f& bounds)
+{
+  const auto unitsPerPixel = camera.perspectiveScalingFactor(bounds.center());
+  if (unitsPerPixel <= 0.0f)
+  {
+    return 0u;
+  }
+
+  const auto pixelSize = vm::get_max_component(bounds.size()) / unitsPerPixel;
+  return size_t(std::count_if(
+    std::begin(LevelOfDetailPixelSizes),
+    std::end(LevelOfDetailPixelSizes),
+    [&](const auto threshold) { return pixelSize < threshold; }));
+}
+} // namespace
+
 EntityModelRenderer::EntityModelRenderer(
   Logger& logger,
   Assets::EntityModelManager& entityModelManager,
@@ -118,6 +147,7 @@ void EntityModelRenderer::updateEntity(const Model::EntityNode* entityNode)
 void EntityModelRenderer::clear()
 {
   m_entities.clear();
+  m_instances.clear();
 }
 
 bool EntityModelRenderer::applyTinting() const
@@ -150,14 +180,65 @@ void EntityModelRenderer::setShowHiddenEntities(const bool showHiddenEntities)
   m_showHiddenEntities = showHiddenEntities;
 }
 
-void EntityModelRenderer::render(RenderBatch& renderBatch)
+void EntityModelRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  // group the visible models by renderer and level of detail so that each group can be
+  // drawn with one instanced draw call per texture
+  m_instances.clear();
+  for (const auto& [entityNode, renderer] : m_entities)
+  {
+    if (!m_showHiddenEntities && !m_editorContext.visible(entityNode))
+    {
+      continue;
+    }
+
+    const auto* model = entityNode->entity().model();
+    if (!model)
+    {
+      continue;
+    }
+
+    const auto bounds = vm::bbox3f{entityNode->physicalBounds()};
+    if (renderContext.camera().culls(bounds))
+    {
+      continue;
+    }
+
+    if (renderContext.occludes(bounds))
+    {
+      renderContext.countOccludedObject(0u);
+      continue;
+    }
+
+    const auto levelOfDetail = selectLevelOfDetail(renderContext.camera(), bounds);
+    auto& modelInstances = m_instances[{renderer, levelOfDetail}];
+    modelInstances.orientation = model->orientation();
+    modelInstances.transformations.emplace_back(
+      entityNode->entity().modelTransformation());
+  }
+
   renderBatch.add(this);
 }
 
 void EntityModelRenderer::doPrepareVertices(VboManager& vboManager)
 {
   m_entityModelManager.prepare(vboManager);
+
+  if (GLEW_ARB_instanced_arrays)
+  {
+    using Instance = GLVertexTypes::ModelInstance::Vertex;
+
+    for (auto& [key, modelInstances] : m_instances)
+    {
+      auto instances = kdl::vec_transform(
+        modelInstances.transformations, [](const vm::mat4x4f& transformation) {
+          return Instance{
+            transformation[0], transformation[1], transformation[2], transformation[3]};
+        });
+      modelInstances.instanceArray = VertexArray::move(std::move(instances));
+      modelInstances.instanceArray.prepare(vboManager);
+    }
+  }
 }
 
 void EntityModelRenderer::doRender(RenderContext& renderContext)
@@ -167,7 +248,11 @@ void EntityModelRenderer::doRender(RenderContext& renderContext)
   glAssert(glEnable(GL_TEXTURE_2D));
   glAssert(glActiveTexture(GL_TEXTURE0));
 
-  auto shader = ActiveShader{renderContext.shaderManager(), Shaders::EntityModelShader};
+  // without instanced arrays, the model matrix is passed as a uniform for every instance
+  const auto instanced = bool(GLEW_ARB_instanced_arrays);
+  auto shader = ActiveShader{
+    renderContext.shaderManager(),
+    instanced ? Shaders::EntityModelInstanceShader : Shaders::EntityModelShader};
   shader.set("Brightness", prefs.get(Preferences::Brightness));
   shader.set("ApplyTinting", m_applyTinting);
   shader.set("TintColor", m_tintColor);
@@ -190,28 +275,23 @@ void EntityModelRenderer::doRender(RenderContext& renderContext)
   shader.set("CameraUp", renderContext.camera().up());
   shader.set("ViewMatrix", renderContext.camera().viewMatrix());
 
-  for (const auto& [entityNode, renderer] : m_entities)
+  for (auto& [key, modelInstances] : m_instances)
   {
-    if (!m_showHiddenEntities && !m_editorContext.visible(entityNode))
+    const auto& [renderer, levelOfDetail] = key;
+    const auto& transformations = modelInstances.transformations;
+
+    shader.set("Orientation", static_cast<int>(modelInstances.orientation));
+    if (instanced)
     {
-      continue;
+      renderer->renderInstances(levelOfDetail, modelInstances.instanceArray);
     }
-
-    const auto* model = entityNode->entity().model();
-    if (!model)
+    else
     {
-      continue;
+      renderer->renderRepeatedly(
+        levelOfDetail, transformations.size(), [&](const size_t i) {
+          shader.set("ModelMatrix", transformations[i]);
+        });
     }
-
-    shader.set("Orientation", static_cast<int>(model->orientation()));
-
-    const auto transformation = vm::mat4x4f{entityNode->entity().modelTransformation()};
-    const auto multMatrix =
-      MultiplyModelMatrix{renderContext.transformation(), transformation};
-
-    shader.set("ModelMatrix", transformation);
-
-    renderer->render();
   }
 }
 } // namespace Renderer
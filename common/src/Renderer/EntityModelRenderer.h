@@ -21,8 +21,14 @@
 
 #include "Color.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/VertexArray.h"
 
+#include <vecmath/mat.h>
+
+#include <map>
+#include <tuple>
 #include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom
 {
@@ -31,7 +37,8 @@ class Logger;
 namespace Assets
 {
 class EntityModelManager;
-}
+enum class Orientation;
+} // namespace Assets
 
 namespace Model
 {
@@ -42,6 +49,7 @@ class EntityNode;
 namespace Renderer
 {
 class RenderBatch;
+class RenderContext;
 class ShaderConfig;
 class TexturedRenderer;
 
@@ -55,6 +63,18 @@ private:
 
   std::unordered_map<const Model::EntityNode*, TexturedRenderer*> m_entities;
 
+  struct ModelInstances
+  {
+    Assets::Orientation orientation;
+    std::vector<vm::mat4x4f> transformations;
+    VertexArray instanceArray;
+  };
+
+  /**
+   * The visible models of the current frame, grouped by renderer and level of detail.
+   */
+  std::map<std::tuple<TexturedRenderer*, size_t>, ModelInstances> m_instances;
+
   bool m_applyTinting;
   Color m_tintColor;
 
@@ -107,7 +127,7 @@ public:
   bool showHiddenEntities() const;
   void setShowHiddenEntities(bool showHiddenEntities);
 
-  void render(RenderBatch& renderBatch);
+  void render(RenderContext& renderContext, RenderBatch& renderBatch);
 
 private:
   void doPrepareVertices(VboManager& vboManager) override;
@@ -29,6 +29,7 @@
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "Renderer/Camera.h"
+#include "Renderer/GL.h"
 #include "Renderer/GLVertexType.h"
 #include "Renderer/PrimType.h"
 #include "Renderer/RenderBatch.h"
@@ -36,6 +37,7 @@
 #include "Renderer/RenderService.h"
 #include "Renderer/TextAnchor.h"
 
+#include <vecmath/bbox.h>
 #include <vecmath/forward.h>
 #include <vecmath/mat.h>
 #include <vecmath/mat_ext.h>
@@ -48,6 +50,44 @@ namespace TrenchBroom
 {
 namespace Renderer
 {
+namespace
+{
+VertexArray makeWireframeBoxMesh()
+{
+  auto vertices = std::vector<GLVertexTypes::P3::Vertex>{};
+  vertices.reserve(24);
+
+  const auto box = vm::bbox3f{vm::vec3f::zero(), vm::vec3f::one()};
+  box.for_each_edge([&](const vm::vec3f& v1, const vm::vec3f& v2) {
+    vertices.emplace_back(v1);
+    vertices.emplace_back(v2);
+  });
+
+  return VertexArray::move(std::move(vertices));
+}
+
+VertexArray makeSolidBoxMesh()
+{
+  auto vertices = std::vector<GLVertexTypes::P3N::Vertex>{};
+  vertices.reserve(24);
+
+  const auto box = vm::bbox3f{vm::vec3f::zero(), vm::vec3f::one()};
+  box.for_each_face([&](
+                      const vm::vec3f& v1,
+                      const vm::vec3f& v2,
+                      const vm::vec3f& v3,
+                      const vm::vec3f& v4,
+                      const vm::vec3f& n) {
+    vertices.emplace_back(v1, n);
+    vertices.emplace_back(v2, n);
+    vertices.emplace_back(v3, n);
+    vertices.emplace_back(v4, n);
+  });
+
+  return VertexArray::move(std::move(vertices));
+}
+} // namespace
+
 class EntityRenderer::EntityClassnameAnchor : public TextAnchor3D
 {
 private:
@@ -77,6 +117,8 @@ EntityRenderer::EntityRenderer(
   const Model::EditorContext& editorContext)
   : m_entityModelManager(entityModelManager)
   , m_editorContext(editorContext)
+  , m_wireframeBoxMesh(makeWireframeBoxMesh())
+  , m_solidBoxMesh(makeSolidBoxMesh())
   , m_modelRenderer(logger, m_entityModelManager, m_editorContext)
   , m_boundsValid(false)
   , m_showOverlays(true)
@@ -266,7 +308,7 @@ void EntityRenderer::renderModels(RenderContext& renderContext, RenderBatch& ren
     m_modelRenderer.setApplyTinting(m_tint);
     m_modelRenderer.setTintColor(m_tintColor);
     m_modelRenderer.setShowHiddenEntities(m_showHiddenEntities);
-    m_modelRenderer.render(renderBatch);
+    m_modelRenderer.render(renderContext, renderBatch);
   }
 }
 
@@ -438,6 +480,67 @@ void EntityRenderer::invalidateBounds()
 }
 
 void EntityRenderer::validateBounds()
+{
+  if (GLEW_ARB_instanced_arrays)
+  {
+    validateBoundsInstances();
+  }
+  else
+  {
+    validateBoundsVertices();
+  }
+  m_boundsValid = true;
+}
+
+void EntityRenderer::validateBoundsInstances()
+{
+  using Instance = GLVertexTypes::BoxInstance::Vertex;
+  std::vector<Instance> pointEntityWireframeInstances;
+  std::vector<Instance> brushEntityWireframeInstances;
+  std::vector<Instance> solidInstances;
+
+  for (const Model::EntityNode* entityNode : m_entities)
+  {
+    if (m_editorContext.visible(entityNode))
+    {
+      const auto bounds = vm::bbox3f{entityNode->logicalBounds()};
+      const auto instance = Instance{bounds.min, bounds.size(), boundsColor(entityNode)};
+
+      const bool pointEntity = !entityNode->hasChildren();
+      const bool solid = pointEntity && entityNode->entity().model() == nullptr;
+      if (solid)
+      {
+        solidInstances.push_back(instance);
+      }
+
+      // without an overridden bounds color, solid bounds are not outlined
+      if (m_overrideBoundsColor || !solid)
+      {
+        if (pointEntity)
+        {
+          pointEntityWireframeInstances.push_back(instance);
+        }
+        else
+        {
+          brushEntityWireframeInstances.push_back(instance);
+        }
+      }
+    }
+  }
+
+  m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer(
+    m_wireframeBoxMesh,
+    VertexArray::move(std::move(pointEntityWireframeInstances)),
+    PrimType::Lines);
+  m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer(
+    m_wireframeBoxMesh,
+    VertexArray::move(std::move(brushEntityWireframeInstances)),
+    PrimType::Lines);
+  m_solidBoundsRenderer = TriangleRenderer(
+    m_solidBoxMesh, VertexArray::move(std::move(solidInstances)), PrimType::Quads);
+}
+
+void EntityRenderer::validateBoundsVertices()
 {
   std::vector<GLVertexTypes::P3NC4::Vertex> solidVertices;
   solidVertices.reserve(36 * m_entities.size());
@@ -532,7 +635,6 @@ void EntityRenderer::validateBounds()
 
   m_solidBoundsRenderer =
     TriangleRenderer(VertexArray::move(std::move(solidVertices)), PrimType::Quads);
-  m_boundsValid = true;
 }
 
 AttrString EntityRenderer::entityString(const Model::EntityNode* entityNode) const
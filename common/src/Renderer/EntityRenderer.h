@@ -24,6 +24,7 @@
 #include "Renderer/EntityModelRenderer.h"
 #include "Renderer/Renderable.h"
 #include "Renderer/TriangleRenderer.h"
+#include "Renderer/VertexArray.h"
 
 #include <kdl/vector_set.h>
 #include <vecmath/forward.h>
@@ -58,6 +59,9 @@ private:
   const Model::EditorContext& m_editorContext;
   kdl::vector_set<const Model::EntityNode*> m_entities;
 
+  VertexArray m_wireframeBoxMesh;
+  VertexArray m_solidBoxMesh;
+
   DirectEdgeRenderer m_pointEntityWireframeBoundsRenderer;
   DirectEdgeRenderer m_brushEntityWireframeBoundsRenderer;
 
@@ -148,6 +152,8 @@ private:
 
   void invalidateBounds();
   void validateBounds();
+  void validateBoundsInstances();
+  void validateBoundsVertices();
 
   AttrString entityString(const Model::EntityNode* entityNode) const;
   const Color& boundsColor(const Model::EntityNode* entityNode) const;
@@ -32,6 +32,10 @@
 #include "Renderer/ShaderManager.h"
 #include "Renderer/Shaders.h"
 
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
 namespace TrenchBroom
 {
 namespace Renderer
@@ -85,8 +89,19 @@ FaceRenderer::FaceRenderer(
   std::shared_ptr<BrushVertexArray> vertexArray,
   std::shared_ptr<TextureToBrushIndicesMap> indexArrayMap,
   const Color& faceColor)
+  : FaceRenderer(
+    std::move(vertexArray),
+    std::vector<std::shared_ptr<TextureToBrushIndicesMap>>{std::move(indexArrayMap)},
+    faceColor)
+{
+}
+
+FaceRenderer::FaceRenderer(
+  std::shared_ptr<BrushVertexArray> vertexArray,
+  std::vector<std::shared_ptr<TextureToBrushIndicesMap>> indexArrayMaps,
+  const Color& faceColor)
   : m_vertexArray(std::move(vertexArray))
-  , m_indexArrayMap(std::move(indexArrayMap))
+  , m_indexArrayMaps(std::move(indexArrayMaps))
   , m_faceColor(faceColor)
   , m_grayscale(false)
   , m_tint(false)
@@ -97,7 +112,8 @@ FaceRenderer::FaceRenderer(
 FaceRenderer::FaceRenderer(const FaceRenderer& other)
   : IndexedRenderable(other)
   , m_vertexArray(other.m_vertexArray)
-  , m_indexArrayMap(other.m_indexArrayMap)
+  , m_indexArrayMaps(other.m_indexArrayMaps)
+  , m_multiDraws(other.m_multiDraws)
   , m_faceColor(other.m_faceColor)
   , m_grayscale(other.m_grayscale)
   , m_tint(other.m_tint)
@@ -117,7 +133,8 @@ void swap(FaceRenderer& left, FaceRenderer& right)
 {
   using std::swap;
   swap(left.m_vertexArray, right.m_vertexArray);
-  swap(left.m_indexArrayMap, right.m_indexArrayMap);
+  swap(left.m_indexArrayMaps, right.m_indexArrayMaps);
+  swap(left.m_multiDraws, right.m_multiDraws);
   swap(left.m_faceColor, right.m_faceColor);
   swap(left.m_grayscale, right.m_grayscale);
   swap(left.m_tint, right.m_tint);
@@ -154,21 +171,62 @@ void FaceRenderer::prepareVerticesAndIndices(VboManager& vboManager)
 {
   m_vertexArray->prepare(vboManager);
 
-  for (const auto& [texture, brushIndexHolderPtr] : *m_indexArrayMap)
+  // group the index arrays by texture so that every texture is only activated once, and
+  // by pool so that the index arrays of every pool are drawn together
+  auto indexArraysByTexture =
+    std::vector<std::tuple<const Assets::Texture*, const BrushIndexArray*>>{};
+  for (const auto& indexArrayMap : m_indexArrayMaps)
   {
-    brushIndexHolderPtr->prepare(vboManager);
+    for (const auto& [texture, brushIndexHolderPtr] : *indexArrayMap)
+    {
+      if (brushIndexHolderPtr->hasValidIndices())
+      {
+        indexArraysByTexture.emplace_back(texture, brushIndexHolderPtr.get());
+      }
+    }
+  }
+
+  std::sort(
+    indexArraysByTexture.begin(),
+    indexArraysByTexture.end(),
+    [](const auto& lhs, const auto& rhs) {
+      return std::make_tuple(std::get<0>(lhs), std::get<1>(lhs)->pool().get())
+             < std::make_tuple(std::get<0>(rhs), std::get<1>(rhs)->pool().get());
+    });
+
+  m_multiDraws.clear();
+  for (const auto& [texture, brushIndexHolder] : indexArraysByTexture)
+  {
+    if (
+      m_multiDraws.empty() || std::get<0>(m_multiDraws.back()) != texture
+      || std::get<1>(m_multiDraws.back())->pool() != brushIndexHolder->pool())
+    {
+      m_multiDraws.emplace_back(
+        texture,
+        std::make_shared<BrushMultiDraw>(
+          brushIndexHolder->pool(), m_vertexArray->compact()));
+    }
+    std::get<1>(m_multiDraws.back())->add(*brushIndexHolder);
+  }
+
+  for (const auto& [texture, multiDraw] : m_multiDraws)
+  {
+    multiDraw->prepare(vboManager);
   }
 }
 
 void FaceRenderer::doRender(RenderContext& context)
 {
-  if (m_indexArrayMap->empty())
+  if (m_multiDraws.empty())
     return;
 
   if (m_vertexArray->setupVertices())
   {
     ShaderManager& shaderManager = context.shaderManager();
-    ActiveShader shader(shaderManager, Shaders::FaceShader);
+    ActiveShader shader(
+      shaderManager,
+      m_vertexArray->compact() ? Shaders::CompactFaceShader : Shaders::FaceShader);
+    auto& program = *shaderManager.currentProgram();
     PreferenceManager& prefs = PreferenceManager::instance();
 
     const bool applyTexture = context.showTextures();
@@ -208,13 +266,10 @@ void FaceRenderer::doRender(RenderContext& context)
     {
       glAssert(glDepthMask(GL_FALSE));
     }
-    for (const auto& [texture, brushIndexHolderPtr] : *m_indexArrayMap)
+    size_t nextI;
+    for (size_t i = 0; i < m_multiDraws.size(); i = nextI)
     {
-      if (!brushIndexHolderPtr->hasValidIndices())
-      {
-        continue;
-      }
-
+      const auto* texture = std::get<0>(m_multiDraws[i]);
       const bool enableMasked = texture != nullptr && texture->masked();
 
       // set any per-texture uniforms
@@ -222,9 +277,14 @@ void FaceRenderer::doRender(RenderContext& context)
       shader.set("EnableMasked", enableMasked);
 
       func.before(texture);
-      brushIndexHolderPtr->setupIndices();
-      brushIndexHolderPtr->render(PrimType::Triangles);
-      brushIndexHolderPtr->cleanupIndices();
+      for (nextI = i;
+           nextI < m_multiDraws.size() && std::get<0>(m_multiDraws[nextI]) == texture;
+           ++nextI)
+      {
+        auto& multiDraw = *std::get<1>(m_multiDraws[nextI]);
+        context.countDrawCalls(multiDraw.render(PrimType::Triangles, program));
+        context.countDrawnVertices(multiDraw.indexCount());
+      }
       func.after(texture);
     }
     if (m_alpha < 1.0f)
@@ -26,7 +26,9 @@
 #include <vecmath/vec.h>
 
 #include <memory>
+#include <tuple>
 #include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom
 {
@@ -38,6 +40,7 @@ class Texture;
 namespace Renderer
 {
 class BrushIndexArray;
+class BrushMultiDraw;
 class BrushVertexArray;
 class RenderBatch;
 
@@ -50,7 +53,16 @@ private:
     const std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
 
   std::shared_ptr<BrushVertexArray> m_vertexArray;
-  std::shared_ptr<TextureToBrushIndicesMap> m_indexArrayMap;
+  std::vector<std::shared_ptr<TextureToBrushIndicesMap>> m_indexArrayMaps;
+
+  /**
+   * The index arrays grouped by texture and by their index pool, see BrushMultiDraw.
+   * These are rebuilt whenever the renderer is prepared. They don't own any buffers, the
+   * indirect draw commands are kept by the index pools.
+   */
+  std::vector<std::tuple<const Assets::Texture*, std::shared_ptr<BrushMultiDraw>>>
+    m_multiDraws;
+
   Color m_faceColor;
   bool m_grayscale;
   bool m_tint;
@@ -64,6 +76,16 @@ public:
     std::shared_ptr<TextureToBrushIndicesMap> indexArrayMap,
     const Color& faceColor);
 
+  /**
+   * Renders the faces of all of the given maps. Each texture is only activated once,
+   * regardless of how many of the maps contain indices for it, and the index arrays of a
+   * texture which share an index pool are drawn with a single multi draw call.
+   */
+  FaceRenderer(
+    std::shared_ptr<BrushVertexArray> vertexArray,
+    std::vector<std::shared_ptr<TextureToBrushIndicesMap>> indexArrayMaps,
+    const Color& faceColor);
+
   FaceRenderer(const FaceRenderer& other);
   FaceRenderer& operator=(FaceRenderer other);
   friend void swap(FaceRenderer& left, FaceRenderer& right);
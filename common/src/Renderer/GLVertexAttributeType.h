@@ -81,6 +81,51 @@ public:
   deleteCopyAndMove(GLVertexAttributeUser);
 };
 
+/**
+ * User defined per instance vertex attribute types. These behave like user defined vertex
+ * attributes, except that the attribute advances once per instance instead of once per
+ * vertex when rendering with VertexArray::renderInstances.
+ *
+ * Requires the ARB_instanced_arrays extension.
+ *
+ * @tparam A class containing the attribute name in a `static inline const std::string`
+ * member called `name`
+ * @tparam D the vertex component type
+ * @tparam S the number of components
+ * @tparam N whether to normalize signed integer types to [-1..1] and unsigned to [0..1]
+ */
+template <class A, GLenum D, size_t S, bool N>
+class GLVertexAttributeInstance
+{
+public:
+  using ComponentType = typename GLType<D>::Type;
+  using ElementType = vm::vec<ComponentType, S>;
+  static const size_t Size = sizeof(ElementType);
+
+  static void setup(
+    ShaderProgram* program, const size_t index, const size_t stride, const size_t offset)
+  {
+    GLVertexAttributeUser<A, D, S, N>::setup(program, index, stride, offset);
+
+    const GLint attributeIndex = program->findAttributeLocation(A::name);
+    glAssert(glVertexAttribDivisorARB(static_cast<GLuint>(attributeIndex), 1));
+  }
+
+  static void cleanup(ShaderProgram* program, const size_t index)
+  {
+    ensure(program != nullptr, "must have a program bound to use generic attributes");
+
+    const GLint attributeIndex = program->findAttributeLocation(A::name);
+    glAssert(glVertexAttribDivisorARB(static_cast<GLuint>(attributeIndex), 0));
+
+    GLVertexAttributeUser<A, D, S, N>::cleanup(program, index);
+  }
+
+  // Non-instantiable
+  GLVertexAttributeInstance() = delete;
+  deleteCopyAndMove(GLVertexAttributeInstance);
+};
+
 /**
  * Vertex position attribute types.
  *
@@ -24,6 +24,8 @@
 
 #include <vecmath/forward.h>
 
+#include <string>
+
 namespace TrenchBroom
 {
 namespace Renderer
@@ -198,6 +200,86 @@ using P3NT2 = GLVertexType<
   GLVertexAttributeTypes::P3,
   GLVertexAttributeTypes::N,
   GLVertexAttributeTypes::T02>;
+
+/**
+ * A compressed brush vertex of 16 bytes. The position is stored as three quantized
+ * offsets from an origin and a power of two exponent to scale them with. The texture
+ * coordinates are stored as the bits of two half floats, followed by the octahedral
+ * encoding of the normal. Refer to BrushVertexArray for the encoding and to
+ * CompactBrushVertex.vertsh for the decoding.
+ */
+using CompactBrushVertex = GLVertexType<
+  GLVertexAttributePosition<GL_SHORT, 4>,
+  GLVertexAttributeTexCoord0<GL_SHORT, 4>>;
+
+struct BoxMinName
+{
+  static inline const auto name = std::string{"boxMin"};
+};
+struct BoxSizeName
+{
+  static inline const auto name = std::string{"boxSize"};
+};
+struct BoxColorName
+{
+  static inline const auto name = std::string{"boxColor"};
+};
+struct HandlePositionName
+{
+  static inline const auto name = std::string{"handlePosition"};
+};
+struct ChunkOriginName
+{
+  static inline const auto name = std::string{"chunkOrigin"};
+};
+struct ModelMatrix0Name
+{
+  static inline const auto name = std::string{"modelMatrix0"};
+};
+struct ModelMatrix1Name
+{
+  static inline const auto name = std::string{"modelMatrix1"};
+};
+struct ModelMatrix2Name
+{
+  static inline const auto name = std::string{"modelMatrix2"};
+};
+struct ModelMatrix3Name
+{
+  static inline const auto name = std::string{"modelMatrix3"};
+};
+
+/**
+ * Per instance data for rendering a unit box mesh scaled and translated into an axis
+ * aligned box with the given minimum corner, size and color.
+ */
+using BoxInstance = GLVertexType<
+  GLVertexAttributeInstance<BoxMinName, GL_FLOAT, 3, false>,
+  GLVertexAttributeInstance<BoxSizeName, GL_FLOAT, 3, false>,
+  GLVertexAttributeInstance<BoxColorName, GL_FLOAT, 4, false>>;
+
+/**
+ * Per instance data for rendering a screen space handle mesh at the given world position.
+ */
+using HandleInstance =
+  GLVertexType<GLVertexAttributeInstance<HandlePositionName, GL_FLOAT, 3, false>>;
+
+/**
+ * Per instance data for rendering compact brush vertices relative to the given chunk
+ * origin, see BrushMultiDraw.
+ */
+using ChunkOriginInstance =
+  GLVertexType<GLVertexAttributeInstance<ChunkOriginName, GL_FLOAT, 3, false>>;
+
+/**
+ * Per instance data for rendering an entity model with the given model matrix, stored as
+ * its four columns.
+ */
+using ModelInstance = GLVertexType<
+  GLVertexAttributeInstance<ModelMatrix0Name, GL_FLOAT, 4, false>,
+  GLVertexAttributeInstance<ModelMatrix1Name, GL_FLOAT, 4, false>,
+  GLVertexAttributeInstance<ModelMatrix2Name, GL_FLOAT, 4, false>,
+  GLVertexAttributeInstance<ModelMatrix3Name, GL_FLOAT, 4, false>>;
 } // namespace GLVertexTypes
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -0,0 +1,165 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GpuTimer.h"
+
+#include <cassert>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+namespace
+{
+/**
+ * If the GPU falls this many frames behind, the oldest frame's intervals are discarded.
+ */
+constexpr auto MaxPendingFrames = size_t(4);
+
+double timeBetween(const GLuint beginQuery, const GLuint endQuery)
+{
+  auto begin = GLuint64(0);
+  auto end = GLuint64(0);
+  glAssert(glGetQueryObjectui64v(beginQuery, GL_QUERY_RESULT, &begin));
+  glAssert(glGetQueryObjectui64v(endQuery, GL_QUERY_RESULT, &end));
+
+  // timestamps are in nanoseconds
+  return end > begin ? double(end - begin) / 1'000'000.0 : 0.0;
+}
+} // namespace
+
+GpuTimer::GpuTimer() = default;
+
+GpuTimer::~GpuTimer()
+{
+  assert(m_allQueries.empty());
+}
+
+void GpuTimer::free()
+{
+  if (!m_allQueries.empty())
+  {
+    glAssert(glDeleteQueries(GLsizei(m_allQueries.size()), m_allQueries.data()));
+  }
+
+  m_allQueries.clear();
+  m_freeQueries.clear();
+  m_currentFrame.clear();
+  m_pendingFrames.clear();
+  m_elapsedTimes.clear();
+}
+
+bool GpuTimer::supported()
+{
+  if (!m_supported)
+  {
+    m_supported = bool(GLEW_ARB_timer_query);
+  }
+  return *m_supported;
+}
+
+size_t GpuTimer::begin(std::string name)
+{
+  assert(supported());
+
+  const auto beginQuery = acquireQuery();
+  const auto endQuery = acquireQuery();
+  glAssert(glQueryCounter(beginQuery, GL_TIMESTAMP));
+
+  m_currentFrame.push_back(Interval{std::move(name), beginQuery, endQuery});
+  return m_currentFrame.size() - 1u;
+}
+
+void GpuTimer::end(const size_t index)
+{
+  assert(index < m_currentFrame.size());
+  glAssert(glQueryCounter(m_currentFrame[index].endQuery, GL_TIMESTAMP));
+}
+
+void GpuTimer::endFrame()
+{
+  if (!m_currentFrame.empty())
+  {
+    m_pendingFrames.push_back(std::move(m_currentFrame));
+    m_currentFrame.clear();
+  }
+
+  while (!m_pendingFrames.empty() && available(m_pendingFrames.front()))
+  {
+    for (const auto& interval : m_pendingFrames.front())
+    {
+      m_elapsedTimes[interval.name] = timeBetween(interval.beginQuery, interval.endQuery);
+    }
+    releaseQueries(m_pendingFrames.front());
+    m_pendingFrames.pop_front();
+  }
+
+  while (m_pendingFrames.size() > MaxPendingFrames)
+  {
+    releaseQueries(m_pendingFrames.front());
+    m_pendingFrames.pop_front();
+  }
+}
+
+std::optional<double> GpuTimer::elapsedTime(const std::string& name) const
+{
+  const auto it = m_elapsedTimes.find(name);
+  return it != std::end(m_elapsedTimes) ? std::optional<double>{it->second}
+                                        : std::nullopt;
+}
+
+GLuint GpuTimer::acquireQuery()
+{
+  if (m_freeQueries.empty())
+  {
+    auto query = GLuint(0);
+    glAssert(glGenQueries(1, &query));
+    m_allQueries.push_back(query);
+    return query;
+  }
+
+  const auto query = m_freeQueries.back();
+  m_freeQueries.pop_back();
+  return query;
+}
+
+void GpuTimer::releaseQueries(const std::vector<Interval>& intervals)
+{
+  for (const auto& interval : intervals)
+  {
+    m_freeQueries.push_back(interval.beginQuery);
+    m_freeQueries.push_back(interval.endQuery);
+  }
+}
+
+bool GpuTimer::available(const std::vector<Interval>& intervals) const
+{
+  for (const auto& interval : intervals)
+  {
+    auto result = GLint(0);
+    glAssert(glGetQueryObjectiv(interval.endQuery, GL_QUERY_RESULT_AVAILABLE, &result));
+    if (result == GL_FALSE)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace Renderer
+} // namespace TrenchBroom
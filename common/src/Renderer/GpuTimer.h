@@ -0,0 +1,107 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+#include "Renderer/GL.h"
+
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+/**
+ * Measures the GPU time of named intervals using timestamp queries.
+ *
+ * Query results become available asynchronously, so the intervals of a frame are only
+ * evaluated once the GPU has finished executing them. Until then, `elapsedTime` returns
+ * the measurements of an earlier frame. If timer queries are not supported, no intervals
+ * are measured.
+ *
+ * All functions must be called while the OpenGL context is current. The queries must be
+ * deleted by calling `free` before the timer is destroyed, since the destructor cannot
+ * make sure that the context is current.
+ */
+class GpuTimer
+{
+private:
+  struct Interval
+  {
+    std::string name;
+    GLuint beginQuery;
+    GLuint endQuery;
+  };
+
+  std::optional<bool> m_supported;
+  std::vector<GLuint> m_allQueries;
+  std::vector<GLuint> m_freeQueries;
+  std::vector<Interval> m_currentFrame;
+  std::deque<std::vector<Interval>> m_pendingFrames;
+  std::unordered_map<std::string, double> m_elapsedTimes;
+
+public:
+  GpuTimer();
+  ~GpuTimer();
+
+  /**
+   * Deletes all queries with glDeleteQueries and discards all measurements. Must be
+   * called before the destructor while the OpenGL context is current.
+   */
+  void free();
+
+  /**
+   * Indicates whether the OpenGL implementation supports timestamp queries.
+   */
+  bool supported();
+
+  /**
+   * Starts measuring an interval with the given name and returns its index, which must
+   * be passed to `end`.
+   */
+  size_t begin(std::string name);
+  void end(size_t index);
+
+  /**
+   * Hands over the intervals of the current frame for evaluation and evaluates the
+   * intervals of all earlier frames whose results are available, without blocking.
+   */
+  void endFrame();
+
+  /**
+   * Returns the most recently measured GPU time in milliseconds for the interval with the
+   * given name, if any.
+   */
+  std::optional<double> elapsedTime(const std::string& name) const;
+
+private:
+  GLuint acquireQuery();
+  void releaseQueries(const std::vector<Interval>& intervals);
+  bool available(const std::vector<Interval>& intervals) const;
+
+  deleteCopyAndMove(GpuTimer);
+};
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -185,6 +185,15 @@ void IndexRangeMap::render(VertexArray& vertexArray) const
   }
 }
 
+void IndexRangeMap::renderInstances(
+  VertexArray& vertexArray, VertexArray& instanceArray) const
+{
+  forEachPrimitive([&](const auto primType, const auto index, const auto count) {
+    vertexArray.renderInstances(
+      primType, static_cast<GLint>(index), static_cast<GLsizei>(count), instanceArray);
+  });
+}
+
 void IndexRangeMap::forEachPrimitive(
   std::function<void(PrimType, size_t, size_t)> func) const
 {
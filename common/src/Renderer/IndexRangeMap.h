@@ -158,6 +158,15 @@ public:
    */
   void render(VertexArray& vertexArray) const;
 
+  /**
+   * Renders the primitives stored in this index range map once for every vertex of the
+   * given instance array.
+   *
+   * @param vertexArray the vertex array to render with
+   * @param instanceArray the per instance attributes
+   */
+  void renderInstances(VertexArray& vertexArray, VertexArray& instanceArray) const;
+
   /**
    * Invokes the given function for each primitive stored in this map.
    *
@@ -36,8 +36,10 @@
 #include "Renderer/EntityLinkRenderer.h"
 #include "Renderer/GroupLinkRenderer.h"
 #include "Renderer/ObjectRenderer.h"
+#include "Renderer/OcclusionCuller.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
+#include "Renderer/RenderPassTimer.h"
 #include "Renderer/RenderUtils.h"
 #include "View/MapDocument.h"
 #include "View/Selection.h"
@@ -229,16 +231,46 @@ void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
   commitPendingChanges();
   setupGL(renderBatch);
-  renderDefaultOpaque(renderContext, renderBatch);
-  renderLockedOpaque(renderContext, renderBatch);
-  renderSelectionOpaque(renderContext, renderBatch);
+  if (auto* occlusionCuller = renderContext.occlusionCuller())
+  {
+    const auto timer = RenderPassTimer{renderContext, renderBatch, "Occluders"};
+    renderOccluders(renderContext, *occlusionCuller);
+  }
+  {
+    const auto timer = RenderPassTimer{renderContext, renderBatch, "Default opaque"};
+    renderDefaultOpaque(renderContext, renderBatch);
+  }
+  {
+    const auto timer = RenderPassTimer{renderContext, renderBatch, "Locked opaque"};
+    renderLockedOpaque(renderContext, renderBatch);
+  }
+  {
+    const auto timer = RenderPassTimer{renderContext, renderBatch, "Selection opaque"};
+    renderSelectionOpaque(renderContext, renderBatch);
+  }
 
-  renderDefaultTransparent(renderContext, renderBatch);
-  renderLockedTransparent(renderContext, renderBatch);
-  renderSelectionTransparent(renderContext, renderBatch);
+  {
+    const auto timer = RenderPassTimer{renderContext, renderBatch, "Default transparent"};
+    renderDefaultTransparent(renderContext, renderBatch);
+  }
+  {
+    const auto timer = RenderPassTimer{renderContext, renderBatch, "Locked transparent"};
+    renderLockedTransparent(renderContext, renderBatch);
+  }
+  {
+    const auto timer =
+      RenderPassTimer{renderContext, renderBatch, "Selection transparent"};
+    renderSelectionTransparent(renderContext, renderBatch);
+  }
 
-  renderEntityLinks(renderContext, renderBatch);
-  renderGroupLinks(renderContext, renderBatch);
+  {
+    const auto timer = RenderPassTimer{renderContext, renderBatch, "Entity links"};
+    renderEntityLinks(renderContext, renderBatch);
+  }
+  {
+    const auto timer = RenderPassTimer{renderContext, renderBatch, "Group links"};
+    renderGroupLinks(renderContext, renderBatch);
+  }
 }
 
 void MapRenderer::commitPendingChanges()
@@ -265,6 +297,19 @@ void MapRenderer::setupGL(RenderBatch& renderBatch)
   renderBatch.addOneShot(new SetupGL{});
 }
 
+/**
+ * Only unselected objects are used as occluders, since selected objects change often and
+ * may be rendered on top of other objects.
+ */
+void MapRenderer::renderOccluders(
+  RenderContext& renderContext, OcclusionCuller& occlusionCuller)
+{
+  occlusionCuller.beginFrame(renderContext.camera());
+  m_defaultRenderer->addOccluders(renderContext, occlusionCuller);
+  m_lockedRenderer->addOccluders(renderContext, occlusionCuller);
+  occlusionCuller.endFrame();
+}
+
 void MapRenderer::renderDefaultOpaque(
   RenderContext& renderContext, RenderBatch& renderBatch)
 {
@@ -342,6 +387,7 @@ void MapRenderer::setupDefaultRenderer(ObjectRenderer& renderer)
 
   renderer.setBrushFaceColor(pref(Preferences::FaceColor));
   renderer.setBrushEdgeColor(pref(Preferences::EdgeColor));
+  renderer.setCompactBrushVertices(pref(Preferences::CompactBrushVertices));
 }
 
 void MapRenderer::setupSelectionRenderer(ObjectRenderer& renderer)
@@ -367,6 +413,7 @@ void MapRenderer::setupSelectionRenderer(ObjectRenderer& renderer)
 
   renderer.setBrushFaceColor(pref(Preferences::FaceColor));
   renderer.setBrushEdgeColor(pref(Preferences::SelectedEdgeColor));
+  renderer.setCompactBrushVertices(pref(Preferences::CompactBrushVertices));
 }
 
 void MapRenderer::setupLockedRenderer(ObjectRenderer& renderer)
@@ -388,6 +435,7 @@ void MapRenderer::setupLockedRenderer(ObjectRenderer& renderer)
 
   renderer.setBrushFaceColor(pref(Preferences::FaceColor));
   renderer.setBrushEdgeColor(pref(Preferences::LockedEdgeColor));
+  renderer.setCompactBrushVertices(pref(Preferences::CompactBrushVertices));
 }
 
 static bool selected(const Model::Node* node)
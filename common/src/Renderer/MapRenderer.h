@@ -56,6 +56,7 @@ namespace Renderer
 class EntityLinkRenderer;
 class GroupLinkRenderer;
 class ObjectRenderer;
+class OcclusionCuller;
 class RenderBatch;
 class RenderContext;
 
@@ -107,6 +108,7 @@ public: // rendering
 private:
   void commitPendingChanges();
   void setupGL(RenderBatch& renderBatch);
+  void renderOccluders(RenderContext& renderContext, OcclusionCuller& occlusionCuller);
   void renderDefaultOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderDefaultTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderSelectionOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
@@ -189,6 +189,11 @@ void ObjectRenderer::setBrushEdgeColor(const Color& brushEdgeColor)
   m_patchRenderer.setEdgeColor(brushEdgeColor);
 }
 
+void ObjectRenderer::setCompactBrushVertices(const bool compactBrushVertices)
+{
+  m_brushRenderer.setCompactVertices(compactBrushVertices);
+}
+
 void ObjectRenderer::setShowHiddenObjects(const bool showHiddenObjects)
 {
   m_entityRenderer.setShowHiddenEntities(showHiddenObjects);
@@ -208,5 +213,11 @@ void ObjectRenderer::renderTransparent(
 {
   m_brushRenderer.renderTransparent(renderContext, renderBatch);
 }
+
+void ObjectRenderer::addOccluders(
+  RenderContext& renderContext, OcclusionCuller& occlusionCuller)
+{
+  m_brushRenderer.addOccluders(renderContext, occlusionCuller);
+}
 } // namespace Renderer
 } // namespace TrenchBroom
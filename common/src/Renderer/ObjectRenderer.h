@@ -50,6 +50,7 @@ class PatchNode;
 namespace Renderer
 {
 class FontManager;
+class OcclusionCuller;
 class RenderBatch;
 
 class ObjectRenderer
@@ -108,12 +109,14 @@ public: // configuration
   void setShowBrushEdges(bool showBrushEdges);
   void setBrushFaceColor(const Color& brushFaceColor);
   void setBrushEdgeColor(const Color& brushEdgeColor);
+  void setCompactBrushVertices(bool compactBrushVertices);
 
   void setShowHiddenObjects(bool showHiddenObjects);
 
 public: // rendering
   void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
   void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
+  void addOccluders(RenderContext& renderContext, OcclusionCuller& occlusionCuller);
 
   deleteCopy(ObjectRenderer);
 };
@@ -0,0 +1,352 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OcclusionCuller.h"
+
+#include "Renderer/Camera.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+namespace
+{
+/**
+ * Clips the given polygon in clip space against the near plane.
+ */
+std::vector<vm::vec4f> clipAgainstNearPlane(const std::vector<vm::vec4f>& polygon)
+{
+  auto result = std::vector<vm::vec4f>{};
+  result.reserve(polygon.size() + 1u);
+
+  for (size_t i = 0; i < polygon.size(); ++i)
+  {
+    const auto& p0 = polygon[i];
+    const auto& p1 = polygon[(i + 1u) % polygon.size()];
+
+    // the distance of the points to the near plane z = -w
+    const auto d0 = p0.z() + p0.w();
+    const auto d1 = p1.z() + p1.w();
+
+    if (d0 >= 0.0f)
+    {
+      result.push_back(p0);
+    }
+    if ((d0 >= 0.0f) != (d1 >= 0.0f))
+    {
+      result.push_back(vm::mix(p0, p1, vm::vec4f::fill(d0 / (d0 - d1))));
+    }
+  }
+
+  return result;
+}
+} // namespace
+
+OcclusionCuller::OcclusionCuller()
+  : m_width{0u}
+  , m_height{0u}
+  , m_occluderCount{0u}
+  , m_ready{false}
+{
+}
+
+void OcclusionCuller::beginFrame(const Camera& camera)
+{
+  m_viewProjectionMatrix = camera.projectionMatrix() * camera.viewMatrix();
+
+  const auto& viewport = camera.viewport();
+  const auto aspect = viewport.width > 0 ? static_cast<float>(viewport.height)
+                                             / static_cast<float>(viewport.width)
+                                         : 1.0f;
+  m_width = Width;
+  m_height = std::clamp(
+    static_cast<size_t>(std::round(static_cast<float>(Width) * aspect)),
+    size_t(1),
+    4u * Width);
+
+  auto levelCount = size_t(1);
+  while (levelWidth(levelCount - 1u) > 1u || levelHeight(levelCount - 1u) > 1u)
+  {
+    ++levelCount;
+  }
+
+  m_levels.resize(levelCount);
+  for (size_t level = 0; level < levelCount; ++level)
+  {
+    m_levels[level].assign(levelWidth(level) * levelHeight(level), 1.0f);
+  }
+
+  m_occluderCount = 0u;
+  m_ready = false;
+}
+
+void OcclusionCuller::addOccluder(const std::vector<vm::vec3f>& polygon)
+{
+  assert(!m_ready);
+  if (full())
+  {
+    return;
+  }
+
+  auto clipPolygon = std::vector<vm::vec4f>{};
+  clipPolygon.reserve(polygon.size());
+  for (const auto& point : polygon)
+  {
+    clipPolygon.push_back(m_viewProjectionMatrix * vm::vec4f{point, 1.0f});
+  }
+
+  clipPolygon = clipAgainstNearPlane(clipPolygon);
+  if (clipPolygon.size() < 3u)
+  {
+    return;
+  }
+
+  // transform to pixel coordinates and normalized depth
+  auto screenPolygon = std::vector<vm::vec3f>{};
+  screenPolygon.reserve(clipPolygon.size());
+  for (const auto& point : clipPolygon)
+  {
+    const auto ndc = vm::vec3f{point.x(), point.y(), point.z()} / point.w();
+    screenPolygon.emplace_back(
+      (ndc.x() * 0.5f + 0.5f) * static_cast<float>(m_width),
+      (ndc.y() * 0.5f + 0.5f) * static_cast<float>(m_height),
+      ndc.z());
+  }
+
+  // find the largest triangle of the polygon's fan to determine its depth plane
+  auto area = 0.0f;
+  auto largestArea = 0.0f;
+  auto largestIndex = size_t(1);
+  const auto& p0 = screenPolygon[0];
+  for (size_t i = 1; i + 1u < screenPolygon.size(); ++i)
+  {
+    const auto& p1 = screenPolygon[i];
+    const auto& p2 = screenPolygon[i + 1u];
+    const auto triangleArea =
+      (p1.x() - p0.x()) * (p2.y() - p0.y()) - (p2.x() - p0.x()) * (p1.y() - p0.y());
+    area += triangleArea;
+    if (std::abs(triangleArea) > std::abs(largestArea))
+    {
+      largestArea = triangleArea;
+      largestIndex = i;
+    }
+  }
+
+  if (std::abs(largestArea) < 1e-3f)
+  {
+    // the polygon is degenerate or seen edge on
+    return;
+  }
+
+  // depth = depthX * x + depthY * y + depthC
+  const auto& p1 = screenPolygon[largestIndex];
+  const auto& p2 = screenPolygon[largestIndex + 1u];
+  const auto depthX = ((p1.z() - p0.z()) * (p2.y() - p0.y())
+                       - (p2.z() - p0.z()) * (p1.y() - p0.y()))
+                      / largestArea;
+  const auto depthY = ((p1.x() - p0.x()) * (p2.z() - p0.z())
+                       - (p2.x() - p0.x()) * (p1.z() - p0.z()))
+                      / largestArea;
+  const auto depthC = p0.z() - depthX * p0.x() - depthY * p0.y();
+
+  // edge functions a * x + b * y + c which are non-negative inside of the polygon
+  const auto orientation = area > 0.0f ? 1.0f : -1.0f;
+  auto edges = std::vector<vm::vec3f>{};
+  edges.reserve(screenPolygon.size());
+
+  auto min = vm::vec2f::fill(std::numeric_limits<float>::max());
+  auto max = vm::vec2f::fill(std::numeric_limits<float>::lowest());
+  for (size_t i = 0; i < screenPolygon.size(); ++i)
+  {
+    const auto& e0 = screenPolygon[i];
+    const auto& e1 = screenPolygon[(i + 1u) % screenPolygon.size()];
+    const auto a = -orientation * (e1.y() - e0.y());
+    const auto b = orientation * (e1.x() - e0.x());
+    edges.emplace_back(a, b, -(a * e0.x() + b * e0.y()));
+
+    min = vm::min(min, e0.xy());
+    max = vm::max(max, e0.xy());
+  }
+
+  const auto toPixel = [](const float f, const size_t size) {
+    return static_cast<size_t>(std::clamp(f, 0.0f, static_cast<float>(size - 1u)));
+  };
+  const auto x0 = toPixel(std::floor(min.x()), m_width);
+  const auto x1 = toPixel(std::ceil(max.x()) - 1.0f, m_width);
+  const auto y0 = toPixel(std::floor(min.y()), m_height);
+  const auto y1 = toPixel(std::ceil(max.y()) - 1.0f, m_height);
+
+  // only write pixels which are entirely covered by the polygon, and use the farthest
+  // depth of the polygon within the pixel, so that the depth buffer is conservative
+  const auto maxDepthOffset = std::max(depthX, 0.0f) + std::max(depthY, 0.0f);
+  for (size_t y = y0; y <= y1; ++y)
+  {
+    const auto fy = static_cast<float>(y);
+    for (size_t x = x0; x <= x1; ++x)
+    {
+      const auto fx = static_cast<float>(x);
+      const auto covered = std::all_of(edges.begin(), edges.end(), [&](const auto& e) {
+        return e.x() * fx + e.y() * fy + e.z() + std::min(e.x(), 0.0f)
+                 + std::min(e.y(), 0.0f)
+               >= 0.0f;
+      });
+
+      if (covered)
+      {
+        auto& d = depth(0u, x, y);
+        d = std::min(d, depthX * fx + depthY * fy + depthC + maxDepthOffset);
+      }
+    }
+  }
+
+  ++m_occluderCount;
+}
+
+void OcclusionCuller::endFrame()
+{
+  for (size_t level = 1; level < m_levels.size(); ++level)
+  {
+    const auto belowWidth = levelWidth(level - 1u);
+    const auto belowHeight = levelHeight(level - 1u);
+    for (size_t y = 0; y < levelHeight(level); ++y)
+    {
+      for (size_t x = 0; x < levelWidth(level); ++x)
+      {
+        auto farthest = depth(level - 1u, 2u * x, 2u * y);
+        if (2u * x + 1u < belowWidth)
+        {
+          farthest = std::max(farthest, depth(level - 1u, 2u * x + 1u, 2u * y));
+        }
+        if (2u * y + 1u < belowHeight)
+        {
+          farthest = std::max(farthest, depth(level - 1u, 2u * x, 2u * y + 1u));
+          if (2u * x + 1u < belowWidth)
+          {
+            farthest = std::max(farthest, depth(level - 1u, 2u * x + 1u, 2u * y + 1u));
+          }
+        }
+        depth(level, x, y) = farthest;
+      }
+    }
+  }
+  m_ready = true;
+}
+
+size_t OcclusionCuller::occluderCount() const
+{
+  return m_occluderCount;
+}
+
+bool OcclusionCuller::full() const
+{
+  return m_occluderCount >= MaxOccluderCount;
+}
+
+bool OcclusionCuller::occludes(const vm::bbox3f& bounds) const
+{
+  if (!m_ready || m_occluderCount == 0u)
+  {
+    return false;
+  }
+
+  auto min = vm::vec3f::fill(std::numeric_limits<float>::max());
+  auto max = vm::vec3f::fill(std::numeric_limits<float>::lowest());
+  for (const auto& corner : bounds.vertices())
+  {
+    const auto clipCorner = m_viewProjectionMatrix * vm::vec4f{corner, 1.0f};
+    if (clipCorner.w() <= 0.0f || clipCorner.z() < -clipCorner.w())
+    {
+      // the box intersects the near plane
+      return false;
+    }
+
+    const auto ndc =
+      vm::vec3f{clipCorner.x(), clipCorner.y(), clipCorner.z()} / clipCorner.w();
+    min = vm::min(min, ndc);
+    max = vm::max(max, ndc);
+  }
+
+  if (max.x() < -1.0f || min.x() > 1.0f || max.y() < -1.0f || min.y() > 1.0f)
+  {
+    return false;
+  }
+
+  const auto toPixel = [](const float f, const size_t size) {
+    return static_cast<size_t>(std::clamp(
+      (f * 0.5f + 0.5f) * static_cast<float>(size), 0.0f, static_cast<float>(size - 1u)));
+  };
+  const auto x0 = toPixel(min.x(), m_width);
+  const auto x1 = toPixel(max.x(), m_width);
+  const auto y0 = toPixel(min.y(), m_height);
+  const auto y1 = toPixel(max.y(), m_height);
+
+  // choose the level where the box covers at most two by two pixels
+  auto level = size_t(0);
+  while (level + 1u < m_levels.size()
+         && ((x1 >> level) - (x0 >> level) > 1u || (y1 >> level) - (y0 >> level) > 1u))
+  {
+    ++level;
+  }
+
+  for (size_t y = y0 >> level; y <= y1 >> level; ++y)
+  {
+    for (size_t x = x0 >> level; x <= x1 >> level; ++x)
+    {
+      if (min.z() <= depth(level, x, y))
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+float& OcclusionCuller::depth(const size_t level, const size_t x, const size_t y)
+{
+  assert(x < levelWidth(level) && y < levelHeight(level));
+  return m_levels[level][y * levelWidth(level) + x];
+}
+
+float OcclusionCuller::depth(const size_t level, const size_t x, const size_t y) const
+{
+  assert(x < levelWidth(level) && y < levelHeight(level));
+  return m_levels[level][y * levelWidth(level) + x];
+}
+
+size_t OcclusionCuller::levelWidth(const size_t level) const
+{
+  return std::max(((m_width - 1u) >> level) + 1u, size_t(1));
+}
+
+size_t OcclusionCuller::levelHeight(const size_t level) const
+{
+  return std::max(((m_height - 1u) >> level) + 1u, size_t(1));
+}
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -0,0 +1,126 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vecmath/forward.h>
+#include <vecmath/mat.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+class Camera;
+
+/**
+ * Determines which objects are hidden behind large occluders, such as the walls of an
+ * indoor map, so that they need not be rendered.
+ *
+ * For every frame, the occluders are rasterized into a low resolution depth buffer on the
+ * CPU. Only pixels which are entirely covered by an occluder are written, and each such
+ * pixel receives the farthest depth of the occluder within the pixel, so the depth buffer
+ * is conservative. From the depth buffer, a hierarchical depth pyramid is built where
+ * every pixel contains the farthest depth of the four pixels it covers on the level
+ * below.
+ *
+ * A bounding box is occluded if its nearest depth is behind the farthest depth of every
+ * pixel of the pyramid level that its projected bounds cover.
+ *
+ * The depth buffer is rasterized on the CPU rather than read back from the GPU so that
+ * the culling results are available immediately without stalling the pipeline.
+ */
+class OcclusionCuller
+{
+public:
+  /**
+   * The width of the depth buffer in pixels. The height depends on the aspect ratio of
+   * the viewport.
+   */
+  static const size_t Width = 256u;
+
+  /**
+   * The maximum number of occluders which are rasterized per frame.
+   */
+  static const size_t MaxOccluderCount = 2048u;
+
+private:
+  vm::mat4x4f m_viewProjectionMatrix;
+  size_t m_width;
+  size_t m_height;
+
+  /**
+   * The levels of the depth pyramid. The first level is the depth buffer, and every
+   * subsequent level has half the width and height of the previous level, rounded up.
+   * Depths are normalized device coordinates in [-1, 1].
+   */
+  std::vector<std::vector<float>> m_levels;
+
+  size_t m_occluderCount;
+  bool m_ready;
+
+public:
+  OcclusionCuller();
+
+  /**
+   * Clears the depth buffer and prepares it for rasterizing the occluders seen by the
+   * given camera.
+   */
+  void beginFrame(const Camera& camera);
+
+  /**
+   * Rasterizes the given convex, planar polygon into the depth buffer unless the culler
+   * is full. Must be called between beginFrame and endFrame.
+   */
+  void addOccluder(const std::vector<vm::vec3f>& polygon);
+
+  /**
+   * Builds the depth pyramid from the rasterized occluders. After this, bounding boxes
+   * can be tested for occlusion until the next call to beginFrame.
+   */
+  void endFrame();
+
+  /**
+   * The number of occluders which were added in the current frame.
+   */
+  size_t occluderCount() const;
+
+  /**
+   * Indicates whether the maximum number of occluders has been added in the current
+   * frame. Any further occluders are ignored.
+   */
+  bool full() const;
+
+  /**
+   * Indicates whether the given bounding box is hidden behind the occluders of the
+   * current frame. Returns false if the depth pyramid has not been built, or if the box
+   * intersects the near plane or lies outside of the viewport.
+   */
+  bool occludes(const vm::bbox3f& bounds) const;
+
+private:
+  float& depth(size_t level, size_t x, size_t y);
+  float depth(size_t level, size_t x, size_t y) const;
+  size_t levelWidth(size_t level) const;
+  size_t levelHeight(size_t level) const;
+};
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -23,6 +23,8 @@
 #include "Preferences.h"
 #include "Renderer/ActiveShader.h"
 #include "Renderer/Camera.h"
+#include "Renderer/GL.h"
+#include "Renderer/GLVertexType.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/ShaderManager.h"
 #include "Renderer/Shaders.h"
@@ -32,10 +34,31 @@
 #include <vecmath/mat_ext.h>
 #include <vecmath/vec.h>
 
+#include <kdl/vector_utils.h>
+
 namespace TrenchBroom
 {
 namespace Renderer
 {
+namespace
+{
+std::map<Color, VertexArray> prepareInstances(
+  const std::map<Color, std::vector<vm::vec3f>>& handles, VboManager& vboManager)
+{
+  using Instance = GLVertexTypes::HandleInstance::Vertex;
+
+  auto result = std::map<Color, VertexArray>{};
+  for (const auto& [color, positions] : handles)
+  {
+    auto instances = kdl::vec_transform(
+      positions, [](const vm::vec3f& position) { return Instance{position}; });
+    auto& instanceArray = result[color] = VertexArray::move(std::move(instances));
+    instanceArray.prepare(vboManager);
+  }
+  return result;
+}
+} // namespace
+
 PointHandleRenderer::PointHandleRenderer()
   : m_handle(pref(Preferences::HandleRadius), 16, true)
   , m_highlight(2.0f * pref(Preferences::HandleRadius), 16, false)
@@ -56,40 +79,34 @@ void PointHandleRenderer::doPrepareVertices(VboManager& vboManager)
 {
   m_handle.prepare(vboManager);
   m_highlight.prepare(vboManager);
+
+  if (GLEW_ARB_instanced_arrays)
+  {
+    m_pointHandleInstances = prepareInstances(m_pointHandles, vboManager);
+    m_highlightInstances = prepareInstances(m_highlights, vboManager);
+  }
 }
 
 void PointHandleRenderer::doRender(RenderContext& renderContext)
 {
-  const Camera& camera = renderContext.camera();
-  const Camera::Viewport& viewport = camera.viewport();
-  const vm::mat4x4f projection = vm::ortho_matrix(
-    0.0f,
-    1.0f,
-    static_cast<float>(viewport.x),
-    static_cast<float>(viewport.height),
-    static_cast<float>(viewport.width),
-    static_cast<float>(viewport.y));
-  const vm::mat4x4f view = vm::view_matrix(vm::vec3f::neg_z(), vm::vec3f::pos_y());
-  ReplaceTransformation ortho(renderContext.transformation(), projection, view);
-
   if (renderContext.render3D())
   {
     // Un-occluded handles: use depth test, draw fully opaque
-    renderHandles(renderContext, m_pointHandles, m_handle, 1.0f);
-    renderHandles(renderContext, m_highlights, m_highlight, 1.0f);
+    renderHandles(renderContext, m_pointHandles, m_pointHandleInstances, m_handle, 1.0f);
+    renderHandles(renderContext, m_highlights, m_highlightInstances, m_highlight, 1.0f);
 
     // Occluded handles: don't use depth test, but draw translucent
     glAssert(glDisable(GL_DEPTH_TEST));
-    renderHandles(renderContext, m_pointHandles, m_handle, 0.33f);
-    renderHandles(renderContext, m_highlights, m_highlight, 0.33f);
+    renderHandles(renderContext, m_pointHandles, m_pointHandleInstances, m_handle, 0.33f);
+    renderHandles(renderContext, m_highlights, m_highlightInstances, m_highlight, 0.33f);
     glAssert(glEnable(GL_DEPTH_TEST));
   }
   else
   {
     // In 2D views, render fully opaque without depth test
     glAssert(glDisable(GL_DEPTH_TEST));
-    renderHandles(renderContext, m_pointHandles, m_handle, 1.0f);
-    renderHandles(renderContext, m_highlights, m_highlight, 1.0f);
+    renderHandles(renderContext, m_pointHandles, m_pointHandleInstances, m_handle, 1.0f);
+    renderHandles(renderContext, m_highlights, m_highlightInstances, m_highlight, 1.0f);
     glAssert(glEnable(GL_DEPTH_TEST));
   }
 
@@ -97,9 +114,66 @@ void PointHandleRenderer::doRender(RenderContext& renderContext)
 }
 
 void PointHandleRenderer::renderHandles(
+  RenderContext& renderContext,
+  const HandleMap& map,
+  InstanceMap& instances,
+  Circle& circle,
+  const float opacity)
+{
+  if (GLEW_ARB_instanced_arrays)
+  {
+    renderHandleInstances(renderContext, instances, circle, opacity);
+  }
+  else
+  {
+    renderHandleVertices(renderContext, map, circle, opacity);
+  }
+}
+
+void PointHandleRenderer::renderHandleInstances(
+  RenderContext& renderContext,
+  InstanceMap& instances,
+  Circle& circle,
+  const float opacity)
+{
+  const Camera& camera = renderContext.camera();
+  const Camera::Viewport& viewport = camera.viewport();
+
+  // The handles are projected onto the screen in the shader, so the camera's
+  // transformation must remain in place.
+  ActiveShader shader(renderContext.shaderManager(), Shaders::HandleInstanceShader);
+  shader.set("CameraPosition", camera.position());
+  shader.set(
+    "ViewportSize",
+    vm::vec2f{static_cast<float>(viewport.width), static_cast<float>(viewport.height)});
+
+  // In 3D view, nudge towards camera by the handle radius, to prevent lines (brush
+  // edges, etc.) from clipping into the handle
+  shader.set(
+    "NudgeDistance", renderContext.render3D() ? pref(Preferences::HandleRadius) : 0.0f);
+
+  for (auto& [color, instanceArray] : instances)
+  {
+    shader.set("Color", mixAlpha(color, opacity));
+    circle.renderInstances(instanceArray);
+  }
+}
+
+void PointHandleRenderer::renderHandleVertices(
   RenderContext& renderContext, const HandleMap& map, Circle& circle, const float opacity)
 {
   const Camera& camera = renderContext.camera();
+  const Camera::Viewport& viewport = camera.viewport();
+  const vm::mat4x4f projection = vm::ortho_matrix(
+    0.0f,
+    1.0f,
+    static_cast<float>(viewport.x),
+    static_cast<float>(viewport.height),
+    static_cast<float>(viewport.width),
+    static_cast<float>(viewport.y));
+  const vm::mat4x4f view = vm::view_matrix(vm::vec3f::neg_z(), vm::vec3f::pos_y());
+  ReplaceTransformation ortho(renderContext.transformation(), projection, view);
+
   ActiveShader shader(renderContext.shaderManager(), Shaders::HandleShader);
 
   for (const auto& [color, positions] : map)
@@ -131,6 +205,8 @@ void PointHandleRenderer::clear()
 {
   m_pointHandles.clear();
   m_highlights.clear();
+  m_pointHandleInstances.clear();
+  m_highlightInstances.clear();
 }
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -22,6 +22,7 @@
 #include "Color.h"
 #include "Renderer/Circle.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/VertexArray.h"
 
 #include <vecmath/forward.h>
 
@@ -39,9 +40,12 @@ class PointHandleRenderer : public DirectRenderable
 {
 private:
   using HandleMap = std::map<Color, std::vector<vm::vec3f>>;
+  using InstanceMap = std::map<Color, VertexArray>;
 
   HandleMap m_pointHandles;
   HandleMap m_highlights;
+  InstanceMap m_pointHandleInstances;
+  InstanceMap m_highlightInstances;
 
   Circle m_handle;
   Circle m_highlight;
@@ -56,6 +60,14 @@ private:
   void doPrepareVertices(VboManager& vboManager) override;
   void doRender(RenderContext& renderContext) override;
   void renderHandles(
+    RenderContext& renderContext,
+    const HandleMap& map,
+    InstanceMap& instances,
+    Circle& circle,
+    float opacity);
+  void renderHandleInstances(
+    RenderContext& renderContext, InstanceMap& instances, Circle& circle, float opacity);
+  void renderHandleVertices(
     RenderContext& renderContext, const HandleMap& map, Circle& circle, float opacity);
 
   void clear();
@@ -20,11 +20,14 @@
 #include "RenderBatch.h"
 
 #include "Ensure.h"
+#include "Renderer/RenderContext.h"
 #include "Renderer/Renderable.h"
 #include "Renderer/VboManager.h"
 
 #include <kdl/vector_utils.h>
 
+#include <chrono>
+
 namespace TrenchBroom
 {
 namespace Renderer
@@ -105,8 +108,18 @@ void RenderBatch::addOneShot(IndexedRenderable* renderable)
 
 void RenderBatch::render(RenderContext& renderContext)
 {
+  const auto start = std::chrono::steady_clock::now();
   prepareRenderables();
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  renderContext.addPrepareTime(
+    std::chrono::duration<double, std::milli>{elapsed}.count());
+
   renderRenderables(renderContext);
+
+  renderContext.setVboUsage(
+    m_vboManager.currentVboCount(),
+    m_vboManager.peakVboCount(),
+    m_vboManager.currentVboSize());
 }
 
 void RenderBatch::doAdd(Renderable* renderable)
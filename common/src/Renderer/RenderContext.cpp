@@ -19,6 +19,9 @@
 
 #include "RenderContext.h"
 #include "Renderer/Camera.h"
+#include "Renderer/OcclusionCuller.h"
+
+#include <cassert>
 
 namespace TrenchBroom
 {
@@ -50,6 +53,8 @@ RenderContext::RenderContext(
   , m_hideSelection(false)
   , m_tintSelection(true)
   , m_showSelectionGuide(ShowSelectionGuide::Hide)
+  , m_gpuTimer(nullptr)
+  , m_occlusionCuller(nullptr)
 {
 }
 
@@ -269,6 +274,98 @@ void RenderContext::setForceHideSelectionGuide()
   setShowSelectionGuide(ShowSelectionGuide::ForceHide);
 }
 
+const RenderStats& RenderContext::stats() const
+{
+  return m_stats;
+}
+
+void RenderContext::countDrawnPrimitives(const size_t count)
+{
+  m_stats.drawnPrimitiveCount += count;
+}
+
+void RenderContext::countCulledPrimitives(const size_t count)
+{
+  m_stats.culledPrimitiveCount += count;
+}
+
+void RenderContext::countOccludedObject(const size_t primitiveCount)
+{
+  ++m_stats.occludedObjectCount;
+  m_stats.occludedPrimitiveCount += primitiveCount;
+}
+
+void RenderContext::countDrawCalls(const size_t count)
+{
+  m_stats.drawCallCount += count;
+}
+
+void RenderContext::countDrawnVertices(const size_t count)
+{
+  m_stats.drawnVertexCount += count;
+}
+
+void RenderContext::countValidatedBrushes(const size_t count)
+{
+  m_stats.validatedBrushCount += count;
+}
+
+void RenderContext::addPrepareTime(const double time)
+{
+  m_stats.prepareTime += time;
+}
+
+void RenderContext::setVboUsage(
+  const size_t vboCount, const size_t peakVboCount, const size_t vboSize)
+{
+  m_stats.vboCount = vboCount;
+  m_stats.peakVboCount = peakVboCount;
+  m_stats.vboSize = vboSize;
+}
+
+size_t RenderContext::addRenderPass(std::string name)
+{
+  m_stats.passes.push_back(RenderPassStats{std::move(name), 0.0, 0.0, std::nullopt});
+  return m_stats.passes.size() - 1u;
+}
+
+void RenderContext::addRenderPassBuildTime(const size_t passIndex, const double time)
+{
+  assert(passIndex < m_stats.passes.size());
+  m_stats.passes[passIndex].buildTime += time;
+}
+
+void RenderContext::addRenderPassSubmitTime(const size_t passIndex, const double time)
+{
+  assert(passIndex < m_stats.passes.size());
+  m_stats.passes[passIndex].submitTime += time;
+}
+
+GpuTimer* RenderContext::gpuTimer()
+{
+  return m_gpuTimer;
+}
+
+void RenderContext::setGpuTimer(GpuTimer* gpuTimer)
+{
+  m_gpuTimer = gpuTimer;
+}
+
+OcclusionCuller* RenderContext::occlusionCuller()
+{
+  return m_occlusionCuller;
+}
+
+void RenderContext::setOcclusionCuller(OcclusionCuller* occlusionCuller)
+{
+  m_occlusionCuller = occlusionCuller;
+}
+
+bool RenderContext::occludes(const vm::bbox3f& bounds) const
+{
+  return m_occlusionCuller != nullptr && m_occlusionCuller->occludes(bounds);
+}
+
 void RenderContext::setShowSelectionGuide(const ShowSelectionGuide showSelectionGuide)
 {
   switch (showSelectionGuide)
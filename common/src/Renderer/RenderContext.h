@@ -20,16 +20,22 @@
 #pragma once
 
 #include "FloatType.h"
+#include "Renderer/RenderStats.h"
 #include "Renderer/Transformation.h"
 
 #include <vecmath/bbox.h>
 
+#include <cstddef>
+#include <string>
+
 namespace TrenchBroom
 {
 namespace Renderer
 {
 class Camera;
 class FontManager;
+class GpuTimer;
+class OcclusionCuller;
 class ShaderManager;
 
 enum class RenderMode
@@ -81,6 +87,10 @@ private:
   ShowSelectionGuide m_showSelectionGuide;
   vm::bbox3f m_sofMapBounds;
 
+  RenderStats m_stats;
+  GpuTimer* m_gpuTimer;
+  OcclusionCuller* m_occlusionCuller;
+
 public:
   RenderContext(
     RenderMode renderMode,
@@ -150,6 +160,47 @@ public:
   void setForceShowSelectionGuide();
   void setForceHideSelectionGuide();
 
+  /**
+   * Statistics about the frame rendered with this context.
+   */
+  const RenderStats& stats() const;
+
+  void countDrawnPrimitives(size_t count);
+  void countCulledPrimitives(size_t count);
+  void countOccludedObject(size_t primitiveCount);
+  void countDrawCalls(size_t count);
+  void countDrawnVertices(size_t count);
+  void countValidatedBrushes(size_t count);
+  void addPrepareTime(double time);
+  void setVboUsage(size_t vboCount, size_t peakVboCount, size_t vboSize);
+
+  /**
+   * Adds a render pass with the given name to the statistics and returns its index.
+   */
+  size_t addRenderPass(std::string name);
+  void addRenderPassBuildTime(size_t passIndex, double time);
+  void addRenderPassSubmitTime(size_t passIndex, double time);
+
+  /**
+   * The GPU timer used to measure render passes, or null if GPU times should not be
+   * measured.
+   */
+  GpuTimer* gpuTimer();
+  void setGpuTimer(GpuTimer* gpuTimer);
+
+  /**
+   * The occlusion culler used to skip objects hidden behind occluders, or null if
+   * occlusion culling is disabled.
+   */
+  OcclusionCuller* occlusionCuller();
+  void setOcclusionCuller(OcclusionCuller* occlusionCuller);
+
+  /**
+   * Indicates whether the given bounds are hidden behind the occluders of the current
+   * frame. Always returns false if occlusion culling is disabled.
+   */
+  bool occludes(const vm::bbox3f& bounds) const;
+
 private:
   void setShowSelectionGuide(ShowSelectionGuide showSelectionGuide);
 
@@ -0,0 +1,113 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RenderPassTimer.h"
+
+#include "Renderer/GpuTimer.h"
+#include "Renderer/RenderBatch.h"
+#include "Renderer/RenderContext.h"
+#include "Renderer/Renderable.h"
+
+#include <optional>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+struct RenderPassMarkerState
+{
+  size_t passIndex;
+  std::chrono::steady_clock::time_point start;
+  std::optional<size_t> gpuInterval;
+};
+
+namespace
+{
+double millisecondsSince(const std::chrono::steady_clock::time_point start)
+{
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::milli>{elapsed}.count();
+}
+
+class BeginPassMarker : public Renderable
+{
+private:
+  std::shared_ptr<RenderPassMarkerState> m_state;
+
+public:
+  explicit BeginPassMarker(std::shared_ptr<RenderPassMarkerState> state)
+    : m_state{std::move(state)}
+  {
+  }
+
+private:
+  void doRender(RenderContext& renderContext) override
+  {
+    if (auto* gpuTimer = renderContext.gpuTimer(); gpuTimer && gpuTimer->supported())
+    {
+      const auto& name = renderContext.stats().passes[m_state->passIndex].name;
+      m_state->gpuInterval = gpuTimer->begin(name);
+    }
+    m_state->start = std::chrono::steady_clock::now();
+  }
+};
+
+class EndPassMarker : public Renderable
+{
+private:
+  std::shared_ptr<RenderPassMarkerState> m_state;
+
+public:
+  explicit EndPassMarker(std::shared_ptr<RenderPassMarkerState> state)
+    : m_state{std::move(state)}
+  {
+  }
+
+private:
+  void doRender(RenderContext& renderContext) override
+  {
+    renderContext.addRenderPassSubmitTime(
+      m_state->passIndex, millisecondsSince(m_state->start));
+    if (m_state->gpuInterval)
+    {
+      renderContext.gpuTimer()->end(*m_state->gpuInterval);
+    }
+  }
+};
+} // namespace
+
+RenderPassTimer::RenderPassTimer(
+  RenderContext& renderContext, RenderBatch& renderBatch, std::string name)
+  : m_renderContext{renderContext}
+  , m_renderBatch{renderBatch}
+  , m_start{std::chrono::steady_clock::now()}
+  , m_markerState{std::make_shared<RenderPassMarkerState>(RenderPassMarkerState{
+      m_renderContext.addRenderPass(std::move(name)), m_start, std::nullopt})}
+{
+  m_renderBatch.addOneShot(new BeginPassMarker{m_markerState});
+}
+
+RenderPassTimer::~RenderPassTimer()
+{
+  m_renderBatch.addOneShot(new EndPassMarker{m_markerState});
+  m_renderContext.addRenderPassBuildTime(
+    m_markerState->passIndex, millisecondsSince(m_start));
+}
+} // namespace Renderer
+} // namespace TrenchBroom
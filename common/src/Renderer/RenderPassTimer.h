@@ -0,0 +1,62 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+class RenderBatch;
+class RenderContext;
+struct RenderPassMarkerState;
+
+/**
+ * Records the timings of a render pass in the statistics of a render context.
+ *
+ * Create an instance before adding the pass's renderables to a render batch and destroy
+ * it afterwards. The time in between is recorded as the pass's build time. The instance
+ * also adds markers around the pass's renderables to the batch, which record the time
+ * spent issuing GL commands and, if the render context has a GPU timer, the GPU time
+ * when the batch is rendered.
+ */
+class RenderPassTimer
+{
+private:
+  RenderContext& m_renderContext;
+  RenderBatch& m_renderBatch;
+  std::chrono::steady_clock::time_point m_start;
+  std::shared_ptr<RenderPassMarkerState> m_markerState;
+
+public:
+  RenderPassTimer(
+    RenderContext& renderContext, RenderBatch& renderBatch, std::string name);
+  ~RenderPassTimer();
+
+  deleteCopyAndMove(RenderPassTimer);
+};
+} // namespace Renderer
+} // namespace TrenchBroom
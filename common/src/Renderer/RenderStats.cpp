@@ -0,0 +1,59 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RenderStats.h"
+
+#include <iomanip>
+#include <ostream>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+std::ostream& operator<<(std::ostream& str, const RenderStats& stats)
+{
+  const auto flags = str.flags();
+  const auto precision = str.precision();
+
+  str << std::fixed << std::setprecision(2);
+  str << stats.drawnPrimitiveCount << " primitives drawn, " << stats.culledPrimitiveCount
+      << " culled, " << stats.drawCallCount << " brush draw calls, "
+      << stats.drawnVertexCount << " vertices\n";
+  str << stats.occludedObjectCount << " objects occluded ("
+      << stats.occludedPrimitiveCount << " primitives)\n";
+  str << stats.validatedBrushCount << " brushes validated, " << stats.vboCount
+      << " VBOs (" << stats.peakVboCount << " peak) totalling " << stats.vboSize / 1024u
+      << " KiB, upload " << stats.prepareTime << " ms";
+  for (const auto& pass : stats.passes)
+  {
+    str << "\n"
+        << pass.name << ": build " << pass.buildTime << " ms, submit " << pass.submitTime
+        << " ms";
+    if (pass.gpuTime)
+    {
+      str << ", GPU " << *pass.gpuTime << " ms";
+    }
+  }
+
+  str.flags(flags);
+  str.precision(precision);
+  return str;
+}
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -0,0 +1,117 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+/**
+ * Timings of a named render pass, such as the opaque faces of unselected objects.
+ */
+struct RenderPassStats
+{
+  std::string name;
+
+  /**
+   * CPU time in milliseconds spent adding the pass's renderables to the render batch.
+   * This includes validating renderers whose contents have changed.
+   */
+  double buildTime = 0.0;
+
+  /**
+   * CPU time in milliseconds spent issuing the pass's GL commands.
+   */
+  double submitTime = 0.0;
+
+  /**
+   * GPU time in milliseconds spent executing the pass's GL commands. Since timer query
+   * results only become available a few frames later, this is the most recent available
+   * measurement for a pass of the same name. Empty if timer queries are unsupported.
+   */
+  std::optional<double> gpuTime;
+};
+
+/**
+ * Statistics about a rendered frame.
+ */
+struct RenderStats
+{
+  /**
+   * The number of primitives that were submitted for rendering.
+   */
+  size_t drawnPrimitiveCount = 0u;
+
+  /**
+   * The number of primitives that were skipped because they were outside of the view
+   * frustum or beyond the far plane.
+   */
+  size_t culledPrimitiveCount = 0u;
+
+  /**
+   * The number of brush chunks and entity models which were skipped because they were
+   * hidden behind occluders, and the number of brush primitives they contain.
+   */
+  size_t occludedObjectCount = 0u;
+  size_t occludedPrimitiveCount = 0u;
+
+  /**
+   * The number of draw calls which were issued to render brush faces and edges.
+   */
+  size_t drawCallCount = 0u;
+
+  /**
+   * The number of vertices which were submitted by draw calls for brush faces and edges,
+   * including degenerate primitives in unused index ranges.
+   */
+  size_t drawnVertexCount = 0u;
+
+  /**
+   * The number of brushes whose vertices and indices were rebuilt for this frame.
+   */
+  size_t validatedBrushCount = 0u;
+
+  /**
+   * CPU time in milliseconds spent uploading vertices and indices before rendering.
+   */
+  double prepareTime = 0.0;
+
+  /**
+   * VBO usage after the frame was rendered.
+   */
+  size_t vboCount = 0u;
+  size_t peakVboCount = 0u;
+  size_t vboSize = 0u;
+
+  std::vector<RenderPassStats> passes;
+};
+
+/**
+ * Prints the given statistics in a human readable form, one line per pass.
+ */
+std::ostream& operator<<(std::ostream& str, const RenderStats& stats);
+} // namespace Renderer
+} // namespace TrenchBroom
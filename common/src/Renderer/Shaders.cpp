@@ -34,13 +34,29 @@ const ShaderConfig VaryingPUniformCShader = ShaderConfig(
 const ShaderConfig MiniMapEdgeShader =
   ShaderConfig("MiniMap Edges", {"MiniMapEdge.vertsh"}, {"MiniMapEdge.fragsh"});
 const ShaderConfig EntityModelShader = ShaderConfig(
-  "Entity Model", {"EntityModel.vertsh"}, {"MapBounds.fragsh", "EntityModel.fragsh"});
+  "Entity Model",
+  {"EntityModel.vertsh", "EntityModelMatrix.vertsh"},
+  {"MapBounds.fragsh", "EntityModel.fragsh"});
+const ShaderConfig EntityModelInstanceShader = ShaderConfig(
+  "Entity Model Instance",
+  {"EntityModel.vertsh", "EntityModelInstanceMatrix.vertsh"},
+  {"MapBounds.fragsh", "EntityModel.fragsh"});
 const ShaderConfig FaceShader = ShaderConfig(
   "Face", {"Face.vertsh"}, {"Grid.fragsh", "MapBounds.fragsh", "Face.fragsh"});
 const ShaderConfig PatchShader = ShaderConfig(
   "Patch", {"Face.vertsh"}, {"Grid.fragsh", "MapBounds.fragsh", "Face.fragsh"});
+const ShaderConfig CompactFaceShader = ShaderConfig(
+  "Compact Face",
+  {"CompactBrushVertex.vertsh", "CompactFace.vertsh"},
+  {"Grid.fragsh", "MapBounds.fragsh", "Face.fragsh"});
 const ShaderConfig EdgeShader =
   ShaderConfig("Edge", {"Edge.vertsh"}, {"MapBounds.fragsh", "Edge.fragsh"});
+const ShaderConfig CompactEdgeShader = ShaderConfig(
+  "Compact Edge",
+  {"CompactBrushVertex.vertsh", "CompactEdge.vertsh"},
+  {"MapBounds.fragsh", "Edge.fragsh"});
+const ShaderConfig BoxInstanceEdgeShader = ShaderConfig(
+  "Box Instance Edge", {"BoxInstanceEdge.vertsh"}, {"MapBounds.fragsh", "Edge.fragsh"});
 const ShaderConfig ColoredTextShader =
   ShaderConfig("Colored Text", {"ColoredText.vertsh"}, {"Text.fragsh"});
 const ShaderConfig TextShader = ShaderConfig("Text", {"Text.vertsh"}, {"Text.fragsh"});
@@ -54,6 +70,8 @@ const ShaderConfig TextureBrowserBorderShader = ShaderConfig(
   {"TextureBrowserBorder.fragsh"});
 const ShaderConfig HandleShader =
   ShaderConfig("Handle", {"Handle.vertsh"}, {"Handle.fragsh"});
+const ShaderConfig HandleInstanceShader =
+  ShaderConfig("Handle Instance", {"HandleInstance.vertsh"}, {"Handle.fragsh"});
 const ShaderConfig ColoredHandleShader =
   ShaderConfig("Colored Handle", {"ColoredHandle.vertsh"}, {"Handle.fragsh"});
 const ShaderConfig CompassShader =
@@ -68,6 +86,8 @@ const ShaderConfig LinkArrowShader =
   ShaderConfig("Link Arrow", {"LinkArrow.vertsh"}, {"LinkArrow.fragsh"});
 const ShaderConfig TriangleShader =
   ShaderConfig("Shaded Triangles", {"Triangle.vertsh"}, {"Triangle.fragsh"});
+const ShaderConfig BoxInstanceTriangleShader = ShaderConfig(
+  "Shaded Box Instance Triangles", {"BoxInstanceTriangle.vertsh"}, {"Triangle.fragsh"});
 const ShaderConfig UVViewShader =
   ShaderConfig("UV View", {"UVView.vertsh"}, {"UVView.fragsh"});
 } // namespace Shaders
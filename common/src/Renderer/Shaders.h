@@ -32,14 +32,19 @@ extern const ShaderConfig VaryingPCShader;
 extern const ShaderConfig VaryingPUniformCShader;
 extern const ShaderConfig MiniMapEdgeShader;
 extern const ShaderConfig EntityModelShader;
+extern const ShaderConfig EntityModelInstanceShader;
 extern const ShaderConfig FaceShader;
 extern const ShaderConfig PatchShader;
+extern const ShaderConfig CompactFaceShader;
 extern const ShaderConfig EdgeShader;
+extern const ShaderConfig CompactEdgeShader;
+extern const ShaderConfig BoxInstanceEdgeShader;
 extern const ShaderConfig ColoredTextShader;
 extern const ShaderConfig TextBackgroundShader;
 extern const ShaderConfig TextureBrowserShader;
 extern const ShaderConfig TextureBrowserBorderShader;
 extern const ShaderConfig HandleShader;
+extern const ShaderConfig HandleInstanceShader;
 extern const ShaderConfig ColoredHandleShader;
 extern const ShaderConfig CompassShader;
 extern const ShaderConfig CompassOutlineShader;
@@ -47,6 +52,7 @@ extern const ShaderConfig CompassBackgroundShader;
 extern const ShaderConfig LinkLineShader;
 extern const ShaderConfig LinkArrowShader;
 extern const ShaderConfig TriangleShader;
+extern const ShaderConfig BoxInstanceTriangleShader;
 extern const ShaderConfig UVViewShader;
 } // namespace Shaders
 } // namespace Renderer
@@ -150,6 +150,35 @@ void TexturedIndexRangeMap::render(VertexArray& vertexArray, TextureRenderFunc&
   }
 }
 
+void TexturedIndexRangeMap::renderInstances(
+  VertexArray& vertexArray, TextureRenderFunc& func, VertexArray& instanceArray)
+{
+  for (const auto& [texture, indexArray] : *m_data)
+  {
+    func.before(texture);
+    indexArray.renderInstances(vertexArray, instanceArray);
+    func.after(texture);
+  }
+}
+
+void TexturedIndexRangeMap::renderRepeatedly(
+  VertexArray& vertexArray,
+  TextureRenderFunc& func,
+  const size_t instanceCount,
+  const std::function<void(size_t)>& setupInstance)
+{
+  for (const auto& [texture, indexArray] : *m_data)
+  {
+    func.before(texture);
+    for (size_t i = 0; i < instanceCount; ++i)
+    {
+      setupInstance(i);
+      indexArray.render(vertexArray);
+    }
+    func.after(texture);
+  }
+}
+
 void TexturedIndexRangeMap::forEachPrimitive(
   std::function<void(const Texture*, PrimType, size_t, size_t)> func) const
 {
@@ -184,6 +184,38 @@ public:
    */
   void render(VertexArray& vertexArray, TextureRenderFunc& func);
 
+  /**
+   * Renders the primitives stored in this index range map once for every vertex of the
+   * given instance array, see VertexArray::renderInstances. Each texture is bound only
+   * once, and the primitives of each texture are drawn with one instanced draw call per
+   * range.
+   *
+   * Requires the ARB_instanced_arrays extension.
+   *
+   * @param vertexArray the vertex array to render with
+   * @param func the texture callbacks
+   * @param instanceArray the per instance attributes
+   */
+  void renderInstances(
+    VertexArray& vertexArray, TextureRenderFunc& func, VertexArray& instanceArray);
+
+  /**
+   * Renders the primitives stored in this index range map once per instance without
+   * instanced draw calls. Each texture is bound only once, and the given setup function
+   * is called with the index of an instance before the primitives of the current texture
+   * are rendered for it.
+   *
+   * @param vertexArray the vertex array to render with
+   * @param func the texture callbacks
+   * @param instanceCount the number of instances to render
+   * @param setupInstance sets up the state of the instance with the given index
+   */
+  void renderRepeatedly(
+    VertexArray& vertexArray,
+    TextureRenderFunc& func,
+    size_t instanceCount,
+    const std::function<void(size_t)>& setupInstance);
+
   /**
    * Invokes the given function for each primitive stored in this map.
    *
@@ -19,6 +19,11 @@
 
 #include "TexturedIndexRangeRenderer.h"
 
+#include "Ensure.h"
+#include "Renderer/RenderUtils.h"
+
+#include <algorithm>
+
 namespace TrenchBroom
 {
 namespace Renderer
@@ -73,6 +78,34 @@ void TexturedIndexRangeRenderer::render(TextureRenderFunc& func)
   }
 }
 
+void TexturedIndexRangeRenderer::renderInstances(
+  const size_t /* levelOfDetail */, VertexArray& instanceArray)
+{
+  if (m_vertexArray.setup())
+  {
+    if (instanceArray.setup())
+    {
+      auto func = DefaultTextureRenderFunc{};
+      m_indexRange.renderInstances(m_vertexArray, func, instanceArray);
+      instanceArray.cleanup();
+    }
+    m_vertexArray.cleanup();
+  }
+}
+
+void TexturedIndexRangeRenderer::renderRepeatedly(
+  const size_t /* levelOfDetail */,
+  const size_t instanceCount,
+  const std::function<void(size_t)>& setupInstance)
+{
+  if (m_vertexArray.setup())
+  {
+    auto func = DefaultTextureRenderFunc{};
+    m_indexRange.renderRepeatedly(m_vertexArray, func, instanceCount, setupInstance);
+    m_vertexArray.cleanup();
+  }
+}
+
 MultiTexturedIndexRangeRenderer::MultiTexturedIndexRangeRenderer(
   std::vector<std::unique_ptr<TexturedIndexRangeRenderer>> renderers)
   : m_renderers(std::move(renderers))
@@ -116,5 +149,78 @@ void MultiTexturedIndexRangeRenderer::render(TextureRenderFunc& func)
     renderer->render(func);
   }
 }
+
+void MultiTexturedIndexRangeRenderer::renderInstances(
+  const size_t levelOfDetail, VertexArray& instanceArray)
+{
+  for (auto& renderer : m_renderers)
+  {
+    renderer->renderInstances(levelOfDetail, instanceArray);
+  }
+}
+
+void MultiTexturedIndexRangeRenderer::renderRepeatedly(
+  const size_t levelOfDetail,
+  const size_t instanceCount,
+  const std::function<void(size_t)>& setupInstance)
+{
+  for (auto& renderer : m_renderers)
+  {
+    renderer->renderRepeatedly(levelOfDetail, instanceCount, setupInstance);
+  }
+}
+
+LevelOfDetailRenderer::LevelOfDetailRenderer(
+  std::vector<std::unique_ptr<TexturedRenderer>> levels)
+  : m_levels(std::move(levels))
+{
+  ensure(!m_levels.empty(), "levels must not be empty");
+}
+
+LevelOfDetailRenderer::~LevelOfDetailRenderer() = default;
+
+size_t LevelOfDetailRenderer::levelOfDetailCount() const
+{
+  return m_levels.size();
+}
+
+bool LevelOfDetailRenderer::empty() const
+{
+  return m_levels.front()->empty();
+}
+
+void LevelOfDetailRenderer::prepare(VboManager& vboManager)
+{
+  for (auto& level : m_levels)
+  {
+    level->prepare(vboManager);
+  }
+}
+
+void LevelOfDetailRenderer::render()
+{
+  m_levels.front()->render();
+}
+
+void LevelOfDetailRenderer::render(TextureRenderFunc& func)
+{
+  m_levels.front()->render(func);
+}
+
+void LevelOfDetailRenderer::renderInstances(
+  const size_t levelOfDetail, VertexArray& instanceArray)
+{
+  const auto index = std::min(levelOfDetail, m_levels.size() - 1u);
+  m_levels[index]->renderInstances(0u, instanceArray);
+}
+
+void LevelOfDetailRenderer::renderRepeatedly(
+  const size_t levelOfDetail,
+  const size_t instanceCount,
+  const std::function<void(size_t)>& setupInstance)
+{
+  const auto index = std::min(levelOfDetail, m_levels.size() - 1u);
+  m_levels[index]->renderRepeatedly(0u, instanceCount, setupInstance);
+}
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -22,6 +22,7 @@
 #include "Renderer/TexturedIndexRangeMap.h"
 #include "Renderer/VertexArray.h"
 
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -47,6 +48,29 @@ public:
   virtual void prepare(VboManager& vboManager) = 0;
   virtual void render() = 0;
   virtual void render(TextureRenderFunc& func) = 0;
+
+  /**
+   * Renders the given level of detail once for every vertex of the given instance array
+   * with instanced draw calls. The per instance attributes, such as the model matrix, are
+   * read from the instance array.
+   *
+   * Level 0 is the most detailed level. Renderers which have fewer levels than requested
+   * render their least detailed level.
+   *
+   * Requires the ARB_instanced_arrays extension.
+   */
+  virtual void renderInstances(size_t levelOfDetail, VertexArray& instanceArray) = 0;
+
+  /**
+   * Renders the given level of detail once per instance without instanced draw calls. The
+   * vertices are set up and each texture is bound only once, and the given setup function
+   * is called with the index of an instance before it is drawn so that it can set per
+   * instance state such as the model matrix.
+   */
+  virtual void renderRepeatedly(
+    size_t levelOfDetail,
+    size_t instanceCount,
+    const std::function<void(size_t)>& setupInstance) = 0;
 };
 
 class TexturedIndexRangeRenderer : public TexturedRenderer
@@ -70,6 +94,11 @@ public:
   void prepare(VboManager& vboManager) override;
   void render() override;
   void render(TextureRenderFunc& func) override;
+  void renderInstances(size_t levelOfDetail, VertexArray& instanceArray) override;
+  void renderRepeatedly(
+    size_t levelOfDetail,
+    size_t instanceCount,
+    const std::function<void(size_t)>& setupInstance) override;
 };
 
 class MultiTexturedIndexRangeRenderer : public TexturedRenderer
@@ -87,6 +116,38 @@ public:
   void prepare(VboManager& vboManager) override;
   void render() override;
   void render(TextureRenderFunc& func) override;
+  void renderInstances(size_t levelOfDetail, VertexArray& instanceArray) override;
+  void renderRepeatedly(
+    size_t levelOfDetail,
+    size_t instanceCount,
+    const std::function<void(size_t)>& setupInstance) override;
+};
+
+/**
+ * Renders one of several levels of detail of the same mesh. Level 0 is the most detailed
+ * level and is used by `render`.
+ */
+class LevelOfDetailRenderer : public TexturedRenderer
+{
+private:
+  std::vector<std::unique_ptr<TexturedRenderer>> m_levels;
+
+public:
+  explicit LevelOfDetailRenderer(std::vector<std::unique_ptr<TexturedRenderer>> levels);
+  ~LevelOfDetailRenderer() override;
+
+  size_t levelOfDetailCount() const;
+
+  bool empty() const override;
+
+  void prepare(VboManager& vboManager) override;
+  void render() override;
+  void render(TextureRenderFunc& func) override;
+  void renderInstances(size_t levelOfDetail, VertexArray& instanceArray) override;
+  void renderRepeatedly(
+    size_t levelOfDetail,
+    size_t instanceCount,
+    const std::function<void(size_t)>& setupInstance) override;
 };
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -53,6 +53,19 @@ TriangleRenderer::TriangleRenderer(
 {
 }
 
+TriangleRenderer::TriangleRenderer(
+  const VertexArray& vertexArray,
+  const VertexArray& instanceArray,
+  const PrimType primType)
+  // without any instances, there is nothing to render
+  : m_vertexArray(instanceArray.empty() ? VertexArray() : vertexArray)
+  , m_instanceArray(instanceArray)
+  , m_indexArray(primType, 0, m_vertexArray.vertexCount())
+  , m_useColor(false)
+  , m_applyTinting(false)
+{
+}
+
 void TriangleRenderer::setUseColor(const bool useColor)
 {
   m_useColor = useColor;
@@ -76,6 +89,7 @@ void TriangleRenderer::setTintColor(const Color& tintColor)
 void TriangleRenderer::doPrepareVertices(VboManager& vboManager)
 {
   m_vertexArray.prepare(vboManager);
+  m_instanceArray.prepare(vboManager);
 }
 
 void TriangleRenderer::doRender(RenderContext& context)
@@ -83,13 +97,23 @@ void TriangleRenderer::doRender(RenderContext& context)
   if (m_vertexArray.vertexCount() == 0)
     return;
 
-  ActiveShader shader(context.shaderManager(), Shaders::TriangleShader);
+  const auto instanced = !m_instanceArray.empty();
+  ActiveShader shader(
+    context.shaderManager(),
+    instanced ? Shaders::BoxInstanceTriangleShader : Shaders::TriangleShader);
   shader.set("ApplyTinting", m_applyTinting);
   shader.set("TintColor", m_tintColor);
   shader.set("UseColor", m_useColor);
   shader.set("Color", m_color);
   shader.set("CameraPosition", context.camera().position());
-  m_indexArray.render(m_vertexArray);
+  if (instanced)
+  {
+    m_indexArray.renderInstances(m_vertexArray, m_instanceArray);
+  }
+  else
+  {
+    m_indexArray.render(m_vertexArray);
+  }
 }
 } // namespace Renderer
 } // namespace TrenchBroom
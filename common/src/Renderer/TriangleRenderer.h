@@ -34,6 +34,7 @@ class TriangleRenderer : public DirectRenderable
 {
 private:
   VertexArray m_vertexArray;
+  VertexArray m_instanceArray;
   IndexRangeMap m_indexArray;
 
   Color m_color;
@@ -46,6 +47,14 @@ public:
   TriangleRenderer(const VertexArray& vertexArray, const IndexRangeMap& indexArray);
   TriangleRenderer(const VertexArray& vertexArray, PrimType primType);
 
+  /**
+   * Renders the given unit box mesh once for every box in the given instance array,
+   * which must contain vertices of type GLVertexTypes::BoxInstance. Requires the
+   * ARB_instanced_arrays extension.
+   */
+  TriangleRenderer(
+    const VertexArray& vertexArray, const VertexArray& instanceArray, PrimType primType);
+
   TriangleRenderer(const TriangleRenderer& other) = default;
   TriangleRenderer& operator=(const TriangleRenderer& other) = default;
 
@@ -27,20 +27,62 @@ namespace TrenchBroom
 {
 namespace Renderer
 {
-Vbo::Vbo(GLenum type, const size_t capacity, const GLenum usage)
+Vbo::Vbo(
+  GLenum type, const size_t capacity, const GLenum usage, const size_t mappedRegionCount)
   : m_type(type)
   , m_capacity(capacity)
+  , m_usage(usage)
+  , m_mappedMemory(nullptr)
+  , m_fences(1u, nullptr)
+  , m_currentRegion(0u)
 {
-  assert(m_type == GL_ELEMENT_ARRAY_BUFFER || m_type == GL_ARRAY_BUFFER);
+  assert(
+    m_type == GL_ELEMENT_ARRAY_BUFFER || m_type == GL_ARRAY_BUFFER
+    || m_type == GL_DRAW_INDIRECT_BUFFER);
 
   glAssert(glGenBuffers(1, &m_bufferId));
   glAssert(glBindBuffer(m_type, m_bufferId));
+
+  if (mappedRegionCount > 0u)
+  {
+    const GLbitfield flags =
+      GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const auto sizei = static_cast<GLsizeiptr>(m_capacity * mappedRegionCount);
+    glAssert(glBufferStorage(m_type, sizei, nullptr, flags));
+    m_mappedMemory = glMapBufferRange(m_type, 0, sizei, flags);
+
+    if (m_mappedMemory != nullptr)
+    {
+      m_fences.resize(mappedRegionCount, nullptr);
+      return;
+    }
+
+    // the immutable storage cannot be respecified, so start over with a new buffer
+    glAssert(glDeleteBuffers(1, &m_bufferId));
+    glAssert(glGenBuffers(1, &m_bufferId));
+    glAssert(glBindBuffer(m_type, m_bufferId));
+  }
+
   glAssert(glBufferData(m_type, static_cast<GLsizeiptr>(m_capacity), nullptr, usage));
 }
 
 void Vbo::free()
 {
   assert(m_bufferId != 0);
+  for (auto& fence : m_fences)
+  {
+    if (fence != nullptr)
+    {
+      glAssert(glDeleteSync(fence));
+      fence = nullptr;
+    }
+  }
+  if (m_mappedMemory != nullptr)
+  {
+    glAssert(glBindBuffer(m_type, m_bufferId));
+    glAssert(glUnmapBuffer(m_type));
+    m_mappedMemory = nullptr;
+  }
   glAssert(glDeleteBuffers(1, &m_bufferId));
   m_bufferId = 0;
 }
@@ -52,7 +94,7 @@ Vbo::~Vbo()
 
 size_t Vbo::offset() const
 {
-  return 0;
+  return m_currentRegion * m_capacity;
 }
 
 size_t Vbo::capacity() const
@@ -60,6 +102,16 @@ size_t Vbo::capacity() const
   return m_capacity;
 }
 
+size_t Vbo::regionCount() const
+{
+  return m_fences.size();
+}
+
+size_t Vbo::currentRegion() const
+{
+  return m_currentRegion;
+}
+
 void Vbo::bind()
 {
   assert(m_bufferId != 0);
@@ -71,5 +123,41 @@ void Vbo::unbind()
   assert(m_bufferId != 0);
   glAssert(glBindBuffer(m_type, 0));
 }
+
+bool Vbo::persistentlyMapped() const
+{
+  return m_mappedMemory != nullptr;
+}
+
+bool Vbo::nextRegion()
+{
+  assert(m_mappedMemory != nullptr);
+  assert(m_fences[m_currentRegion] == nullptr);
+
+  // one fence covers all draw calls which have read from the current region
+  m_fences[m_currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  m_currentRegion = (m_currentRegion + 1u) % m_fences.size();
+
+  auto& fence = m_fences[m_currentRegion];
+  if (fence == nullptr)
+  {
+    return true;
+  }
+
+  // the first wait flushes the command queue, otherwise the fence might never be signaled
+  static constexpr GLuint64 timeoutNanos = 1000000u;
+  auto flags = GLbitfield(GL_SYNC_FLUSH_COMMANDS_BIT);
+  auto result = glClientWaitSync(fence, flags, timeoutNanos);
+  while (result == GL_TIMEOUT_EXPIRED)
+  {
+    flags = 0;
+    result = glClientWaitSync(fence, flags, timeoutNanos);
+  }
+
+  glAssert(glDeleteSync(fence));
+  fence = nullptr;
+
+  return result != GL_WAIT_FAILED;
+}
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -22,6 +22,7 @@
 #include "Renderer/VboManager.h"
 
 #include <cassert>
+#include <cstring>
 #include <type_traits>
 #include <vector>
 
@@ -42,13 +43,35 @@ private:
    */
   GLenum m_type;
   size_t m_capacity;
+  GLenum m_usage;
   GLuint m_bufferId;
 
+  /**
+   * Points to the buffer's storage if it is persistently mapped, and is null otherwise.
+   */
+  void* m_mappedMemory;
+
+  /**
+   * The storage of a persistently mapped buffer is divided into a ring of regions of
+   * m_capacity bytes each. The GPU reads from the current region while the regions which
+   * the GPU has finished reading can be written. Each region has a fence which is
+   * signaled once the draw calls issued before the region was left have completed.
+   *
+   * A buffer which is not persistently mapped has a single region without a fence.
+   */
+  std::vector<GLsync> m_fences;
+  size_t m_currentRegion;
+
   /**
    * Immediately creates and binds to a buffer of the given type and capacity.
    * The contents are initially unspecified.
+   *
+   * If mappedRegionCount is greater than zero, then the buffer's storage is immutable,
+   * holds the given number of regions of the given capacity, and is mapped for reading
+   * and writing until the buffer is freed. This requires ARB_buffer_storage. If the
+   * storage cannot be mapped, an ordinary buffer with a single region is created instead.
    */
-  Vbo(GLenum type, size_t capacity, GLenum usage);
+  Vbo(GLenum type, size_t capacity, GLenum usage, size_t mappedRegionCount = 0u);
   ~Vbo();
 
   /**
@@ -60,14 +83,59 @@ private:
 
 public:
   /**
-   * Deprecated, always returns 0.
+   * Returns the byte offset of the current region, which draw calls must read from.
    */
   size_t offset() const;
   size_t capacity() const;
+  size_t regionCount() const;
+  size_t currentRegion() const;
 
   void bind();
   void unbind();
 
+  bool persistentlyMapped() const;
+
+  /**
+   * Returns a pointer to the given region of the mapped storage at the given byte offset.
+   * Since the mapping is coherent, writes will be visible to any subsequent draw calls.
+   * The storage is mapped for reading too, so that the contents of a region can be copied
+   * to another region.
+   *
+   * Must only be called for persistently mapped buffers.
+   */
+  template <typename T>
+  T* mappedElements(const size_t region, const size_t address)
+  {
+    assert(m_mappedMemory != nullptr);
+    assert(region < m_fences.size());
+    assert(address <= m_capacity);
+    return reinterpret_cast<T*>(
+      static_cast<char*>(m_mappedMemory) + region * m_capacity + address);
+  }
+
+  /**
+   * Returns a pointer to the current region of the mapped storage at the given byte
+   * offset, see above.
+   */
+  template <typename T>
+  T* mappedElements(const size_t address)
+  {
+    return mappedElements<T>(m_currentRegion, address);
+  }
+
+  /**
+   * Makes the next region of a persistently mapped buffer current so that it can be
+   * written while the GPU may still read from the previous region.
+   *
+   * A fence is inserted for the region that is left, and this blocks only if the GPU has
+   * not yet finished reading from the next region, i.e. if the ring wraps around before
+   * the GPU catches up.
+   *
+   * Returns false if waiting for the GPU failed. Then it is unknown whether the next
+   * region is still in use, and the buffer must not be written anymore.
+   */
+  bool nextRegion();
+
   template <typename T>
   size_t writeElements(const size_t address, const std::vector<T>& elements)
   {
@@ -81,7 +149,8 @@ public:
   }
 
   /**
-   * Writes a C array to the VBO block.
+   * Writes a C array to the VBO block. If the buffer is persistently mapped, the array is
+   * written to the current region, which the GPU must not be reading from.
    *
    * @tparam T        element type
    * @param address   byte offset from the start of the block to write at
@@ -98,6 +167,12 @@ public:
     static_assert(std::is_trivially_copyable<T>::value);
     static_assert(std::is_standard_layout<T>::value);
 
+    if (m_mappedMemory != nullptr)
+    {
+      std::memcpy(mappedElements<T>(address), array, size);
+      return size;
+    }
+
     const GLvoid* ptr = static_cast<const GLvoid*>(array);
     const GLintptr offset = static_cast<GLintptr>(address);
     const GLsizeiptr sizei = static_cast<GLsizeiptr>(size);
@@ -106,6 +181,36 @@ public:
 
     return size;
   }
+
+  /**
+   * Replaces the entire contents of the VBO block with the given C array. The buffer's
+   * old storage is orphaned, so unlike writeArray, this does not wait for pending draw
+   * calls which read from the buffer.
+   *
+   * Must not be called for persistently mapped buffers.
+   *
+   * @tparam T        element type
+   * @param array     elements to write
+   * @param count     number of elements to write, must fill the entire capacity
+   * @return          number of bytes written
+   */
+  template <typename T>
+  size_t replaceArray(const T* array, const size_t count)
+  {
+    const size_t size = count * sizeof(T);
+    assert(size == m_capacity);
+    assert(m_mappedMemory == nullptr);
+
+    static_assert(std::is_trivially_copyable<T>::value);
+    static_assert(std::is_standard_layout<T>::value);
+
+    const GLvoid* ptr = static_cast<const GLvoid*>(array);
+    const GLsizeiptr sizei = static_cast<GLsizeiptr>(size);
+    glAssert(glBindBuffer(m_type, m_bufferId));
+    glAssert(glBufferData(m_type, sizei, ptr, m_usage));
+
+    return size;
+  }
 };
 } // namespace Renderer
 } // namespace TrenchBroom
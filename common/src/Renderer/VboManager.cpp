@@ -21,9 +21,12 @@
 
 #include "GL.h"
 #include "Macros.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
 #include "Vbo.h"
 
 #include <algorithm> // for std::max
+#include <cassert>
 
 namespace TrenchBroom
 {
@@ -40,6 +43,8 @@ static GLenum typeToOpenGL(const VboType type)
     return GL_ARRAY_BUFFER;
   case VboType::ElementArrayBuffer:
     return GL_ELEMENT_ARRAY_BUFFER;
+  case VboType::DrawIndirectBuffer:
+    return GL_DRAW_INDIRECT_BUFFER;
     switchDefault();
   }
 }
@@ -77,15 +82,58 @@ Vbo* VboManager::allocateVbo(VboType type, const size_t capacity, const VboUsage
   return result;
 }
 
+Vbo* VboManager::allocateMappedVbo(
+  VboType type, const size_t capacity, const size_t regionCount)
+{
+  assert(persistentMappingEnabled());
+  assert(regionCount > 0u);
+
+  auto* result = new Vbo(typeToOpenGL(type), capacity, GL_DYNAMIC_DRAW, regionCount);
+  if (!result->persistentlyMapped())
+  {
+    disablePersistentMapping();
+  }
+
+  m_currentVboSize += capacity * result->regionCount();
+  m_currentVboCount++;
+  m_peakVboCount = std::max(m_peakVboCount, m_currentVboCount);
+
+  return result;
+}
+
 void VboManager::destroyVbo(Vbo* vbo)
 {
-  m_currentVboSize -= vbo->capacity();
+  m_currentVboSize -= vbo->capacity() * vbo->regionCount();
   m_currentVboCount--;
 
   vbo->free();
   delete vbo;
 }
 
+bool VboManager::persistentMappingEnabled()
+{
+  if (!m_persistentMappingSupported)
+  {
+    m_persistentMappingSupported = bool(GLEW_ARB_buffer_storage);
+  }
+  return *m_persistentMappingSupported && pref(Preferences::PersistentlyMappedBuffers);
+}
+
+void VboManager::disablePersistentMapping()
+{
+  m_persistentMappingSupported = false;
+}
+
+bool VboManager::multiDrawIndirectSupported()
+{
+  if (!m_multiDrawIndirectSupported)
+  {
+    m_multiDrawIndirectSupported =
+      GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance && GLEW_ARB_instanced_arrays;
+  }
+  return *m_multiDrawIndirectSupported;
+}
+
 size_t VboManager::peakVboCount() const
 {
   return m_peakVboCount;
@@ -22,6 +22,7 @@
 #include "Renderer/GL.h"
 
 #include <cstddef> // for size_t
+#include <optional>
 
 namespace TrenchBroom
 {
@@ -33,7 +34,8 @@ class ShaderManager;
 enum class VboType
 {
   ArrayBuffer,
-  ElementArrayBuffer
+  ElementArrayBuffer,
+  DrawIndirectBuffer
 };
 
 enum class VboUsage
@@ -49,6 +51,8 @@ private:
   size_t m_currentVboCount;
   size_t m_currentVboSize;
   ShaderManager* m_shaderManager;
+  std::optional<bool> m_persistentMappingSupported;
+  std::optional<bool> m_multiDrawIndirectSupported;
 
 public:
   explicit VboManager(ShaderManager* shaderManager);
@@ -57,8 +61,41 @@ public:
    * The contents are initially unspecified. See Vbo class.
    */
   Vbo* allocateVbo(VboType type, size_t capacity, VboUsage usage = VboUsage::StaticDraw);
+
+  /**
+   * Immediately creates and binds to an OpenGL buffer with the given number of regions
+   * of the given capacity whose storage is persistently mapped, so that it can be written
+   * to directly. The contents are initially unspecified. See Vbo class.
+   *
+   * If the storage cannot be mapped, an ordinary buffer is returned and persistent
+   * mapping is disabled.
+   *
+   * Must only be called if persistentMappingEnabled() returns true.
+   */
+  Vbo* allocateMappedVbo(VboType type, size_t capacity, size_t regionCount);
   void destroyVbo(Vbo* vbo);
 
+  /**
+   * Indicates whether persistently mapped buffers should be allocated, i.e. whether the
+   * OpenGL implementation supports them and they are enabled in the preferences.
+   * Requires a current OpenGL context when called for the first time.
+   */
+  bool persistentMappingEnabled();
+
+  /**
+   * Stops allocating persistently mapped buffers, e.g. because waiting for the GPU to
+   * finish reading a mapped buffer has failed.
+   */
+  void disablePersistentMapping();
+
+  /**
+   * Indicates whether the OpenGL implementation supports drawing many ranges of an index
+   * buffer with glMultiDrawElementsIndirect, where every range can read its own per
+   * instance attributes. Otherwise, callers must fall back to glMultiDrawElements.
+   * Requires a current OpenGL context when called for the first time.
+   */
+  bool multiDrawIndirectSupported();
+
   size_t peakVboCount() const;
   size_t currentVboCount() const;
   size_t currentVboSize() const;
@@ -152,6 +152,48 @@ void VertexArray::render(
   }
 }
 
+void VertexArray::renderInstances(const PrimType primType, VertexArray& instanceArray)
+{
+  renderInstances(primType, 0, static_cast<GLsizei>(vertexCount()), instanceArray);
+}
+
+void VertexArray::renderInstances(
+  const PrimType primType,
+  const GLint index,
+  const GLsizei count,
+  VertexArray& instanceArray)
+{
+  assert(prepared());
+  assert(instanceArray.prepared());
+  if (empty() || instanceArray.empty())
+  {
+    return;
+  }
+
+  const auto setupThis = !m_setup;
+  const auto setupInstances = !instanceArray.m_setup;
+  if (setupThis)
+  {
+    setup();
+  }
+  if (setupInstances)
+  {
+    instanceArray.setup();
+  }
+
+  glAssert(glDrawArraysInstancedARB(
+    toGL(primType), index, count, static_cast<GLsizei>(instanceArray.vertexCount())));
+
+  if (setupInstances)
+  {
+    instanceArray.cleanup();
+  }
+  if (setupThis)
+  {
+    cleanup();
+  }
+}
+
 VertexArray::VertexArray(std::shared_ptr<BaseHolder> holder)
   : m_holder(std::move(holder))
   , m_prepared(false)
@@ -328,6 +328,30 @@ public:
    * @param count the number of vertices to render
    */
   void render(PrimType primType, const GLIndices& indices, GLsizei count);
+
+  /**
+   * Renders this vertex array once for every vertex of the given instance array. The
+   * attributes of the instance array must be per instance attributes, i.e., they advance
+   * once per rendered instance.
+   *
+   * Requires the ARB_instanced_arrays extension.
+   *
+   * @param primType the primitive type to render
+   * @param instanceArray the per instance attributes
+   */
+  void renderInstances(PrimType primType, VertexArray& instanceArray);
+
+  /**
+   * Renders a sub range of this vertex array once for every vertex of the given instance
+   * array.
+   *
+   * @param primType the primitive type to render
+   * @param index the index of the first vertex in this vertex array to render
+   * @param count the number of vertices to render
+   * @param instanceArray the per instance attributes
+   */
+  void renderInstances(
+    PrimType primType, GLint index, GLsizei count, VertexArray& instanceArray);
   void cleanup();
 
 private:
@@ -48,9 +48,11 @@
 #include "View/MainMenuBuilder.h"
 #endif
 
+#include <kdl/parallel.h>
 #include <kdl/set_temp.h>
 #include <kdl/string_utils.h>
 
+#include <algorithm>
 #include <clocale>
 #include <csignal>
 #include <cstdlib>
@@ -123,6 +125,9 @@ TrenchBroomApp::TrenchBroomApp(int& argc, char** argv)
   setOrganizationName("");
   setOrganizationDomain("io.github.trenchbroom");
 
+  kdl::set_default_thread_pool_size(
+    static_cast<size_t>(std::max(0, pref(Preferences::MaxThreadCount))));
+
   if (!initializeGameFactory())
   {
     QCoreApplication::exit(1);
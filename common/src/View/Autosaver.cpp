@@ -19,9 +19,12 @@
 
 #include "Autosaver.h"
 
+#include "BufferingLogger.h"
 #include "Exceptions.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
+#include "IO/IOUtils.h"
+#include "Logger.h"
 #include "View/MapDocument.h"
 
 #include <kdl/memory_utils.h>
@@ -31,8 +34,12 @@
 
 #include <algorithm> // for std::sort
 #include <cassert>
+#include <exception>
+#include <fstream>
 #include <limits>
 #include <memory>
+#include <sstream>
+#include <utility>
 
 namespace TrenchBroom
 {
@@ -75,17 +82,38 @@ bool Autosaver::BackupFileMatcher::operator()(
 Autosaver::Autosaver(
   std::weak_ptr<MapDocument> document,
   const std::chrono::milliseconds saveInterval,
-  const size_t maxBackups)
+  const size_t maxBackups,
+  const bool saveInBackground)
   : m_document(document)
   , m_saveInterval(saveInterval)
   , m_maxBackups(maxBackups)
   , m_lastSaveTime(Clock::now())
   , m_lastModificationCount(kdl::mem_lock(m_document)->modificationCount())
+  , m_saveInBackground(saveInBackground)
 {
 }
 
+Autosaver::~Autosaver()
+{
+  // the worker thread accesses this autosaver, so it must finish before it is destroyed
+  if (m_pendingAutosave.valid())
+  {
+    m_pendingAutosave.wait();
+  }
+}
+
+void Autosaver::setSaveInBackground(const bool saveInBackground)
+{
+  m_saveInBackground = saveInBackground;
+}
+
 void Autosaver::triggerAutosave(Logger& logger)
 {
+  if (!finishAutosave(logger, false))
+  {
+    return;
+  }
+
   if (kdl::mem_expired(m_document))
   {
     return;
@@ -120,11 +148,86 @@ void Autosaver::triggerAutosave(Logger& logger)
   autosave(logger, document);
 }
 
+void Autosaver::waitForAutosave(Logger& logger)
+{
+  finishAutosave(logger, true);
+}
+
+/**
+ * Logs the messages of a backup that was written in the background. Returns true if no
+ * backup is being written in the background anymore.
+ */
+bool Autosaver::finishAutosave(Logger& logger, const bool wait)
+{
+  if (!m_pendingAutosave.valid())
+  {
+    return true;
+  }
+
+  if (
+    !wait
+    && m_pendingAutosave.wait_for(std::chrono::seconds{0}) != std::future_status::ready)
+  {
+    return false;
+  }
+
+  try
+  {
+    for (const auto& [level, message] : m_pendingAutosave.get())
+    {
+      logger.log(level, message);
+    }
+  }
+  catch (const std::exception& e)
+  {
+    logger.error() << "Aborting autosave: " << e.what();
+  }
+  return true;
+}
+
 void Autosaver::autosave(Logger& logger, std::shared_ptr<MapDocument> document)
 {
   const auto& mapPath = document->path();
   assert(IO::Disk::fileExists(IO::Disk::fixPath(mapPath)));
 
+  m_lastSaveTime = Clock::now();
+  m_lastModificationCount = document->modificationCount();
+
+  if (m_saveInBackground)
+  {
+    // Serializing the map must happen here because the document may change as soon as
+    // this function returns. Since unchanged brushes reuse their serialized text, this is
+    // much cheaper than writing the map to disk.
+    auto stream = std::stringstream{};
+    document->saveDocumentTo(stream);
+
+    m_pendingAutosave = std::async(
+      std::launch::async, [&, mapPath = mapPath, mapText = stream.str()]() {
+        auto bufferingLogger = BufferingLogger{};
+        createBackup(bufferingLogger, mapPath, [&](const IO::Path& backupFilePath) {
+          auto file = IO::openPathAsOutputStream(backupFilePath);
+          if (!file)
+          {
+            throw FileSystemException{"Cannot open file: " + backupFilePath.asString()};
+          }
+          file << mapText;
+        });
+        return bufferingLogger.takeMessages();
+      });
+  }
+  else
+  {
+    createBackup(logger, mapPath, [&](const IO::Path& backupFilePath) {
+      document->saveDocumentTo(backupFilePath);
+    });
+  }
+}
+
+void Autosaver::createBackup(
+  Logger& logger,
+  const IO::Path& mapPath,
+  const std::function<void(const IO::Path&)>& writeBackup) const
+{
   const auto mapFilename = mapPath.lastComponent();
   const auto mapBasename = mapFilename.deleteExtension();
 
@@ -140,10 +243,7 @@ void Autosaver::autosave(Logger& logger, std::shared_ptr<MapDocument> document)
     const auto backupNo = backups.size() + 1;
 
     const auto backupFilePath = fs.makeAbsolute(makeBackupName(mapBasename, backupNo));
-
-    m_lastSaveTime = Clock::now();
-    m_lastModificationCount = document->modificationCount();
-    document->saveDocumentTo(backupFilePath);
+    writeBackup(backupFilePath);
 
     logger.info() << "Created autosave backup at " << backupFilePath;
   }
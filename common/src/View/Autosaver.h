@@ -22,10 +22,16 @@
 #include "IO/Path.h"
 
 #include <chrono>
+#include <functional>
+#include <future>
 #include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
 
 namespace TrenchBroom
 {
+enum class LogLevel;
 class Logger;
 
 namespace IO
@@ -53,6 +59,7 @@ public:
 
 private:
   using Clock = std::chrono::system_clock;
+  using LogMessages = std::vector<std::tuple<LogLevel, std::string>>;
 
   std::weak_ptr<MapDocument> m_document;
 
@@ -77,16 +84,53 @@ private:
    */
   size_t m_lastModificationCount;
 
+  /**
+   * Whether backups are written on a worker thread. If so, the map is serialized into
+   * memory on the calling thread and the worker thread rotates the existing backups and
+   * writes the new one.
+   */
+  bool m_saveInBackground;
+
+  /**
+   * The messages of a backup that is being written in the background. They are logged
+   * when the backup has been written.
+   */
+  std::future<LogMessages> m_pendingAutosave;
+
 public:
   explicit Autosaver(
     std::weak_ptr<MapDocument> document,
     std::chrono::milliseconds saveInterval = std::chrono::milliseconds(10 * 60 * 1000),
-    size_t maxBackups = 50);
+    size_t maxBackups = 50,
+    bool saveInBackground = true);
+  ~Autosaver();
+
+  /**
+   * Sets whether backups are written on a worker thread. A backup that is already being
+   * written in the background is not affected.
+   */
+  void setSaveInBackground(bool saveInBackground);
 
+  /**
+   * Creates a backup if the document was modified and the save interval has elapsed. If
+   * a backup is being written in the background, no new backup is created until it is
+   * done.
+   */
   void triggerAutosave(Logger& logger);
 
+  /**
+   * Blocks until a backup that is being written in the background is done and logs its
+   * messages to the given logger.
+   */
+  void waitForAutosave(Logger& logger);
+
 private:
+  bool finishAutosave(Logger& logger, bool wait);
   void autosave(Logger& logger, std::shared_ptr<View::MapDocument> document);
+  void createBackup(
+    Logger& logger,
+    const IO::Path& mapPath,
+    const std::function<void(const IO::Path&)>& writeBackup) const;
   IO::WritableDiskFileSystem createBackupFileSystem(
     Logger& logger, const IO::Path& mapPath) const;
   std::vector<IO::Path> collectBackups(
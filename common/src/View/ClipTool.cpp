@@ -569,14 +569,14 @@ private:
     {
       Renderer::RenderService renderService(renderContext, renderBatch);
 
-      const auto vertices = m_faceHandle->face().vertices();
+      const auto vertices = m_faceHandle->face().vertexPositions();
 
       std::vector<vm::vec3f> positions;
       positions.reserve(vertices.size());
 
-      for (const Model::BrushVertex* vertex : vertices)
+      for (const auto& vertex : vertices)
       {
-        positions.push_back(vm::vec3f(vertex->position()));
+        positions.push_back(vm::vec3f(vertex));
       }
 
       renderService.setForegroundColor(pref(Preferences::ClipHandleColor));
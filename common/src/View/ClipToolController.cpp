@@ -23,8 +23,8 @@
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushFaceHandle.h"
-#include "Model/BrushGeometry.h"
 #include "Model/BrushNode.h"
+#include "Model/CompactBrushGeometry.h"
 #include "Model/Hit.h"
 #include "Model/HitAdapter.h"
 #include "Model/HitFilter.h"
@@ -191,49 +191,56 @@ std::vector<const Model::BrushFace*> selectIncidentFaces(
 {
   static const auto MaxDistance = vm::constants<FloatType>::almost_zero();
 
+  const auto& brush = brushNode->brush();
+  const auto& geometry = brush.geometry();
+  const auto faceIndex = face.faceIndex();
+
   // First, try to see if the clip point is almost equal to a vertex:
   FloatType closestVertexDistance = MaxDistance;
-  const Model::BrushVertex* closestVertex = nullptr;
-  for (const auto* vertex : face.vertices())
+  std::optional<size_t> closestVertexIndex;
+  for (auto it = geometry.faceVertexIndicesBegin(faceIndex),
+            end = geometry.faceVertexIndicesEnd(faceIndex);
+       it != end;
+       ++it)
   {
-    const auto distance = vm::distance(vertex->position(), hitPoint);
+    const auto distance = vm::distance(geometry.vertexPosition(*it), hitPoint);
     if (distance < closestVertexDistance)
     {
-      closestVertex = vertex;
+      closestVertexIndex = *it;
       closestVertexDistance = distance;
     }
   }
 
-  if (closestVertex != nullptr)
+  if (closestVertexIndex)
   {
-    const Model::Brush& brush = brushNode->brush();
-    return brush.incidentFaces(closestVertex);
+    return brush.incidentFaces(*closestVertexIndex);
   }
 
   // Next, try the edges:
   FloatType closestEdgeDistance = MaxDistance;
-  const Model::BrushEdge* closestEdge = nullptr;
-  for (const auto* edge : face.edges())
+  std::optional<size_t> closestEdgeIndex;
+  for (size_t i = 0u; i < geometry.edgeCount(); ++i)
   {
-    const auto distance = vm::distance(edge->segment(), hitPoint).distance;
-    if (distance < closestEdgeDistance)
+    const auto [faceIndex1, faceIndex2] = geometry.edgeFaceIndices(i);
+    if (faceIndex1 == faceIndex || faceIndex2 == faceIndex)
     {
-      closestEdge = edge;
-      closestEdgeDistance = distance;
+      const auto [vertexIndex1, vertexIndex2] = geometry.edgeVertexIndices(i);
+      const auto segment = vm::segment3{
+        geometry.vertexPosition(vertexIndex1), geometry.vertexPosition(vertexIndex2)};
+      const auto distance = vm::distance(segment, hitPoint).distance;
+      if (distance < closestEdgeDistance)
+      {
+        closestEdgeIndex = i;
+        closestEdgeDistance = distance;
+      }
     }
   }
 
-  if (closestEdge != nullptr)
+  if (closestEdgeIndex)
   {
-    const auto firstFaceIndex = closestEdge->firstFace()->payload();
-    const auto secondFaceIndex = closestEdge->secondFace()->payload();
-
-    if (firstFaceIndex && secondFaceIndex)
-    {
-      return {
-        &brushNode->brush().face(*firstFaceIndex),
-        &brushNode->brush().face(*secondFaceIndex)};
-    }
+    const auto [firstFaceIndex, secondFaceIndex] =
+      geometry.edgeFaceIndices(*closestEdgeIndex);
+    return {&brush.face(firstFaceIndex), &brush.face(secondFaceIndex)};
   }
 
   return {&face};
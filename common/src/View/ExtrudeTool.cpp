@@ -25,6 +25,7 @@
 #include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
 #include "Model/BrushNode.h"
+#include "Model/CompactBrushGeometry.h"
 #include "Model/Hit.h"
 #include "Model/HitAdapter.h"
 #include "Model/HitFilter.h"
@@ -123,22 +124,23 @@ bool operator<(const std::optional<EdgeInfo>& lhs, const std::optional<EdgeInfo>
 }
 
 std::optional<EdgeInfo> getEdgeInfo(
-  const Model::BrushEdge* edge, Model::BrushNode* brushNode, const vm::ray3& pickRay)
+  const size_t edgeIndex, Model::BrushNode* brushNode, const vm::ray3& pickRay)
 {
+  const auto& geometry = brushNode->brush().geometry();
+  const auto [vertexIndex1, vertexIndex2] = geometry.edgeVertexIndices(edgeIndex);
 
-  const auto segment = edge->segment();
+  const auto segment = vm::segment3{
+    geometry.vertexPosition(vertexIndex1), geometry.vertexPosition(vertexIndex2)};
   const auto dist = vm::distance(pickRay, segment);
   if (vm::is_nan(dist.distance))
   {
     return std::nullopt;
   }
 
-  const auto leftFaceIndex = edge->firstFace()->payload();
-  const auto rightFaceIndex = edge->secondFace()->payload();
-  assert(leftFaceIndex && rightFaceIndex);
+  const auto [leftFaceIndex, rightFaceIndex] = geometry.edgeFaceIndices(edgeIndex);
 
-  const auto& leftFace = brushNode->brush().face(*leftFaceIndex);
-  const auto& rightFace = brushNode->brush().face(*rightFaceIndex);
+  const auto& leftFace = brushNode->brush().face(leftFaceIndex);
+  const auto& rightFace = brushNode->brush().face(rightFaceIndex);
 
   const auto leftDot = vm::dot(leftFace.boundary().normal, pickRay.direction);
   const auto rightDot = vm::dot(rightFace.boundary().normal, pickRay.direction);
@@ -149,8 +151,8 @@ std::optional<EdgeInfo> getEdgeInfo(
     return std::nullopt;
   }
 
-  const auto leftFaceHandle = Model::BrushFaceHandle{brushNode, *leftFaceIndex};
-  const auto rightFaceHandle = Model::BrushFaceHandle{brushNode, *rightFaceIndex};
+  const auto leftFaceHandle = Model::BrushFaceHandle{brushNode, leftFaceIndex};
+  const auto rightFaceHandle = Model::BrushFaceHandle{brushNode, rightFaceIndex};
 
   return {{leftFaceHandle, rightFaceHandle, leftDot, rightDot, segment, dist}};
 }
@@ -167,9 +169,9 @@ std::optional<EdgeInfo> findClosestHorizonEdge(
       [](Model::GroupNode*) {},
       [](Model::EntityNode*) {},
       [&](Model::BrushNode* brushNode) {
-        for (const auto* edge : brushNode->brush().edges())
+        for (size_t i = 0u; i < brushNode->brush().edgeCount(); ++i)
         {
-          result = std::min(result, getEdgeInfo(edge, brushNode, pickRay));
+          result = std::min(result, getEdgeInfo(i, brushNode, pickRay));
         }
       },
       [](Model::PatchNode*) {}));
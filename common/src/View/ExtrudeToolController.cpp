@@ -104,11 +104,11 @@ Renderer::DirectEdgeRenderer buildEdgeRenderer(
 
   for (const auto& dragHandle : dragHandles)
   {
-    const auto& dragFace = dragHandle.face();
-    for (const auto* edge : dragFace.edges())
+    const auto positions = dragHandle.face().vertexPositions();
+    for (size_t i = 0u; i < positions.size(); ++i)
     {
-      vertices.emplace_back(vm::vec3f{edge->firstVertex()->position()});
-      vertices.emplace_back(vm::vec3f{edge->secondVertex()->position()});
+      vertices.emplace_back(vm::vec3f{positions[i]});
+      vertices.emplace_back(vm::vec3f{positions[(i + 1u) % positions.size()]});
     }
   }
 
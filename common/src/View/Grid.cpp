@@ -22,15 +22,15 @@
 #include "FloatType.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
-#include "Model/BrushGeometry.h"
 #include "Model/BrushNode.h"
-#include "Model/Polyhedron.h"
+#include "Model/CompactBrushGeometry.h"
 
 #include <vecmath/intersection.h>
 #include <vecmath/ray.h>
 #include <vecmath/scalar.h>
 #include <vecmath/vec.h>
 
+#include <algorithm>
 #include <cmath>
 
 namespace TrenchBroom
@@ -272,39 +272,56 @@ FloatType Grid::snapToGridPlane(const vm::line3& line, const FloatType distance)
 FloatType Grid::snapMoveDistanceForFace(
   const Model::BrushFace& face, const FloatType moveDistance) const
 {
-  const auto isBoundaryEdge = [&](const Model::BrushEdge* edge) {
-    return edge->firstFace() == face.geometry() || edge->secondFace() == face.geometry();
+  const auto& geometry = *face.geometry();
+  const auto faceIndex = face.faceIndex();
+  const auto isFaceVertex = [&](const size_t vertexIndex) {
+    return std::find(
+             geometry.faceVertexIndicesBegin(faceIndex),
+             geometry.faceVertexIndicesEnd(faceIndex),
+             vertexIndex)
+           != geometry.faceVertexIndicesEnd(faceIndex);
   };
 
   const auto& moveDirection = face.normal();
   auto snappedMoveDistance = std::numeric_limits<FloatType>::max();
 
-  for (const auto* vertex : face.vertices())
+  const auto snapEdge = [&](const size_t originIndex, const size_t destinationIndex) {
+    const auto& origin = geometry.vertexPosition(originIndex);
+    const auto& destination = geometry.vertexPosition(destinationIndex);
+
+    // compute how far the vertex has to move along its edge vector to hit a grid plane
+    const auto edgeDirection = vm::normalize(destination - origin);
+    const auto distanceOnEdge = moveDistance / vm::dot(edgeDirection, moveDirection);
+    const auto line = vm::line3{origin, edgeDirection};
+    const auto snappedDistanceOnEdge = snapToGridPlane(line, distanceOnEdge);
+
+    // convert this to a movement along moveDirection and minimize the difference
+    const auto snappedMoveDistanceForEdge =
+      snappedDistanceOnEdge * vm::dot(edgeDirection, moveDirection);
+    if (
+      vm::abs(snappedMoveDistanceForEdge - moveDistance)
+      < vm::abs(snappedMoveDistance - moveDistance))
+    {
+      snappedMoveDistance = snappedMoveDistanceForEdge;
+    }
+  };
+
+  // consider the edges which leave the vertices of the face and are not on its boundary
+  for (size_t i = 0u; i < geometry.edgeCount(); ++i)
   {
-    const auto* currentHalfEdge = vertex->leaving();
-    do
+    const auto [faceIndex1, faceIndex2] = geometry.edgeFaceIndices(i);
+    if (faceIndex1 != faceIndex && faceIndex2 != faceIndex)
     {
-      if (!isBoundaryEdge(currentHalfEdge->edge()))
+      const auto [vertexIndex1, vertexIndex2] = geometry.edgeVertexIndices(i);
+      if (isFaceVertex(vertexIndex1))
       {
-        // compute how far the vertex has to move along its edge vector to hit a grid
-        // plane
-        const auto edgeDirection = vm::normalize(currentHalfEdge->vector());
-        const auto distanceOnEdge = moveDistance / vm::dot(edgeDirection, moveDirection);
-        const auto line = vm::line3{currentHalfEdge->origin()->position(), edgeDirection};
-        const auto snappedDistanceOnEdge = snapToGridPlane(line, distanceOnEdge);
-
-        // convert this to a movement along moveDirection and minimize the difference
-        const auto snappedMoveDistanceForEdge =
-          snappedDistanceOnEdge * vm::dot(edgeDirection, moveDirection);
-        if (
-          vm::abs(snappedMoveDistanceForEdge - moveDistance)
-          < vm::abs(snappedMoveDistance - moveDistance))
-        {
-          snappedMoveDistance = snappedMoveDistanceForEdge;
-        }
+        snapEdge(vertexIndex1, vertexIndex2);
       }
-      currentHalfEdge = currentHalfEdge->nextIncident();
-    } while (currentHalfEdge != vertex->leaving());
+      if (isFaceVertex(vertexIndex2))
+      {
+        snapEdge(vertexIndex2, vertexIndex1);
+      }
+    }
   }
 
   return snappedMoveDistance;
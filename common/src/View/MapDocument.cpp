@@ -27,6 +27,7 @@
 #include "Assets/EntityModelManager.h"
 #include "Assets/Texture.h"
 #include "Assets/TextureManager.h"
+#include "BufferingLogger.h"
 #include "EL/ELExceptions.h"
 #include "Exceptions.h"
 #include "IO/DiskFileSystem.h"
@@ -121,6 +122,7 @@
 #include <vecmath/vec_io.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdlib> // for std::abs
 #include <map>
@@ -203,6 +205,11 @@ static auto findAllLinkedGroups(Model::WorldNode& worldNode, const std::vector<T
  * The given node contents should be modified in place and the lambda should return true
  * if it was applied successfully and false otherwise.
  *
+ * The lambda is applied to the node contents in parallel, see kdl::parallel_for. It must
+ * therefore be safe to call concurrently: it must not access preferences, and it must
+ * synchronize any access to state other than the given node contents, e.g. by logging to
+ * a BufferingLogger that is flushed on the calling thread.
+ *
  * Returns a vector of pairs which map each node to its modified contents if the lambda
  * succeeded for every given node, or an empty optional otherwise.
  */
@@ -213,37 +220,47 @@ applyToNodeContents(const std::vector<N*>& nodes, L lambda)
   using NodeContentType = std::
     variant<Model::Layer, Model::Group, Model::Entity, Model::Brush, Model::BezierPatch>;
 
+  auto results = kdl::vec_parallel_transform(nodes, [&](N* node) {
+    NodeContentType nodeContents = node->accept(kdl::overload(
+      [](const Model::WorldNode* worldNode) -> NodeContentType {
+        return worldNode->entity();
+      },
+      [](const Model::LayerNode* layerNode) -> NodeContentType {
+        return layerNode->layer();
+      },
+      [](const Model::GroupNode* groupNode) -> NodeContentType {
+        return groupNode->group();
+      },
+      [](const Model::EntityNode* entityNode) -> NodeContentType {
+        return entityNode->entity();
+      },
+      [](const Model::BrushNode* brushNode) -> NodeContentType {
+        return brushNode->brush();
+      },
+      [](const Model::PatchNode* patchNode) -> NodeContentType {
+        return patchNode->patch();
+      }));
+
+    const auto success = std::visit(lambda, nodeContents);
+    return std::make_tuple(
+      success,
+      static_cast<Model::Node*>(node),
+      Model::NodeContents{std::move(nodeContents)});
+  });
+
   auto newNodes = std::vector<std::pair<Model::Node*, Model::NodeContents>>{};
-  newNodes.reserve(nodes.size());
-
-  bool success = true;
-  std::transform(
-    std::begin(nodes), std::end(nodes), std::back_inserter(newNodes), [&](auto* node) {
-      NodeContentType nodeContents = node->accept(kdl::overload(
-        [](const Model::WorldNode* worldNode) -> NodeContentType {
-          return worldNode->entity();
-        },
-        [](const Model::LayerNode* layerNode) -> NodeContentType {
-          return layerNode->layer();
-        },
-        [](const Model::GroupNode* groupNode) -> NodeContentType {
-          return groupNode->group();
-        },
-        [](const Model::EntityNode* entityNode) -> NodeContentType {
-          return entityNode->entity();
-        },
-        [](const Model::BrushNode* brushNode) -> NodeContentType {
-          return brushNode->brush();
-        },
-        [](const Model::PatchNode* patchNode) -> NodeContentType {
-          return patchNode->patch();
-        }));
+  newNodes.reserve(results.size());
 
-      success = success && std::visit(lambda, nodeContents);
-      return std::make_pair(node, Model::NodeContents(std::move(nodeContents)));
-    });
+  for (auto& [success, node, nodeContents] : results)
+  {
+    if (!success)
+    {
+      return std::nullopt;
+    }
+    newNodes.emplace_back(node, std::move(nodeContents));
+  }
 
-  return success ? std::make_optional(newNodes) : std::nullopt;
+  return newNodes;
 }
 
 /**
@@ -256,7 +273,8 @@ applyToNodeContents(const std::vector<N*>& nodes, L lambda)
  * - bool operator()(Model::BezierPatch&);
  *
  * The given node contents should be modified in place and the lambda should return true
- * if it was applied successfully and false otherwise.
+ * if it was applied successfully and false otherwise. The lambda is applied in parallel,
+ * see applyToNodeContents.
  *
  * For each linked group in the given list of linked groups, its changes are distributed
  * to the connected members of its link set.
@@ -297,8 +315,9 @@ static bool applyAndSwap(
  * The lambda L needs to accept brush faces:
  * - bool operator()(Model::BrushFace&);
  *
- * The given node contents should be modified in place and the lambda should return true
- * if it was applied successfully and false otherwise.
+ * The given faces should be modified in place and the lambda should return true if it
+ * was applied successfully and false otherwise. The brushes are processed in parallel, so
+ * the lambda must be safe to call concurrently, see applyToNodeContents.
  *
  * For each linked group in the given list of linked groups, its changes are distributed
  * to the connected members of its link set.
@@ -319,39 +338,62 @@ static bool applyAndSwap(
     return true;
   }
 
-  auto brushes = std::unordered_map<Model::BrushNode*, Model::Brush>{};
-
-  bool success = true;
-  std::for_each(std::begin(faces), std::end(faces), [&](const auto& faceHandle) {
+  // group the faces by their brushes, keeping the brushes in selection order
+  auto faceIndicesByBrush =
+    std::vector<std::pair<Model::BrushNode*, std::vector<size_t>>>{};
+  auto brushIndices = std::unordered_map<Model::BrushNode*, size_t>{};
+  for (const auto& faceHandle : faces)
+  {
     auto* brushNode = faceHandle.node();
-    auto it = brushes.find(brushNode);
-    if (it == std::end(brushes))
+    const auto [it, inserted] =
+      brushIndices.emplace(brushNode, faceIndicesByBrush.size());
+    if (inserted)
     {
-      it = brushes.emplace(brushNode, brushNode->brush()).first;
+      faceIndicesByBrush.emplace_back(brushNode, std::vector<size_t>{});
     }
+    faceIndicesByBrush[it->second].second.push_back(faceHandle.faceIndex());
+  }
 
-    auto& brush = it->second;
-    success = success && lambda(brush.face(faceHandle.faceIndex()));
-  });
+  // compute the new brushes in parallel, see applyToNodeContents
+  auto results =
+    kdl::vec_parallel_transform(std::move(faceIndicesByBrush), [&](auto&& brushAndFaces) {
+      const auto& [brushNode, faceIndices] = brushAndFaces;
+      auto brush = brushNode->brush();
+      const auto success = std::all_of(
+        std::begin(faceIndices), std::end(faceIndices), [&](const auto faceIndex) {
+          return lambda(brush.face(faceIndex));
+        });
+      return std::make_tuple(
+        success,
+        static_cast<Model::Node*>(brushNode),
+        Model::NodeContents{std::move(brush)});
+    });
 
-  if (success)
-  {
-    auto newNodes = std::vector<std::pair<Model::Node*, Model::NodeContents>>{};
-    newNodes.reserve(brushes.size());
+  auto newNodes = std::vector<std::pair<Model::Node*, Model::NodeContents>>{};
+  newNodes.reserve(results.size());
 
-    for (auto& [brushNode, brush] : brushes)
+  for (auto& [success, node, nodeContents] : results)
+  {
+    if (!success)
     {
-      newNodes.emplace_back(brushNode, Model::NodeContents(std::move(brush)));
+      return false;
     }
-
-    auto changedLinkedGroups = findContainingLinkedGroups(
-      *document.world(),
-      kdl::vec_transform(newNodes, [](const auto& p) { return p.first; }));
-    document.swapNodeContents(
-      commandName, std::move(newNodes), std::move(changedLinkedGroups));
+    newNodes.emplace_back(node, std::move(nodeContents));
   }
 
-  return success;
+  auto changedLinkedGroups = findContainingLinkedGroups(
+    *document.world(),
+    kdl::vec_transform(newNodes, [](const auto& p) { return p.first; }));
+  document.swapNodeContents(
+    commandName, std::move(newNodes), std::move(changedLinkedGroups));
+
+  return true;
+}
+
+static size_t textureMemoryBudget()
+{
+  const auto megabytes = std::max(pref(Preferences::TextureMemoryBudget), 0);
+  return static_cast<size_t>(megabytes) * 1024u * 1024u;
 }
 
 const vm::bbox3 MapDocument::DefaultWorldBounds(-32768.0, 32768.0);
@@ -379,6 +421,7 @@ MapDocument::MapDocument()
   , m_viewEffectsService(nullptr)
   , m_repeatStack(std::make_unique<RepeatStack>())
 {
+  m_textureManager->setMemoryBudget(textureMemoryBudget());
   connectObservers();
 }
 
@@ -622,6 +665,13 @@ void MapDocument::saveDocumentTo(const IO::Path& path)
   m_game->writeMap(*m_world, path);
 }
 
+void MapDocument::saveDocumentTo(std::ostream& stream)
+{
+  ensure(m_game.get() != nullptr, "game is null");
+  ensure(m_world != nullptr, "world is null");
+  m_game->writeMapToStream(*m_world, stream);
+}
+
 void MapDocument::exportDocumentAs(const IO::ExportOptions& options)
 {
   m_game->exportMap(*m_world, options);
@@ -1352,10 +1402,10 @@ void MapDocument::selectTall(const vm::axis::type cameraAxis)
       std::vector<vm::vec3> tallVertices;
       tallVertices.reserve(2 * selectionBrush.vertexCount());
 
-      for (const Model::BrushVertex* vertex : selectionBrush.vertices())
+      for (const auto& position : selectionBrush.vertexPositions())
       {
-        tallVertices.push_back(minPlane.project_point(vertex->position()));
-        tallVertices.push_back(maxPlane.project_point(vertex->position()));
+        tallVertices.push_back(minPlane.project_point(position));
+        tallVertices.push_back(maxPlane.project_point(position));
       }
 
       return brushBuilder
@@ -3011,9 +3061,9 @@ bool MapDocument::csgConvexMerge()
   {
     for (const auto& handle : selectedBrushFaces())
     {
-      for (const auto* vertex : handle.face().vertices())
+      for (const auto& position : handle.face().vertexPositions())
       {
-        points.push_back(vertex->position());
+        points.push_back(position);
       }
     }
   }
@@ -3021,9 +3071,9 @@ bool MapDocument::csgConvexMerge()
   {
     for (const auto* brushNode : selectedNodes().brushes())
     {
-      for (const auto* vertex : brushNode->brush().vertices())
+      for (const auto& position : brushNode->brush().vertexPositions())
       {
-        points.push_back(vertex->position());
+        points.push_back(position);
       }
     }
   }
@@ -3094,19 +3144,29 @@ bool MapDocument::csgSubtract()
   const auto subtrahends = kdl::vec_transform(
     subtrahendNodes, [](const auto* subtrahendNode) { return &subtrahendNode->brush(); });
 
+  const auto mapFormat = m_world->mapFormat();
+  const auto& textureName = currentTextureName();
+  auto bufferingLogger = BufferingLogger{};
+  auto brushesByMinuend =
+    kdl::vec_parallel_transform(minuendNodes, [&](const auto* minuendNode) {
+      const auto& minuend = minuendNode->brush();
+      auto currentSubtractionResults =
+        minuend.subtract(mapFormat, m_worldBounds, textureName, subtrahends);
+      return kdl::collect_values(
+        std::move(currentSubtractionResults), [&](const Model::BrushError& e) {
+          bufferingLogger.error() << "Could not create brush: " << e;
+        });
+    });
+  bufferingLogger.flush(*this);
+
   auto toAdd = std::map<Model::Node*, std::vector<Model::Node*>>{};
   auto toRemove =
     std::vector<Model::Node*>{std::begin(subtrahendNodes), std::end(subtrahendNodes)};
 
-  for (auto* minuendNode : minuendNodes)
+  for (size_t i = 0; i < minuendNodes.size(); ++i)
   {
-    const auto& minuend = minuendNode->brush();
-    auto currentSubtractionResults = minuend.subtract(
-      m_world->mapFormat(), m_worldBounds, currentTextureName(), subtrahends);
-    auto currentBrushes = kdl::collect_values(
-      std::move(currentSubtractionResults),
-      [&](const Model::BrushError& e) { error() << "Could not create brush: " << e; });
-
+    auto* minuendNode = minuendNodes[i];
+    auto& currentBrushes = brushesByMinuend[i];
     if (!currentBrushes.empty())
     {
       auto resultNodes = kdl::vec_transform(std::move(currentBrushes), [&](auto b) {
@@ -3182,32 +3242,37 @@ bool MapDocument::csgHollow()
     return false;
   }
 
-  bool didHollowAnything = false;
+  const auto thickness = static_cast<FloatType>(m_grid->actualSize());
+  const auto mapFormat = m_world->mapFormat();
+  const auto& textureName = currentTextureName();
+  auto bufferingLogger = BufferingLogger{};
+
+  auto didHollowAnything = std::atomic<bool>{false};
   auto fragmentsAndSourceNodes =
-    kdl::vec_transform(brushNodes, [&](Model::BrushNode* brushNode) {
+    kdl::vec_parallel_transform(brushNodes, [&](Model::BrushNode* brushNode) {
       const auto& originalBrush = brushNode->brush();
 
       auto shrunkenBrush = originalBrush;
       auto fragments = std::vector<Model::Brush>{};
-      shrunkenBrush
-        .expand(m_worldBounds, -1.0 * static_cast<FloatType>(m_grid->actualSize()), true)
+      shrunkenBrush.expand(m_worldBounds, -1.0 * thickness, true)
         .and_then([&]() {
           didHollowAnything = true;
 
           auto subtractionResults = originalBrush.subtract(
-            m_world->mapFormat(), m_worldBounds, currentTextureName(), shrunkenBrush);
+            mapFormat, m_worldBounds, textureName, shrunkenBrush);
           fragments = kdl::collect_values(
             std::move(subtractionResults), [&](const Model::BrushError& e) {
-              error() << "Could not create brush: " << e;
+              bufferingLogger.error() << "Could not create brush: " << e;
             });
         })
         .handle_errors([&](const Model::BrushError& e) {
-          error() << "Could not hollow brush: " << e;
+          bufferingLogger.error() << "Could not hollow brush: " << e;
           fragments = {originalBrush};
         });
 
       return std::make_pair(brushNode, std::move(fragments));
     });
+  bufferingLogger.flush(*this);
 
   if (!didHollowAnything)
   {
@@ -3595,7 +3660,9 @@ bool MapDocument::extrudeBrushes(
   const std::vector<vm::polygon3>& faces, const vm::vec3& delta)
 {
   const auto nodes = m_selectedNodes.nodes();
-  return applyAndSwap(
+  const auto lockTextures = pref(Preferences::TextureLock);
+  auto bufferingLogger = BufferingLogger{};
+  const auto success = applyAndSwap(
     *this,
     "Resize Brushes",
     nodes,
@@ -3612,16 +3679,18 @@ bool MapDocument::extrudeBrushes(
           return true;
         }
 
-        return brush
-          .moveBoundary(m_worldBounds, *faceIndex, delta, pref(Preferences::TextureLock))
+        return brush.moveBoundary(m_worldBounds, *faceIndex, delta, lockTextures)
           .visit(kdl::overload(
             [&]() { return m_worldBounds.contains(brush.bounds()); },
             [&](const Model::BrushError e) {
-              error() << "Could not resize brush: " << e;
+              bufferingLogger.error() << "Could not resize brush: " << e;
               return false;
             }));
       },
       [](Model::BezierPatch&) { return true; }));
+
+  bufferingLogger.flush(*this);
+  return success;
 }
 
 bool MapDocument::setFaceAttributes(const Model::BrushFaceAttributes& attributes)
@@ -3712,10 +3781,12 @@ bool MapDocument::flipTextures(
 
 bool MapDocument::snapVertices(const FloatType snapTo)
 {
-  size_t succeededBrushCount = 0;
-  size_t failedBrushCount = 0;
+  auto succeededBrushCount = std::atomic<size_t>{0};
+  auto failedBrushCount = std::atomic<size_t>{0};
 
   const auto allSelectedBrushes = allSelectedBrushNodes();
+  const auto lockTextures = pref(Preferences::UVLock);
+  auto bufferingLogger = BufferingLogger{};
   const bool applyAndSwapSuccess = applyAndSwap(
     *this,
     "Snap Brush Vertices",
@@ -3728,10 +3799,10 @@ bool MapDocument::snapVertices(const FloatType snapTo)
       [&](Model::Brush& originalBrush) {
         if (originalBrush.canSnapVertices(m_worldBounds, snapTo))
         {
-          originalBrush.snapVertices(m_worldBounds, snapTo, pref(Preferences::UVLock))
+          originalBrush.snapVertices(m_worldBounds, snapTo, lockTextures)
             .and_then([&]() { succeededBrushCount += 1; })
             .handle_errors([&](const Model::BrushError e) {
-              error() << "Could not snap vertices: " << e;
+              bufferingLogger.error() << "Could not snap vertices: " << e;
               failedBrushCount += 1;
             });
         }
@@ -3743,6 +3814,7 @@ bool MapDocument::snapVertices(const FloatType snapTo)
       },
       [](Model::BezierPatch&) { return true; }));
 
+  bufferingLogger.flush(*this);
   if (!applyAndSwapSuccess)
   {
     return false;
@@ -3751,17 +3823,17 @@ bool MapDocument::snapVertices(const FloatType snapTo)
   {
     info(kdl::str_to_string(
       "Snapped vertices of ",
-      succeededBrushCount,
+      succeededBrushCount.load(),
       " ",
-      kdl::str_plural(succeededBrushCount, "brush", "brushes")));
+      kdl::str_plural(succeededBrushCount.load(), "brush", "brushes")));
   }
   if (failedBrushCount > 0)
   {
     info(kdl::str_to_string(
       "Failed to snap vertices of ",
-      failedBrushCount,
+      failedBrushCount.load(),
       " ",
-      kdl::str_plural(failedBrushCount, "brush", "brushes")));
+      kdl::str_plural(failedBrushCount.load(), "brush", "brushes")));
   }
 
   return true;
@@ -3771,6 +3843,9 @@ MapDocument::MoveVerticesResult MapDocument::moveVertices(
   std::vector<vm::vec3> vertexPositions, const vm::vec3& delta)
 {
   auto newVertexPositions = std::vector<vm::vec3>{};
+  auto newVertexPositionsMutex = std::mutex{};
+  const auto lockTextures = pref(Preferences::UVLock);
+  auto bufferingLogger = BufferingLogger{};
   auto newNodes = applyToNodeContents(
     m_selectedNodes.nodes(),
     kdl::overload(
@@ -3791,17 +3866,19 @@ MapDocument::MoveVerticesResult MapDocument::moveVertices(
         }
 
         return brush
-          .moveVertices(m_worldBounds, verticesToMove, delta, pref(Preferences::UVLock))
+          .moveVertices(m_worldBounds, verticesToMove, delta, lockTextures)
           .and_then([&]() {
             auto newPositions = brush.findClosestVertexPositions(verticesToMove + delta);
+            const auto lock = std::lock_guard<std::mutex>{newVertexPositionsMutex};
             newVertexPositions =
               kdl::vec_concat(std::move(newVertexPositions), std::move(newPositions));
           })
           .handle_errors([&](const Model::BrushError e) {
-            error() << "Could not move brush vertices: " << e;
+            bufferingLogger.error() << "Could not move brush vertices: " << e;
           });
       },
       [](Model::BezierPatch&) { return true; }));
+  bufferingLogger.flush(*this);
 
   if (newNodes)
   {
@@ -3850,6 +3927,9 @@ bool MapDocument::moveEdges(
   std::vector<vm::segment3> edgePositions, const vm::vec3& delta)
 {
   auto newEdgePositions = std::vector<vm::segment3>{};
+  auto newEdgePositionsMutex = std::mutex{};
+  const auto lockTextures = pref(Preferences::UVLock);
+  auto bufferingLogger = BufferingLogger{};
   auto newNodes = applyToNodeContents(
     m_selectedNodes.nodes(),
     kdl::overload(
@@ -3870,18 +3950,20 @@ bool MapDocument::moveEdges(
         }
 
         return brush
-          .moveEdges(m_worldBounds, edgesToMove, delta, pref(Preferences::UVLock))
+          .moveEdges(m_worldBounds, edgesToMove, delta, lockTextures)
           .and_then([&]() {
             auto newPositions = brush.findClosestEdgePositions(kdl::vec_transform(
               edgesToMove, [&](const auto& edge) { return edge.translate(delta); }));
+            const auto lock = std::lock_guard<std::mutex>{newEdgePositionsMutex};
             newEdgePositions =
               kdl::vec_concat(std::move(newEdgePositions), std::move(newPositions));
           })
           .handle_errors([&](const Model::BrushError e) {
-            error() << "Could not move brush edges: " << e;
+            bufferingLogger.error() << "Could not move brush edges: " << e;
           });
       },
       [](Model::BezierPatch&) { return true; }));
+  bufferingLogger.flush(*this);
 
   if (newNodes)
   {
@@ -3917,6 +3999,9 @@ bool MapDocument::moveFaces(
   std::vector<vm::polygon3> facePositions, const vm::vec3& delta)
 {
   auto newFacePositions = std::vector<vm::polygon3>{};
+  auto newFacePositionsMutex = std::mutex{};
+  const auto lockTextures = pref(Preferences::UVLock);
+  auto bufferingLogger = BufferingLogger{};
   auto newNodes = applyToNodeContents(
     m_selectedNodes.nodes(),
     kdl::overload(
@@ -3937,18 +4022,20 @@ bool MapDocument::moveFaces(
         }
 
         return brush
-          .moveFaces(m_worldBounds, facesToMove, delta, pref(Preferences::UVLock))
+          .moveFaces(m_worldBounds, facesToMove, delta, lockTextures)
           .and_then([&]() {
             auto newPositions = brush.findClosestFacePositions(kdl::vec_transform(
               facesToMove, [&](const auto& face) { return face.translate(delta); }));
+            const auto lock = std::lock_guard<std::mutex>{newFacePositionsMutex};
             newFacePositions =
               kdl::vec_concat(std::move(newFacePositions), std::move(newPositions));
           })
           .handle_errors([&](const Model::BrushError e) {
-            error() << "Could not move brush faces: " << e;
+            bufferingLogger.error() << "Could not move brush faces: " << e;
           });
       },
       [](Model::BezierPatch&) { return true; }));
+  bufferingLogger.flush(*this);
 
   if (newNodes)
   {
@@ -3982,6 +4069,7 @@ bool MapDocument::moveFaces(
 
 bool MapDocument::addVertex(const vm::vec3& vertexPosition)
 {
+  auto bufferingLogger = BufferingLogger{};
   auto newNodes = applyToNodeContents(
     m_selectedNodes.nodes(),
     kdl::overload(
@@ -3996,10 +4084,11 @@ bool MapDocument::addVertex(const vm::vec3& vertexPosition)
 
         return brush.addVertex(m_worldBounds, vertexPosition)
           .handle_errors([&](const Model::BrushError e) {
-            error() << "Could not add brush vertex: " << e;
+            bufferingLogger.error() << "Could not add brush vertex: " << e;
           });
       },
       [](Model::BezierPatch&) { return true; }));
+  bufferingLogger.flush(*this);
 
   if (newNodes)
   {
@@ -4031,6 +4120,7 @@ bool MapDocument::addVertex(const vm::vec3& vertexPosition)
 bool MapDocument::removeVertices(
   const std::string& commandName, std::vector<vm::vec3> vertexPositions)
 {
+  auto bufferingLogger = BufferingLogger{};
   auto newNodes = applyToNodeContents(
     m_selectedNodes.nodes(),
     kdl::overload(
@@ -4052,10 +4142,11 @@ bool MapDocument::removeVertices(
 
         return brush.removeVertices(m_worldBounds, verticesToRemove)
           .handle_errors([&](const Model::BrushError e) {
-            error() << "Could not remove brush vertices: " << e;
+            bufferingLogger.error() << "Could not remove brush vertices: " << e;
           });
       },
       [](Model::BezierPatch&) { return true; }));
+  bufferingLogger.flush(*this);
 
   if (newNodes)
   {
@@ -4091,9 +4182,9 @@ void MapDocument::printVertices()
     {
       std::stringstream str;
       str.precision(17);
-      for (const Model::BrushVertex* vertex : handle.face().vertices())
+      for (const auto& position : handle.face().vertexPositions())
       {
-        str << "(" << vertex->position() << ") ";
+        str << "(" << position << ") ";
       }
       info(str.str());
     }
@@ -4106,9 +4197,9 @@ void MapDocument::printVertices()
 
       std::stringstream str;
       str.precision(17);
-      for (const Model::BrushVertex* vertex : brush.vertices())
+      for (const auto& position : brush.vertexPositions())
       {
-        str << vertex->position() << " ";
+        str << position << " ";
       }
       info(str.str());
     }
@@ -5084,6 +5175,10 @@ void MapDocument::preferenceDidChange(const IO::Path& path)
     m_textureManager->setTextureMode(
       pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
   }
+  else if (path == Preferences::TextureMemoryBudget.path())
+  {
+    m_textureManager->setMemoryBudget(textureMemoryBudget());
+  }
 }
 
 void MapDocument::commandDone(Command& command)
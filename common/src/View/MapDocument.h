@@ -34,6 +34,7 @@
 #include <vecmath/forward.h>
 #include <vecmath/util.h>
 
+#include <iosfwd>
 #include <map>
 #include <memory>
 #include <optional>
@@ -299,6 +300,7 @@ public: // new, load, save document
   void saveDocument();
   void saveDocumentAs(const IO::Path& path);
   void saveDocumentTo(const IO::Path& path);
+  void saveDocumentTo(std::ostream& stream);
   void exportDocumentAs(const IO::ExportOptions& options);
 
 private:
@@ -157,6 +157,7 @@ MapFrame::MapFrame(FrameManager* frameManager, std::shared_ptr<MapDocument> docu
   m_document->setParentLogger(m_console);
   m_document->setViewEffectsService(m_mapView);
 
+  m_autosaver->setSaveInBackground(pref(Preferences::AutosaveInBackground));
   m_autosaveTimer = new QTimer(this);
   m_autosaveTimer->start(1000);
 
@@ -197,7 +198,9 @@ MapFrame::~MapFrame()
 
   // let's trigger a final autosave before releasing the document
   NullLogger logger;
+  m_autosaver->waitForAutosave(logger);
   m_autosaver->triggerAutosave(logger);
+  m_autosaver->waitForAutosave(logger);
 
   m_document->setViewEffectsService(nullptr);
   m_document.reset();
@@ -873,6 +876,10 @@ void MapFrame::preferenceDidChange(const IO::Path& path)
     m_mapView->switchToMapView(
       static_cast<MapViewLayout>(pref(Preferences::MapViewLayout)));
   }
+  else if (path == Preferences::AutosaveInBackground.path())
+  {
+    m_autosaver->setSaveInBackground(pref(Preferences::AutosaveInBackground));
+  }
 
   updateShortcuts();
 }
@@ -39,6 +39,7 @@
 #include "Renderer/BoundsGuideRenderer.h"
 #include "Renderer/Compass3D.h"
 #include "Renderer/MapRenderer.h"
+#include "Renderer/OcclusionCuller.h"
 #include "Renderer/PerspectiveCamera.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
@@ -87,6 +88,7 @@ MapView3D::MapView3D(
   : MapViewBase(logger, std::move(document), toolBox, renderer, contextManager)
   , m_camera(std::make_unique<Renderer::PerspectiveCamera>())
   , m_flyModeHelper(std::make_unique<FlyModeHelper>(*m_camera))
+  , m_occlusionCuller(std::make_unique<Renderer::OcclusionCuller>())
   , m_ignoreCameraChangeEvents(false)
 {
   bindEvents();
@@ -322,9 +324,9 @@ static vm::vec3 computeCameraTargetPosition(const std::vector<Model::Node*>& nod
         }
       },
       [&](Model::BrushNode* brush) {
-        for (const auto* vertex : brush->brush().vertices())
+        for (const auto& position : brush->brush().vertexPositions())
         {
-          handlePoint(vertex->position());
+          handlePoint(position);
         }
       },
       [&](Model::PatchNode* patchNode) {
@@ -380,11 +382,11 @@ static FloatType computeCameraOffset(
         }
       },
       [&](Model::BrushNode* brush) {
-        for (const auto* vertex : brush->brush().vertices())
+        for (const auto& position : brush->brush().vertexPositions())
         {
           for (size_t i = 0u; i < 4u; ++i)
           {
-            handlePoint(vertex->position(), frustumPlanes[i]);
+            handlePoint(position, frustumPlanes[i]);
           }
         }
       },
@@ -558,7 +560,13 @@ void MapView3D::doRenderMap(
   Renderer::RenderContext& renderContext,
   Renderer::RenderBatch& renderBatch)
 {
+  // only the map itself is culled, tools and guides are always rendered
+  if (pref(Preferences::OcclusionCulling))
+  {
+    renderContext.setOcclusionCuller(m_occlusionCuller.get());
+  }
   renderer.render(renderContext, renderBatch);
+  renderContext.setOcclusionCuller(nullptr);
 
   auto document = kdl::mem_lock(m_document);
   if (renderContext.showSelectionGuide() && document->hasSelectedNodes())
@@ -47,6 +47,7 @@
 #include "Renderer/Compass.h"
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/FontManager.h"
+#include "Renderer/GpuTimer.h"
 #include "Renderer/MapRenderer.h"
 #include "Renderer/PrimitiveRenderer.h"
 #include "Renderer/RenderBatch.h"
@@ -104,6 +105,7 @@ MapViewBase::MapViewBase(
   , m_renderer{renderer}
   , m_compass{nullptr}
   , m_portalFileRenderer{nullptr}
+  , m_gpuTimer{std::make_unique<Renderer::GpuTimer>()}
   , m_isCurrent{false}
   , m_updateActionStatesSignalDelayer{new SignalDelayer{this}}
 {
@@ -129,6 +131,8 @@ MapViewBase::~MapViewBase()
   // Deleting m_compass will access the VBO so we need to be current
   // see: http://doc.qt.io/qt-5/qopenglwidget.html#resource-initialization-and-cleanup
   makeCurrent();
+
+  m_gpuTimer->free();
 }
 
 void MapViewBase::setIsCurrent(const bool isCurrent)
@@ -1023,6 +1027,11 @@ void MapViewBase::doRender()
       ? vm::bbox3f{document->softMapBounds().bounds.value_or(vm::bbox3{})}
       : vm::bbox3f{});
 
+  if (pref(Preferences::ShowRenderStats))
+  {
+    renderContext.setGpuTimer(m_gpuTimer.get());
+  }
+
   setupGL(renderContext);
   setRenderOptions(renderContext);
 
@@ -1041,6 +1050,13 @@ void MapViewBase::doRender()
   renderFPS(renderContext, renderBatch);
 
   renderBatch.render(renderContext);
+  m_gpuTimer->endFrame();
+
+  m_lastFrameStats = renderContext.stats();
+  for (auto& pass : m_lastFrameStats.passes)
+  {
+    pass.gpuTime = m_gpuTimer->elapsedTime(pass.name);
+  }
 }
 
 void MapViewBase::setupGL(Renderer::RenderContext& context)
@@ -1151,10 +1167,22 @@ void MapViewBase::renderCompass(Renderer::RenderBatch& renderBatch)
 void MapViewBase::renderFPS(
   Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch)
 {
-  if (pref(Preferences::ShowFPS))
+  const auto showFPS = pref(Preferences::ShowFPS);
+  const auto showRenderStats = pref(Preferences::ShowRenderStats);
+  if (showFPS || showRenderStats)
   {
+    auto str = std::stringstream{};
+    if (showFPS)
+    {
+      str << m_currentFPS;
+    }
+    if (showRenderStats)
+    {
+      str << (showFPS ? "\n" : "") << m_lastFrameStats;
+    }
+
     auto renderService = Renderer::RenderService{renderContext, renderBatch};
-    renderService.renderHeadsUp(m_currentFPS);
+    renderService.renderHeadsUp(str.str());
   }
 }
 
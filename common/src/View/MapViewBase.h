@@ -20,6 +20,7 @@
 #pragma once
 
 #include "NotifierConnection.h"
+#include "Renderer/RenderContext.h"
 #include "View/ActionContext.h"
 #include "View/CameraLinkHelper.h"
 #include "View/MapView.h"
@@ -64,6 +65,7 @@ namespace Renderer
 {
 class Camera;
 class Compass;
+class GpuTimer;
 class MapRenderer;
 class PrimitiveRenderer;
 class RenderBatch;
@@ -104,6 +106,17 @@ private:
   std::unique_ptr<Renderer::Compass> m_compass;
   std::unique_ptr<Renderer::PrimitiveRenderer> m_portalFileRenderer;
 
+  /**
+   * Measures the GPU time of the render passes while render statistics are shown.
+   */
+  std::unique_ptr<Renderer::GpuTimer> m_gpuTimer;
+
+  /**
+   * The render batch is only rendered after the FPS counter has been added to it, so the
+   * FPS counter shows the statistics of the previous frame.
+   */
+  Renderer::RenderStats m_lastFrameStats;
+
   /**
    * Tracks whether this map view has most recently gotten the focus. This is tracked and
    * updated by a MapViewActivationTracker instance.
@@ -44,6 +44,7 @@
 #include <vecmath/mat_ext.h>
 #include <vecmath/vec.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -333,6 +334,8 @@ void TextureBrowserView::doClear() {}
 void TextureBrowserView::doRender(Layout& layout, const float y, const float height)
 {
   auto doc = kdl::mem_lock(m_document);
+  // textures which are loaded on demand are loaded when committing the changes
+  requestTextures(layout, y, height);
   doc->textureManager().commitChanges();
 
   const float viewLeft = static_cast<float>(0);
@@ -364,6 +367,27 @@ const Color& TextureBrowserView::getBackgroundColor()
   return pref(Preferences::BrowserBackgroundColor);
 }
 
+void TextureBrowserView::requestTextures(
+  Layout& layout, const float y, const float height)
+{
+  for (const auto& group : layout.groups())
+  {
+    if (group.intersectsY(y, height))
+    {
+      for (const auto& row : group.rows())
+      {
+        if (row.intersectsY(y, height))
+        {
+          for (const auto& cell : row.cells())
+          {
+            cellData(cell).texture->request();
+          }
+        }
+      }
+    }
+  }
+}
+
 void TextureBrowserView::renderBounds(Layout& layout, const float y, const float height)
 {
   using BoundsVertex = Renderer::GLVertexTypes::P2C4::Vertex;
@@ -547,7 +571,7 @@ TextureBrowserView::StringMap TextureBrowserView::collectStringVertices(
   {
     if (group.intersectsY(y, height))
     {
-      const auto& title = group.item();
+      const auto title = groupTitle(group.item());
       if (!title.empty())
       {
         const auto titleBounds = layout.titleBoundsForVisibleRect(group, y, height);
@@ -624,6 +648,29 @@ TextureBrowserView::StringMap TextureBrowserView::collectStringVertices(
   return stringVertices;
 }
 
+std::string TextureBrowserView::groupTitle(const std::string& collectionName) const
+{
+  if (collectionName.empty())
+  {
+    return collectionName;
+  }
+
+  // show how much memory the collection uses, this changes as textures are loaded
+  const auto& collections = getCollections();
+  const auto it = std::find_if(
+    std::begin(collections), std::end(collections), [&](const auto& collection) {
+      return collection.name() == collectionName;
+    });
+  if (it == std::end(collections))
+  {
+    return collectionName;
+  }
+
+  return collectionName + " (" + Assets::formatByteSize(it->gpuByteSize())
+         + " video memory, " + Assets::formatByteSize(it->cpuByteSize())
+         + " main memory)";
+}
+
 void TextureBrowserView::doLeftClick(Layout& layout, const float x, const float y)
 {
   if (const Cell* cell = layout.cellAt(x, y))
@@ -125,6 +125,7 @@ private:
   bool doShouldRenderFocusIndicator() const override;
   const Color& getBackgroundColor() override;
 
+  void requestTextures(Layout& layout, float y, float height);
   void renderBounds(Layout& layout, float y, float height);
   const Color& textureColor(const Assets::Texture& texture) const;
   void renderTextures(Layout& layout, float y, float height);
@@ -132,6 +133,7 @@ private:
   void renderGroupTitleBackgrounds(Layout& layout, float y, float height);
   void renderStrings(Layout& layout, float y, float height);
   StringMap collectStringVertices(Layout& layout, float y, float height);
+  std::string groupTitle(const std::string& collectionName) const;
 
   void doLeftClick(Layout& layout, float x, float y) override;
   QString tooltip(const Cell& cell) override;
@@ -89,10 +89,9 @@ static vm::vec2f snapDelta(const UVViewHelper& helper, const vm::vec2f& delta)
     true);
 
   auto distance = vm::vec2f::max();
-  for (const Model::BrushVertex* vertex : helper.face()->vertices())
+  for (const auto& position : helper.face()->vertexPositions())
   {
-    const auto temp =
-      helper.computeDistanceFromTextureGrid(transform * vertex->position());
+    const auto temp = helper.computeDistanceFromTextureGrid(transform * position);
     distance = vm::abs_min(distance, temp);
   }
 
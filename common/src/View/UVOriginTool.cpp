@@ -197,11 +197,10 @@ static vm::vec2f snapDelta(const UVViewHelper& helper, const vm::vec2f& delta)
   // TODO: this actually doesn't work because we're snapping to the X or Y coordinate of
   // the vertices instead, we must snap to the edges!
   auto distanceInTexCoords = vm::vec2f::max();
-  for (const Model::BrushVertex* vertex : helper.face()->vertices())
+  for (const auto& position : helper.face()->vertexPositions())
   {
     distanceInTexCoords = vm::abs_min(
-      distanceInTexCoords,
-      vm::vec2f{w2tTransform * vertex->position()} - newOriginInTexCoords);
+      distanceInTexCoords, vm::vec2f{w2tTransform * position} - newOriginInTexCoords);
   }
 
   // and to the texture grid
@@ -132,10 +132,13 @@ static float snapAngle(const UVViewHelper& helper, const float angle)
 
   const auto toFace =
     helper.face()->toTexCoordSystemMatrix(vm::vec2f::zero(), vm::vec2f::one(), true);
-  for (const auto* edge : helper.face()->edges())
+  const auto vertices = helper.face()->vertexPositions();
+  for (size_t edgeIndex = 0u; edgeIndex < vertices.size(); ++edgeIndex)
   {
-    const auto startInFaceCoords = vm::vec2f{toFace * edge->firstVertex()->position()};
-    const auto endInFaceCoords = vm::vec2f{toFace * edge->secondVertex()->position()};
+    const auto& start = vertices[edgeIndex];
+    const auto& end = vertices[(edgeIndex + 1u) % vertices.size()];
+    const auto startInFaceCoords = vm::vec2f{toFace * start};
+    const auto endInFaceCoords = vm::vec2f{toFace * end};
     const auto edgeAngle = vm::mod(
       helper.face()->measureTextureAngle(startInFaceCoords, endInFaceCoords), 360.0f);
 
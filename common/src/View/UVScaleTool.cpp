@@ -132,13 +132,13 @@ static vm::vec2f snap(const UVViewHelper& helper, const vm::vec2f& position)
   const auto toTex =
     helper.face()->toTexCoordSystemMatrix(vm::vec2f::zero(), vm::vec2f::one(), true);
 
-  const auto vertices = helper.face()->vertices();
+  const auto vertices = helper.face()->vertexPositions();
   auto distance = std::accumulate(
     std::begin(vertices),
     std::end(vertices),
     vm::vec2f::max(),
-    [&](const vm::vec2f& current, const Model::BrushVertex* vertex) {
-      const auto vertex2 = vm::vec2f{toTex * vertex->position()};
+    [&](const vm::vec2f& current, const vm::vec3& vertex) {
+      const auto vertex2 = vm::vec2f{toTex * vertex};
       return vm::abs_min(current, position - vertex2);
     });
 
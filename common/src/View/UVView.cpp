@@ -331,15 +331,15 @@ void UVView::renderFace(Renderer::RenderContext&, Renderer::RenderBatch& renderB
 {
   assert(m_helper.valid());
 
-  const auto faceVertices = m_helper.face()->vertices();
+  const auto faceVertices = m_helper.face()->vertexPositions();
 
   using Vertex = Renderer::GLVertexTypes::P3::Vertex;
   std::vector<Vertex> edgeVertices;
   edgeVertices.reserve(faceVertices.size());
 
-  for (const auto* vertex : faceVertices)
+  for (const auto& position : faceVertices)
   {
-    edgeVertices.push_back(Vertex(vm::vec3f(vertex->position())));
+    edgeVertices.push_back(Vertex(vm::vec3f(position)));
   }
 
   const Color edgeColor(1.0f, 1.0f, 1.0f, 1.0f); // TODO: make this a preference
@@ -395,14 +395,14 @@ vm::bbox3 UVViewHelper::computeFaceBoundsInCameraCoords() const
     vm::vec3(m_camera.position()));
 
   vm::bbox3 result;
-  const auto vertices = face()->vertices();
+  const auto vertices = face()->vertexPositions();
   auto it = std::begin(vertices);
   auto end = std::end(vertices);
 
-  result.min = result.max = transform * (*it++)->position();
+  result.min = result.max = transform * *it++;
   while (it != end)
   {
-    result = merge(result, transform * (*it++)->position());
+    result = merge(result, transform * *it++);
   }
   return result;
 }
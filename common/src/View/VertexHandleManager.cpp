@@ -20,6 +20,7 @@
 #include "VertexHandleManager.h"
 
 #include "FloatType.h"
+#include "Model/CompactBrushGeometry.h"
 #include "Model/Polyhedron.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
@@ -61,18 +62,18 @@ void VertexHandleManager::pick(
 void VertexHandleManager::addHandles(const Model::BrushNode* brushNode)
 {
   const Model::Brush& brush = brushNode->brush();
-  for (const Model::BrushVertex* vertex : brush.vertices())
+  for (const auto& position : brush.vertexPositions())
   {
-    add(vertex->position());
+    add(position);
   }
 }
 
 void VertexHandleManager::removeHandles(const Model::BrushNode* brushNode)
 {
   const Model::Brush& brush = brushNode->brush();
-  for (const Model::BrushVertex* vertex : brush.vertices())
+  for (const auto& position : brush.vertexPositions())
   {
-    assertResult(remove(vertex->position()));
+    assertResult(remove(position));
   }
 }
 
@@ -137,20 +138,23 @@ void EdgeHandleManager::pickCenterHandle(
 
 void EdgeHandleManager::addHandles(const Model::BrushNode* brushNode)
 {
-  const Model::Brush& brush = brushNode->brush();
-  for (const Model::BrushEdge* edge : brush.edges())
+  const auto& geometry = brushNode->brush().geometry();
+  for (size_t i = 0u; i < geometry.edgeCount(); ++i)
   {
-    add(vm::segment3(edge->firstVertex()->position(), edge->secondVertex()->position()));
+    const auto [vertexIndex1, vertexIndex2] = geometry.edgeVertexIndices(i);
+    add(vm::segment3(
+      geometry.vertexPosition(vertexIndex1), geometry.vertexPosition(vertexIndex2)));
   }
 }
 
 void EdgeHandleManager::removeHandles(const Model::BrushNode* brushNode)
 {
-  const Model::Brush& brush = brushNode->brush();
-  for (const Model::BrushEdge* edge : brush.edges())
+  const auto& geometry = brushNode->brush().geometry();
+  for (size_t i = 0u; i < geometry.edgeCount(); ++i)
   {
-    assertResult(remove(
-      vm::segment3(edge->firstVertex()->position(), edge->secondVertex()->position())));
+    const auto [vertexIndex1, vertexIndex2] = geometry.edgeVertexIndices(i);
+    assertResult(remove(vm::segment3(
+      geometry.vertexPosition(vertexIndex1), geometry.vertexPosition(vertexIndex2))));
   }
 }
 
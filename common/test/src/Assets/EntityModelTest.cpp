@@ -0,0 +1,153 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/EntityModel.h"
+#include "Assets/Texture.h"
+#include "Renderer/PrimType.h"
+#include "Renderer/TexturedIndexRangeRenderer.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Assets
+{
+namespace
+{
+/**
+ * Returns a square in the XY plane with the given size, made of 2 * n * n triangles.
+ */
+std::vector<EntityModelVertex> makeTessellatedSquare(const float size, const size_t n)
+{
+  const auto step = size / float(n);
+  auto result = std::vector<EntityModelVertex>{};
+  for (size_t y = 0; y < n; ++y)
+  {
+    for (size_t x = 0; x < n; ++x)
+    {
+      const auto x0 = float(x) * step;
+      const auto y0 = float(y) * step;
+      const auto p1 = vm::vec3f{x0, y0, 0};
+      const auto p2 = vm::vec3f{x0 + step, y0, 0};
+      const auto p3 = vm::vec3f{x0 + step, y0 + step, 0};
+      const auto p4 = vm::vec3f{x0, y0 + step, 0};
+      const auto uv = vm::vec2f{x0 / size, y0 / size};
+
+      result.emplace_back(p1, uv);
+      result.emplace_back(p2, uv);
+      result.emplace_back(p3, uv);
+      result.emplace_back(p1, uv);
+      result.emplace_back(p3, uv);
+      result.emplace_back(p4, uv);
+    }
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("EntityModelTest.simplifyTriangles", "[EntityModelTest]")
+{
+  SECTION("Triangles larger than the cells are kept")
+  {
+    const auto triangles = makeTessellatedSquare(64.0f, 4);
+    CHECK(simplifyTriangles(triangles, 1.0f).size() == triangles.size());
+  }
+
+  SECTION("Triangles within a cell are removed")
+  {
+    const auto triangles = makeTessellatedSquare(4.0f, 4);
+    CHECK(simplifyTriangles(triangles, 64.0f).empty());
+  }
+
+  SECTION("Fine triangles are merged")
+  {
+    const auto triangles = makeTessellatedSquare(64.0f, 32);
+    const auto simplified = simplifyTriangles(triangles, 8.0f);
+
+    CHECK_FALSE(simplified.empty());
+    CHECK(simplified.size() % 3u == 0u);
+    CHECK(simplified.size() < triangles.size() / 4u);
+
+    const auto bounds = vm::bbox3f{{0, 0, 0}, {64, 64, 0}};
+    for (size_t i = 0; i < simplified.size(); i += 3)
+    {
+      const auto& p1 = Renderer::getVertexComponent<0>(simplified[i + 0]);
+      const auto& p2 = Renderer::getVertexComponent<0>(simplified[i + 1]);
+      const auto& p3 = Renderer::getVertexComponent<0>(simplified[i + 2]);
+      CHECK(bounds.contains(p1));
+      CHECK(p1 != p2);
+      CHECK(p2 != p3);
+      CHECK(p1 != p3);
+    }
+  }
+}
+
+TEST_CASE("EntityModelTest.buildRendererWithLevelsOfDetail", "[EntityModelTest]")
+{
+  auto model = EntityModel{"model", PitchType::Normal, Orientation::Oriented};
+  model.addFrame();
+  auto& frame = model.loadFrame(0, "frame", vm::bbox3f{{0, 0, 0}, {64, 64, 0}});
+
+  auto skins = std::vector<Texture>{};
+  skins.emplace_back("skin", 1, 1);
+
+  auto& surface = model.addSurface("surface");
+  surface.setSkins(std::move(skins));
+
+  SECTION("Coarse meshes have no simplified levels of detail")
+  {
+    auto vertices = makeTessellatedSquare(64.0f, 2);
+    const auto vertexCount = vertices.size();
+    surface.addIndexedMesh(
+      frame,
+      std::move(vertices),
+      EntityModelIndices{Renderer::PrimType::Triangles, 0, vertexCount});
+
+    CHECK(surface.levelOfDetailCount(0) == 1u);
+
+    const auto renderer = model.buildRenderer(0, 0);
+    CHECK(renderer != nullptr);
+    CHECK(dynamic_cast<Renderer::LevelOfDetailRenderer*>(renderer.get()) == nullptr);
+  }
+
+  SECTION("Fine meshes have simplified levels of detail")
+  {
+    auto vertices = makeTessellatedSquare(64.0f, 32);
+    const auto vertexCount = vertices.size();
+    surface.addIndexedMesh(
+      frame,
+      std::move(vertices),
+      EntityModelIndices{Renderer::PrimType::Triangles, 0, vertexCount});
+
+    CHECK(surface.levelOfDetailCount(0) == 3u);
+
+    const auto renderer = model.buildRenderer(0, 0);
+    const auto* lodRenderer =
+      dynamic_cast<Renderer::LevelOfDetailRenderer*>(renderer.get());
+    REQUIRE(lodRenderer != nullptr);
+    CHECK(lodRenderer->levelOfDetailCount() == 3u);
+  }
+}
+} // namespace Assets
+} // namespace TrenchBroom
@@ -0,0 +1,48 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/ContentHash.h"
+
+#include <string>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace IO
+{
+TEST_CASE("ContentHashTest.contentHash", "[ContentHashTest]")
+{
+  // reference values computed with the xxHash library
+  CHECK(contentHash("") == 0xef46db3751d8e999u);
+  CHECK(contentHash("a") == 0xd24ec4f1a98c6e5bu);
+  CHECK(contentHash("abc") == 0x44bc2cf5ad770999u);
+  CHECK(contentHash("0123456789abcdefghijklmnopqrstuvwxyz") == 0x69196c1b3af0bff9u);
+  CHECK(
+    contentHash("The quick brown fox jumps over the lazy dog") == 0x0b242d361fda71bcu);
+
+  auto bytes = std::string(1000u, '\0');
+  for (size_t i = 0; i < bytes.size(); ++i)
+  {
+    bytes[i] = static_cast<char>((i * 7u) % 256u);
+  }
+  CHECK(contentHash(bytes) == 0x25275608a9cfc168u);
+}
+} // namespace IO
+} // namespace TrenchBroom
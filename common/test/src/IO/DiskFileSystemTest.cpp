@@ -29,6 +29,8 @@
 
 #include <algorithm>
 
+#include <QDateTime>
+#include <QFile>
 #include <QFileInfo>
 #include <QString>
 
@@ -106,6 +108,36 @@ TEST_CASE("DiskTest.fixPath", "[DiskTest]")
     Disk::fixPath(env.dir() + Path("anotHERDIR/./SUBdirTEST/../SubdirTesT/TesT2.MAP")))));
 }
 
+TEST_CASE("DiskTest.fixPathAfterChanges", "[DiskTest]")
+{
+  auto env = makeTestEnvironment();
+
+  if (Disk::isCaseSensitive())
+  {
+    // the first lookup caches the contents of anotherDir
+    CHECK(
+      env.dir() + Path("anotherDir/test3.map")
+      == Disk::fixPath(env.dir() + Path("ANOTHERdir/TEST3.MAP")));
+    CHECK(
+      env.dir() + Path("ANOTHERdir/TEST4.MAP")
+      == Disk::fixPath(env.dir() + Path("ANOTHERdir/TEST4.MAP")));
+
+    env.createFile(Path("anotherDir/test4.map"), "//a new test file\n{}");
+    CHECK(
+      env.dir() + Path("anotherDir/test4.map")
+      == Disk::fixPath(env.dir() + Path("ANOTHERdir/TEST4.MAP")));
+
+    // exact matches are preferred
+    env.createFile(Path("anotherDir/TEST3.map"), "//a test file with a similar name\n{}");
+    CHECK(
+      env.dir() + Path("anotherDir/TEST3.map")
+      == Disk::fixPath(env.dir() + Path("anotherDir/TEST3.map")));
+    CHECK(
+      env.dir() + Path("anotherDir/test3.map")
+      == Disk::fixPath(env.dir() + Path("anotherDir/test3.map")));
+  }
+}
+
 TEST_CASE("DiskTest.directoryExists", "[DiskTest]")
 {
   const auto env = makeTestEnvironment();
@@ -171,6 +203,58 @@ TEST_CASE("DiskTest.openFile", "[DiskTest]")
   CHECK(Disk::openFile(env.dir() + Path("anotherDir/subDirTest/test2.map")) != nullptr);
 }
 
+TEST_CASE("DiskTest.openMappedFile", "[DiskTest]")
+{
+  const auto env = makeTestEnvironment();
+
+  CHECK_THROWS_AS(
+    Disk::openMappedFile(env.dir() + Path("does_not_exist.txt")), FileNotFoundException);
+
+  const auto file = Disk::openMappedFile(env.dir() + Path("test.txt"));
+  CHECK(file->size() == 12u);
+
+  auto reader = file->reader().buffer();
+  CHECK(reader.stringView() == "some content");
+}
+
+TEST_CASE("DiskTest.trimDirectory", "[DiskTest]")
+{
+  const auto env = TestEnvironment{
+    Catch::getResultCapture().getCurrentTestName(), [](TestEnvironment& env) {
+      env.createFile(Path("old.bin"), "0123456789");
+      env.createFile(Path("mid.bin"), "0123456789");
+      env.createFile(Path("new.bin"), "0123456789");
+    }};
+
+  const auto setModificationTime = [&](const std::string& name, const int secondsAgo) {
+    auto file = QFile{pathAsQString(env.dir() + Path(name))};
+    REQUIRE(file.open(QIODevice::ReadWrite));
+    const auto time = QDateTime::currentDateTime().addSecs(-secondsAgo);
+    file.setFileTime(time, QFileDevice::FileModificationTime);
+  };
+
+  setModificationTime("old.bin", 300);
+  setModificationTime("mid.bin", 200);
+  setModificationTime("new.bin", 100);
+
+  Disk::trimDirectory(env.dir(), 30u);
+  CHECK(env.fileExists(Path("old.bin")));
+  CHECK(env.fileExists(Path("mid.bin")));
+  CHECK(env.fileExists(Path("new.bin")));
+
+  // touching a file makes it the most recently used one
+  Disk::touchFile(env.dir() + Path("old.bin"));
+
+  Disk::trimDirectory(env.dir(), 25u);
+  CHECK(env.fileExists(Path("old.bin")));
+  CHECK(env.fileExists(Path("new.bin")));
+  CHECK_FALSE(env.fileExists(Path("mid.bin")));
+
+  Disk::trimDirectory(env.dir(), 0u);
+  CHECK_FALSE(env.fileExists(Path("old.bin")));
+  CHECK_FALSE(env.fileExists(Path("new.bin")));
+}
+
 TEST_CASE("DiskTest.resolvePath", "[DiskTest]")
 {
   const auto env = makeTestEnvironment();
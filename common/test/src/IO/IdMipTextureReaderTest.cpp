@@ -86,5 +86,27 @@ TEST_CASE("IdMipTextureReaderTest.testLoadWad", "[IdMipTextureReaderTest]")
   CHECK(texture.width() == width);
   CHECK(texture.height() == height);
 }
+
+TEST_CASE("IdMipTextureReaderTest.testLoadWadInfo", "[IdMipTextureReaderTest]")
+{
+  DiskFileSystem fs(IO::Disk::getCurrentWorkingDir());
+  const Assets::Palette palette =
+    Assets::Palette::loadFile(fs, Path("fixture/test/palette.lmp"));
+
+  TextureReader::TextureNameStrategy nameStrategy;
+  NullLogger logger;
+  IdMipTextureReader textureLoader(nameStrategy, fs, logger, palette);
+
+  const Path wadPath =
+    Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Wad/cr8_czg.wad");
+  WadFileSystem wadFS(wadPath, logger);
+
+  const Assets::Texture texture =
+    textureLoader.readTextureInfo(wadFS.openFile(Path("cr8_czg_3.D")));
+  CHECK(texture.name() == "cr8_czg_3");
+  CHECK(texture.width() == 64u);
+  CHECK(texture.height() == 128u);
+  CHECK_FALSE(texture.loaded());
+}
 } // namespace IO
 } // namespace TrenchBroom
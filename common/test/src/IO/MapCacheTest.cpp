@@ -0,0 +1,296 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/DiskIO.h"
+#include "IO/IOUtils.h"
+#include "IO/MapCache.h"
+#include "IO/NodeWriter.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/BrushNode.h"
+#include "Model/EntityNode.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/PatchNode.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/overload.h>
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace IO
+{
+namespace
+{
+std::string writeMap(const Model::WorldNode& worldNode)
+{
+  auto str = std::stringstream{};
+  auto writer = NodeWriter{worldNode, str};
+  writer.writeMap();
+  return str.str();
+}
+
+std::vector<const Model::Node*> collectNodes(const Model::WorldNode& worldNode)
+{
+  auto result = std::vector<const Model::Node*>{};
+  worldNode.accept(kdl::overload(
+    [&](auto&& thisLambda, const Model::WorldNode* w) {
+      result.push_back(w);
+      w->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const Model::LayerNode* l) {
+      result.push_back(l);
+      l->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const Model::GroupNode* g) {
+      result.push_back(g);
+      g->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const Model::EntityNode* e) {
+      result.push_back(e);
+      e->visitChildren(thisLambda);
+    },
+    [&](const Model::BrushNode* b) { result.push_back(b); },
+    [&](const Model::PatchNode* p) { result.push_back(p); }));
+  return result;
+}
+
+void checkEqualWorlds(const Model::WorldNode& expected, const Model::WorldNode& actual)
+{
+  CHECK(actual.mapFormat() == expected.mapFormat());
+  CHECK(writeMap(actual) == writeMap(expected));
+
+  const auto expectedNodes = collectNodes(expected);
+  const auto actualNodes = collectNodes(actual);
+  REQUIRE(actualNodes.size() == expectedNodes.size());
+
+  for (size_t i = 0; i < expectedNodes.size(); ++i)
+  {
+    CHECK(actualNodes[i]->lineNumber() == expectedNodes[i]->lineNumber());
+
+    const auto* expectedBrushNode =
+      dynamic_cast<const Model::BrushNode*>(expectedNodes[i]);
+    const auto* actualBrushNode = dynamic_cast<const Model::BrushNode*>(actualNodes[i]);
+    REQUIRE((expectedBrushNode == nullptr) == (actualBrushNode == nullptr));
+    if (expectedBrushNode)
+    {
+      const auto& expectedBrush = expectedBrushNode->brush();
+      const auto& actualBrush = actualBrushNode->brush();
+      CHECK(actualBrush.faces() == expectedBrush.faces());
+      CHECK(actualBrush.vertexPositions() == expectedBrush.vertexPositions());
+      CHECK(actualBrush.edgeCount() == expectedBrush.edgeCount());
+      CHECK(actualBrush.bounds() == expectedBrush.bounds());
+      for (size_t j = 0; j < expectedBrush.faceCount(); ++j)
+      {
+        CHECK(
+          actualBrush.face(j).vertexPositions()
+          == expectedBrush.face(j).vertexPositions());
+        CHECK(
+          actualBrush.face(j).lineNumber() == expectedBrush.face(j).lineNumber());
+      }
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("MapCacheTest.writeAndRead", "[MapCacheTest]")
+{
+  const auto env = TestEnvironment{};
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto cachePath = env.dir() + Path{"cache/map.tbcache"};
+
+  using T = std::tuple<Model::MapFormat, std::string>;
+
+  // clang-format off
+  const auto
+  [mapFormat,                  data] = GENERATE(values<T>({
+  {Model::MapFormat::Valve,    R"(
+{
+"classname" "worldspawn"
+"mapversion" "220"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) tex1 [ 0 -1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) tex2 [ 1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) tex3 [ -1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) tex4 [ 1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) tex5 [ -1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) tex6 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+}
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "My Layer"
+"_tb_id" "1"
+"_tb_layer_sort_index" "0"
+"_tb_layer_locked" "1"
+{
+( 0 0 0 ) ( 0 1 0 ) ( 0 0 1 ) tex1 [ 0 -1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( 0 0 0 ) ( 0 0 1 ) ( 1 0 0 ) tex1 [ 1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( 0 0 0 ) ( 1 0 0 ) ( 0 1 0 ) tex1 [ 1 0 0 16 ] [ 0 -1 0 8 ] 45 0.5 2
+( 32 32 32 ) ( 32 33 32 ) ( 33 32 32 ) tex1 [ 1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 32 32 32 ) ( 33 32 32 ) ( 32 32 33 ) tex1 [ -1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( 32 32 32 ) ( 32 32 33 ) ( 32 33 32 ) tex1 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+}
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "My Group"
+"_tb_id" "2"
+"_tb_layer" "1"
+}
+{
+"classname" "light"
+"origin" "0 0 32"
+"_tb_group" "2"
+}
+{
+"classname" "func_door"
+"target" "the door"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) door [ 0 -1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) door [ 1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) door [ -1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) door [ 1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) door [ -1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) door [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+}
+}
+)"},
+  {Model::MapFormat::Quake3,   R"(
+{
+"classname" "worldspawn"
+{
+( 64 64 64 ) ( 64 -64 64 ) ( -64 64 64 ) common/caulk 0 0 0 1 1 134217728 0 0
+( 64 64 64 ) ( -64 64 64 ) ( 64 64 -64 ) common/caulk 0 0 0 1 1 134217728 0 0
+( 64 64 64 ) ( 64 64 -64 ) ( 64 -64 64 ) common/caulk 0 0 0 1 1 134217728 0 0
+( -64 -64 -64 ) ( 64 -64 -64 ) ( -64 64 -64 ) common/caulk 16 8 30 0.5 2 0 4 1
+( -64 -64 -64 ) ( -64 -64 64 ) ( 64 -64 -64 ) common/caulk 0 0 0 1 1 134217728 0 0
+( -64 -64 -64 ) ( -64 64 -64 ) ( -64 -64 64 ) common/caulk 0 0 0 1 1 134217728 0 0
+}
+{
+patchDef2
+{
+common/caulk
+( 3 3 0 0 0 )
+(
+( (-64 -64 4 0   0 ) (-64 0 4 0   -0.25 ) (-64 64 4 0   -0.5 ) )
+( (  0 -64 4 0.2 0 ) (  0 0 4 0.2 -0.25 ) (  0 64 4 0.2 -0.5 ) )
+( ( 64 -64 4 0.4 0 ) ( 64 0 4 0.4 -0.25 ) ( 64 64 4 0.4 -0.5 ) )
+)
+}
+}
+}
+)"},
+  }));
+  // clang-format on
+
+  CAPTURE(mapFormat);
+
+  auto status = TestParserStatus{};
+  const auto cache = MapCache{cachePath, data, "Test", mapFormat, worldBounds};
+  CHECK(cache.read() == std::nullopt);
+  CHECK(WorldReader::readFromCache(cache, worldBounds, {}, status) == nullptr);
+
+  auto reader = WorldReader{data, mapFormat, {}};
+  const auto expected = reader.read(worldBounds, status);
+  cache.write(cache.serialize(*expected));
+  REQUIRE(Disk::fileExists(cachePath));
+
+  const auto actual = WorldReader::readFromCache(cache, worldBounds, {}, status);
+  REQUIRE(actual != nullptr);
+  checkEqualWorlds(*expected, *actual);
+
+  SECTION("The cache isn't used for different contents or parameters")
+  {
+    const auto otherData = data + "\n";
+    CHECK(
+      MapCache{cachePath, otherData, "Test", mapFormat, worldBounds}.read()
+      == std::nullopt);
+    CHECK(
+      MapCache{cachePath, data, "Other", mapFormat, worldBounds}.read() == std::nullopt);
+    CHECK(
+      MapCache{cachePath, data, "Test", Model::MapFormat::Unknown, worldBounds}.read()
+      == std::nullopt);
+    CHECK(
+      MapCache{cachePath, data, "Test", mapFormat, vm::bbox3{4096.0}}.read()
+      == std::nullopt);
+  }
+
+  SECTION("A damaged cache file isn't used")
+  {
+    auto contents = std::string{};
+    {
+      auto stream = openPathAsInputStream(cachePath, std::ios::in | std::ios::binary);
+      contents = std::string{std::istreambuf_iterator<char>{stream}, {}};
+    }
+    {
+      auto stream = openPathAsOutputStream(cachePath, std::ios::out | std::ios::binary);
+      stream.write(contents.data(), static_cast<std::streamsize>(contents.size() - 8u));
+    }
+    CHECK(cache.read() == std::nullopt);
+  }
+}
+
+TEST_CASE("MapCacheTest.tryReadWithUnknownFormat", "[MapCacheTest]")
+{
+  const auto env = TestEnvironment{};
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto cachePath = env.dir() + Path{"map.tbcache"};
+
+  const auto data = std::string{R"(
+{
+"classname" "worldspawn"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) tex1 0 0 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) tex2 0 0 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) tex3 0 0 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) tex4 0 0 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) tex5 0 0 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) tex6 0 0 0 1 1
+}
+}
+)"};
+
+  auto status = TestParserStatus{};
+  const auto cache =
+    MapCache{cachePath, data, "Test", Model::MapFormat::Unknown, worldBounds};
+
+  const auto expected = WorldReader::tryRead(
+    data, {Model::MapFormat::Valve, Model::MapFormat::Standard}, worldBounds, {}, status);
+  cache.write(cache.serialize(*expected));
+
+  const auto actual = WorldReader::readFromCache(cache, worldBounds, {}, status);
+  REQUIRE(actual != nullptr);
+  CHECK(actual->mapFormat() == Model::MapFormat::Standard);
+  checkEqualWorlds(*expected, *actual);
+}
+} // namespace IO
+} // namespace TrenchBroom
@@ -1308,5 +1308,91 @@ common/caulk
   CHECK(actual == expected);
 }
 
+TEST_CASE("NodeWriterTest.reuseSerializedTextOfUnchangedNodes", "[NodeWriterTest]")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+
+  auto map = Model::WorldNode{{}, {}, Model::MapFormat::Standard};
+
+  auto builder = Model::BrushBuilder{map.mapFormat(), worldBounds};
+  auto* brushNode1 = new Model::BrushNode{builder.createCube(64.0, "none").value()};
+  auto* brushNode2 = new Model::BrushNode{builder.createCube(32.0, "none").value()};
+  auto* patchNode = new Model::PatchNode{Model::BezierPatch{
+    3,
+    3,
+    {{0, 0, 0, 0, 0},
+     {1, 0, 0, 0, 0},
+     {2, 0, 0, 0, 0},
+     {0, 1, 0, 0, 0},
+     {1, 1, 0, 0, 0},
+     {2, 1, 0, 0, 0},
+     {0, 2, 0, 0, 0},
+     {1, 2, 0, 0, 0},
+     {2, 2, 0, 0, 0}},
+    "texture"}};
+
+  map.defaultLayer()->addChild(brushNode1);
+  map.defaultLayer()->addChild(brushNode2);
+  map.defaultLayer()->addChild(patchNode);
+
+  const auto writeMap = [&]() {
+    auto str = std::stringstream{};
+    auto writer = NodeWriter{map, str};
+    writer.writeMap();
+    return str.str();
+  };
+
+  CHECK(brushNode1->serializedText(Model::MapFormat::Standard) == nullptr);
+  CHECK(patchNode->serializedText(Model::MapFormat::Standard) == nullptr);
+
+  const auto original = writeMap();
+
+  const auto* brushText1 = brushNode1->serializedText(Model::MapFormat::Standard);
+  const auto* brushText2 = brushNode2->serializedText(Model::MapFormat::Standard);
+  const auto* patchText = patchNode->serializedText(Model::MapFormat::Standard);
+  REQUIRE(brushText1 != nullptr);
+  REQUIRE(brushText2 != nullptr);
+  REQUIRE(patchText != nullptr);
+  CHECK(brushText1->lineCount == 6u);
+  CHECK(patchText->lineCount == 12u);
+  CHECK(brushNode1->serializedText(Model::MapFormat::Valve) == nullptr);
+
+  SECTION("Writing an unchanged map reuses the serialized text")
+  {
+    CHECK(writeMap() == original);
+    CHECK(brushNode1->serializedText(Model::MapFormat::Standard) == brushText1);
+    CHECK(brushNode2->serializedText(Model::MapFormat::Standard) == brushText2);
+    CHECK(patchNode->serializedText(Model::MapFormat::Standard) == patchText);
+  }
+
+  SECTION("Changing a brush invalidates its serialized text")
+  {
+    auto brush = brushNode1->brush();
+    REQUIRE(
+      brush.transform(worldBounds, vm::translation_matrix(vm::vec3{16, 0, 0}), false)
+        .is_success());
+    brushNode1->setBrush(std::move(brush));
+
+    CHECK(brushNode1->serializedText(Model::MapFormat::Standard) == nullptr);
+    CHECK(brushNode2->serializedText(Model::MapFormat::Standard) == brushText2);
+
+    const auto changed = writeMap();
+    CHECK(changed != original);
+    CHECK_THAT(
+      changed,
+      Catch::Contains("( -16 -32 -32 ) ( -16 -31 -32 ) ( -16 -32 -31 ) none 0 0 0 1 1"));
+    CHECK(brushNode1->serializedText(Model::MapFormat::Standard) != nullptr);
+  }
+
+  SECTION("Changing a patch invalidates its serialized text")
+  {
+    auto patch = patchNode->patch();
+    patch.setTextureName("other");
+    patchNode->setPatch(std::move(patch));
+
+    CHECK(patchNode->serializedText(Model::MapFormat::Standard) == nullptr);
+    CHECK_THAT(writeMap(), Catch::Contains("other"));
+  }
+}
 } // namespace IO
 } // namespace TrenchBroom
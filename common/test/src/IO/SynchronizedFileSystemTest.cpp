@@ -0,0 +1,64 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/SynchronizedFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Reader.h"
+#include "IO/WadFileSystem.h"
+#include "Logger.h"
+
+#include <kdl/parallel.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace IO
+{
+TEST_CASE("SynchronizedFileSystemTest.openFile", "[SynchronizedFileSystemTest]")
+{
+  const Path wadPath =
+    Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Wad/cr8_czg.wad");
+  NullLogger logger;
+  const auto wadFS = std::make_shared<WadFileSystem>(wadPath, logger);
+  const auto fs = SynchronizedFileSystem{wadFS};
+
+  const auto paths = fs.findItems(Path(""));
+  CHECK(paths == wadFS->findItems(Path("")));
+
+  auto files = std::vector<std::shared_ptr<File>>(paths.size());
+  kdl::parallel_for(
+    paths.size(), [&](const size_t i) { files[i] = fs.openFile(paths[i]); });
+
+  for (size_t i = 0; i < paths.size(); ++i)
+  {
+    CHECK(dynamic_cast<const OwningBufferFile*>(files[i].get()) != nullptr);
+
+    const auto expected = wadFS->openFile(paths[i])->reader().buffer();
+    const auto actual = files[i]->reader().buffer();
+    CHECK(std::equal(expected.begin(), expected.end(), actual.begin(), actual.end()));
+  }
+}
+} // namespace IO
+} // namespace TrenchBroom
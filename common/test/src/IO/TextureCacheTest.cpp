@@ -0,0 +1,153 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Color.h"
+#include "IO/ContentHash.h"
+#include "IO/DiskIO.h"
+#include "IO/IOUtils.h"
+#include "IO/Path.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TextureCache.h"
+#include "Renderer/GL.h"
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace IO
+{
+namespace
+{
+Assets::Texture makeTexture()
+{
+  auto buffers = Assets::TextureBufferList{};
+  Assets::setMipBufferSize(buffers, 3u, 4u, 2u, GL_BGRA);
+  for (size_t level = 0; level < buffers.size(); ++level)
+  {
+    auto& buffer = buffers[level];
+    for (size_t i = 0; i < buffer.size(); ++i)
+    {
+      buffer.data()[i] = static_cast<unsigned char>(level * 64u + i);
+    }
+  }
+
+  return Assets::Texture{
+    "texture",
+    4u,
+    2u,
+    Color{0.25f, 0.5f, 0.75f, 1.0f},
+    std::move(buffers),
+    GL_BGRA,
+    Assets::TextureType::Masked};
+}
+} // namespace
+
+TEST_CASE("TextureCacheTest.writeAndRead", "[TextureCacheTest]")
+{
+  const auto env = TestEnvironment{};
+  const auto cacheDir = env.dir() + Path{"cache"};
+  const auto imagePath = Path{"textures/base/texture.png"};
+  const auto imageContents = std::string{"image contents"};
+
+  const auto cache = TextureCache{cacheDir, 1024u * 1024u};
+  CHECK(cache.read(imagePath, imageContents, "texture") == std::nullopt);
+
+  const auto texture = makeTexture();
+  cache.write(imagePath, imageContents, texture);
+
+  SECTION("The cached texture is read")
+  {
+    const auto cachedTexture = cache.read(imagePath, imageContents, "cached");
+    REQUIRE(cachedTexture != std::nullopt);
+    CHECK(cachedTexture->name() == "cached");
+    CHECK(cachedTexture->width() == texture.width());
+    CHECK(cachedTexture->height() == texture.height());
+    CHECK(cachedTexture->averageColor() == texture.averageColor());
+    CHECK(cachedTexture->format() == texture.format());
+    CHECK(cachedTexture->type() == texture.type());
+
+    const auto& expectedBuffers = texture.buffersIfUnprepared();
+    const auto& buffers = cachedTexture->buffersIfUnprepared();
+    REQUIRE(buffers.size() == expectedBuffers.size());
+    for (size_t i = 0; i < buffers.size(); ++i)
+    {
+      REQUIRE(buffers[i].size() == expectedBuffers[i].size());
+      CHECK(
+        std::memcmp(buffers[i].data(), expectedBuffers[i].data(), buffers[i].size())
+        == 0);
+    }
+  }
+
+  SECTION("The cache file is named after the content hash of the image path")
+  {
+    auto fileName = std::stringstream{};
+    fileName << std::hex << std::setw(16) << std::setfill('0')
+             << contentHash(imagePath.asString()) << ".tbtexture";
+    CHECK(
+      Disk::findItems(cacheDir) == std::vector<Path>{cacheDir + Path{fileName.str()}});
+  }
+
+  SECTION("The cache isn't used for different contents or paths")
+  {
+    CHECK(cache.read(imagePath, "other contents", "texture") == std::nullopt);
+    CHECK(
+      cache.read(Path{"textures/other.png"}, imageContents, "texture") == std::nullopt);
+  }
+
+  SECTION("A damaged cache file isn't used")
+  {
+    const auto cacheFiles = Disk::findItems(cacheDir);
+    REQUIRE(cacheFiles.size() == 1u);
+
+    auto contents = std::string{};
+    {
+      auto stream =
+        openPathAsInputStream(cacheFiles.front(), std::ios::in | std::ios::binary);
+      contents = std::string{std::istreambuf_iterator<char>{stream}, {}};
+    }
+    {
+      auto stream =
+        openPathAsOutputStream(cacheFiles.front(), std::ios::out | std::ios::binary);
+      stream.write(contents.data(), static_cast<std::streamsize>(contents.size() - 8u));
+    }
+    CHECK(cache.read(imagePath, imageContents, "texture") == std::nullopt);
+  }
+
+  SECTION("Trimming the cache removes files exceeding its size")
+  {
+    cache.trim();
+    CHECK(Disk::findItems(cacheDir).size() == 1u);
+
+    const auto smallCache = TextureCache{cacheDir, 16u};
+    smallCache.trim();
+    CHECK(Disk::findItems(cacheDir).empty());
+  }
+}
+} // namespace IO
+} // namespace TrenchBroom
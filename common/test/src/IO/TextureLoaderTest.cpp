@@ -23,10 +23,13 @@
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
 #include "IO/Path.h"
+#include "IO/SynchronizedFileSystem.h"
 #include "Logger.h"
 #include "Model/GameConfig.h"
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "Catch2.h"
 
@@ -40,7 +43,8 @@ TEST_CASE("TextureLoaderTest.testLoad", "[TextureLoaderTest]")
 
   const IO::Path root = IO::Disk::getCurrentWorkingDir();
   const std::vector<IO::Path> fileSearchPaths{root};
-  const IO::DiskFileSystem fileSystem(root, true);
+  const auto fileSystem = std::make_shared<IO::SynchronizedFileSystem>(
+    std::make_shared<IO::DiskFileSystem>(root, true));
 
   const Model::TextureConfig textureConfig{
     Model::TextureFilePackageConfig{Model::PackageFormatConfig{{"wad"}, "idmip"}},
@@ -98,7 +102,8 @@ TEST_CASE("TextureLoaderTest.testLoadExclusions", "[TextureLoaderTest]")
 
   const IO::Path root = IO::Disk::getCurrentWorkingDir();
   const std::vector<IO::Path> fileSearchPaths{root};
-  const IO::DiskFileSystem fileSystem(root, true);
+  const auto fileSystem = std::make_shared<IO::SynchronizedFileSystem>(
+    std::make_shared<IO::DiskFileSystem>(root, true));
 
   const Model::TextureConfig textureConfig{
     Model::TextureFilePackageConfig{Model::PackageFormatConfig{{"wad"}, "idmip"}},
@@ -144,5 +149,73 @@ TEST_CASE("TextureLoaderTest.testLoadExclusions", "[TextureLoaderTest]")
     CHECK(texture->height() == height);
   }
 }
+
+TEST_CASE("TextureLoaderTest.testLoadLazily", "[TextureLoaderTest]")
+{
+  const std::vector<IO::Path> paths({Path("fixture/test/IO/Wad/cr8_czg.wad")});
+
+  const IO::Path root = IO::Disk::getCurrentWorkingDir();
+  const std::vector<IO::Path> fileSearchPaths{root};
+  const auto fileSystem = std::make_shared<IO::SynchronizedFileSystem>(
+    std::make_shared<IO::DiskFileSystem>(root, true));
+
+  const Model::TextureConfig textureConfig{
+    Model::TextureFilePackageConfig{Model::PackageFormatConfig{{"wad"}, "idmip"}},
+    Model::PackageFormatConfig{{"D"}, "idmip"},
+    IO::Path{"fixture/test/palette.lmp"},
+    "wad",
+    IO::Path{},
+    {}};
+
+  auto logger = NullLogger();
+  auto textureManager = Assets::TextureManager(0, 0, logger);
+
+  IO::TextureLoader textureLoader(
+    fileSystem, fileSearchPaths, textureConfig, logger, true);
+  textureLoader.loadTextures(paths, textureManager);
+
+  CHECK(textureManager.textures().size() == 21u);
+
+  auto* texture = textureManager.texture("cr8_czg_3");
+  REQUIRE(texture != nullptr);
+  CHECK(texture->width() == 64u);
+  CHECK(texture->height() == 128u);
+  CHECK(texture->lazy());
+  CHECK_FALSE(texture->loaded());
+  CHECK(texture->cpuByteSize() == 0u);
+
+  const auto& collection = textureManager.collections().front();
+  CHECK(collection.cpuByteSize() == 0u);
+  CHECK(collection.gpuByteSize() == 0u);
+
+  texture->load();
+  CHECK(texture->loaded());
+  CHECK(texture->buffersIfUnprepared().size() == 4u);
+  CHECK(texture->cpuByteSize() == (64u * 128u * 4u) * 85u / 64u);
+  CHECK(texture->gpuByteSize() == 0u);
+  CHECK(collection.cpuByteSize() == texture->cpuByteSize());
+
+  texture->unload();
+  CHECK_FALSE(texture->loaded());
+  CHECK(texture->lazy());
+  CHECK(texture->cpuByteSize() == 0u);
+
+  auto requestQueue = Assets::TextureRequestQueue{};
+  texture->setRequestQueue(&requestQueue);
+
+  texture->request();
+  texture->request();
+  CHECK(requestQueue.take() == std::vector<const Assets::Texture*>{texture});
+
+  texture->resetRequested();
+  texture->incUsageCount();
+  texture->incUsageCount();
+  CHECK(requestQueue.take() == std::vector<const Assets::Texture*>{texture});
+  CHECK(requestQueue.take().empty());
+
+  texture->decUsageCount();
+  texture->decUsageCount();
+  texture->setRequestQueue(nullptr);
+}
 } // namespace IO
 } // namespace TrenchBroom
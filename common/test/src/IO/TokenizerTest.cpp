@@ -17,6 +17,7 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "IO/StandardMapParser.h"
 #include "IO/Tokenizer.h"
 #include "IO/Token.h"
 
@@ -279,5 +280,97 @@ TEST_CASE(
   CHECK((token = tokenizer.nextToken()).type() == SimpleToken::CBrace);
   CHECK(tokenizer.nextToken().type() == SimpleToken::Eof);
 }
+
+TEST_CASE("TokenizerTest.simpleLanguageLongTokens", "[TokenizerTest]")
+{
+  // long tokens and runs of whitespace are skipped in bulk
+  const auto longString = std::string(100, 'x');
+  const auto longInteger = std::string(40, '1');
+  const std::string testString = "{\r\n" + longString + " =\n\n" + longInteger
+                                 + "   ;\r\n" + std::string(50, ' ') + "}";
+
+  SimpleTokenizer tokenizer(testString);
+  SimpleTokenizer::Token token;
+  CHECK((token = tokenizer.nextToken()).type() == SimpleToken::OBrace);
+  CHECK((token = tokenizer.nextToken()).type() == SimpleToken::String);
+  CHECK(token.data() == longString);
+  CHECK(token.line() == 2u);
+  CHECK(token.column() == 1u);
+  CHECK((token = tokenizer.nextToken()).type() == SimpleToken::Equals);
+  CHECK(token.line() == 2u);
+  CHECK(token.column() == 102u);
+  CHECK((token = tokenizer.nextToken()).type() == SimpleToken::Integer);
+  CHECK(token.data() == longInteger);
+  CHECK(token.line() == 4u);
+  CHECK(token.column() == 1u);
+  CHECK((token = tokenizer.nextToken()).type() == SimpleToken::Semicolon);
+  CHECK(token.line() == 4u);
+  CHECK(token.column() == 44u);
+  CHECK((token = tokenizer.nextToken()).type() == SimpleToken::CBrace);
+  CHECK(token.line() == 5u);
+  CHECK(token.column() == 51u);
+  CHECK(tokenizer.nextToken().type() == SimpleToken::Eof);
+}
+
+TEST_CASE("TokenizerTest.quotedStringsWithEscapes", "[TokenizerTest]")
+{
+  // short and long strings, so that escapes are found both while examining single
+  // characters and while skipping runs in bulk
+  const auto backslashes = std::string(20, '\\');
+  const auto testString =
+    std::string{R"("short \" quote" )"
+                R"("a long string with an escaped \" quote in the middle")"
+                "\n"
+                R"("ends with four backslashes \\\\" "three backslashes \\\" and more")"
+                "\n"}
+    + "\"" + backslashes + "\" " + R"("c:\quake\id1\")" + "\n}";
+
+  const auto skipRunsInBulk = GENERATE(true, false);
+  CAPTURE(skipRunsInBulk);
+
+  auto tokenizer = QuakeMapTokenizer{testString};
+  tokenizer.setSkipRunsInBulk(skipRunsInBulk);
+
+  auto token = tokenizer.nextToken();
+  CHECK(token.type() == QuakeMapToken::String);
+  CHECK(token.data() == R"(short \" quote)");
+
+  token = tokenizer.nextToken();
+  CHECK(token.type() == QuakeMapToken::String);
+  CHECK(token.data() == R"(a long string with an escaped \" quote in the middle)");
+
+  token = tokenizer.nextToken();
+  CHECK(token.type() == QuakeMapToken::String);
+  CHECK(token.data() == R"(ends with four backslashes \\\\)");
+  CHECK(token.line() == 2u);
+  CHECK(token.column() == 1u);
+
+  token = tokenizer.nextToken();
+  CHECK(token.type() == QuakeMapToken::String);
+  CHECK(token.data() == R"(three backslashes \\\" and more)");
+  CHECK(token.line() == 2u);
+  CHECK(token.column() == 35u);
+
+  // an even number of backslashes does not escape the closing quotation mark
+  token = tokenizer.nextToken();
+  CHECK(token.type() == QuakeMapToken::String);
+  CHECK(token.data() == backslashes);
+  CHECK(token.line() == 3u);
+  CHECK(token.column() == 1u);
+
+  // a trailing backslash in a path does not escape a quotation mark followed by a newline
+  token = tokenizer.nextToken();
+  CHECK(token.type() == QuakeMapToken::String);
+  CHECK(token.data() == R"(c:\quake\id1\)");
+  CHECK(token.line() == 3u);
+  CHECK(token.column() == 24u);
+
+  token = tokenizer.nextToken();
+  CHECK(token.type() == QuakeMapToken::CBrace);
+  CHECK(token.line() == 4u);
+  CHECK(token.column() == 1u);
+
+  CHECK(tokenizer.nextToken().type() == QuakeMapToken::Eof);
+}
 } // namespace IO
 } // namespace TrenchBroom
@@ -1776,6 +1776,87 @@ TEST_CASE("WorldReaderTest.parseProtectedEntityProperties", "[WorldReaderTest]")
   }
 }
 
+TEST_CASE("WorldReaderTest.parseLargeMapInChunks", "[WorldReaderTest]")
+{
+  // large enough to be split into chunks that are parsed in parallel
+  constexpr auto brushCount = size_t(2000);
+  constexpr auto entityCount = size_t(200);
+
+  auto data = std::string{"// Game: Quake\n{\n\"classname\" \"worldspawn\"\n"};
+  for (size_t i = 0; i < brushCount; ++i)
+  {
+    data += fmt::format(
+      R"(// brush {0}
+{{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) tex{0} 1 2 3 4 5
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) tex2 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) "tex 3" 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) tex4 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) {{tex5 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) tex6 0 0 0 1 1
+}}
+)",
+      i);
+  }
+  data += "}\n";
+  for (size_t i = 0; i < entityCount; ++i)
+  {
+    data += fmt::format(
+      R"({{
+"classname" "info_null"
+"message" "{{ // }} \"{0}\""
+"message" "duplicate"
+}}
+)",
+      i);
+  }
+
+  const vm::bbox3 worldBounds(8192.0);
+
+  IO::TestParserStatus status;
+  WorldReader reader(data, Model::MapFormat::Standard, {});
+
+  auto world = reader.read(worldBounds, status);
+  REQUIRE(world != nullptr);
+  CHECK(reader.parsedChunkCount() > 1u);
+
+  const auto& children = world->defaultLayer()->children();
+  REQUIRE(children.size() == brushCount + entityCount);
+
+  for (size_t i = 0; i < brushCount; ++i)
+  {
+    const auto* brushNode = dynamic_cast<Model::BrushNode*>(children[i]);
+    REQUIRE(brushNode != nullptr);
+    CHECK(brushNode->lineNumber() == 5u + i * 9u);
+    CHECK(brushNode->containsLine(11u + i * 9u));
+    CHECK_FALSE(brushNode->containsLine(12u + i * 9u));
+    CHECK(brushNode->brush().faces().size() == 6u);
+  }
+
+  const auto firstEntityLine = 5u + brushCount * 9u;
+  for (size_t i = 0; i < entityCount; ++i)
+  {
+    const auto* entityNode = dynamic_cast<Model::EntityNode*>(children[brushCount + i]);
+    REQUIRE(entityNode != nullptr);
+    CHECK(entityNode->lineNumber() == firstEntityLine + i * 5u);
+    CHECK(entityNode->containsLine(firstEntityLine + i * 5u + 3u));
+    CHECK_FALSE(entityNode->containsLine(firstEntityLine + i * 5u + 4u));
+    CHECK(
+      *entityNode->entity().property("message")
+      == fmt::format(R"({{ // }} \"{0}\")", i));
+  }
+
+  // messages are reported in file order
+  const auto& warnings = status.messages(LogLevel::Warn);
+  REQUIRE(warnings.size() == entityCount);
+  for (size_t i = 0; i < entityCount; ++i)
+  {
+    CHECK_THAT(
+      warnings[i],
+      Catch::Contains(fmt::format("line {}, column 1", firstEntityLine + i * 5u + 3u)));
+  }
+}
+
 TEST_CASE("WorldReaderTest.parseUnknownFormatEmptyMap", "[WorldReaderTest]")
 {
   const auto data = R"(
@@ -166,12 +166,12 @@ static void getFaceVertsAndTexCoords(
   std::vector<vm::vec3>* vertPositions,
   std::vector<vm::vec2f>* vertTexCoords)
 {
-  for (const auto* vertex : face.vertices())
+  for (const auto& position : face.vertexPositions())
   {
-    vertPositions->push_back(vertex->position());
+    vertPositions->push_back(position);
     if (vertTexCoords != nullptr)
     {
-      vertTexCoords->push_back(face.textureCoords(vm::vec3(vertex->position())));
+      vertTexCoords->push_back(face.textureCoords(position));
     }
   }
 }
@@ -257,11 +257,10 @@ static void checkFaceUVsEqual(const BrushFace& face, const BrushFace& other)
   std::vector<vm::vec2f> faceUVs;
   std::vector<vm::vec2f> otherFaceUVs;
 
-  for (const auto* vertex : face.vertices())
+  for (const auto& position : face.vertexPositions())
   {
-    verts.push_back(vertex->position());
+    verts.push_back(position);
 
-    const vm::vec3 position(vertex->position());
     faceUVs.push_back(face.textureCoords(position));
     otherFaceUVs.push_back(other.textureCoords(position));
   }
@@ -518,10 +517,10 @@ static void checkTextureLockOffWithVerticalFlip(const Brush& cube)
 
   // get UV of each vert using `face` and `resetFace`
   std::vector<vm::vec2f> face_UVs, origFace_UVs;
-  for (const auto vert : origFace.vertices())
+  for (const auto& vert : origFace.vertexPositions())
   {
-    face_UVs.push_back(face.textureCoords(vert->position()));
-    origFace_UVs.push_back(origFace.textureCoords(vert->position()));
+    face_UVs.push_back(face.textureCoords(vert));
+    origFace_UVs.push_back(origFace.textureCoords(vert));
   }
 
   checkUVListsEqual(face_UVs, origFace_UVs, face);
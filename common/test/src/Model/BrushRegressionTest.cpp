@@ -804,9 +804,8 @@ static void assertSnapTo(const std::string& data, const FloatType gridSize)
 
   // Ensure they were actually snapped
   {
-    for (const Model::BrushVertex* vertex : brush.vertices())
+    for (const vm::vec3& pos : brush.vertexPositions())
     {
-      const vm::vec3& pos = vertex->position();
       CHECK(vm::is_integral(pos, 0.001));
     }
   }
@@ -1383,9 +1382,9 @@ TEST_CASE("BrushTest.convexMergeCrash_2789", "[BrushTest]")
   {
     if (const auto* brushNode = dynamic_cast<const BrushNode*>(node))
     {
-      for (const auto* vertex : brushNode->brush().vertices())
+      for (const auto& position : brushNode->brush().vertexPositions())
       {
-        points.push_back(vertex->position());
+        points.push_back(position);
       }
     }
   }
@@ -1451,9 +1450,9 @@ TEST_CASE("BrushTest.convexMergeIncorrectResult_2789", "[BrushTest]")
   {
     const auto* brushNode = dynamic_cast<const BrushNode*>(node);
     REQUIRE(brushNode != nullptr);
-    for (const auto* vertex : brushNode->brush().vertices())
+    for (const auto& position : brushNode->brush().vertexPositions())
     {
-      points.push_back(vertex->position());
+      points.push_back(position);
     }
   }
 
@@ -1286,11 +1286,7 @@ TEST_CASE("BrushTest.moveVerticesPastWorldBounds", "[BrushTest]")
 
   Model::Brush brush = builder.createCube(128.0, "texture").value();
 
-  std::vector<vm::vec3> allVertexPositions;
-  for (const auto* vertex : brush.vertices())
-  {
-    allVertexPositions.push_back(vertex->position());
-  }
+  const std::vector<vm::vec3> allVertexPositions = brush.vertexPositions();
 
   CHECK(brush.canMoveVertices(worldBounds, allVertexPositions, vm::vec3(16, 0, 0)));
   CHECK_FALSE(
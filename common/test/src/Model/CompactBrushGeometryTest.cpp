@@ -0,0 +1,296 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushError.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushGeometry.h"
+#include "Model/CompactBrushGeometry.h"
+#include "Model/MapFormat.h"
+#include "Model/Polyhedron.h"
+
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Model
+{
+static std::vector<std::vector<size_t>> faceVertexIndices(
+  const CompactBrushGeometry& geometry)
+{
+  auto result = std::vector<std::vector<size_t>>{};
+  for (size_t i = 0u; i < geometry.faceCount(); ++i)
+  {
+    result.emplace_back(
+      geometry.faceVertexIndicesBegin(i), geometry.faceVertexIndicesEnd(i));
+  }
+  return result;
+}
+
+static void checkEdges(const CompactBrushGeometry& geometry)
+{
+  REQUIRE(geometry.closed());
+  for (size_t i = 0u; i < geometry.edgeCount(); ++i)
+  {
+    const auto [vertexIndex1, vertexIndex2] = geometry.edgeVertexIndices(i);
+    const auto [faceIndex1, faceIndex2] = geometry.edgeFaceIndices(i);
+    CHECK(faceIndex1 != faceIndex2);
+
+    // the first face leads from the first to the second vertex, the second face back
+    const auto leadsFrom =
+      [&](const size_t faceIndex, const size_t from, const size_t to) {
+        const auto indices = faceVertexIndices(geometry)[faceIndex];
+        for (size_t j = 0u; j < indices.size(); ++j)
+        {
+          if (indices[j] == from && indices[(j + 1u) % indices.size()] == to)
+          {
+            return true;
+          }
+        }
+        return false;
+      };
+    CHECK(leadsFrom(faceIndex1, vertexIndex1, vertexIndex2));
+    CHECK(leadsFrom(faceIndex2, vertexIndex2, vertexIndex1));
+  }
+}
+
+TEST_CASE("CompactBrushGeometryTest.emptyGeometry", "[CompactBrushGeometryTest]")
+{
+  const auto geometry = CompactBrushGeometry{};
+  CHECK(geometry.vertexCount() == 0u);
+  CHECK(geometry.faceCount() == 0u);
+  CHECK(geometry.edgeCount() == 0u);
+}
+
+TEST_CASE("CompactBrushGeometryTest.fromBrushGeometry", "[CompactBrushGeometryTest]")
+{
+  auto brushGeometry =
+    BrushGeometry{vm::bbox3{vm::vec3{-32.0, -32.0, 0.0}, vm::vec3{32.0, 32.0, 64.0}}};
+
+  auto faceGeometries = std::vector<const BrushFaceGeometry*>{};
+  for (auto* faceGeometry : brushGeometry.faces())
+  {
+    faceGeometry->setPayload(faceGeometries.size());
+    faceGeometries.push_back(faceGeometry);
+  }
+
+  const auto geometry = CompactBrushGeometry{brushGeometry};
+  CHECK(geometry.vertexCount() == 8u);
+  CHECK(geometry.faceCount() == 6u);
+  CHECK(geometry.edgeCount() == 12u);
+  CHECK(geometry.bounds() == brushGeometry.bounds());
+  CHECK_THAT(
+    geometry.vertexPositions(),
+    Catch::Matchers::UnorderedEquals(brushGeometry.vertexPositions()));
+
+  for (size_t i = 0u; i < faceGeometries.size(); ++i)
+  {
+    CHECK(geometry.faceVertexPositions(i) == faceGeometries[i]->vertexPositions());
+  }
+
+  checkEdges(geometry);
+}
+
+TEST_CASE("CompactBrushGeometryTest.fromFaceVertexIndices", "[CompactBrushGeometryTest]")
+{
+  const auto worldBounds = vm::bbox3{4096.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  const auto brush = builder
+                       .createBrush(
+                         std::vector<vm::vec3>{
+                           {-32.0, -32.0, 0.0},
+                           {32.0, -32.0, 0.0},
+                           {32.0, 32.0, 0.0},
+                           {-32.0, 32.0, 0.0},
+                           {0.0, 0.0, 64.0},
+                         },
+                         "texture")
+                       .value();
+  const auto& original = brush.geometry();
+
+  const auto geometry =
+    CompactBrushGeometry{original.vertexPositions(), faceVertexIndices(original)};
+  CHECK(geometry.vertexPositions() == original.vertexPositions());
+  CHECK(faceVertexIndices(geometry) == faceVertexIndices(original));
+  CHECK(geometry.edgeCount() == 8u);
+  CHECK(geometry.bounds() == original.bounds());
+
+  checkEdges(geometry);
+}
+
+TEST_CASE("CompactBrushGeometryTest.makeBrushGeometry", "[CompactBrushGeometryTest]")
+{
+  const auto worldBounds = vm::bbox3{4096.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  const auto brush = builder.createCube(64.0, "texture").value();
+  const auto& geometry = brush.geometry();
+
+  const auto brushGeometry = geometry.makeBrushGeometry(kdl::vec_transform(
+    brush.faces(), [](const auto& face) { return face.boundary(); }));
+  CHECK(brushGeometry.closed());
+  CHECK(brushGeometry.vertexCount() == geometry.vertexCount());
+  CHECK(brushGeometry.edgeCount() == geometry.edgeCount());
+  CHECK(brushGeometry.faceCount() == geometry.faceCount());
+
+  for (const auto* faceGeometry : brushGeometry.faces())
+  {
+    const auto faceIndex = faceGeometry->payload();
+    REQUIRE(faceIndex.has_value());
+    CHECK(faceGeometry->vertexPositions() == geometry.faceVertexPositions(*faceIndex));
+    CHECK(faceGeometry->plane() == brush.face(*faceIndex).boundary());
+  }
+}
+
+TEST_CASE("CompactBrushGeometryTest.queries", "[CompactBrushGeometryTest]")
+{
+  const auto worldBounds = vm::bbox3{4096.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  const auto brush = builder.createCube(64.0, "texture").value();
+  const auto& geometry = brush.geometry();
+
+  const auto p1 = vm::vec3{-32.0, -32.0, -32.0};
+  const auto p2 = vm::vec3{32.0, -32.0, -32.0};
+  const auto p3 = vm::vec3{32.0, 32.0, -32.0};
+
+  SECTION("findVertex")
+  {
+    const auto vertexIndex = geometry.findVertex(p1);
+    REQUIRE(vertexIndex.has_value());
+    CHECK(geometry.vertexPosition(*vertexIndex) == p1);
+    CHECK(geometry.findVertex(p1 + vm::vec3{0.5, 0.0, 0.0}) == std::nullopt);
+    CHECK(geometry.findVertex(p1 + vm::vec3{0.5, 0.0, 0.0}, 1.0) == vertexIndex);
+    CHECK(geometry.findClosestVertex(p1 + vm::vec3{1.0, 1.0, 1.0}) == vertexIndex);
+    CHECK(geometry.findClosestVertex(p1 + vm::vec3{1.0, 1.0, 1.0}, 1.0) == std::nullopt);
+  }
+
+  SECTION("findEdge")
+  {
+    const auto edgeIndex = geometry.findEdge(p1, p2);
+    REQUIRE(edgeIndex.has_value());
+    CHECK(geometry.findEdge(p2, p1) == edgeIndex);
+    CHECK(geometry.findEdge(p1, p3) == std::nullopt);
+    CHECK(
+      geometry.findClosestEdge(p1 + vm::vec3{0.0, 0.0, 0.1}, p2, 0.1) == edgeIndex);
+  }
+
+  SECTION("findFace")
+  {
+    const auto faceIndex = brush.findFace(vm::vec3::neg_z());
+    REQUIRE(faceIndex.has_value());
+
+    auto positions = geometry.faceVertexPositions(*faceIndex);
+    CHECK(geometry.findFace(positions) == faceIndex);
+
+    std::rotate(positions.begin(), std::next(positions.begin()), positions.end());
+    CHECK(geometry.faceHasVertexPositions(*faceIndex, positions));
+    CHECK(geometry.findFace(positions) == faceIndex);
+
+    std::reverse(positions.begin(), positions.end());
+    CHECK(geometry.findFace(positions) == std::nullopt);
+    std::reverse(positions.begin(), positions.end());
+
+    for (auto& position : positions)
+    {
+      position = position + vm::vec3{0.0, 0.0, 0.001};
+    }
+    CHECK(geometry.findFace(positions) == std::nullopt);
+    CHECK(geometry.findClosestFace(positions, 0.01) == faceIndex);
+  }
+
+  SECTION("incidentFaces")
+  {
+    const auto vertexIndex = geometry.findVertex(p1);
+    REQUIRE(vertexIndex.has_value());
+
+    const auto faceIndices = geometry.incidentFaces(*vertexIndex);
+    CHECK_THAT(
+      faceIndices,
+      Catch::Matchers::UnorderedEquals(std::vector<size_t>{
+        *brush.findFace(vm::vec3::neg_x()),
+        *brush.findFace(vm::vec3::neg_y()),
+        *brush.findFace(vm::vec3::neg_z()),
+      }));
+  }
+}
+
+TEST_CASE("CompactBrushGeometryTest.sharedWithBrush", "[CompactBrushGeometryTest]")
+{
+  const auto worldBounds = vm::bbox3{4096.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  auto brush = builder.createCube(64.0, "texture").value();
+  const auto* originalGeometry = &brush.geometry();
+  const auto originalPositions = brush.geometry().vertexPositions();
+
+  for (size_t i = 0u; i < brush.faceCount(); ++i)
+  {
+    CHECK(brush.face(i).geometry() == originalGeometry);
+    CHECK(brush.face(i).faceIndex() == i);
+  }
+
+  SECTION("Copying a brush shares its geometry")
+  {
+    const auto copy = brush;
+    CHECK(&copy.geometry() == originalGeometry);
+    for (size_t i = 0u; i < copy.faceCount(); ++i)
+    {
+      CHECK(copy.face(i).geometry() == originalGeometry);
+    }
+  }
+
+  SECTION("Transforming a brush replaces its geometry")
+  {
+    const auto copy = brush;
+    REQUIRE(brush
+              .transform(
+                worldBounds, vm::translation_matrix(vm::vec3{16.0, 0.0, 0.0}), false)
+              .is_success());
+    CHECK(brush.geometry().vertexPositions() != originalPositions);
+    CHECK(copy.geometry().vertexPositions() == originalPositions);
+    for (size_t i = 0u; i < brush.faceCount(); ++i)
+    {
+      CHECK(brush.face(i).geometry() == &brush.geometry());
+    }
+  }
+
+  SECTION("Adding a vertex replaces its geometry")
+  {
+    REQUIRE(brush.addVertex(worldBounds, vm::vec3{0.0, 0.0, 64.0}).is_success());
+    CHECK(brush.geometry().vertexCount() == 9u);
+    CHECK(brush.vertexPositions() == brush.geometry().vertexPositions());
+    checkEdges(brush.geometry());
+  }
+}
+} // namespace Model
+} // namespace TrenchBroom
@@ -27,6 +27,7 @@
 #include "IO/IOUtils.h"
 #include "IO/NodeReader.h"
 #include "IO/NodeWriter.h"
+#include "IO/SynchronizedFileSystem.h"
 #include "IO/TestParserStatus.h"
 #include "IO/TextureLoader.h"
 #include "Model/BrushFace.h"
@@ -155,6 +156,14 @@ void TestGame::doWriteMap(WorldNode& world, const IO::Path& path) const
   writer.writeMap();
 }
 
+void TestGame::doWriteMapToStream(WorldNode& world, std::ostream& stream) const
+{
+  IO::writeGameComment(stream, gameName(), formatName(world.mapFormat()));
+
+  IO::NodeWriter writer(world, stream);
+  writer.writeMap();
+}
+
 void TestGame::doExportMap(
   WorldNode& /* world */, const IO::ExportOptions& /* options */) const
 {
@@ -210,7 +219,8 @@ void TestGame::doLoadTextureCollections(
 
   const IO::Path root = IO::Disk::getCurrentWorkingDir();
   const std::vector<IO::Path> fileSearchPaths{root};
-  const IO::DiskFileSystem fileSystem(root, true);
+  const auto fileSystem = std::make_shared<IO::SynchronizedFileSystem>(
+    std::make_shared<IO::DiskFileSystem>(root, true));
 
   const Model::TextureConfig textureConfig{
     Model::TextureFilePackageConfig{Model::PackageFormatConfig{{"wad"}, "idmip"}},
@@ -77,6 +77,7 @@ private:
     const IO::Path& path,
     Logger& logger) const override;
   void doWriteMap(WorldNode& world, const IO::Path& path) const override;
+  void doWriteMapToStream(WorldNode& world, std::ostream& stream) const override;
   void doExportMap(WorldNode& world, const IO::ExportOptions& options) const override;
 
   std::vector<Node*> doParseNodes(
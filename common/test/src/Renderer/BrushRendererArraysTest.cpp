@@ -0,0 +1,444 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Renderer/BrushRendererArrays.h"
+
+#include <vecmath/approx.h>
+#include <vecmath/vec.h>
+#include <vecmath/vec_io.h>
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+using Vertex = BrushVertexArray::Vertex;
+
+TEST_CASE("BrushVertexArrayTest.toHalfFloat", "[BrushVertexArrayTest]")
+{
+  CHECK(BrushVertexArray::toHalfFloat(0.0f) == GLshort(0x0000));
+  CHECK(BrushVertexArray::toHalfFloat(1.0f) == GLshort(0x3C00));
+  CHECK(BrushVertexArray::toHalfFloat(0.5f) == GLshort(0x3800));
+  CHECK(BrushVertexArray::toHalfFloat(-2.0f) == GLshort(0xC000));
+  CHECK(BrushVertexArray::toHalfFloat(65504.0f) == GLshort(0x7BFF));
+  CHECK(BrushVertexArray::toHalfFloat(1.0e6f) == GLshort(0x7BFF));
+
+  // the smallest subnormal
+  CHECK(BrushVertexArray::toHalfFloat(5.9604645e-8f) == GLshort(0x0001));
+
+  for (const auto value : {0.0f, 1.0f, -0.25f, 0.1f, 3.75f, -1000.5f})
+  {
+    CHECK(
+      BrushVertexArray::fromHalfFloat(BrushVertexArray::toHalfFloat(value))
+      == Approx(value).epsilon(1.0f / 1024.0f));
+  }
+
+  // subnormals have a fixed precision
+  CHECK(
+    BrushVertexArray::fromHalfFloat(BrushVertexArray::toHalfFloat(6.0e-6f))
+    == Approx(6.0e-6f).margin(3.0e-8f));
+}
+
+TEST_CASE("BrushVertexArrayTest.compactVertices", "[BrushVertexArrayTest]")
+{
+  const auto origin = vm::vec3f{512, -512, 1536};
+
+  SECTION("Grid aligned positions near the origin are exact")
+  {
+    const auto vertices = std::vector<Vertex>{
+      Vertex{vm::vec3f{0, 0, 1024}, vm::vec3f::pos_z(), vm::vec2f{0, 0}},
+      Vertex{vm::vec3f{1023.5f, -1.25f, 2047}, vm::vec3f::pos_z(), vm::vec2f{0, 0}},
+      Vertex{vm::vec3f{512.0625f, -512, 1536}, vm::vec3f::pos_z(), vm::vec2f{0, 0}},
+    };
+
+    const auto compactVertices = BrushVertexArray::compactVertices(vertices, origin);
+    REQUIRE(compactVertices.size() == vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+      CHECK(
+        BrushVertexArray::decodePosition(compactVertices[i], origin)
+        == vertices[i].attr);
+    }
+  }
+
+  SECTION("Positions far from the origin are quantized coarser")
+  {
+    const auto vertices = std::vector<Vertex>{
+      Vertex{vm::vec3f{65536, 0, 0}, vm::vec3f::pos_z(), vm::vec2f{0, 0}},
+      Vertex{vm::vec3f{-65537, 0, 0}, vm::vec3f::pos_z(), vm::vec2f{0, 0}},
+    };
+
+    const auto compactVertices = BrushVertexArray::compactVertices(vertices, origin);
+    CHECK(
+      BrushVertexArray::decodePosition(compactVertices[0], origin) == vertices[0].attr);
+    CHECK(vm::is_equal(
+      BrushVertexArray::decodePosition(compactVertices[1], origin),
+      vertices[1].attr,
+      2.0f));
+  }
+
+  SECTION("Normals")
+  {
+    const auto normals = std::vector<vm::vec3f>{
+      vm::vec3f::pos_x(),
+      vm::vec3f::neg_x(),
+      vm::vec3f::pos_y(),
+      vm::vec3f::neg_y(),
+      vm::vec3f::pos_z(),
+      vm::vec3f::neg_z(),
+      vm::normalize(vm::vec3f{1, -2, 3}),
+      vm::normalize(vm::vec3f{-3, 1, -2}),
+    };
+
+    auto vertices = std::vector<Vertex>{};
+    for (const auto& normal : normals)
+    {
+      vertices.emplace_back(origin, normal, vm::vec2f{0, 0});
+    }
+
+    const auto compactVertices = BrushVertexArray::compactVertices(vertices, origin);
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+      CHECK(vm::is_equal(
+        BrushVertexArray::decodeNormal(compactVertices[i]), normals[i], 0.001f));
+    }
+  }
+
+  SECTION("Texture coordinates are translated by whole repetitions per face")
+  {
+    const auto vertices = std::vector<Vertex>{
+      Vertex{origin, vm::vec3f::pos_z(), vm::vec2f{100.25f, -40.5f}},
+      Vertex{origin, vm::vec3f::pos_z(), vm::vec2f{102.75f, -38.0f}},
+      Vertex{origin, vm::vec3f::pos_x(), vm::vec2f{0.5f, 0.25f}},
+      Vertex{origin, vm::vec3f::pos_x(), vm::vec2f{1.5f, 1.25f}},
+    };
+
+    const auto compactVertices = BrushVertexArray::compactVertices(vertices, origin);
+    CHECK(
+      BrushVertexArray::decodeTexCoords(compactVertices[0])
+      == vm::vec2f{-1.75f, -1.5f});
+    CHECK(
+      BrushVertexArray::decodeTexCoords(compactVertices[1])
+      == vm::vec2f{0.75f, 1.0f});
+    CHECK(
+      BrushVertexArray::decodeTexCoords(compactVertices[2])
+      == vm::vec2f{-0.5f, -0.75f});
+    CHECK(
+      BrushVertexArray::decodeTexCoords(compactVertices[3])
+      == vm::vec2f{0.5f, 0.25f});
+  }
+}
+
+TEST_CASE("RingDirtyRangeTrackerTest.regions", "[RingDirtyRangeTrackerTest]")
+{
+  auto tracker = RingDirtyRangeTracker{3u, 10u};
+  CHECK(tracker.regionCount() == 3u);
+  CHECK(tracker.capacity() == 10u);
+
+  SECTION("Only the initial region is clean")
+  {
+    CHECK(tracker.currentRegion() == 0u);
+    CHECK(tracker.clean());
+
+    tracker.advance();
+    CHECK(tracker.currentRegion() == 1u);
+    CHECK(tracker.current().m_dirtyPos == 0u);
+    CHECK(tracker.current().m_dirtySize == 10u);
+
+    tracker.advance();
+    CHECK(!tracker.clean());
+
+    tracker.advance();
+    CHECK(tracker.currentRegion() == 0u);
+    CHECK(tracker.clean());
+  }
+
+  SECTION("Edits are tracked for every region until it is brought up to date")
+  {
+    tracker.advance();
+    tracker.markCurrentClean();
+    tracker.advance();
+    tracker.markCurrentClean();
+    tracker.advance();
+    REQUIRE(tracker.clean());
+
+    tracker.markDirty(2u, 3u);
+    tracker.markDirty(6u, 1u);
+    CHECK(tracker.current().m_dirtyPos == 2u);
+    CHECK(tracker.current().m_dirtySize == 5u);
+
+    tracker.markCurrentClean();
+    CHECK(tracker.clean());
+
+    tracker.advance();
+    CHECK(tracker.current().m_dirtyPos == 2u);
+    CHECK(tracker.current().m_dirtySize == 5u);
+
+    tracker.markCurrentClean();
+    tracker.markDirty(0u, 1u);
+    CHECK(tracker.current().m_dirtyPos == 0u);
+    CHECK(tracker.current().m_dirtySize == 1u);
+
+    tracker.advance();
+    CHECK(tracker.current().m_dirtyPos == 0u);
+    CHECK(tracker.current().m_dirtySize == 7u);
+  }
+
+  SECTION("Expanding marks the new range dirty in every region")
+  {
+    tracker.expand(16u);
+    CHECK(tracker.capacity() == 16u);
+    CHECK(tracker.current().m_dirtyPos == 10u);
+    CHECK(tracker.current().m_dirtySize == 6u);
+
+    tracker.advance();
+    CHECK(tracker.current().m_dirtyPos == 0u);
+    CHECK(tracker.current().m_dirtySize == 16u);
+  }
+
+  SECTION("A single region")
+  {
+    auto single = RingDirtyRangeTracker{1u, 10u};
+    CHECK(single.clean());
+
+    single.markDirty(4u, 2u);
+    single.advance();
+    CHECK(single.currentRegion() == 0u);
+    CHECK(single.current().m_dirtyPos == 4u);
+    CHECK(single.current().m_dirtySize == 2u);
+  }
+}
+
+TEST_CASE("IndexHolderTest.editsBeforePreparing", "[IndexHolderTest]")
+{
+  auto indices = std::vector<GLuint>{1u, 2u, 3u, 4u};
+  auto holder = IndexHolder{indices};
+  CHECK(indices.empty());
+  CHECK(holder.size() == 4u);
+  CHECK(!holder.prepared());
+
+  auto* elements = holder.getPointerToWriteElementsTo(0u, 4u);
+  CHECK(std::vector<GLuint>(elements, elements + 4) == std::vector<GLuint>{1, 2, 3, 4});
+
+  holder.zeroRange(1u, 2u);
+  CHECK(std::vector<GLuint>(elements, elements + 4) == std::vector<GLuint>{1, 0, 0, 4});
+
+  holder.resize(6u);
+  CHECK(holder.size() == 6u);
+  CHECK(!holder.prepared());
+
+  elements = holder.getPointerToWriteElementsTo(4u, 2u);
+  CHECK(elements[0] == 0u);
+  CHECK(elements[1] == 0u);
+}
+
+TEST_CASE("IndexHolderTest.empty", "[IndexHolderTest]")
+{
+  auto holder = IndexHolder{};
+  CHECK(holder.empty());
+  CHECK(holder.prepared());
+}
+
+TEST_CASE("IndexHolderTest.copyElements", "[IndexHolderTest]")
+{
+  auto indices = std::vector<GLuint>{1u, 2u, 0u, 0u};
+  auto holder = IndexHolder{indices};
+
+  holder.copyElements(0u, 2u, 2u);
+  CHECK(holder.elements() == std::vector<GLuint>{1, 2, 1, 2});
+}
+
+TEST_CASE("PendingEditsTest.apply", "[PendingEditsTest]")
+{
+  auto buffer = std::vector<GLuint>{1u, 2u, 3u, 4u, 5u, 6u};
+  auto edits = PendingEdits<GLuint>{};
+  CHECK(edits.empty());
+
+  auto* elements = edits.write(0u, 2u);
+  elements[0] = 7u;
+  elements[1] = 8u;
+
+  // the first pointer stays valid while more edits are recorded
+  edits.copy(0u, 4u, 2u);
+  edits.write(1u, 1u)[0] = 9u;
+  elements[1] = 10u;
+  CHECK(!edits.empty());
+  CHECK(buffer == std::vector<GLuint>{1, 2, 3, 4, 5, 6});
+
+  edits.apply(buffer.data());
+  CHECK(edits.empty());
+  CHECK(buffer == std::vector<GLuint>{7, 9, 3, 4, 7, 10});
+}
+
+TEST_CASE("BrushIndexPoolTest.pages", "[BrushIndexPoolTest]")
+{
+  auto pool = BrushIndexPool{};
+  CHECK(!pool.hasPages());
+
+  auto* page = pool.allocatePage(3u);
+  CHECK(pool.hasPages());
+  CHECK(pool.capacity() == 3u);
+  CHECK(pool.indices() == std::vector<GLuint>{0, 0, 0});
+
+  std::copy_n(
+    std::vector<GLuint>{1, 2, 3}.begin(), 3u, pool.getPointerToWriteElementsTo(0u, 3u));
+  pool.freePage(page);
+  CHECK(!pool.hasPages());
+
+  // a freed page is zeroed when it is used again
+  page = pool.allocatePage(3u);
+  CHECK(page->pos == 0u);
+  CHECK(pool.indices() == std::vector<GLuint>{0, 0, 0});
+
+  std::copy_n(
+    std::vector<GLuint>{1, 2, 3}.begin(), 3u, pool.getPointerToWriteElementsTo(0u, 3u));
+  auto* otherPage = pool.allocatePage(2u);
+  CHECK(otherPage->pos == 3u);
+  CHECK(pool.capacity() == 6u);
+
+  pool.copyElements(1u, otherPage->pos, 2u);
+  pool.zeroRange(0u, 1u);
+  CHECK(pool.indices() == std::vector<GLuint>{0, 2, 3, 2, 3, 0});
+}
+
+TEST_CASE("BrushIndexArrayTest.sharedPool", "[BrushIndexArrayTest]")
+{
+  auto pool = std::make_shared<BrushIndexPool>();
+  auto first = BrushIndexArray{pool, vm::vec3f{1, 2, 3}};
+  auto second = BrushIndexArray{pool, vm::vec3f{4, 5, 6}};
+  CHECK(!pool->hasPages());
+  CHECK(first.indexCount() == 0u);
+
+  auto [firstKey, firstDest] = first.getPointerToInsertElementsAt(3u);
+  std::copy_n(std::vector<GLuint>{1, 2, 3}.begin(), 3u, firstDest);
+  auto* secondDest = second.getPointerToInsertElementsAt(2u).second;
+  std::copy_n(std::vector<GLuint>{4, 5}.begin(), 2u, secondDest);
+
+  CHECK(pool->hasPages());
+  CHECK(first.indexCount() == 3u);
+  CHECK(second.indexCount() == 2u);
+  CHECK(second.pagePos() == first.pagePos() + first.indexCount());
+
+  const auto indices = [&](const BrushIndexArray& indexArray) {
+    const auto begin = pool->indices().begin() + long(indexArray.pagePos());
+    return std::vector<GLuint>(begin, begin + long(indexArray.indexCount()));
+  };
+
+  CHECK(indices(first) == std::vector<GLuint>{1, 2, 3});
+  CHECK(indices(second) == std::vector<GLuint>{4, 5});
+
+  SECTION("Growing an array moves its indices to a larger page")
+  {
+    const auto oldPagePos = first.pagePos();
+    *first.getPointerToInsertElementsAt(1u).second = 6u;
+
+    CHECK(first.pagePos() != oldPagePos);
+    CHECK(first.indexCount() == 6u);
+    CHECK(first.validIndexCount() == 4u);
+    CHECK(indices(first) == std::vector<GLuint>{1, 2, 3, 6, 0, 0});
+    CHECK(indices(second) == std::vector<GLuint>{4, 5});
+
+  }
+
+  SECTION("Zeroing indices")
+  {
+    first.zeroElementsWithKey(firstKey);
+    CHECK(!first.hasValidIndices());
+    CHECK(first.indexCount() == 3u);
+    CHECK(indices(first) == std::vector<GLuint>{0, 0, 0});
+    CHECK(indices(second) == std::vector<GLuint>{4, 5});
+  }
+}
+
+TEST_CASE("BrushIndexArrayTest.poolLifetime", "[BrushIndexArrayTest]")
+{
+  auto pool = std::make_shared<BrushIndexPool>();
+  {
+    auto indexArray = BrushIndexArray{pool, vm::vec3f{}};
+    indexArray.getPointerToInsertElementsAt(4u);
+    CHECK(pool->hasPages());
+  }
+  CHECK(!pool->hasPages());
+}
+
+TEST_CASE("BrushMultiDrawTest.add", "[BrushMultiDrawTest]")
+{
+  auto pool = std::make_shared<BrushIndexPool>();
+  auto first = BrushIndexArray{pool, vm::vec3f{1, 2, 3}};
+  auto second = BrushIndexArray{pool, vm::vec3f{4, 5, 6}};
+  auto empty = BrushIndexArray{pool, vm::vec3f{7, 8, 9}};
+  first.getPointerToInsertElementsAt(3u);
+  second.getPointerToInsertElementsAt(6u);
+
+  auto multiDraw = BrushMultiDraw{pool, true};
+  multiDraw.add(second);
+  multiDraw.add(first);
+  multiDraw.add(empty);
+
+  CHECK(multiDraw.indexCount() == 9u);
+  REQUIRE(multiDraw.ranges().size() == 2u);
+  CHECK(multiDraw.ranges()[0].pos == second.pagePos());
+  CHECK(multiDraw.ranges()[0].count == 6u);
+  CHECK(multiDraw.ranges()[0].origin == vm::vec3f{4, 5, 6});
+  CHECK(multiDraw.ranges()[1].pos == first.pagePos());
+  CHECK(multiDraw.ranges()[1].count == 3u);
+  CHECK(multiDraw.ranges()[1].origin == vm::vec3f{1, 2, 3});
+}
+
+TEST_CASE("BrushMultiDrawTest.mergeRanges", "[BrushMultiDrawTest]")
+{
+  using Range = BrushMultiDraw::Range;
+
+  const auto a = vm::vec3f{1, 2, 3};
+  const auto b = vm::vec3f{4, 5, 6};
+
+  const auto toTuples = [](const std::vector<Range>& ranges) {
+    auto result = std::vector<std::tuple<size_t, size_t, vm::vec3f>>{};
+    for (const auto& range : ranges)
+    {
+      result.emplace_back(range.pos, range.count, range.origin);
+    }
+    return result;
+  };
+
+  const auto ranges = std::vector<Range>{
+    Range{12, 3, a},
+    Range{0, 4, a},
+    Range{4, 2, b},
+    Range{6, 6, a},
+    Range{20, 1, b},
+  };
+
+  CHECK(
+    toTuples(BrushMultiDraw::mergeRanges(ranges, false))
+    == std::vector<std::tuple<size_t, size_t, vm::vec3f>>{{0, 15, a}, {20, 1, b}});
+  CHECK(
+    toTuples(BrushMultiDraw::mergeRanges(ranges, true))
+    == std::vector<std::tuple<size_t, size_t, vm::vec3f>>{
+      {0, 4, a}, {4, 2, b}, {6, 9, a}, {20, 1, b}});
+  CHECK(BrushMultiDraw::mergeRanges({}, true).empty());
+}
+} // namespace Renderer
+} // namespace TrenchBroom
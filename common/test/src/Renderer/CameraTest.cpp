@@ -18,8 +18,11 @@
  */
 
 #include "Renderer/Camera.h"
+#include "Renderer/OrthographicCamera.h"
 #include "Renderer/PerspectiveCamera.h"
 
+#include <vecmath/bbox.h>
+
 #include "Catch2.h"
 
 namespace TrenchBroom
@@ -71,5 +74,59 @@ TEST_CASE("CameraTest.testYawWhenPitchedDown", "[CameraTest]")
   CHECK_FALSE(vm::is_nan(c.right()));
   CHECK_FALSE(vm::is_nan(c.up()));
 }
+
+TEST_CASE("CameraTest.culls", "[CameraTest]")
+{
+  const auto viewport = Camera::Viewport{0, 0, 800, 600};
+
+  SECTION("Perspective camera")
+  {
+    const auto c = PerspectiveCamera{
+      90.0f,
+      1.0f,
+      1000.0f,
+      viewport,
+      vm::vec3f::zero(),
+      vm::vec3f::pos_x(),
+      vm::vec3f::pos_z()};
+
+    // in front of the camera
+    CHECK_FALSE(c.culls(vm::bbox3f{{100, -10, -10}, {120, 10, 10}}));
+    // contains the camera
+    CHECK_FALSE(c.culls(vm::bbox3f{{-10, -10, -10}, {10, 10, 10}}));
+    // intersects the far plane
+    CHECK_FALSE(c.culls(vm::bbox3f{{990, -10, -10}, {1010, 10, 10}}));
+
+    // behind the camera
+    CHECK(c.culls(vm::bbox3f{{-120, -10, -10}, {-100, 10, 10}}));
+    // beyond the far plane
+    CHECK(c.culls(vm::bbox3f{{1010, -10, -10}, {1030, 10, 10}}));
+    // to the left, to the right, above and below the frustum
+    CHECK(c.culls(vm::bbox3f{{100, 200, -10}, {120, 220, 10}}));
+    CHECK(c.culls(vm::bbox3f{{100, -220, -10}, {120, -200, 10}}));
+    CHECK(c.culls(vm::bbox3f{{100, -10, 200}, {120, 10, 220}}));
+    CHECK(c.culls(vm::bbox3f{{100, -10, -220}, {120, 10, -200}}));
+  }
+
+  SECTION("Orthographic camera")
+  {
+    const auto c = OrthographicCamera{
+      1.0f,
+      1000.0f,
+      viewport,
+      vm::vec3f::zero(),
+      vm::vec3f::pos_x(),
+      vm::vec3f::pos_z()};
+
+    // within the viewport
+    CHECK_FALSE(c.culls(vm::bbox3f{{100, 380, 280}, {120, 390, 290}}));
+
+    // beyond the far plane
+    CHECK(c.culls(vm::bbox3f{{1010, -10, -10}, {1030, 10, 10}}));
+    // outside of the viewport
+    CHECK(c.culls(vm::bbox3f{{100, 410, -10}, {120, 420, 10}}));
+    CHECK(c.culls(vm::bbox3f{{100, -10, 310}, {120, 10, 320}}));
+  }
+}
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -0,0 +1,125 @@
+/*
+ Copyright (C) 2022 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Renderer/OcclusionCuller.h"
+#include "Renderer/PerspectiveCamera.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+TEST_CASE("OcclusionCullerTest.occludes", "[OcclusionCullerTest]")
+{
+  const auto camera = PerspectiveCamera{
+    90.0f,
+    1.0f,
+    8192.0f,
+    Camera::Viewport{0, 0, 800, 600},
+    vm::vec3f::zero(),
+    vm::vec3f::pos_x(),
+    vm::vec3f::pos_z()};
+
+  // a wall at x = 256 which covers the left half of the view
+  const auto wall = std::vector<vm::vec3f>{
+    {256, 0, -512},
+    {256, 0, 512},
+    {256, 512, 512},
+    {256, 512, -512},
+  };
+
+  auto culler = OcclusionCuller{};
+
+  SECTION("Nothing is occluded before the depth pyramid is built")
+  {
+    culler.beginFrame(camera);
+    culler.addOccluder(wall);
+    CHECK_FALSE(culler.occludes(vm::bbox3f{{512, 100, -10}, {532, 120, 10}}));
+  }
+
+  SECTION("Nothing is occluded without occluders")
+  {
+    culler.beginFrame(camera);
+    culler.endFrame();
+    CHECK_FALSE(culler.occludes(vm::bbox3f{{512, 100, -10}, {532, 120, 10}}));
+  }
+
+  SECTION("Boxes behind the wall are occluded")
+  {
+    culler.beginFrame(camera);
+    culler.addOccluder(wall);
+    culler.endFrame();
+
+    CHECK(culler.occluderCount() == 1u);
+
+    // behind the wall
+    CHECK(culler.occludes(vm::bbox3f{{512, 100, -10}, {532, 120, 10}}));
+    CHECK(culler.occludes(vm::bbox3f{{2048, 600, -100}, {2148, 700, 100}}));
+
+    // in front of the wall
+    CHECK_FALSE(culler.occludes(vm::bbox3f{{128, 50, -10}, {148, 70, 10}}));
+    // intersects the wall
+    CHECK_FALSE(culler.occludes(vm::bbox3f{{240, 100, -10}, {270, 120, 10}}));
+    // behind the wall, but visible next to it
+    CHECK_FALSE(culler.occludes(vm::bbox3f{{512, -120, -10}, {532, -100, 10}}));
+    CHECK_FALSE(culler.occludes(vm::bbox3f{{512, -10, -10}, {532, 10, 10}}));
+    // contains the camera
+    CHECK_FALSE(culler.occludes(vm::bbox3f{{-10, -10, -10}, {10, 10, 10}}));
+  }
+
+  SECTION("Walls which intersect the near plane are clipped")
+  {
+    const auto sideWall = std::vector<vm::vec3f>{
+      {-512, 64, -512},
+      {-512, 64, 512},
+      {4096, 64, 512},
+      {4096, 64, -512},
+    };
+
+    culler.beginFrame(camera);
+    culler.addOccluder(sideWall);
+    culler.endFrame();
+
+    // behind the side wall
+    CHECK(culler.occludes(vm::bbox3f{{512, 128, -10}, {532, 148, 10}}));
+    // in front of the side wall
+    CHECK_FALSE(culler.occludes(vm::bbox3f{{512, -20, -10}, {532, 0, 10}}));
+  }
+
+  SECTION("Occluders are ignored once the culler is full")
+  {
+    culler.beginFrame(camera);
+    for (size_t i = 0; i < OcclusionCuller::MaxOccluderCount; ++i)
+    {
+      culler.addOccluder(wall);
+    }
+    CHECK(culler.full());
+
+    culler.addOccluder(wall);
+    CHECK(culler.occluderCount() == OcclusionCuller::MaxOccluderCount);
+  }
+}
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -20,6 +20,8 @@
 #define CATCH_CONFIG_RUNNER
 
 #include "Ensure.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
 #include "TestPreferenceManager.h"
 #include "TrenchBroomApp.h"
 
@@ -34,6 +36,11 @@ int main(int argc, char** argv)
 
   TrenchBroom::View::setCrashReportGUIEnbled(false);
 
+  // don't write map and texture cache files to the user data directory when tests load
+  // maps or textures
+  TrenchBroom::setPref(TrenchBroom::Preferences::MapCacheSize, 0);
+  TrenchBroom::setPref(TrenchBroom::Preferences::TextureCacheSize, 0);
+
   ensure(qApp == &app, "invalid app instance");
 
   // set the locale to US so that we can parse floats attribute
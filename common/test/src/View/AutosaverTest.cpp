@@ -18,6 +18,7 @@
  */
 
 #include "View/Autosaver.h"
+#include "IO/DiskIO.h"
 #include "IO/Path.h"
 #include "IO/TestEnvironment.h"
 #include "Logger.h"
@@ -65,6 +66,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverNoSaveUntilSaveInter
   document->addNodes({{document->currentLayer(), {createBrushNode("some_texture")}}});
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForAutosave(logger);
 
   CHECK_FALSE(env.fileExists(IO::Path("autosave/test.1.map")));
   CHECK_FALSE(env.directoryExists(IO::Path("autosave")));
@@ -82,6 +84,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverNoSaveOfUnchangedMap
 
   Autosaver autosaver(document, 0s);
   autosaver.triggerAutosave(logger);
+  autosaver.waitForAutosave(logger);
 
   CHECK_FALSE(env.fileExists(IO::Path("autosave/test.1.map")));
   CHECK_FALSE(env.directoryExists(IO::Path("autosave")));
@@ -97,7 +100,10 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAfterSaveInterv
   document->saveDocumentAs(env.dir() + IO::Path("test.map"));
   assert(env.fileExists(IO::Path("test.map")));
 
+  const auto saveInBackground = GENERATE(true, false);
+
   Autosaver autosaver(document, 100ms);
+  autosaver.setSaveInBackground(saveInBackground);
 
   // modify the map
   document->addNodes({{document->currentLayer(), {createBrushNode("some_texture")}}});
@@ -107,6 +113,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAfterSaveInterv
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForAutosave(logger);
 
   CHECK(env.fileExists(IO::Path("autosave/test.1.map")));
   CHECK(env.directoryExists(IO::Path("autosave")));
@@ -132,6 +139,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAgainAfterSaveI
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForAutosave(logger);
 
   CHECK(env.fileExists(IO::Path("autosave/test.1.map")));
   CHECK(env.directoryExists(IO::Path("autosave")));
@@ -141,12 +149,14 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAgainAfterSaveI
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForAutosave(logger);
   CHECK_FALSE(env.fileExists(IO::Path("autosave/test.2.map")));
 
   // modify the map
   document->addNodes({{document->currentLayer(), {createBrushNode("some_texture")}}});
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForAutosave(logger);
   CHECK(env.fileExists(IO::Path("autosave/test.2.map")));
 }
 
@@ -172,8 +182,44 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesWhenCrashFilesP
   document->addNodes({{document->currentLayer(), {createBrushNode("some_texture")}}});
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForAutosave(logger);
 
   CHECK(env.fileExists(IO::Path("autosave/test.2.map")));
 }
+
+TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesInBackground")
+{
+  using namespace std::literals::chrono_literals;
+
+  IO::TestEnvironment env;
+  NullLogger logger;
+
+  document->saveDocumentAs(env.dir() + IO::Path("test.map"));
+  assert(env.fileExists(IO::Path("test.map")));
+
+  Autosaver autosaver(document, 0s);
+
+  // modify the map
+  auto* brushNode = createBrushNode("some_texture");
+  document->addNodes({{document->currentLayer(), {brushNode}}});
+
+  autosaver.triggerAutosave(logger);
+
+  // modifying the map while the backup is being written must not affect the backup
+  document->removeNodes({brushNode});
+
+  autosaver.waitForAutosave(logger);
+  REQUIRE(env.fileExists(IO::Path("autosave/test.1.map")));
+  CHECK_THAT(
+    IO::Disk::readTextFile(env.dir() + IO::Path("autosave/test.1.map")),
+    Catch::Contains("some_texture"));
+
+  autosaver.triggerAutosave(logger);
+  autosaver.waitForAutosave(logger);
+  REQUIRE(env.fileExists(IO::Path("autosave/test.2.map")));
+  CHECK_THAT(
+    IO::Disk::readTextFile(env.dir() + IO::Path("autosave/test.2.map")),
+    !Catch::Contains("some_texture"));
+}
 } // namespace View
 } // namespace TrenchBroom
@@ -125,6 +125,51 @@ TEST_CASE_METHOD(ValveMapDocumentTest, "ChangeBrushFaceAttributesTest.undoRedo")
   }
 }
 
+TEST_CASE_METHOD(ValveMapDocumentTest, "ChangeBrushFaceAttributesTest.manyBrushes")
+{
+  auto brushNodes = std::vector<Model::BrushNode*>{};
+  for (size_t i = 0; i < 64; ++i)
+  {
+    brushNodes.push_back(createBrushNode("original"));
+  }
+  document->addNodes(
+    {{document->parentForNodes(),
+      std::vector<Model::Node*>{std::begin(brushNodes), std::end(brushNodes)}}});
+
+  // select two faces of every other brush
+  auto faceHandles = std::vector<Model::BrushFaceHandle>{};
+  for (size_t i = 0; i < brushNodes.size(); i += 2)
+  {
+    faceHandles.emplace_back(brushNodes[i], 0u);
+    faceHandles.emplace_back(brushNodes[i], 2u);
+  }
+  document->selectBrushFaces(faceHandles);
+
+  auto setTexture = Model::ChangeBrushFaceAttributesRequest{};
+  setTexture.setTextureName("changed");
+  CHECK(document->setFaceAttributes(setTexture));
+
+  for (size_t i = 0; i < brushNodes.size(); ++i)
+  {
+    const auto& brush = brushNodes[i]->brush();
+    for (size_t j = 0; j < brush.faceCount(); ++j)
+    {
+      const auto expectedTextureName =
+        i % 2 == 0 && (j == 0u || j == 2u) ? "changed" : "original";
+      CHECK(brush.face(j).attributes().textureName() == expectedTextureName);
+    }
+  }
+
+  document->undoCommand();
+  for (const auto* brushNode : brushNodes)
+  {
+    for (const auto& face : brushNode->brush().faces())
+    {
+      CHECK(face.attributes().textureName() == "original");
+    }
+  }
+}
+
 TEST_CASE_METHOD(ValveMapDocumentTest, "ChangeBrushFaceAttributesTest.setAll")
 {
   auto* brushNode = createBrushNode();
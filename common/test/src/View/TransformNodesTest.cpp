@@ -68,9 +68,9 @@ static void checkPlanePointsIntegral(const Model::BrushNode* brushNode)
 static void checkVerticesIntegral(const Model::BrushNode* brushNode)
 {
   const Model::Brush& brush = brushNode->brush();
-  for (const Model::BrushVertex* vertex : brush.vertices())
+  for (const auto& position : brush.vertexPositions())
   {
-    CHECK(pointExactlyIntegral(vertex->position()));
+    CHECK(pointExactlyIntegral(position));
   }
 }
 
@@ -0,0 +1,311 @@
+/*
+ Copyright 2022 TrenchBroom contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace kdl
+{
+namespace detail
+{
+struct object_pool_block
+{
+  object_pool_block* next;
+};
+
+/**
+ * A singly linked list of free blocks.
+ */
+struct object_pool_batch
+{
+  object_pool_block* first = nullptr;
+  std::size_t count = 0u;
+};
+
+/**
+ * The state shared by all threads. Owns the slabs from which the blocks are carved and
+ * keeps the batches of free blocks that threads have given back.
+ */
+struct object_pool_shared_state
+{
+  std::mutex mutex;
+  std::vector<object_pool_batch> free_batches;
+  std::size_t slab_count = 0u;
+};
+} // namespace detail
+
+/**
+ * Allocates storage for objects of type T from large slabs of contiguous memory instead
+ * of allocating every object individually.
+ *
+ * Every thread keeps a cache of free blocks, so allocating and deallocating only pushes
+ * or pops a block from a thread local list without any locking. Objects that are
+ * allocated one after another are placed next to each other in memory, which improves
+ * cache locality when they are traversed later. If the cache of a thread runs empty, it
+ * takes a batch of free blocks from the shared state or carves a new slab into blocks. If
+ * it grows too large, a batch of blocks is returned to the shared state so that other
+ * threads can reuse them. Therefore, an object may be deallocated on a different thread
+ * than the one that allocated it.
+ *
+ * The slabs are never released, so the memory used by the pool is determined by the peak
+ * number of live objects. This also allows objects with static storage duration to be
+ * deallocated after the pool's shared state would otherwise have been destroyed.
+ *
+ * This pool is meant to be used in class specific operator new and operator delete
+ * overloads.
+ *
+ * @tparam T the type of the objects to allocate storage for
+ * @tparam BatchSize the number of blocks that are moved between a thread and the shared
+ * state at once, this is also the number of blocks per slab
+ */
+template <typename T, std::size_t BatchSize = 256u>
+class object_pool
+{
+  static_assert(BatchSize > 0u, "batch size must not be 0");
+  static_assert(
+    alignof(T) <= alignof(std::max_align_t), "over aligned types are not supported");
+
+private:
+  using block = detail::object_pool_block;
+  using batch = detail::object_pool_batch;
+  using shared_state = detail::object_pool_shared_state;
+
+  static constexpr std::size_t block_alignment =
+    alignof(T) > alignof(block) ? alignof(T) : alignof(block);
+  static constexpr std::size_t min_block_size =
+    sizeof(T) > sizeof(block) ? sizeof(T) : sizeof(block);
+  static constexpr std::size_t block_size =
+    (min_block_size + block_alignment - 1u) / block_alignment * block_alignment;
+
+  /**
+   * Returns the free blocks of a thread to the shared state when the thread exits.
+   */
+  struct thread_cache_owner
+  {
+    ~thread_cache_owner()
+    {
+      // objects with thread storage duration that are destroyed after this one may still
+      // allocate or deallocate, but the cache must not be used for that anymore
+      thread_exiting() = true;
+
+      auto& cache = thread_cache();
+      give_back(cache);
+      cache = batch{};
+    }
+  };
+
+public:
+  /**
+   * Returns uninitialized storage for one object of type T.
+   *
+   * @throws std::bad_alloc if a new slab cannot be allocated
+   */
+  static void* allocate()
+  {
+    auto& cache = thread_cache();
+    if (cache.count == 0u)
+    {
+      refill(cache);
+    }
+
+    auto* result = cache.first;
+    cache.first = result->next;
+    --cache.count;
+
+    if (thread_exiting())
+    {
+      // nobody would return the remaining blocks to the shared state
+      give_back(cache);
+      cache = batch{};
+    }
+
+    return result;
+  }
+
+  /**
+   * Returns the given storage to the pool. The storage must have been returned by a call
+   * to allocate, but that call may have happened on another thread.
+   *
+   * @param ptr the storage to return, may be null
+   */
+  static void deallocate(void* ptr) noexcept
+  {
+    if (ptr == nullptr)
+    {
+      return;
+    }
+
+    auto* b = static_cast<block*>(ptr);
+    if (thread_exiting())
+    {
+      b->next = nullptr;
+      give_back(batch{b, 1u});
+      return;
+    }
+
+    auto& cache = thread_cache();
+    if (cache.count == 0u)
+    {
+      register_thread_cache();
+    }
+
+    b->next = cache.first;
+    cache.first = b;
+    ++cache.count;
+
+    if (cache.count >= 2u * BatchSize)
+    {
+      release(cache);
+    }
+  }
+
+  /**
+   * Returns the number of slabs allocated by this pool so far.
+   */
+  static std::size_t slab_count()
+  {
+    auto& state = get_shared_state();
+    auto lock = std::unique_lock<std::mutex>{state.mutex};
+    return state.slab_count;
+  }
+
+private:
+  static batch& thread_cache()
+  {
+    // trivially destructible so that it remains usable during thread shutdown
+    static thread_local auto cache = batch{};
+    return cache;
+  }
+
+  /**
+   * Indicates whether the calling thread is exiting and its cache has already been
+   * returned to the shared state.
+   */
+  static bool& thread_exiting()
+  {
+    // trivially destructible so that it remains usable during thread shutdown
+    static thread_local auto exiting = false;
+    return exiting;
+  }
+
+  static shared_state& get_shared_state()
+  {
+    // intentionally leaked, see the class comment
+    static auto* state = new shared_state{};
+    return *state;
+  }
+
+  /**
+   * Makes sure that the cache of the calling thread is returned to the shared state when
+   * the thread exits.
+   */
+  static void register_thread_cache() noexcept
+  {
+    static thread_local auto owner = thread_cache_owner{};
+    (void)owner;
+  }
+
+  static void refill(batch& cache)
+  {
+    if (!thread_exiting())
+    {
+      register_thread_cache();
+    }
+
+    auto& state = get_shared_state();
+    {
+      auto lock = std::unique_lock<std::mutex>{state.mutex};
+      if (!state.free_batches.empty())
+      {
+        cache = state.free_batches.back();
+        state.free_batches.pop_back();
+        return;
+      }
+    }
+
+    auto* slab = static_cast<unsigned char*>(::operator new(block_size * BatchSize));
+    {
+      auto lock = std::unique_lock<std::mutex>{state.mutex};
+      ++state.slab_count;
+    }
+
+    for (std::size_t i = BatchSize; i > 0u; --i)
+    {
+      // link the blocks in address order so that consecutive allocations are adjacent
+      auto* b = new (slab + (i - 1u) * block_size) block{cache.first};
+      cache.first = b;
+    }
+    cache.count = BatchSize;
+  }
+
+  /**
+   * Returns the given blocks to the shared state. If that fails, the blocks are leaked.
+   */
+  static void give_back(const batch& blocks) noexcept
+  {
+    if (blocks.count == 0u)
+    {
+      return;
+    }
+
+    auto& state = get_shared_state();
+    try
+    {
+      auto lock = std::unique_lock<std::mutex>{state.mutex};
+      state.free_batches.push_back(blocks);
+    }
+    catch (...)
+    {
+    }
+  }
+
+  static void release(batch& cache) noexcept
+  {
+    // keep the most recently freed blocks because they are likely still in the cache
+    auto* last = cache.first;
+    for (std::size_t i = 1u; i < BatchSize; ++i)
+    {
+      last = last->next;
+    }
+
+    auto released = batch{last->next, cache.count - BatchSize};
+    last->next = nullptr;
+    cache.count = BatchSize;
+
+    auto& state = get_shared_state();
+    try
+    {
+      auto lock = std::unique_lock<std::mutex>{state.mutex};
+      state.free_batches.push_back(released);
+    }
+    catch (...)
+    {
+      // the shared state could not take the blocks, so keep them
+      last->next = released.first;
+      cache.count += released.count;
+    }
+  }
+};
+} // namespace kdl
@@ -0,0 +1,486 @@
+/*
+ Copyright 2022 TrenchBroom contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace kdl
+{
+/**
+ * A persistent pool of worker threads that executes index ranges using work stealing.
+ *
+ * Every worker owns a task queue. A call to parallel_for splits the index range into
+ * chunks and pushes them onto the queue of the calling worker, or distributes them over
+ * all worker queues if the caller is not a worker of this pool. Workers pop tasks from the
+ * back of their own queue and steal from the front of the other queues when they run out
+ * of work.
+ *
+ * The calling thread participates in the work while it waits for its chunks to complete,
+ * so a pool created with a thread count of n runs n - 1 worker threads. This also makes
+ * nested calls to parallel_for from within a task safe: the nested caller keeps executing
+ * tasks instead of blocking a worker.
+ */
+class thread_pool
+{
+private:
+  /**
+   * The number of chunks per thread that an index range is split into. More chunks give
+   * better load balancing for irregular workloads at the cost of more queue operations.
+   */
+  static constexpr std::size_t chunks_per_thread = 4u;
+
+  struct job
+  {
+    void (*run)(void* context, std::size_t begin, std::size_t end);
+    void* context;
+    std::atomic<std::size_t> pending_tasks;
+    std::atomic<bool> failed;
+    std::mutex exception_mutex;
+    std::exception_ptr exception;
+
+    job(
+      void (*i_run)(void*, std::size_t, std::size_t),
+      void* i_context,
+      const std::size_t i_pending_tasks)
+      : run(i_run)
+      , context(i_context)
+      , pending_tasks(i_pending_tasks)
+      , failed(false)
+    {
+    }
+  };
+
+  struct task
+  {
+    job* owner;
+    std::size_t begin;
+    std::size_t end;
+  };
+
+  struct task_queue
+  {
+    std::mutex mutex;
+    std::deque<task> tasks;
+  };
+
+  struct worker_identity
+  {
+    const thread_pool* pool = nullptr;
+    std::size_t index = 0u;
+  };
+
+  std::size_t m_thread_count;
+  std::vector<std::unique_ptr<task_queue>> m_queues;
+  std::vector<std::thread> m_workers;
+
+  std::atomic<std::size_t> m_queued_tasks;
+  std::atomic<std::size_t> m_next_queue;
+
+  std::mutex m_sleep_mutex;
+  std::condition_variable m_sleep_condition;
+  bool m_stopping;
+
+public:
+  /**
+   * Creates a pool that runs at most the given number of threads concurrently, including
+   * the calling thread. A thread count of 0 means std::thread::hardware_concurrency().
+   *
+   * @param thread_count the maximum number of threads to run concurrently
+   */
+  explicit thread_pool(const std::size_t thread_count = 0u)
+    : m_thread_count(resolve_thread_count(thread_count))
+    , m_queued_tasks(0u)
+    , m_next_queue(0u)
+    , m_stopping(false)
+  {
+    const auto worker_count = m_thread_count - 1u;
+    m_queues.reserve(worker_count);
+    for (std::size_t i = 0u; i < worker_count; ++i)
+    {
+      m_queues.push_back(std::make_unique<task_queue>());
+    }
+
+    m_workers.reserve(worker_count);
+    for (std::size_t i = 0u; i < worker_count; ++i)
+    {
+      m_workers.emplace_back([this, i]() { work(i); });
+    }
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  /**
+   * Stops all workers after the remaining tasks have been executed and joins them.
+   */
+  ~thread_pool()
+  {
+    {
+      auto lock = std::unique_lock<std::mutex>{m_sleep_mutex};
+      m_stopping = true;
+    }
+    m_sleep_condition.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+      worker.join();
+    }
+  }
+
+  /**
+   * Returns the maximum number of threads that this pool runs concurrently, including the
+   * calling thread.
+   */
+  std::size_t thread_count() const { return m_thread_count; }
+
+  /**
+   * Runs the given lambda `count` times, passing it indices `0` through `count - 1`.
+   *
+   * The index range is split into chunks of consecutive indices which are executed by the
+   * workers of this pool and by the calling thread. This function returns once all indices
+   * have been processed. If the lambda throws, the remaining chunks are skipped and the
+   * first exception is rethrown on the calling thread.
+   *
+   * @tparam L type of lambda
+   * @param count the maximum value (exclusive) to pass to lambda
+   * @param lambda the lambda to run
+   */
+  template <class L>
+  void parallel_for(const std::size_t count, L&& lambda)
+  {
+    if (count == 0u)
+    {
+      return;
+    }
+
+    if (count == 1u || m_thread_count == 1u)
+    {
+      for (std::size_t i = 0u; i < count; ++i)
+      {
+        lambda(i);
+      }
+      return;
+    }
+
+    using lambda_type = std::remove_reference_t<L>;
+    const auto run = [](void* context, const std::size_t begin, const std::size_t end) {
+      auto& l = *static_cast<lambda_type*>(context);
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        l(i);
+      }
+    };
+
+    const auto chunk_size =
+      std::max(std::size_t(1u), count / (m_thread_count * chunks_per_thread));
+    const auto task_count = (count + chunk_size - 1u) / chunk_size;
+
+    auto j = job{run, const_cast<void*>(static_cast<const void*>(&lambda)), task_count};
+    submit(j, count, chunk_size);
+    wait(j);
+
+    if (j.exception)
+    {
+      std::rethrow_exception(j.exception);
+    }
+  }
+
+private:
+  static std::size_t resolve_thread_count(const std::size_t thread_count)
+  {
+    if (thread_count > 0u)
+    {
+      return thread_count;
+    }
+    return std::max(std::size_t(1u), std::size_t(std::thread::hardware_concurrency()));
+  }
+
+  static worker_identity& current_worker()
+  {
+    static thread_local auto identity = worker_identity{};
+    return identity;
+  }
+
+  std::optional<std::size_t> current_worker_index() const
+  {
+    const auto& identity = current_worker();
+    if (identity.pool == this)
+    {
+      return identity.index;
+    }
+    return std::nullopt;
+  }
+
+  void submit(job& j, const std::size_t count, const std::size_t chunk_size)
+  {
+    m_queued_tasks.fetch_add(j.pending_tasks.load());
+
+    if (const auto own_index = current_worker_index())
+    {
+      // nested call from one of our workers: keep the tasks local so that this worker
+      // processes them first, other workers will steal them if they become idle
+      auto& queue = *m_queues[*own_index];
+      auto lock = std::unique_lock<std::mutex>{queue.mutex};
+      for (std::size_t begin = 0u; begin < count; begin += chunk_size)
+      {
+        queue.tasks.push_back(task{&j, begin, std::min(begin + chunk_size, count)});
+      }
+    }
+    else
+    {
+      for (std::size_t begin = 0u; begin < count; begin += chunk_size)
+      {
+        const auto queue_index = m_next_queue.fetch_add(1u) % m_queues.size();
+        auto& queue = *m_queues[queue_index];
+        auto lock = std::unique_lock<std::mutex>{queue.mutex};
+        queue.tasks.push_back(task{&j, begin, std::min(begin + chunk_size, count)});
+      }
+    }
+
+    notify();
+  }
+
+  void notify()
+  {
+    // lock and unlock the mutex to avoid losing a wakeup to a thread that has just checked
+    // its wait predicate
+    {
+      auto lock = std::unique_lock<std::mutex>{m_sleep_mutex};
+    }
+    m_sleep_condition.notify_all();
+  }
+
+  std::optional<task> pop_task(const std::optional<std::size_t> own_index)
+  {
+    if (m_queued_tasks.load() == 0u)
+    {
+      return std::nullopt;
+    }
+
+    if (own_index)
+    {
+      auto& queue = *m_queues[*own_index];
+      auto lock = std::unique_lock<std::mutex>{queue.mutex};
+      if (!queue.tasks.empty())
+      {
+        const auto result = queue.tasks.back();
+        queue.tasks.pop_back();
+        m_queued_tasks.fetch_sub(1u);
+        return result;
+      }
+    }
+
+    const auto first = own_index ? *own_index + 1u : 0u;
+    for (std::size_t i = 0u; i < m_queues.size(); ++i)
+    {
+      auto& queue = *m_queues[(first + i) % m_queues.size()];
+      auto lock = std::unique_lock<std::mutex>{queue.mutex};
+      if (!queue.tasks.empty())
+      {
+        const auto result = queue.tasks.front();
+        queue.tasks.pop_front();
+        m_queued_tasks.fetch_sub(1u);
+        return result;
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  void execute(const task& t)
+  {
+    auto& j = *t.owner;
+    if (!j.failed.load())
+    {
+      try
+      {
+        j.run(j.context, t.begin, t.end);
+      }
+      catch (...)
+      {
+        auto lock = std::unique_lock<std::mutex>{j.exception_mutex};
+        if (!j.exception)
+        {
+          j.exception = std::current_exception();
+        }
+        j.failed = true;
+      }
+    }
+
+    // the job may be destroyed by its waiting thread as soon as the counter reaches 0, so
+    // it must not be accessed afterwards
+    if (j.pending_tasks.fetch_sub(1u) == 1u)
+    {
+      notify();
+    }
+  }
+
+  void wait(job& j)
+  {
+    const auto own_index = current_worker_index();
+    while (j.pending_tasks.load() > 0u)
+    {
+      if (const auto t = pop_task(own_index))
+      {
+        execute(*t);
+      }
+      else
+      {
+        auto lock = std::unique_lock<std::mutex>{m_sleep_mutex};
+        m_sleep_condition.wait(lock, [&]() {
+          return j.pending_tasks.load() == 0u || m_queued_tasks.load() > 0u;
+        });
+      }
+    }
+  }
+
+  void work(const std::size_t index)
+  {
+    current_worker() = worker_identity{this, index};
+
+    while (true)
+    {
+      if (const auto t = pop_task(index))
+      {
+        execute(*t);
+      }
+      else
+      {
+        auto lock = std::unique_lock<std::mutex>{m_sleep_mutex};
+        m_sleep_condition.wait(
+          lock, [&]() { return m_stopping || m_queued_tasks.load() > 0u; });
+        if (m_stopping && m_queued_tasks.load() == 0u)
+        {
+          return;
+        }
+      }
+    }
+  }
+};
+
+namespace detail
+{
+struct default_thread_pool_state
+{
+  std::mutex mutex;
+  std::condition_variable idle_condition;
+  std::size_t thread_count = 0u;
+  std::size_t active_calls = 0u;
+  std::unique_ptr<thread_pool> pool;
+};
+
+inline default_thread_pool_state& get_default_thread_pool_state()
+{
+  static auto state = default_thread_pool_state{};
+  return state;
+}
+
+inline thread_pool& get_or_create_default_thread_pool(default_thread_pool_state& state)
+{
+  if (!state.pool)
+  {
+    state.pool = std::make_unique<thread_pool>(state.thread_count);
+  }
+  return *state.pool;
+}
+
+/**
+ * Keeps the default thread pool alive while a parallel algorithm runs on it.
+ * set_default_thread_pool_size waits until no such lease exists anymore.
+ */
+class default_thread_pool_lease
+{
+private:
+  default_thread_pool_state& m_state;
+  thread_pool* m_pool;
+
+public:
+  default_thread_pool_lease()
+    : m_state(get_default_thread_pool_state())
+    , m_pool(nullptr)
+  {
+    auto lock = std::unique_lock<std::mutex>{m_state.mutex};
+    m_pool = &get_or_create_default_thread_pool(m_state);
+    ++m_state.active_calls;
+  }
+
+  default_thread_pool_lease(const default_thread_pool_lease&) = delete;
+  default_thread_pool_lease& operator=(const default_thread_pool_lease&) = delete;
+
+  ~default_thread_pool_lease()
+  {
+    {
+      auto lock = std::unique_lock<std::mutex>{m_state.mutex};
+      --m_state.active_calls;
+    }
+    m_state.idle_condition.notify_all();
+  }
+
+  thread_pool& pool() const { return *m_pool; }
+};
+} // namespace detail
+
+/**
+ * Returns the process wide thread pool used by kdl::parallel_for and
+ * kdl::vec_parallel_transform. The pool is created on first use.
+ *
+ * The returned reference becomes invalid when set_default_thread_pool_size is called.
+ * Use kdl::parallel_for to run work on the default pool, it keeps the pool alive until
+ * the work is done.
+ */
+inline thread_pool& default_thread_pool()
+{
+  auto& state = detail::get_default_thread_pool_state();
+  auto lock = std::unique_lock<std::mutex>{state.mutex};
+  return detail::get_or_create_default_thread_pool(state);
+}
+
+/**
+ * Limits the number of threads used by the default thread pool. A value of 0 means
+ * std::thread::hardware_concurrency(), and a value of 1 makes all parallel algorithms run
+ * sequentially on the calling thread.
+ *
+ * If the default pool already exists, this function blocks until all parallel algorithms
+ * that are running on it have returned. Then the pool is destroyed and recreated lazily
+ * with the new thread count. This function must not be called from within a parallel
+ * algorithm, since it would wait for itself.
+ *
+ * @param thread_count the maximum number of threads to use
+ */
+inline void set_default_thread_pool_size(const std::size_t thread_count)
+{
+  auto& state = detail::get_default_thread_pool_state();
+  auto lock = std::unique_lock<std::mutex>{state.mutex};
+  state.idle_condition.wait(lock, [&]() { return state.active_calls == 0u; });
+  state.thread_count = thread_count;
+  state.pool.reset();
+}
+} // namespace kdl
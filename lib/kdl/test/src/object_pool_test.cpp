@@ -0,0 +1,201 @@
+/*
+ Copyright 2022 TrenchBroom contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#include "kdl/object_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace kdl
+{
+namespace
+{
+struct small_object
+{
+  char value;
+};
+
+struct large_object
+{
+  double values[5];
+};
+
+struct reused_object
+{
+  double value;
+};
+
+struct cross_thread_object
+{
+  int value;
+};
+
+struct thread_exit_object
+{
+  int value;
+};
+
+struct thread_local_object
+{
+  int value;
+};
+} // namespace
+
+TEST_CASE("object_pool.allocate", "[object_pool_test]")
+{
+  using pool = object_pool<large_object, 4u>;
+
+  auto ptrs = std::vector<void*>{};
+  for (std::size_t i = 0u; i < 10u; ++i)
+  {
+    ptrs.push_back(pool::allocate());
+  }
+
+  for (auto* ptr : ptrs)
+  {
+    CHECK(reinterpret_cast<std::uintptr_t>(ptr) % alignof(large_object) == 0u);
+  }
+
+  auto sorted = ptrs;
+  std::sort(sorted.begin(), sorted.end(), std::less<void*>{});
+  CHECK(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+
+  CHECK(pool::slab_count() == 3u);
+
+  for (auto* ptr : ptrs)
+  {
+    pool::deallocate(ptr);
+  }
+}
+
+TEST_CASE("object_pool.allocate_contiguous", "[object_pool_test]")
+{
+  using pool = object_pool<small_object, 8u>;
+
+  auto* first = static_cast<unsigned char*>(pool::allocate());
+  auto* second = static_cast<unsigned char*>(pool::allocate());
+
+  // blocks are at least pointer sized so that they can be linked while free
+  CHECK(second - first == static_cast<std::ptrdiff_t>(sizeof(void*)));
+
+  pool::deallocate(second);
+  pool::deallocate(first);
+}
+
+TEST_CASE("object_pool.reuse", "[object_pool_test]")
+{
+  using pool = object_pool<reused_object, 4u>;
+
+  auto* ptr = pool::allocate();
+  pool::deallocate(ptr);
+  CHECK(pool::allocate() == ptr);
+  pool::deallocate(ptr);
+
+  pool::deallocate(nullptr);
+}
+
+TEST_CASE("object_pool.deallocate_on_other_thread", "[object_pool_test]")
+{
+  using pool = object_pool<cross_thread_object, 4u>;
+
+  auto ptrs = std::vector<void*>{};
+  for (std::size_t i = 0u; i < 100u; ++i)
+  {
+    ptrs.push_back(pool::allocate());
+  }
+  const auto slabCount = pool::slab_count();
+
+  auto thread = std::thread{[&]() {
+    for (auto* ptr : ptrs)
+    {
+      pool::deallocate(ptr);
+    }
+  }};
+  thread.join();
+
+  // the other thread has returned the blocks to the shared state
+  for (std::size_t i = 0u; i < 100u; ++i)
+  {
+    ptrs[i] = pool::allocate();
+  }
+  CHECK(pool::slab_count() == slabCount);
+
+  for (auto* ptr : ptrs)
+  {
+    pool::deallocate(ptr);
+  }
+}
+
+TEST_CASE("object_pool.thread_exit", "[object_pool_test]")
+{
+  using pool = object_pool<thread_exit_object, 4u>;
+
+  auto thread = std::thread{[]() {
+    auto* ptr = pool::allocate();
+    pool::deallocate(ptr);
+  }};
+  thread.join();
+  CHECK(pool::slab_count() == 1u);
+
+  // the blocks of the exited thread are reused
+  auto* ptr = pool::allocate();
+  CHECK(pool::slab_count() == 1u);
+  pool::deallocate(ptr);
+}
+
+TEST_CASE("object_pool.deallocate_during_thread_exit", "[object_pool_test]")
+{
+  using pool = object_pool<thread_local_object, 4u>;
+
+  struct holder
+  {
+    void* ptr = nullptr;
+    ~holder() { pool::deallocate(ptr); }
+  };
+
+  auto thread = std::thread{[]() {
+    // the holder is constructed first, so it is destroyed after the pool's thread cache
+    // has been returned to the shared state
+    static thread_local auto h = holder{};
+    h.ptr = pool::allocate();
+  }};
+  thread.join();
+  CHECK(pool::slab_count() == 1u);
+
+  // the block that was deallocated while the thread was exiting is reused as well
+  auto ptrs = std::vector<void*>{};
+  for (std::size_t i = 0u; i < 4u; ++i)
+  {
+    ptrs.push_back(pool::allocate());
+  }
+  CHECK(pool::slab_count() == 1u);
+
+  for (auto* ptr : ptrs)
+  {
+    pool::deallocate(ptr);
+  }
+}
+} // namespace kdl
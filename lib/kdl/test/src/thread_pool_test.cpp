@@ -0,0 +1,156 @@
+/*
+ Copyright 2022 TrenchBroom contributors
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#include "kdl/parallel.h"
+#include "kdl/thread_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace kdl
+{
+TEST_CASE("thread_pool.thread_count", "[thread_pool_test]")
+{
+  CHECK(thread_pool{1u}.thread_count() == 1u);
+  CHECK(thread_pool{3u}.thread_count() == 3u);
+  CHECK(thread_pool{}.thread_count() >= 1u);
+}
+
+TEST_CASE("thread_pool.parallel_for", "[thread_pool_test]")
+{
+  const auto thread_count = GENERATE(1u, 2u, 4u, 7u);
+  auto pool = thread_pool{thread_count};
+
+  constexpr std::size_t count = 10'000u;
+  auto visits = std::vector<std::atomic<std::size_t>>(count);
+
+  pool.parallel_for(count, [&](const std::size_t i) { visits[i].fetch_add(1u); });
+
+  for (std::size_t i = 0u; i < count; ++i)
+  {
+    CHECK(visits[i].load() == 1u);
+  }
+}
+
+TEST_CASE("thread_pool.parallel_for_small_batches", "[thread_pool_test]")
+{
+  auto pool = thread_pool{4u};
+  auto counter = std::atomic<std::size_t>{0u};
+
+  for (std::size_t i = 0u; i < 1'000u; ++i)
+  {
+    pool.parallel_for(3u, [&](const std::size_t) { counter.fetch_add(1u); });
+  }
+
+  CHECK(counter.load() == 3'000u);
+}
+
+TEST_CASE("thread_pool.nested_parallel_for", "[thread_pool_test]")
+{
+  auto pool = thread_pool{4u};
+
+  constexpr std::size_t outer = 64u;
+  constexpr std::size_t inner = 100u;
+  auto visits = std::vector<std::atomic<std::size_t>>(outer * inner);
+
+  pool.parallel_for(outer, [&](const std::size_t i) {
+    pool.parallel_for(
+      inner, [&](const std::size_t j) { visits[i * inner + j].fetch_add(1u); });
+  });
+
+  for (std::size_t i = 0u; i < outer * inner; ++i)
+  {
+    CHECK(visits[i].load() == 1u);
+  }
+}
+
+TEST_CASE("thread_pool.exception", "[thread_pool_test]")
+{
+  auto pool = thread_pool{4u};
+
+  CHECK_THROWS_AS(
+    pool.parallel_for(
+      1'000u,
+      [](const std::size_t i) {
+        if (i == 500u)
+        {
+          throw std::runtime_error{"error"};
+        }
+      }),
+    std::runtime_error);
+
+  // the pool is still usable afterwards
+  auto counter = std::atomic<std::size_t>{0u};
+  pool.parallel_for(100u, [&](const std::size_t) { counter.fetch_add(1u); });
+  CHECK(counter.load() == 100u);
+}
+
+TEST_CASE("thread_pool.set_default_thread_pool_size", "[thread_pool_test]")
+{
+  set_default_thread_pool_size(2u);
+  CHECK(default_thread_pool().thread_count() == 2u);
+
+  set_default_thread_pool_size(0u);
+  CHECK(default_thread_pool().thread_count() >= 1u);
+}
+
+TEST_CASE(
+  "thread_pool.set_default_thread_pool_size_waits_for_running_work", "[thread_pool_test]")
+{
+  set_default_thread_pool_size(4u);
+
+  auto started = std::promise<void>{};
+  auto release = std::promise<void>{};
+  auto releaseFuture = release.get_future().share();
+  auto finished = std::atomic<bool>{false};
+
+  auto work = std::async(std::launch::async, [&]() {
+    parallel_for(4u, [&](const std::size_t i) {
+      if (i == 0u)
+      {
+        started.set_value();
+        releaseFuture.wait();
+        finished = true;
+      }
+    });
+  });
+
+  started.get_future().wait();
+  auto resize = std::async(std::launch::async, [&]() {
+    set_default_thread_pool_size(2u);
+    // the old pool must not be destroyed while parallel_for is still running on it
+    return finished.load();
+  });
+
+  CHECK(resize.wait_for(std::chrono::milliseconds{50}) == std::future_status::timeout);
+  release.set_value();
+
+  work.get();
+  CHECK(resize.get());
+  CHECK(default_thread_pool().thread_count() == 2u);
+
+  set_default_thread_pool_size(0u);
+}
+} // namespace kdl